@@ -85,6 +85,7 @@ const char program_name[] = "avconv";
 const int program_birth_year = 2000;
 
 static FILE *vstats_file;
+static AVIOContext *stats_pb;
 
 static int nb_frames_drop = 0;
 
@@ -234,6 +235,8 @@ static void avconv_cleanup(int ret)
     if (vstats_file)
         fclose(vstats_file);
     av_free(vstats_filename);
+    avio_closep(&stats_pb);
+    av_free(stats_filename);
 
     av_freep(&input_streams);
     av_freep(&input_files);
@@ -278,6 +281,7 @@ static void write_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost)
 {
     AVFormatContext *s = of->ctx;
     AVStream *st = ost->st;
+    int64_t start;
     int ret;
 
     if (!of->header_written) {
@@ -352,7 +356,9 @@ static void write_packet(OutputFile *of, AVPacket *pkt, OutputStream *ost)
 
     pkt->stream_index = ost->index;
 
+    start = av_gettime_relative();
     ret = av_interleaved_write_frame(s, pkt);
+    ost->mux_time += av_gettime_relative() - start;
     if (ret < 0) {
         print_error("av_interleaved_write_frame()", ret);
         exit_program(1);
@@ -422,11 +428,30 @@ static int check_recording_time(OutputStream *ost)
     return 1;
 }
 
+/*
+ * Account for a packet received from the encoder. The n-th video packet
+ * is matched with the n-th frame sent to the encoder.
+ */
+static void update_encoder_latency(OutputStream *ost)
+{
+    uint64_t idx = ost->packets_encoded++;
+
+    if (ost->enc_ctx->codec_type != AVMEDIA_TYPE_VIDEO ||
+        idx >= ost->frames_encoded ||
+        ost->frames_encoded - idx > ENC_LATENCY_SLOTS)
+        return;
+
+    ost->enc_latency = av_gettime_relative() -
+                       ost->enc_send_time[idx % ENC_LATENCY_SLOTS];
+    ost->enc_latency_max = FFMAX(ost->enc_latency_max, ost->enc_latency);
+}
+
 static void do_audio_out(OutputFile *of, OutputStream *ost,
                          AVFrame *frame)
 {
     AVCodecContext *enc = ost->enc_ctx;
     AVPacket pkt;
+    int64_t start;
     int ret;
 
     av_init_packet(&pkt);
@@ -440,17 +465,22 @@ static void do_audio_out(OutputFile *of, OutputStream *ost,
     ost->samples_encoded += frame->nb_samples;
     ost->frames_encoded++;
 
+    start = av_gettime_relative();
     ret = avcodec_send_frame(enc, frame);
+    ost->encode_time += av_gettime_relative() - start;
     if (ret < 0)
         goto error;
 
     while (1) {
+        start = av_gettime_relative();
         ret = avcodec_receive_packet(enc, &pkt);
+        ost->encode_time += av_gettime_relative() - start;
         if (ret == AVERROR(EAGAIN))
             break;
         if (ret < 0)
             goto error;
 
+        update_encoder_latency(ost);
         output_packet(of, &pkt, ost, 0);
     }
 
@@ -537,6 +567,7 @@ static void do_video_out(OutputFile *of,
     int ret, format_video_sync;
     AVPacket pkt;
     AVCodecContext *enc = ost->enc_ctx;
+    int64_t start;
 
     *frame_size = 0;
 
@@ -549,6 +580,7 @@ static void do_video_out(OutputFile *of,
         in_picture->pts != AV_NOPTS_VALUE &&
         in_picture->pts < ost->sync_opts) {
         nb_frames_drop++;
+        ost->frames_dropped++;
         av_log(NULL, AV_LOG_WARNING,
                "*** dropping frame %d from stream %d at ts %"PRId64"\n",
                ost->frame_number, ost->st->index, in_picture->pts);
@@ -582,9 +614,12 @@ static void do_video_out(OutputFile *of,
         ost->forced_kf_index++;
     }
 
+    start = av_gettime_relative();
+    ost->enc_send_time[ost->frames_encoded % ENC_LATENCY_SLOTS] = start;
     ost->frames_encoded++;
 
     ret = avcodec_send_frame(enc, in_picture);
+    ost->encode_time += av_gettime_relative() - start;
     if (ret < 0)
         goto error;
 
@@ -595,12 +630,15 @@ static void do_video_out(OutputFile *of,
     ost->frame_number++;
 
     while (1) {
+        start = av_gettime_relative();
         ret = avcodec_receive_packet(enc, &pkt);
+        ost->encode_time += av_gettime_relative() - start;
         if (ret == AVERROR(EAGAIN))
             break;
         if (ret < 0)
             goto error;
 
+        update_encoder_latency(ost);
         output_packet(of, &pkt, ost, 0);
         *frame_size = pkt.size;
 
@@ -681,6 +719,7 @@ static int poll_filter(OutputStream *ost)
 {
     OutputFile    *of = output_files[ost->file_index];
     AVFrame *filtered_frame = NULL;
+    int64_t start;
     int frame_size, ret;
 
     if (!ost->filtered_frame && !(ost->filtered_frame = av_frame_alloc())) {
@@ -698,12 +737,14 @@ static int poll_filter(OutputStream *ost)
         }
     }
 
+    start = av_gettime_relative();
     if (ost->enc->type == AVMEDIA_TYPE_AUDIO &&
         !(ost->enc->capabilities & AV_CODEC_CAP_VARIABLE_FRAME_SIZE))
         ret = av_buffersink_get_samples(ost->filter->filter, filtered_frame,
                                          ost->enc_ctx->frame_size);
     else
         ret = av_buffersink_get_frame(ost->filter->filter, filtered_frame);
+    ost->filter_time += av_gettime_relative() - start;
 
     if (ret < 0)
         return ret;
@@ -1040,6 +1081,127 @@ FF_ENABLE_DEPRECATION_WARNINGS
 
 }
 
+static int input_queue_depth(InputFile *f)
+{
+    int nb = 0;
+#if HAVE_PTHREADS
+    if (f->fifo && !f->joined) {
+        pthread_mutex_lock(&f->fifo_lock);
+        nb = av_fifo_size(f->fifo) / sizeof(AVPacket);
+        pthread_mutex_unlock(&f->fifo_lock);
+    }
+#endif
+    return nb;
+}
+
+/*
+ * How far ahead of the slowest stream of its file this stream is, i.e. how
+ * long its packets wait in the muxer for interleaving.
+ */
+static int64_t interleave_delay(OutputStream *ost)
+{
+    OutputFile *of = output_files[ost->file_index];
+    int64_t dts, min_dts = INT64_MAX;
+    int i;
+
+    if (ost->last_mux_dts == AV_NOPTS_VALUE)
+        return 0;
+    dts = av_rescale_q(ost->last_mux_dts, ost->st->time_base, AV_TIME_BASE_Q);
+
+    for (i = 0; i < of->ctx->nb_streams; i++) {
+        OutputStream *o = output_streams[of->ost_index + i];
+        if (o->finished || o->last_mux_dts == AV_NOPTS_VALUE)
+            continue;
+        min_dts = FFMIN(min_dts, av_rescale_q(o->last_mux_dts, o->st->time_base,
+                                              AV_TIME_BASE_Q));
+    }
+    return min_dts < dts ? dts - min_dts : 0;
+}
+
+/*
+ * Write one JSON line with the per-stream counters to -stats_file.
+ */
+static void write_stats(int is_last_report, int64_t timer_start)
+{
+    static int64_t last_time = -1;
+    int64_t cur_time = av_gettime_relative();
+    int i, j;
+
+    if (!stats_filename)
+        return;
+
+    if (!is_last_report) {
+        if (last_time != -1 && cur_time - last_time < stats_period * 1000000)
+            return;
+        last_time = cur_time;
+    }
+
+    if (!stats_pb) {
+        int ret = avio_open2(&stats_pb, stats_filename, AVIO_FLAG_WRITE,
+                             &int_cb, NULL);
+        if (ret < 0) {
+            print_error(stats_filename, ret);
+            exit_program(1);
+        }
+    }
+
+    avio_printf(stats_pb, "{\"time\":%0.3f,\"final\":%s,\"input_streams\":[",
+                (cur_time - timer_start) / 1000000.0,
+                is_last_report ? "true" : "false");
+    for (i = 0; i < nb_input_files; i++) {
+        InputFile *f = input_files[i];
+        int demux_queue = input_queue_depth(f);
+
+        for (j = 0; j < f->nb_streams; j++) {
+            InputStream *ist = input_streams[f->ist_index + j];
+            int k, filter_queue = 0;
+
+            for (k = 0; k < ist->nb_filters; k++)
+                filter_queue += av_fifo_size(ist->filters[k]->frame_queue) /
+                                sizeof(AVFrame*);
+
+            avio_printf(stats_pb, "%s{\"file\":%d,\"stream\":%d,\"type\":\"%s\","
+                        "\"packets\":%"PRIu64",\"bytes\":%"PRIu64","
+                        "\"frames_decoded\":%"PRIu64","
+                        "\"decode_time\":%"PRId64",\"filter_time\":%"PRId64","
+                        "\"demux_queue\":%d,\"filter_queue\":%d}",
+                        f->ist_index + j ? "," : "", i, j,
+                        media_type_string(ist->dec_ctx->codec_type),
+                        ist->nb_packets, ist->data_size, ist->frames_decoded,
+                        ist->decode_time, ist->filter_time,
+                        demux_queue, filter_queue);
+        }
+    }
+
+    avio_printf(stats_pb, "],\"output_streams\":[");
+    for (i = 0; i < nb_output_streams; i++) {
+        OutputStream *ost = output_streams[i];
+
+        avio_printf(stats_pb, "%s{\"file\":%d,\"stream\":%d,\"type\":\"%s\","
+                    "\"frames_encoded\":%"PRIu64",\"packets_encoded\":%"PRIu64","
+                    "\"packets_muxed\":%"PRIu64",\"bytes\":%"PRIu64","
+                    "\"frames_dropped\":%"PRIu64","
+                    "\"filter_time\":%"PRId64",\"encode_time\":%"PRId64","
+                    "\"mux_time\":%"PRId64","
+                    "\"encoder_delay\":%"PRId64",\"encoder_latency\":%"PRId64","
+                    "\"encoder_latency_max\":%"PRId64","
+                    "\"muxing_queue\":%d,\"interleave_delay\":%"PRId64"}",
+                    i ? "," : "", ost->file_index, ost->index,
+                    media_type_string(ost->enc_ctx->codec_type),
+                    ost->frames_encoded, ost->packets_encoded,
+                    ost->packets_written, ost->data_size, ost->frames_dropped,
+                    ost->filter_time, ost->encode_time, ost->mux_time,
+                    ost->enc_ctx->codec_type == AVMEDIA_TYPE_VIDEO ?
+                    (int64_t)(ost->frames_encoded - ost->packets_encoded) : 0,
+                    ost->enc_latency, ost->enc_latency_max,
+                    ost->muxing_queue ?
+                    (int)(av_fifo_size(ost->muxing_queue) / sizeof(AVPacket)) : 0,
+                    interleave_delay(ost));
+    }
+    avio_printf(stats_pb, "]}\n");
+    avio_flush(stats_pb);
+}
+
 static void flush_encoders(void)
 {
     int i, ret;
@@ -1077,15 +1239,20 @@ static void flush_encoders(void)
 
             if (1) {
                 AVPacket pkt;
+                int64_t start;
                 av_init_packet(&pkt);
                 pkt.data = NULL;
                 pkt.size = 0;
 
+                start = av_gettime_relative();
                 ret = avcodec_receive_packet(enc, &pkt);
+                ost->encode_time += av_gettime_relative() - start;
                 if (ret < 0 && ret != AVERROR_EOF) {
                     av_log(NULL, AV_LOG_FATAL, "%s encoding failed\n", desc);
                     exit_program(1);
                 }
+                if (ret >= 0)
+                    update_encoder_latency(ost);
                 if (ost->logfile && enc->stats_out) {
                     fprintf(ost->logfile, "%s", enc->stats_out);
                 }
@@ -1198,6 +1365,7 @@ static void do_streamcopy(InputStream *ist, OutputStream *ost, const AVPacket *p
 static int ifilter_send_frame(InputFilter *ifilter, AVFrame *frame)
 {
     FilterGraph *fg = ifilter->graph;
+    int64_t start;
     int need_reinit, ret, i;
 
     /* determine if the parameters for this input changed */
@@ -1258,7 +1426,9 @@ static int ifilter_send_frame(InputFilter *ifilter, AVFrame *frame)
         }
     }
 
+    start = av_gettime_relative();
     ret = av_buffersrc_add_frame(ifilter->filter, frame);
+    ifilter->ist->filter_time += av_gettime_relative() - start;
     if (ret < 0) {
         av_log(NULL, AV_LOG_ERROR, "Error while filtering\n");
         return ret;
@@ -1345,6 +1515,7 @@ static int decode_audio(InputStream *ist, AVPacket *pkt, int *got_output,
 {
     AVFrame *decoded_frame, *f;
     AVCodecContext *avctx = ist->dec_ctx;
+    int64_t start;
     int i, ret, err = 0;
 
     if (!ist->decoded_frame && !(ist->decoded_frame = av_frame_alloc()))
@@ -1353,7 +1524,9 @@ static int decode_audio(InputStream *ist, AVPacket *pkt, int *got_output,
         return AVERROR(ENOMEM);
     decoded_frame = ist->decoded_frame;
 
+    start = av_gettime_relative();
     ret = decode(avctx, decoded_frame, got_output, pkt);
+    ist->decode_time += av_gettime_relative() - start;
     if (ret < 0)
         *decode_failed = 1;
     if (!*got_output || ret < 0)
@@ -1398,6 +1571,7 @@ static int decode_video(InputStream *ist, AVPacket *pkt, int *got_output,
                         int *decode_failed)
 {
     AVFrame *decoded_frame, *f;
+    int64_t start;
     int i, ret = 0, err = 0;
 
     if (!ist->decoded_frame && !(ist->decoded_frame = av_frame_alloc()))
@@ -1406,7 +1580,9 @@ static int decode_video(InputStream *ist, AVPacket *pkt, int *got_output,
         return AVERROR(ENOMEM);
     decoded_frame = ist->decoded_frame;
 
+    start = av_gettime_relative();
     ret = decode(ist->dec_ctx, decoded_frame, got_output, pkt);
+    ist->decode_time += av_gettime_relative() - start;
     if (ret < 0)
         *decode_failed = 1;
     if (!*got_output || ret < 0)
@@ -1453,8 +1629,10 @@ static int transcode_subtitles(InputStream *ist, AVPacket *pkt, int *got_output,
                                int *decode_failed)
 {
     AVSubtitle subtitle;
+    int64_t start = av_gettime_relative();
     int i, ret = avcodec_decode_subtitle2(ist->dec_ctx,
                                           &subtitle, got_output, pkt);
+    ist->decode_time += av_gettime_relative() - start;
     if (ret < 0) {
         *decode_failed = 1;
         return ret;
@@ -2409,6 +2587,7 @@ static void free_input_threads(void)
             av_packet_unref(&pkt);
         }
         av_fifo_free(f->fifo);
+        f->fifo = NULL;
     }
 }
 
@@ -2779,6 +2958,7 @@ static int transcode(void)
 
         /* dump report by using the output first video and audio streams */
         print_report(0, timer_start);
+        write_stats(0, timer_start);
     }
 #if HAVE_PTHREADS
     free_input_threads();
@@ -2811,6 +2991,7 @@ static int transcode(void)
 
     /* dump report by using the first video and audio streams */
     print_report(1, timer_start);
+    write_stats(1, timer_start);
 
     /* close each encoder */
     for (i = 0; i < nb_output_streams; i++) {
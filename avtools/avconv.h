@@ -263,6 +263,8 @@ typedef struct FilterGraph {
     int         nb_outputs;
 } FilterGraph;
 
+#define ENC_LATENCY_SLOTS 256
+
 typedef struct InputStream {
     int file_index;
     AVStream *st;
@@ -322,6 +324,9 @@ typedef struct InputStream {
     // number of frames/samples retrieved from the decoder
     uint64_t frames_decoded;
     uint64_t samples_decoded;
+    // time spent in the decoder and sending frames to the filters, in us
+    int64_t decode_time;
+    int64_t filter_time;
 } InputStream;
 
 typedef struct InputFile {
@@ -430,6 +435,19 @@ typedef struct OutputStream {
     // number of frames/samples sent to the encoder
     uint64_t frames_encoded;
     uint64_t samples_encoded;
+    // number of packets received from the encoder
+    uint64_t packets_encoded;
+    // number of frames dropped before the encoder
+    uint64_t frames_dropped;
+    // time spent getting frames from the filters, encoding and muxing, in us
+    int64_t filter_time;
+    int64_t encode_time;
+    int64_t mux_time;
+    // time each of the last video frames was sent to the encoder, used to
+    // measure the time until the matching packet comes out
+    int64_t enc_send_time[ENC_LATENCY_SLOTS];
+    int64_t enc_latency;
+    int64_t enc_latency_max;
 
     /* packet quality factor */
     int quality;
@@ -467,6 +485,8 @@ extern FilterGraph **filtergraphs;
 extern int        nb_filtergraphs;
 
 extern char *vstats_filename;
+extern char *stats_filename;
+extern float stats_period;
 
 extern float audio_drift_threshold;
 extern float dts_delta_threshold;
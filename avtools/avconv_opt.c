@@ -91,6 +91,8 @@ AVBufferRef *hw_device_ctx;
 HWDevice *filter_hw_device;
 
 char *vstats_filename;
+char *stats_filename;
+float stats_period = 1.0;
 
 float audio_drift_threshold = 0.1;
 float dts_delta_threshold   = 10;
@@ -2223,6 +2225,13 @@ static int opt_vstats_file(void *optctx, const char *opt, const char *arg)
     return 0;
 }
 
+static int opt_stats_file(void *optctx, const char *opt, const char *arg)
+{
+    av_free(stats_filename);
+    stats_filename = av_strdup(arg);
+    return 0;
+}
+
 static int opt_vstats(void *optctx, const char *opt, const char *arg)
 {
     char filename[40];
@@ -2646,6 +2655,10 @@ const OptionDef options[] = {
         "read complex filtergraph description from a file", "filename" },
     { "stats",          OPT_BOOL,                                    { &print_stats },
         "print progress report during encoding", },
+    { "stats_file",     HAS_ARG | OPT_EXPERT,                        { .func_arg = opt_stats_file },
+        "write per-stream statistics as JSON lines to the given URL", "url" },
+    { "stats_period",   HAS_ARG | OPT_FLOAT | OPT_EXPERT,            { &stats_period },
+        "set the interval between two -stats_file updates", "seconds" },
     { "attach",         HAS_ARG | OPT_PERFILE | OPT_EXPERT |
                         OPT_OUTPUT,                                  { .func_arg = opt_attach },
         "add an attachment to the output file", "filename" },
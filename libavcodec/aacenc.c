@@ -502,6 +502,22 @@ static void copy_input_samples(AACEncContext *s, const AVFrame *frame)
     }
 }
 
+/**
+ * Search the quantizers of one channel, the channels are independent once
+ * the psychoacoustic analysis of the frame is done.
+ */
+static int search_channel_quantizers(AVCodecContext *avctx, void *arg,
+                                     int channel, int threadnr)
+{
+    AACEncContext *s = avctx->priv_data;
+    AACEncContext *ctx = s->thread_ctx[threadnr];
+    SingleChannelElement **sces = arg;
+
+    ctx->cur_channel = channel;
+    s->coder->search_for_quantizers(avctx, ctx, sces[channel], s->lambda);
+    return 0;
+}
+
 static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                             const AVFrame *frame, int *got_packet_ptr)
 {
@@ -578,27 +594,36 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
     }
 
     do {
+        SingleChannelElement *sces[AAC_MAX_CHANNELS];
+
         init_put_bits(&s->pb, avpkt->data, avpkt->size);
 
         if ((avctx->frame_number & 0xFF)==1 && !(avctx->flags & AV_CODEC_FLAG_BITEXACT))
             put_bitstream_info(s, LIBAVCODEC_IDENT);
         start_ch = 0;
-        memset(chan_el_counter, 0, sizeof(chan_el_counter));
         for (i = 0; i < s->chan_map[0]; i++) {
             FFPsyWindowInfo* wi = windows + start_ch;
             const float *coeffs[2];
+            chans    = s->chan_map[i+1] == TYPE_CPE ? 2 : 1;
+            cpe      = &s->cpe[i];
+            for (ch = 0; ch < chans; ch++) {
+                coeffs[ch]          = cpe->ch[ch].coeffs;
+                sces[start_ch + ch] = &cpe->ch[ch];
+            }
+            s->psy.model->analyze(&s->psy, start_ch, coeffs, wi);
+            start_ch += chans;
+        }
+        avctx->execute2(avctx, search_channel_quantizers, sces, NULL, s->channels);
+
+        start_ch = 0;
+        memset(chan_el_counter, 0, sizeof(chan_el_counter));
+        for (i = 0; i < s->chan_map[0]; i++) {
+            FFPsyWindowInfo* wi = windows + start_ch;
             tag      = s->chan_map[i+1];
             chans    = tag == TYPE_CPE ? 2 : 1;
             cpe      = &s->cpe[i];
             put_bits(&s->pb, 3, tag);
             put_bits(&s->pb, 4, chan_el_counter[tag]++);
-            for (ch = 0; ch < chans; ch++)
-                coeffs[ch] = cpe->ch[ch].coeffs;
-            s->psy.model->analyze(&s->psy, start_ch, coeffs, wi);
-            for (ch = 0; ch < chans; ch++) {
-                s->cur_channel = start_ch + ch;
-                s->coder->search_for_quantizers(avctx, s, &cpe->ch[ch], s->lambda);
-            }
             cpe->common_window = 0;
             if (chans > 1
                 && wi[0].window_type[0] == wi[1].window_type[0]
@@ -678,6 +703,7 @@ FF_ENABLE_DEPRECATION_WARNINGS
 static av_cold int aac_encode_end(AVCodecContext *avctx)
 {
     AACEncContext *s = avctx->priv_data;
+    int i;
 
     ff_mdct_end(&s->mdct1024);
     ff_mdct_end(&s->mdct128);
@@ -687,6 +713,9 @@ static av_cold int aac_encode_end(AVCodecContext *avctx)
     av_freep(&s->buffer.samples);
     av_freep(&s->cpe);
     ff_af_queue_close(&s->afq);
+    for (i = 1; i < s->nb_thread_ctx; i++)
+        av_freep(&s->thread_ctx[i]);
+    av_freep(&s->thread_ctx);
     return 0;
 }
 
@@ -695,6 +724,7 @@ static av_cold int dsp_init(AVCodecContext *avctx, AACEncContext *s)
     int ret = 0;
 
     avpriv_float_dsp_init(&s->fdsp, avctx->flags & AV_CODEC_FLAG_BITEXACT);
+    ff_aacenc_dsp_init(&s->aacdsp);
 
     // window init
     ff_kbd_window_init(ff_aac_kbd_long_1024, 4.0, 1024);
@@ -712,7 +742,7 @@ static av_cold int dsp_init(AVCodecContext *avctx, AACEncContext *s)
 
 static av_cold int alloc_buffers(AVCodecContext *avctx, AACEncContext *s)
 {
-    int ch;
+    int ch, nb_thread_ctx;
     FF_ALLOCZ_OR_GOTO(avctx, s->buffer.samples, 3 * 1024 * s->channels * sizeof(s->buffer.samples[0]), alloc_fail);
     FF_ALLOCZ_OR_GOTO(avctx, s->cpe, sizeof(ChannelElement) * s->chan_map[0], alloc_fail);
     FF_ALLOCZ_OR_GOTO(avctx, avctx->extradata, 5 + AV_INPUT_BUFFER_PADDING_SIZE, alloc_fail);
@@ -720,6 +750,14 @@ static av_cold int alloc_buffers(AVCodecContext *avctx, AACEncContext *s)
     for(ch = 0; ch < s->channels; ch++)
         s->planar_samples[ch] = s->buffer.samples + 3 * 1024 * ch;
 
+    nb_thread_ctx = avctx->active_thread_type & FF_THREAD_SLICE ?
+                    avctx->thread_count : 1;
+    FF_ALLOCZ_OR_GOTO(avctx, s->thread_ctx, sizeof(*s->thread_ctx) * nb_thread_ctx, alloc_fail);
+    s->nb_thread_ctx = nb_thread_ctx;
+    s->thread_ctx[0] = s;
+    for (ch = 1; ch < s->nb_thread_ctx; ch++)
+        FF_ALLOCZ_OR_GOTO(avctx, s->thread_ctx[ch], sizeof(*s), alloc_fail);
+
     return 0;
 alloc_fail:
     return AVERROR(ENOMEM);
@@ -777,6 +815,11 @@ static av_cold int aac_encode_init(AVCodecContext *avctx)
     s->psypp = ff_psy_preprocess_init(avctx);
     s->coder = &ff_aac_coders[2];
 
+    for (i = 1; i < s->nb_thread_ctx; i++) {
+        s->thread_ctx[i]->aacdsp = s->aacdsp;
+        s->thread_ctx[i]->psy.ch = s->psy.ch;
+    }
+
     s->lambda = avctx->global_quality ? avctx->global_quality : 120;
 
     ff_aac_tableinit();
@@ -819,7 +862,7 @@ AVCodec ff_aac_encoder = {
     .encode2        = aac_encode_frame,
     .close          = aac_encode_end,
     .capabilities   = AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_DELAY |
-                      AV_CODEC_CAP_EXPERIMENTAL,
+                      AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_EXPERIMENTAL,
     .sample_fmts    = (const enum AVSampleFormat[]){ AV_SAMPLE_FMT_FLTP,
                                                      AV_SAMPLE_FMT_NONE },
     .priv_class     = &aacenc_class,
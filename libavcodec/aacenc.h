@@ -27,6 +27,7 @@
 #include "put_bits.h"
 
 #include "aac.h"
+#include "aacencdsp.h"
 #include "audio_frame_queue.h"
 #include "psymodel.h"
 
@@ -58,6 +59,7 @@ typedef struct AACEncContext {
     FFTContext mdct1024;                         ///< long (1024 samples) frame transform context
     FFTContext mdct128;                          ///< short (128 samples) frame transform context
     AVFloatDSPContext fdsp;
+    AACEncDSPContext aacdsp;
     float *planar_samples[6];                    ///< saved preprocessed input
 
     int samplerate_index;                        ///< MPEG-4 samplerate index
@@ -78,6 +80,14 @@ typedef struct AACEncContext {
     struct {
         float *samples;
     } buffer;
+
+    /**
+     * Contexts with their own scratch buffers, used to search the quantizers
+     * of several channels in parallel. Only the fields read by the search,
+     * the DSP functions and the per-channel psy data, are set up in init.
+     */
+    struct AACEncContext **thread_ctx;
+    int nb_thread_ctx;
 } AACEncContext;
 
 extern float ff_aac_pow34sf_tab[428];
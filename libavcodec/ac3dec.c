@@ -198,10 +198,14 @@ static av_cold int ac3_decode_init(AVCodecContext *avctx)
         avctx->channels = 2;
     s->downmixed = 1;
 
-    for (i = 0; i < AC3_MAX_CHANNELS; i++) {
-        s->xcfptr[i] = s->transform_coeffs[i];
+    for (i = 0; i < AC3_MAX_CHANNELS; i++)
         s->dlyptr[i] = s->delay[i];
-    }
+
+    s->frame.f      = av_frame_alloc();
+    s->last_frame.f = av_frame_alloc();
+    if (!s->frame.f || !s->last_frame.f)
+        return AVERROR(ENOMEM);
+    avctx->internal->allocate_progress = 1;
 
     return 0;
 }
@@ -638,24 +642,25 @@ static void do_rematrixing(AC3DecodeContext *s)
  * Convert frequency domain coefficients to time-domain audio samples.
  * reference: Section 7.9.4 Transformation Equations
  */
-static inline void do_imdct(AC3DecodeContext *s, int channels)
+static inline void do_imdct(AC3DecodeContext *s, int blk, int channels)
 {
+    float (*coeffs)[AC3_MAX_COEFS] = s->block_coeffs[blk];
     int ch;
 
     for (ch = 1; ch <= channels; ch++) {
-        if (s->block_switch[ch]) {
+        if (s->block_switch[blk][ch]) {
             int i;
             float *x = s->tmp_output + 128;
             for (i = 0; i < 128; i++)
-                x[i] = s->transform_coeffs[ch][2 * i];
+                x[i] = coeffs[ch][2 * i];
             s->imdct_256.imdct_half(&s->imdct_256, s->tmp_output, x);
             s->fdsp.vector_fmul_window(s->outptr[ch - 1], s->delay[ch - 1],
                                        s->tmp_output, s->window, 128);
             for (i = 0; i < 128; i++)
-                x[i] = s->transform_coeffs[ch][2 * i + 1];
+                x[i] = coeffs[ch][2 * i + 1];
             s->imdct_256.imdct_half(&s->imdct_256, s->delay[ch - 1], x);
         } else {
-            s->imdct_512.imdct_half(&s->imdct_512, s->tmp_output, s->transform_coeffs[ch]);
+            s->imdct_512.imdct_half(&s->imdct_512, s->tmp_output, coeffs[ch]);
             s->fdsp.vector_fmul_window(s->outptr[ch - 1], s->delay[ch - 1],
                                        s->tmp_output, s->window, 128);
             memcpy(s->delay[ch - 1], s->tmp_output + 128, 128 * sizeof(float));
@@ -979,19 +984,19 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
     int fbw_channels = s->fbw_channels;
     int channel_mode = s->channel_mode;
     int i, bnd, seg, ch, ret;
-    int different_transforms;
-    int downmix_output;
     int cpl_in_use;
     GetBitContext *gbc = &s->gbc;
     uint8_t bit_alloc_stages[AC3_MAX_CHANNELS] = { 0 };
 
+    s->transform_coeffs = s->block_coeffs[blk];
+
     /* block switch flags */
-    different_transforms = 0;
+    s->different_transforms[blk] = 0;
     if (s->block_switch_syntax) {
         for (ch = 1; ch <= fbw_channels; ch++) {
-            s->block_switch[ch] = get_bits1(gbc);
-            if (ch > 1 && s->block_switch[ch] != s->block_switch[1])
-                different_transforms = 1;
+            s->block_switch[blk][ch] = get_bits1(gbc);
+            if (ch > 1 && s->block_switch[blk][ch] != s->block_switch[blk][1])
+                s->different_transforms[blk] = 1;
         }
     }
 
@@ -1311,13 +1316,29 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
         ff_eac3_apply_spectral_extension(s);
     }
 
+    return 0;
+}
+
+/**
+ * Downmix and transform the coefficients of a decoded audio block to
+ * output samples. Apart from the coefficients, this only depends on the
+ * delay samples left by the previous block, so it can run once the whole
+ * frame has been parsed.
+ */
+static void output_audio_block(AC3DecodeContext *s, int blk)
+{
+    int ch, downmix_output;
+
+    for (ch = 0; ch <= s->channels; ch++)
+        s->xcfptr[ch] = s->block_coeffs[blk][ch];
+
     /* downmix and MDCT. order depends on whether block switching is used for
        any channel in this block. this is because coefficients for the long
        and short transforms cannot be mixed. */
     downmix_output = s->channels != s->out_channels &&
                      !((s->output_mode & AC3_OUTPUT_LFEON) &&
                      s->fbw_channels == s->out_channels);
-    if (different_transforms) {
+    if (s->different_transforms[blk]) {
         /* the delay samples have already been downmixed, so we upmix the delay
            samples in order to reconstruct all channels before downmixing. */
         if (s->downmixed) {
@@ -1325,7 +1346,7 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
             ac3_upmix_delay(s);
         }
 
-        do_imdct(s, s->channels);
+        do_imdct(s, blk, s->channels);
 
         if (downmix_output) {
             ff_ac3dsp_downmix(&s->ac3dsp, s->outptr, s->downmix_coeffs,
@@ -1343,10 +1364,8 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
                               s->out_channels, s->fbw_channels, 128);
         }
 
-        do_imdct(s, s->out_channels);
+        do_imdct(s, blk, s->out_channels);
     }
-
-    return 0;
 }
 
 /**
@@ -1359,21 +1378,29 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
     const uint8_t *buf = avpkt->data;
     int buf_size = avpkt->size;
     AC3DecodeContext *s = avctx->priv_data;
-    int blk, ch, err, ret;
+    int blk, ch, err, ret, input_size, decoded_blocks;
     const uint8_t *channel_map;
     const float *output[AC3_MAX_CHANNELS];
     enum AVMatrixEncoding matrix_encoding;
     AVDownmixInfo *downmix_info;
 
+    /* a frame which fails before getting a buffer passes the output state
+       of the previous one on to the next thread */
+    ff_thread_release_buffer(avctx, &s->frame);
+
     /* copy input buffer to decoder context to avoid reading past the end
        of the buffer, which can be caused by a damaged input stream. */
+    input_size = FFMIN(buf_size, AC3_FRAME_BUFFER_SIZE);
     if (buf_size >= 2 && AV_RB16(buf) == 0x770B) {
         // seems to be byte-swapped AC-3
-        int cnt = FFMIN(buf_size, AC3_FRAME_BUFFER_SIZE) >> 1;
+        int cnt = input_size >> 1;
         s->bdsp.bswap16_buf((uint16_t *) s->input_buffer,
                             (const uint16_t *) buf, cnt);
+        input_size = cnt * 2;
     } else
-        memcpy(s->input_buffer, buf, FFMIN(buf_size, AC3_FRAME_BUFFER_SIZE));
+        memcpy(s->input_buffer, buf, input_size);
+    /* do not let the bits read past the end depend on earlier frames */
+    memset(s->input_buffer + input_size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
     buf = s->input_buffer;
     /* initialize the GetBitContext with the start of valid AC-3 Frame */
     init_get_bits(&s->gbc, buf, buf_size * 8);
@@ -1477,27 +1504,47 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
         avctx->audio_service_type = AV_AUDIO_SERVICE_TYPE_KARAOKE;
 
     /* get output buffer */
-    frame->nb_samples = s->num_blocks * AC3_BLOCK_SIZE;
-    if ((ret = ff_get_buffer(avctx, frame, 0)) < 0) {
+    s->frame.f->nb_samples = s->num_blocks * AC3_BLOCK_SIZE;
+    if ((ret = ff_thread_get_buffer(avctx, &s->frame, 0)) < 0) {
         av_log(avctx, AV_LOG_ERROR, "get_buffer() failed\n");
         return ret;
     }
 
-    /* decode the audio blocks */
+    /* parse the audio blocks */
+    decoded_blocks = 0;
+    while (!err && decoded_blocks < s->num_blocks) {
+        if (decode_audio_block(s, decoded_blocks)) {
+            av_log(avctx, AV_LOG_ERROR, "error decoding the audio block\n");
+            err = 1;
+        } else {
+            decoded_blocks++;
+        }
+    }
+
+    /* the rest only depends on the output state of the previous frame */
+    ff_thread_finish_setup(avctx);
+    if (s->last_ctx && s->last_ctx != s) {
+        const AC3DecodeContext *last = s->last_ctx;
+
+        ff_thread_await_progress(&s->last_frame, INT_MAX, 0);
+        memcpy(s->delay,  last->delay,  sizeof(s->delay));
+        memcpy(s->output, last->output, sizeof(s->output));
+        s->downmixed = last->downmixed;
+    }
+
+    /* output the audio blocks */
     channel_map = ff_ac3_dec_channel_map[s->output_mode & ~AC3_OUTPUT_LFEON][s->lfe_on];
     for (ch = 0; ch < s->channels; ch++) {
         if (ch < s->out_channels)
-            s->outptr[channel_map[ch]] = (float *)frame->data[ch];
+            s->outptr[channel_map[ch]] = (float *)s->frame.f->data[ch];
         else
             s->outptr[ch] = s->output[ch];
         output[ch] = s->output[ch];
     }
     for (blk = 0; blk < s->num_blocks; blk++) {
-        if (!err && decode_audio_block(s, blk)) {
-            av_log(avctx, AV_LOG_ERROR, "error decoding the audio block\n");
-            err = 1;
-        }
-        if (err)
+        if (blk < decoded_blocks)
+            output_audio_block(s, blk);
+        else
             for (ch = 0; ch < s->out_channels; ch++)
                 memcpy(s->outptr[channel_map[ch]], output[ch], sizeof(**output) * AC3_BLOCK_SIZE);
         for (ch = 0; ch < s->out_channels; ch++)
@@ -1510,6 +1557,8 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
     for (ch = 0; ch < s->out_channels; ch++)
         memcpy(s->output[ch], output[ch], sizeof(**output) * AC3_BLOCK_SIZE);
 
+    ff_thread_report_progress(&s->frame, INT_MAX, 0);
+
     /*
      * AVMatrixEncoding
      *
@@ -1536,8 +1585,10 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
             break;
         }
     }
-    if ((ret = ff_side_data_update_matrix_encoding(frame, matrix_encoding)) < 0)
+    if ((ret = av_frame_ref(frame, s->frame.f)) < 0)
         return ret;
+    if ((ret = ff_side_data_update_matrix_encoding(frame, matrix_encoding)) < 0)
+        goto fail;
 
     /* AVDownmixInfo */
     if ((downmix_info = av_downmix_info_update_side_data(frame))) {
@@ -1563,12 +1614,17 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
             downmix_info->lfe_mix_level       = gain_levels_lfe[s->lfe_mix_level];
         else
             downmix_info->lfe_mix_level       = 0.0; // -inf dB
-    } else
-        return AVERROR(ENOMEM);
+    } else {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
 
     *got_frame_ptr = 1;
 
     return FFMIN(buf_size, s->frame_size);
+fail:
+    av_frame_unref(frame);
+    return ret;
 }
 
 /**
@@ -1581,9 +1637,112 @@ static av_cold int ac3_decode_end(AVCodecContext *avctx)
     ff_mdct_end(&s->imdct_256);
     av_freep(&s->downmix_coeffs[0]);
 
+    if (s->frame.f)
+        ff_thread_release_buffer(avctx, &s->frame);
+    if (s->last_frame.f)
+        ff_thread_release_buffer(avctx, &s->last_frame);
+    av_frame_free(&s->frame.f);
+    av_frame_free(&s->last_frame.f);
+
     return 0;
 }
 
+static void ac3_decode_flush(AVCodecContext *avctx)
+{
+    AC3DecodeContext *s = avctx->priv_data;
+
+    ff_thread_release_buffer(avctx, &s->last_frame);
+    s->last_ctx = NULL;
+}
+
+#if HAVE_THREADS
+static av_cold int ac3_decode_init_thread_copy(AVCodecContext *avctx)
+{
+    AC3DecodeContext *s = avctx->priv_data;
+    int i;
+
+    s->avctx             = avctx;
+    s->downmix_coeffs[0] = NULL;
+    s->last_ctx          = NULL;
+
+    ff_mdct_init(&s->imdct_256, 8, 1, 1.0);
+    ff_mdct_init(&s->imdct_512, 9, 1, 1.0);
+
+    for (i = 0; i < AC3_MAX_CHANNELS; i++)
+        s->dlyptr[i] = s->delay[i];
+
+    memset(&s->frame,      0, sizeof(s->frame));
+    memset(&s->last_frame, 0, sizeof(s->last_frame));
+    s->frame.f      = av_frame_alloc();
+    s->last_frame.f = av_frame_alloc();
+    if (!s->frame.f || !s->last_frame.f)
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
+static int ac3_update_thread_context(AVCodecContext *dst,
+                                     const AVCodecContext *src)
+{
+    AC3DecodeContext *s = dst->priv_data, *s1 = src->priv_data;
+
+    if (dst == src)
+        return 0;
+
+#define COPY(field) memcpy(&s->field, &s1->field, sizeof(s->field))
+    /* The parameters of the last valid header, used when the header of the
+     * next frame is damaged. */
+    COPY(sample_rate);
+    COPY(bit_rate);
+    COPY(num_blocks);
+    COPY(bitstream_mode);
+    COPY(channel_mode);
+    COPY(lfe_on);
+    COPY(fbw_channels);
+    COPY(channels);
+    COPY(lfe_ch);
+    COPY(output_mode);
+    COPY(out_channels);
+    COPY(eac3_frame_dependent_found);
+    COPY(eac3_subsbtreamid_found);
+
+    /* E-AC-3 frames of less than 6 blocks may reuse the exponents and the
+     * bit allocation of the previous frame. */
+    COPY(start_freq);
+    COPY(end_freq);
+    COPY(num_exp_groups);
+    COPY(dexps);
+    COPY(bit_alloc_params);
+    COPY(snr_offset);
+    COPY(fast_gain);
+    COPY(dba_mode);
+    COPY(dba_nsegs);
+    COPY(dba_offsets);
+    COPY(dba_lengths);
+    COPY(dba_values);
+    COPY(psd);
+    COPY(band_psd);
+    COPY(mask);
+    COPY(bap);
+
+    COPY(dith_state);
+#undef COPY
+
+    /* The delay samples are only known once the last frame that has been
+     * output is complete. */
+    ff_thread_release_buffer(dst, &s->last_frame);
+    if (s1->frame.f->buf[0]) {
+        s->last_ctx = s1;
+        return ff_thread_ref_frame(&s->last_frame, &s1->frame);
+    }
+    s->last_ctx = s1->last_ctx;
+    if (s1->last_frame.f->buf[0])
+        return ff_thread_ref_frame(&s->last_frame, &s1->last_frame);
+
+    return 0;
+}
+#endif
+
 #define OFFSET(x) offsetof(AC3DecodeContext, x)
 #define PAR (AV_OPT_FLAG_DECODING_PARAM | AV_OPT_FLAG_AUDIO_PARAM)
 static const AVOption options[] = {
@@ -1607,7 +1766,10 @@ AVCodec ff_ac3_decoder = {
     .init           = ac3_decode_init,
     .close          = ac3_decode_end,
     .decode         = ac3_decode_frame,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .flush          = ac3_decode_flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(ac3_decode_init_thread_copy),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(ac3_update_thread_context),
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_FLTP,
                                                       AV_SAMPLE_FMT_NONE },
     .priv_class     = &ac3_decoder_class,
@@ -1630,7 +1792,10 @@ AVCodec ff_eac3_decoder = {
     .init           = ac3_decode_init,
     .close          = ac3_decode_end,
     .decode         = ac3_decode_frame,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .flush          = ac3_decode_flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(ac3_decode_init_thread_copy),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(ac3_update_thread_context),
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_FLTP,
                                                       AV_SAMPLE_FMT_NONE },
     .priv_class     = &eac3_decoder_class,
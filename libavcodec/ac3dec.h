@@ -58,6 +58,7 @@
 #include "get_bits.h"
 #include "fft.h"
 #include "fmtconvert.h"
+#include "thread.h"
 
 #define AC3_OUTPUT_LFEON  8
 
@@ -147,8 +148,6 @@ typedef struct AC3DecodeContext {
     int fbw_channels;                           ///< number of full-bandwidth channels
     int channels;                               ///< number of total channels
     int lfe_ch;                                 ///< index of LFE channel
-    float *downmix_coeffs[2];                   ///< stereo downmix coefficients
-    int downmixed;                              ///< indicates if coeffs are currently downmixed
     int output_mode;                            ///< output channel configuration
     int out_channels;                           ///< number of output channels
 ///@}
@@ -196,7 +195,9 @@ typedef struct AC3DecodeContext {
 ///@}
 
 ///@name IMDCT
-    int block_switch[AC3_MAX_CHANNELS];     ///< block switch flags                     (blksw)
+    int block_switch[AC3_MAX_BLOCKS][AC3_MAX_CHANNELS]; ///< block switch flags         (blksw)
+    int different_transforms[AC3_MAX_BLOCKS];   ///< block uses both transform sizes
+    int downmixed;                              ///< indicates if the delay samples are currently downmixed
     FFTContext imdct_512;                   ///< for 512 sample IMDCT
     FFTContext imdct_256;                   ///< for 256 sample IMDCT
 ///@}
@@ -208,13 +209,21 @@ typedef struct AC3DecodeContext {
     FmtConvertContext fmt_conv;             ///< optimized conversion functions
 ///@}
 
+///@name Frame threading
+    ThreadFrame frame;                      ///< frame being decoded
+    ThreadFrame last_frame;                 ///< last frame output before this one
+    struct AC3DecodeContext *last_ctx;      ///< context that decoded last_frame
+///@}
+
+    float *downmix_coeffs[2];               ///< stereo downmix coefficients
+    float (*transform_coeffs)[AC3_MAX_COEFS]; ///< transform coefficients of the current block
     float *outptr[AC3_MAX_CHANNELS];
     float *xcfptr[AC3_MAX_CHANNELS];
     float *dlyptr[AC3_MAX_CHANNELS];
 
 ///@name Aligned arrays
     DECLARE_ALIGNED(16, int32_t, fixed_coeffs)[AC3_MAX_CHANNELS][AC3_MAX_COEFS];     ///< fixed-point transform coefficients
-    DECLARE_ALIGNED(32, float, transform_coeffs)[AC3_MAX_CHANNELS][AC3_MAX_COEFS];   ///< transform coefficients
+    DECLARE_ALIGNED(32, float, block_coeffs)[AC3_MAX_BLOCKS][AC3_MAX_CHANNELS][AC3_MAX_COEFS]; ///< transform coefficients of each block
     DECLARE_ALIGNED(32, float, delay)[AC3_MAX_CHANNELS][AC3_BLOCK_SIZE];             ///< delay - added to the next block
     DECLARE_ALIGNED(32, float, window)[AC3_BLOCK_SIZE];                              ///< window coefficients
     DECLARE_ALIGNED(32, float, tmp_output)[AC3_BLOCK_SIZE];                          ///< temporary storage for output before windowing
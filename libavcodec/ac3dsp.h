@@ -100,7 +100,8 @@ typedef struct AC3DSPContext {
      * @param[in]  end        ending bin location
      * @param[in]  snr_offset SNR adjustment
      * @param[in]  floor      noise floor
-     * @param[in]  bap_tab    look-up table for bit allocation pointers
+     * @param[in]  bap_tab    look-up table for bit allocation pointers,
+     *                        64 non-decreasing entries
      * @param[out] bap        bit allocation pointers
      */
     void (*bit_alloc_calc_bap)(int16_t *mask, int16_t *psd, int start, int end,
@@ -2261,6 +2261,7 @@ typedef struct AVCodecContext {
 #define FF_DEBUG_BUGS        0x00001000
 #define FF_DEBUG_BUFFERS     0x00008000
 #define FF_DEBUG_THREADS     0x00010000
+#define FF_DEBUG_PROF        0x00020000
 
     /**
      * Error recognition; may misdetect some more or less valid parts as errors.
@@ -3940,6 +3941,84 @@ int avcodec_send_packet(AVCodecContext *avctx, const AVPacket *avpkt);
  */
 int avcodec_receive_frame(AVCodecContext *avctx, AVFrame *frame);
 
+/**
+ * One decoding request of avcodec_decode_audio_batch().
+ */
+typedef struct AVAudioDecodeBatchEntry {
+    /**
+     * An opened audio decoder.
+     * Set by the caller.
+     */
+    AVCodecContext *avctx;
+
+    /**
+     * The packet to decode, it must not be empty.
+     * Set by the caller.
+     */
+    const AVPacket *pkt;
+
+    /**
+     * Output buffers in the decoder sample format, one per channel for
+     * planar formats and a single interleaved one otherwise.
+     *
+     * The decoder writes directly into them when they are aligned to 32 bytes
+     * and have room for the decoded samples rounded up to a multiple of 32;
+     * otherwise the output is decoded into internal buffers and copied.
+     * Set by the caller.
+     */
+    uint8_t *data[AV_NUM_DATA_POINTERS];
+
+    /**
+     * Size of each output buffer in samples.
+     * Set by the caller.
+     */
+    int max_samples;
+
+    /**
+     * Number of samples per channel written to data.
+     * Set by libavcodec.
+     */
+    int nb_samples;
+
+    /**
+     * Presentation timestamp of the first sample, copied from the packet.
+     * Set by libavcodec.
+     */
+    int64_t pts;
+
+    /**
+     * 0 on success, a negative AVERROR code if this packet failed to decode.
+     * Set by libavcodec.
+     */
+    int ret;
+} AVAudioDecodeBatchEntry;
+
+/**
+ * Decode a set of audio packets into caller-provided buffers.
+ *
+ * This is a lightweight alternative to avcodec_send_packet() and
+ * avcodec_receive_frame() for applications running many concurrent streams
+ * of short packets: each packet is sent with avcodec_send_packet() and all
+ * the output it produces is written to the entry buffers, no AVFrame is
+ * returned, AVCodecContext.get_buffer2() is not called and no timestamps or
+ * side data are propagated to the output besides AVAudioDecodeBatchEntry.pts.
+ *
+ * Each packet must decode to at most max_samples samples, the sample format
+ * and channel count are those of the codec context after the call. The
+ * entries are processed in order and the same codec context may appear in
+ * several of them.
+ *
+ * Frame threading is not supported, the entry fails with AVERROR(ENOSYS).
+ * A codec context must not be fed through avcodec_send_packet() and this
+ * function without avcodec_flush_buffers() in between.
+ *
+ * @param entries    pointers to the decoding requests
+ * @param nb_entries number of entries
+ * @return the number of entries decoded successfully, the status of each
+ *         entry is stored in AVAudioDecodeBatchEntry.ret
+ */
+int avcodec_decode_audio_batch(AVAudioDecodeBatchEntry **entries, int nb_entries);
+
 /**
  * Supply a raw video or audio frame to the encoder. Use avcodec_receive_packet()
  * to retrieve buffered output packets.
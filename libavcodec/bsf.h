@@ -28,6 +28,14 @@
  */
 int ff_bsf_get_packet(AVBSFContext *ctx, AVPacket **pkt);
 
+/**
+ * Called by bitstream filters to get the next packet for filtering, moving
+ * it into a packet owned by the filter instead of allocating a new one.
+ * The filter is responsible for unreferencing the packet or passing it to
+ * the caller.
+ */
+int ff_bsf_get_packet_ref(AVBSFContext *ctx, AVPacket *pkt);
+
 const AVClass *ff_bsf_child_class_next(const AVClass *prev);
 
 #endif /* AVCODEC_BSF_H */
@@ -35,6 +35,7 @@
 #include "bytestream.h"
 #include "decode.h"
 #include "internal.h"
+#include "prof.h"
 #include "thread.h"
 
 static int apply_param_change(AVCodecContext *avctx, AVPacket *avpkt)
@@ -307,6 +308,7 @@ static int decode_simple_internal(AVCodecContext *avctx, AVFrame *frame)
     AVCodecInternal   *avci = avctx->internal;
     DecodeSimpleContext *ds = &avci->ds;
     AVPacket           *pkt = ds->in_pkt;
+    uint64_t     prof_start;
     int got_frame;
     int ret;
 
@@ -332,7 +334,9 @@ static int decode_simple_internal(AVCodecContext *avctx, AVFrame *frame)
     if (HAVE_THREADS && avctx->active_thread_type & FF_THREAD_FRAME) {
         ret = ff_thread_decode_frame(avctx, frame, &got_frame, pkt);
     } else {
+        prof_start = ff_prof_start(avctx);
         ret = avctx->codec->decode(avctx, frame, &got_frame, pkt);
+        ff_prof_stop(avctx, FF_PROF_DECODE, prof_start);
 
         if (!(avctx->codec->caps_internal & FF_CODEC_CAP_SETS_PKT_DTS))
             frame->pkt_dts = pkt->dts;
@@ -398,9 +402,11 @@ static int decode_receive_frame_internal(AVCodecContext *avctx, AVFrame *frame)
 
     av_assert0(!frame->buf[0]);
 
-    if (avctx->codec->receive_frame)
+    if (avctx->codec->receive_frame) {
+        uint64_t prof_start = ff_prof_start(avctx);
         ret = avctx->codec->receive_frame(avctx, frame);
-    else
+        ff_prof_stop(avctx, FF_PROF_DECODE, prof_start);
+    } else
         ret = decode_simple_receive_frame(avctx, frame);
 
     if (ret == AVERROR_EOF)
@@ -535,6 +541,96 @@ int attribute_align_arg avcodec_receive_frame(AVCodecContext *avctx, AVFrame *fr
     return 0;
 }
 
+/* copy a frame the decoder did not output into the entry buffers */
+static int batch_copy_frame(AVCodecContext *avctx, AVAudioDecodeBatchEntry *e,
+                            const AVFrame *frame)
+{
+    int planar = av_sample_fmt_is_planar(frame->format);
+    int planes = planar ? avctx->channels : 1;
+    int i;
+
+    if (frame->nb_samples > e->max_samples - e->nb_samples)
+        return AVERROR(ENOSPC);
+    if (planes > AV_NUM_DATA_POINTERS)
+        return AVERROR(ENOSYS);
+    for (i = 0; i < planes; i++)
+        if (!e->data[i])
+            return AVERROR(EINVAL);
+
+    av_samples_copy(e->data, frame->extended_data, e->nb_samples, 0,
+                    frame->nb_samples, avctx->channels, frame->format);
+
+    return 0;
+}
+
+static int decode_batch_entry(AVAudioDecodeBatchEntry *e)
+{
+    AVCodecContext *avctx = e->avctx;
+    AVCodecInternal *avci;
+    AVFrame *frame;
+    int ret;
+
+    e->nb_samples = 0;
+    e->pts        = e->pkt ? e->pkt->pts : AV_NOPTS_VALUE;
+
+    if (!avctx || !avcodec_is_open(avctx) || !av_codec_is_decoder(avctx->codec) ||
+        avctx->codec_type != AVMEDIA_TYPE_AUDIO || !e->pkt || e->pkt->size <= 0)
+        return AVERROR(EINVAL);
+
+    /* the output of a packet would only be returned with the later ones */
+    if (avctx->active_thread_type & FF_THREAD_FRAME)
+        return AVERROR(ENOSYS);
+
+    avci = avctx->internal;
+    if (!avci->batch_frame) {
+        avci->batch_frame = av_frame_alloc();
+        if (!avci->batch_frame)
+            return AVERROR(ENOMEM);
+    }
+    if (!avci->batch_buf) {
+        avci->batch_buf = av_buffer_alloc(1);
+        if (!avci->batch_buf)
+            return AVERROR(ENOMEM);
+    }
+    frame = avci->batch_frame;
+
+    avci->batch_entry = e;
+
+    ret = avcodec_send_packet(avctx, e->pkt);
+    while (ret >= 0) {
+        ret = avcodec_receive_frame(avctx, frame);
+        if (ret < 0) {
+            if (ret == AVERROR(EAGAIN))
+                ret = 0;
+            break;
+        }
+
+        if (!frame->buf[0] || frame->buf[0]->buffer != avci->batch_buf->buffer)
+            ret = batch_copy_frame(avctx, e, frame);
+        if (ret >= 0)
+            e->nb_samples += frame->nb_samples;
+        av_frame_unref(frame);
+    }
+
+    avci->batch_entry = NULL;
+
+    return ret;
+}
+
+int attribute_align_arg avcodec_decode_audio_batch(AVAudioDecodeBatchEntry **entries,
+                                                   int nb_entries)
+{
+    int i, nb_decoded = 0;
+
+    for (i = 0; i < nb_entries; i++) {
+        entries[i]->ret = decode_batch_entry(entries[i]);
+        if (!entries[i]->ret)
+            nb_decoded++;
+    }
+
+    return nb_decoded;
+}
+
 static int compat_decode(AVCodecContext *avctx, AVFrame *frame,
                          int *got_frame, AVPacket *pkt)
 {
@@ -1085,7 +1181,7 @@ FF_ENABLE_DEPRECATION_WARNINGS
         int size;
         uint8_t *packet_sd = av_packet_get_side_data(pkt, sd[i].packet, &size);
         if (packet_sd) {
-            AVFrameSideData *frame_sd = av_frame_new_side_data(frame,
+            AVFrameSideData *frame_sd = ff_frame_new_side_data(avctx, frame,
                                                                sd[i].frame,
                                                                size);
             if (!frame_sd)
@@ -1135,6 +1231,37 @@ static int attach_decode_data(AVFrame *frame)
     return 0;
 }
 
+/* Hand out the avcodec_decode_audio_batch() caller buffers. The decoders may
+ * rely on the alignment and the padding to 32 samples of the default buffers,
+ * so fall back to those (and a copy) when the caller buffers lack them. */
+static int batch_get_buffer(AVCodecContext *avctx, AVFrame *frame, int flags)
+{
+    AVCodecInternal *avci      = avctx->internal;
+    AVAudioDecodeBatchEntry *e = avci->batch_entry;
+    int planar = av_sample_fmt_is_planar(frame->format);
+    int planes = planar ? avctx->channels : 1;
+    int size   = av_get_bytes_per_sample(frame->format) * (planar ? 1 : avctx->channels);
+    int padded = FFALIGN(frame->nb_samples, 32);
+    int i;
+
+    if (planes > AV_NUM_DATA_POINTERS || padded > e->max_samples - e->nb_samples)
+        return avcodec_default_get_buffer2(avctx, frame, flags);
+    for (i = 0; i < planes; i++)
+        if (!e->data[i] || ((uintptr_t)e->data[i] + e->nb_samples * size) & 31)
+            return avcodec_default_get_buffer2(avctx, frame, flags);
+
+    for (i = 0; i < planes; i++)
+        frame->data[i] = e->data[i] + e->nb_samples * size;
+    frame->extended_data = frame->data;
+    frame->linesize[0]   = padded * size;
+
+    frame->buf[0] = av_buffer_ref(avci->batch_buf);
+    if (!frame->buf[0])
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
 int ff_get_buffer(AVCodecContext *avctx, AVFrame *frame, int flags)
 {
     const AVHWAccel *hwaccel = avctx->hwaccel;
@@ -1207,7 +1334,10 @@ int ff_get_buffer(AVCodecContext *avctx, AVFrame *frame, int flags)
     } else
         avctx->sw_pix_fmt = avctx->pix_fmt;
 
-    ret = avctx->get_buffer2(avctx, frame, flags);
+    if (avctx->internal->batch_entry)
+        ret = batch_get_buffer(avctx, frame, flags);
+    else
+        ret = avctx->get_buffer2(avctx, frame, flags);
     if (ret < 0)
         goto end;
 
@@ -1241,7 +1371,7 @@ int ff_reget_buffer(AVCodecContext *avctx, AVFrame *frame)
     if (av_frame_is_writable(frame))
         return ff_decode_frame_props(avctx, frame);
 
-    tmp = av_frame_alloc();
+    tmp = ff_frame_pool_get(avctx->internal->frame_pool);
     if (!tmp)
         return AVERROR(ENOMEM);
 
@@ -1249,12 +1379,12 @@ int ff_reget_buffer(AVCodecContext *avctx, AVFrame *frame)
 
     ret = ff_get_buffer(avctx, frame, AV_GET_BUFFER_FLAG_REF);
     if (ret < 0) {
-        av_frame_free(&tmp);
+        ff_frame_pool_release(avctx->internal->frame_pool, &tmp);
         return ret;
     }
 
     av_frame_copy(frame, tmp);
-    av_frame_free(&tmp);
+    ff_frame_pool_release(avctx->internal->frame_pool, &tmp);
 
     return 0;
 }
@@ -27,6 +27,7 @@
 
 #include "avcodec.h"
 #include "internal.h"
+#include "prof.h"
 
 int ff_alloc_packet(AVPacket *avpkt, int size)
 {
@@ -56,7 +57,7 @@ static int pad_last_frame(AVCodecContext *s, AVFrame **dst, const AVFrame *src)
     AVFrame *frame = NULL;
     int ret;
 
-    if (!(frame = av_frame_alloc()))
+    if (!(frame = ff_frame_pool_get(s->internal->frame_pool)))
         return AVERROR(ENOMEM);
 
     frame->format         = src->format;
@@ -83,7 +84,7 @@ static int pad_last_frame(AVCodecContext *s, AVFrame **dst, const AVFrame *src)
     return 0;
 
 fail:
-    av_frame_free(&frame);
+    ff_frame_pool_release(s->internal->frame_pool, &frame);
     return ret;
 }
 
@@ -94,6 +95,7 @@ int attribute_align_arg avcodec_encode_audio2(AVCodecContext *avctx,
 {
     AVFrame tmp;
     AVFrame *padded_frame = NULL;
+    uint64_t prof_start;
     int ret;
     int user_packet = !!avpkt->data;
 
@@ -156,7 +158,9 @@ int attribute_align_arg avcodec_encode_audio2(AVCodecContext *avctx,
         }
     }
 
+    prof_start = ff_prof_start(avctx);
     ret = avctx->codec->encode2(avctx, avpkt, frame, got_packet_ptr);
+    ff_prof_stop(avctx, FF_PROF_ENCODE, prof_start);
     if (!ret) {
         if (*got_packet_ptr) {
             if (!(avctx->codec->capabilities & AV_CODEC_CAP_DELAY)) {
@@ -192,7 +196,7 @@ int attribute_align_arg avcodec_encode_audio2(AVCodecContext *avctx,
     avpkt->flags |= AV_PKT_FLAG_KEY;
 
 end:
-    av_frame_free(&padded_frame);
+    ff_frame_pool_release(avctx->internal->frame_pool, &padded_frame);
 
     return ret;
 }
@@ -202,6 +206,7 @@ int attribute_align_arg avcodec_encode_video2(AVCodecContext *avctx,
                                               const AVFrame *frame,
                                               int *got_packet_ptr)
 {
+    uint64_t prof_start;
     int ret;
     int user_packet = !!avpkt->data;
 
@@ -224,7 +229,9 @@ int attribute_align_arg avcodec_encode_video2(AVCodecContext *avctx,
 
     av_assert0(avctx->codec->encode2);
 
+    prof_start = ff_prof_start(avctx);
     ret = avctx->codec->encode2(avctx, avpkt, frame, got_packet_ptr);
+    ff_prof_stop(avctx, FF_PROF_ENCODE, prof_start);
     if (!ret) {
         if (!*got_packet_ptr)
             avpkt->size = 0;
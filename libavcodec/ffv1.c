@@ -146,6 +146,8 @@ av_cold int ffv1_common_init(AVCodecContext *avctx)
     s->num_h_slices = 1;
     s->num_v_slices = 1;
 
+    ff_ffv1dsp_init(&s->dsp);
+
     return 0;
 }
 
@@ -175,8 +177,8 @@ int ffv1_init_slice_state(FFV1Context *f, FFV1Context *fs)
     if (fs->ac == AC_RANGE_CUSTOM_TAB) {
         //FIXME only redo if state_transition changed
         for (j = 1; j < 256; j++) {
-            fs->c.one_state[j]        = f->state_transition[j];
-            fs->c.zero_state[256 - j] = 256 - fs->c.one_state[j];
+            fs->c.next_state[1][j]       = f->state_transition[j];
+            fs->c.next_state[0][256 - j] = 256 - fs->c.next_state[1][j];
         }
     }
 
@@ -213,9 +215,17 @@ av_cold int ffv1_init_slice_contexts(FFV1Context *f)
         fs->slice_x      = sxs;
         fs->slice_y      = sys;
 
-        fs->sample_buffer = av_malloc(3 * MAX_PLANES * (fs->width + 6) *
-                                      sizeof(*fs->sample_buffer));
-        if (!fs->sample_buffer) {
+        /* the line functions work on whole vectors and read past the end */
+        fs->sample_buffer  = av_malloc(sizeof(*fs->sample_buffer) *
+                                       (3 * MAX_PLANES * (fs->width + 6) + 16));
+        fs->context_buffer = av_malloc(FFALIGN(fs->width, 16) *
+                                       sizeof(*fs->context_buffer));
+        fs->diff_buffer    = av_malloc(FFALIGN(fs->width, 16) *
+                                       sizeof(*fs->diff_buffer));
+        if (!fs->sample_buffer || !fs->context_buffer || !fs->diff_buffer) {
+            av_free(fs->sample_buffer);
+            av_free(fs->context_buffer);
+            av_free(fs->diff_buffer);
             av_free(fs);
             goto memfail;
         }
@@ -225,6 +235,8 @@ av_cold int ffv1_init_slice_contexts(FFV1Context *f)
 memfail:
     for (j = 0; j < i; j++) {
         av_free(f->slice_context[j]->sample_buffer);
+        av_free(f->slice_context[j]->context_buffer);
+        av_free(f->slice_context[j]->diff_buffer);
         av_free(f->slice_context[j]);
     }
     return AVERROR(ENOMEM);
@@ -286,6 +298,8 @@ av_cold int ffv1_close(AVCodecContext *avctx)
             av_freep(&p->vlc_state);
         }
         av_freep(&fs->sample_buffer);
+        av_freep(&fs->context_buffer);
+        av_freep(&fs->diff_buffer);
     }
 
     av_freep(&avctx->stats_out);
@@ -25,10 +25,14 @@
 
 #include <stdint.h>
 
+#include "libavutil/buffer.h"
+
 #include "avcodec.h"
 #include "bitstream.h"
+#include "ffv1dsp.h"
 #include "put_bits.h"
 #include "rangecoder.h"
+#include "thread.h"
 
 #define MAX_PLANES 4
 #define CONTEXT_SIZE 32
@@ -84,7 +88,13 @@ typedef struct FFV1Context {
     int picture_number;
     int key_frame;
     const AVFrame *frame;
-    AVFrame *last_picture;
+    ThreadFrame picture, last_picture;
+
+    /* frame threading: the slice contexts left by the current and the
+     * previous frame, state_stride bytes per slice */
+    AVBufferPool *state_pool;
+    AVBufferRef *states, *last_states;
+    int state_stride, last_state_stride, state_pool_size;
 
     AVFrame *cur;
     int plane_count;
@@ -99,6 +109,8 @@ typedef struct FFV1Context {
     int run_index;
     int colorspace;
     int16_t *sample_buffer;
+    int16_t *context_buffer;
+    int16_t *diff_buffer;
 
     int ec;
     int slice_damaged;
@@ -119,6 +131,8 @@ typedef struct FFV1Context {
     int slice_height;
     int slice_x;
     int slice_y;
+
+    FFV1DSPContext dsp;
 } FFV1Context;
 
 static av_always_inline int fold(int diff, int bits)
@@ -143,26 +157,46 @@ static inline int predict(int16_t *src, int16_t *last)
     return mid_pred(L, L + T - LT, T);
 }
 
-static inline int get_context(PlaneContext *p, int16_t *src,
-                              int16_t *last, int16_t *last2)
+/**
+ * Compute the part of the contexts of a line that only depends on the
+ * previous lines, the left neighbours are added by get_context().
+ * @param top  previous line, top[-1] and top[w] are the borders
+ * @param top2 line before the previous one, only read when the plane uses
+ *             five context inputs
+ */
+static inline void top_contexts(int16_t *dst, const int16_t *top,
+                                const int16_t *top2,
+                                const int16_t (*quant_table)[256], int w)
+{
+    int x;
+
+    if (quant_table[3][127]) {
+        for (x = 0; x < w; x++)
+            dst[x] = quant_table[1][(top[x - 1] - top[x]) & 0xFF] +
+                     quant_table[2][(top[x] - top[x + 1]) & 0xFF] +
+                     quant_table[4][(top2[x] - top[x])    & 0xFF];
+    } else {
+        for (x = 0; x < w; x++)
+            dst[x] = quant_table[1][(top[x - 1] - top[x]) & 0xFF] +
+                     quant_table[2][(top[x] - top[x + 1]) & 0xFF];
+    }
+}
+
+/**
+ * Complete a context from top_contexts() with the left neighbours.
+ */
+static inline int get_context(PlaneContext *p, int16_t *src, int16_t *last,
+                              int top_context)
 {
     const int LT = last[-1];
-    const int T  = last[0];
-    const int RT = last[1];
     const int L  = src[-1];
 
     if (p->quant_table[3][127]) {
-        const int TT = last2[0];
         const int LL = src[-2];
         return p->quant_table[0][(L - LT) & 0xFF] +
-               p->quant_table[1][(LT - T) & 0xFF] +
-               p->quant_table[2][(T - RT) & 0xFF] +
-               p->quant_table[3][(LL - L) & 0xFF] +
-               p->quant_table[4][(TT - T) & 0xFF];
+               p->quant_table[3][(LL - L) & 0xFF] + top_context;
     } else
-        return p->quant_table[0][(L - LT) & 0xFF] +
-               p->quant_table[1][(LT - T) & 0xFF] +
-               p->quant_table[2][(T - RT) & 0xFF];
+        return p->quant_table[0][(L - LT) & 0xFF] + top_context;
 }
 
 static inline void update_vlc_state(VlcState *const state, const int v)
@@ -40,6 +40,7 @@
 #include "rangecoder.h"
 #include "mathops.h"
 #include "ffv1.h"
+#include "thread.h"
 
 static inline av_flatten int get_symbol_inline(RangeCoder *c, uint8_t *state,
                                                int is_signed)
@@ -99,15 +100,19 @@ static av_always_inline void decode_line(FFV1Context *s, int w,
 {
     PlaneContext *const p = &s->plane[plane_index];
     RangeCoder *const c   = &s->c;
+    const int16_t *top_context = s->context_buffer;
     int x;
     int run_count = 0;
     int run_mode  = 0;
     int run_index = s->run_index;
 
+    top_contexts(s->context_buffer, sample[0], sample[1], p->quant_table, w);
+
     for (x = 0; x < w; x++) {
         int diff, context, sign;
 
-        context = get_context(p, sample[1] + x, sample[0] + x, sample[1] + x);
+        context = get_context(p, sample[1] + x, sample[0] + x,
+                              top_context[x]);
         if (context < 0) {
             context = -context;
             sign    = 1;
@@ -272,8 +277,8 @@ static int decode_slice_header(FFV1Context *f, FFV1Context *fs)
 
     if (fs->ac == AC_RANGE_CUSTOM_TAB) {
         for (i = 1; i < 256; i++) {
-            fs->c.one_state[i]        = f->state_transition[i];
-            fs->c.zero_state[256 - i] = 256 - fs->c.one_state[i];
+            fs->c.next_state[1][i]       = f->state_transition[i];
+            fs->c.next_state[0][256 - i] = 256 - fs->c.next_state[1][i];
         }
     }
 
@@ -335,26 +340,132 @@ static int decode_slice_header(FFV1Context *f, FFV1Context *fs)
     return 0;
 }
 
+/* Contexts of a slice at the end of a frame, for the next frame decoded by
+ * another frame thread. The states of the planes follow. */
+typedef struct SliceState {
+    int slice_damaged;
+    int context_count[MAX_PLANES];
+    uint8_t interlace_bit_state[MAX_PLANES][2];
+} SliceState;
+
+static int context_state_size(const FFV1Context *fs)
+{
+    return fs->ac != AC_GOLOMB_RICE ? CONTEXT_SIZE : sizeof(VlcState);
+}
+
+static void save_slice_state(FFV1Context *f, FFV1Context *fs, int slice)
+{
+    SliceState *ss = (SliceState *)(f->states->data + slice * f->state_stride);
+    uint8_t *dst   = (uint8_t *)(ss + 1);
+    int i;
+
+    ss->slice_damaged = fs->slice_damaged;
+    for (i = 0; i < f->plane_count; i++) {
+        const PlaneContext *p = &fs->plane[i];
+        const int size        = p->context_count * context_state_size(fs);
+
+        ss->context_count[i] = p->context_count;
+        memcpy(ss->interlace_bit_state[i], p->interlace_bit_state,
+               sizeof(p->interlace_bit_state));
+        memcpy(dst, fs->ac != AC_GOLOMB_RICE ? (void *)p->state : p->vlc_state,
+               size);
+        dst += size;
+    }
+}
+
+static void load_slice_state(FFV1Context *f, FFV1Context *fs, int slice)
+{
+    const SliceState *ss;
+    const uint8_t *src;
+    int i;
+
+    if ((slice + 1) * f->last_state_stride > f->last_states->size)
+        return;
+    ss  = (const SliceState *)(f->last_states->data +
+                               slice * f->last_state_stride);
+    src = (const uint8_t *)(ss + 1);
+
+    fs->slice_damaged |= ss->slice_damaged;
+    for (i = 0; i < f->plane_count; i++) {
+        PlaneContext *p = &fs->plane[i];
+        const int count = FFMIN(ss->context_count[i], p->context_count);
+
+        memcpy(p->interlace_bit_state, ss->interlace_bit_state[i],
+               sizeof(p->interlace_bit_state));
+        memcpy(fs->ac != AC_GOLOMB_RICE ? (void *)p->state : p->vlc_state,
+               src, count * context_state_size(fs));
+        src += ss->context_count[i] * context_state_size(fs);
+    }
+}
+
+/* Get the buffer receiving the slice contexts of the frame. The slices
+ * which fail before saving their contexts are handed over as damaged. */
+static int alloc_slice_states(FFV1Context *f)
+{
+    int i, count = 0, size;
+
+    if (f->version < 2)
+        count = f->slice_context[0]->plane[0].context_count;
+    for (i = 0; i < f->quant_table_count; i++)
+        count = FFMAX(count, f->context_count[i]);
+
+    f->state_stride = FFALIGN(sizeof(SliceState) + f->plane_count * count *
+                              FFMAX(CONTEXT_SIZE, sizeof(VlcState)), 16);
+    size = f->state_stride * f->slice_count;
+
+    av_buffer_unref(&f->states);
+    if (size != f->state_pool_size) {
+        av_buffer_pool_uninit(&f->state_pool);
+        f->state_pool_size = 0;
+        f->state_pool      = av_buffer_pool_init(size, NULL);
+        if (!f->state_pool)
+            return AVERROR(ENOMEM);
+        f->state_pool_size = size;
+    }
+    f->states = av_buffer_pool_get(f->state_pool);
+    if (!f->states)
+        return AVERROR(ENOMEM);
+
+    for (i = 0; i < f->slice_count; i++) {
+        SliceState *ss = (SliceState *)(f->states->data + i * f->state_stride);
+
+        memset(ss, 0, sizeof(*ss));
+        ss->slice_damaged = 1;
+    }
+
+    return 0;
+}
+
 static int decode_slice(AVCodecContext *c, void *arg)
 {
     FFV1Context *fs = *(void **)arg;
     FFV1Context *f  = fs->avctx->priv_data;
+    const int slice = (FFV1Context **)arg - f->slice_context;
     int width, height, x, y, ret;
     const int ps = (av_pix_fmt_desc_get(c->pix_fmt)->flags & AV_PIX_FMT_FLAG_PLANAR)
                    ? (c->bits_per_raw_sample > 8) + 1
                    : 4;
     AVFrame *const p = f->cur;
 
+    /* with frame threading, the slices are decoded in order and the progress
+     * of a frame is the number of slices whose contexts are saved */
     if (f->version > 2) {
         if (decode_slice_header(f, fs) < 0) {
             fs->slice_damaged = 1;
+            ff_thread_report_progress(&f->picture, slice + 1, 0);
             return AVERROR_INVALIDDATA;
         }
     }
-    if ((ret = ffv1_init_slice_state(f, fs)) < 0)
+    if ((ret = ffv1_init_slice_state(f, fs)) < 0) {
+        ff_thread_report_progress(&f->picture, slice + 1, 0);
         return ret;
-    if (f->cur->key_frame)
+    }
+    if (f->cur->key_frame) {
         ffv1_clear_slice_state(f, fs);
+    } else if (f->last_states) {
+        ff_thread_await_progress(&f->last_picture, slice + 1, 0);
+        load_slice_state(f, fs, slice);
+    }
     width  = fs->slice_width;
     height = fs->slice_height;
     x      = fs->slice_x;
@@ -408,6 +519,10 @@ static int decode_slice(AVCodecContext *c, void *arg)
         }
     }
 
+    if (f->states)
+        save_slice_state(f, fs, slice);
+    ff_thread_report_progress(&f->picture, slice + 1, 0);
+
     emms_c();
 
     return 0;
@@ -477,7 +592,7 @@ static int read_extra_header(FFV1Context *f)
 
     if (f->ac == AC_RANGE_CUSTOM_TAB) {
         for (i = 1; i < 256; i++)
-            f->state_transition[i] = get_symbol(c, state, 1) + c->one_state[i];
+            f->state_transition[i] = get_symbol(c, state, 1) + c->next_state[1][i];
     }
 
     f->colorspace                 = get_symbol(c, state, 0); //YUV cs type
@@ -567,7 +682,7 @@ static int read_header(FFV1Context *f)
         if (f->ac == AC_RANGE_CUSTOM_TAB) {
             for (i = 1; i < 256; i++)
                 f->state_transition[i] =
-                    get_symbol(c, state, 1) + c->one_state[i];
+                    get_symbol(c, state, 1) + c->next_state[1][i];
         }
 
         colorspace          = get_symbol(c, state, 0); //YUV cs type
@@ -825,8 +940,9 @@ static av_cold int ffv1_decode_init(AVCodecContext *avctx)
 
     ffv1_common_init(avctx);
 
-    f->last_picture = av_frame_alloc();
-    if (!f->last_picture)
+    f->picture.f      = av_frame_alloc();
+    f->last_picture.f = av_frame_alloc();
+    if (!f->picture.f || !f->last_picture.f)
         return AVERROR(ENOMEM);
 
     if (avctx->extradata && (ret = read_extra_header(f)) < 0)
@@ -835,6 +951,8 @@ static av_cold int ffv1_decode_init(AVCodecContext *avctx)
     if ((ret = ffv1_init_slice_contexts(f)) < 0)
         return ret;
 
+    avctx->internal->allocate_progress = 1;
+
     return 0;
 }
 
@@ -848,9 +966,12 @@ static int ffv1_decode_frame(AVCodecContext *avctx, void *data,
     int i, ret;
     uint8_t keystate = 128;
     uint8_t *buf_p;
-    AVFrame *const p    = data;
+    AVFrame *p;
+
+    ff_thread_release_buffer(avctx, &f->last_picture);
+    FFSWAP(ThreadFrame, f->picture, f->last_picture);
 
-    f->cur = p;
+    f->cur = p = f->picture.f;
 
     ff_init_range_decoder(c, buf, buf_size);
     ff_build_rac_states(c, 0.05 * (1LL << 32), 256 - 8);
@@ -871,7 +992,8 @@ static int ffv1_decode_frame(AVCodecContext *avctx, void *data,
         p->key_frame = 0;
     }
 
-    if ((ret = ff_get_buffer(avctx, p, AV_GET_BUFFER_FLAG_REF)) < 0) {
+    if ((ret = ff_thread_get_buffer(avctx, &f->picture,
+                                    AV_GET_BUFFER_FLAG_REF)) < 0) {
         av_log(avctx, AV_LOG_ERROR, "get_buffer() failed\n");
         return ret;
     }
@@ -882,6 +1004,20 @@ static int ffv1_decode_frame(AVCodecContext *avctx, void *data,
                f->version, p->key_frame, f->ac, f->ec, f->slice_count,
                f->avctx->bits_per_raw_sample);
 
+    /* Keyframes reset the contexts, other frames continue each slice from
+     * the contexts the previous frame left for it, see decode_slice(). */
+    if (avctx->active_thread_type & FF_THREAD_FRAME) {
+        if (!p->key_frame && !f->last_states) {
+            av_log(avctx, AV_LOG_ERROR,
+                   "Cannot decode non-keyframe without valid keyframe\n");
+            ret = AVERROR_INVALIDDATA;
+            goto fail;
+        }
+        if ((ret = alloc_slice_states(f)) < 0)
+            goto fail;
+    }
+    ff_thread_finish_setup(avctx);
+
     buf_p = buf + buf_size;
     for (i = f->slice_count - 1; i >= 0; i--) {
         FFV1Context *fs = f->slice_context[i];
@@ -894,10 +1030,15 @@ static int ffv1_decode_frame(AVCodecContext *avctx, void *data,
             v = buf_p - c->bytestream_start;
         if (buf_p - c->bytestream_start < v) {
             av_log(avctx, AV_LOG_ERROR, "Slice pointer chain broken\n");
-            return AVERROR_INVALIDDATA;
+            ret = AVERROR_INVALIDDATA;
+            goto fail;
         }
         buf_p -= v;
 
+        /* the damage of the previous frame is added in decode_slice() */
+        if (!p->key_frame && f->last_states)
+            fs->slice_damaged = 0;
+
         if (f->ec) {
             unsigned crc = av_crc(av_crc_get_table(AV_CRC_32_IEEE), 0, buf_p, v);
             if (crc) {
@@ -921,42 +1062,181 @@ static int ffv1_decode_frame(AVCodecContext *avctx, void *data,
     for (i = f->slice_count - 1; i >= 0; i--) {
         FFV1Context *fs = f->slice_context[i];
         int j;
-        if (fs->slice_damaged && f->last_picture->data[0]) {
+        if (fs->slice_damaged && f->last_picture.f->data[0]) {
             const uint8_t *src[4];
             uint8_t *dst[4];
+            ff_thread_await_progress(&f->last_picture, INT_MAX, 0);
             for (j = 0; j < 4; j++) {
                 int sh = (j == 1 || j == 2) ? f->chroma_h_shift : 0;
                 int sv = (j == 1 || j == 2) ? f->chroma_v_shift : 0;
                 dst[j] = p->data[j] + p->linesize[j] *
                          (fs->slice_y >> sv) + (fs->slice_x >> sh);
-                src[j] = f->last_picture->data[j] +
-                         f->last_picture->linesize[j] *
+                src[j] = f->last_picture.f->data[j] +
+                         f->last_picture.f->linesize[j] *
                          (fs->slice_y >> sv) + (fs->slice_x >> sh);
             }
             av_image_copy(dst, p->linesize, src,
-                          f->last_picture->linesize,
+                          f->last_picture.f->linesize,
                           avctx->pix_fmt, fs->slice_width,
                           fs->slice_height);
         }
     }
+    ff_thread_report_progress(&f->picture, INT_MAX, 0);
 
     f->picture_number++;
 
-    av_frame_unref(f->last_picture);
-    if ((ret = av_frame_ref(f->last_picture, p)) < 0)
+    if ((ret = av_frame_ref(data, f->picture.f)) < 0)
         return ret;
     f->cur = NULL;
 
     *got_frame = 1;
 
     return buf_size;
+
+fail:
+    ff_thread_report_progress(&f->picture, INT_MAX, 0);
+    return ret;
 }
 
-static av_cold int ffv1_decode_close(AVCodecContext *avctx)
+#if HAVE_THREADS
+static av_cold int ffv1_decode_init_thread_copy(AVCodecContext *avctx)
+{
+    FFV1Context *f = avctx->priv_data;
+    int i;
+
+    f->avctx = avctx;
+
+    f->picture.f      = av_frame_alloc();
+    f->last_picture.f = av_frame_alloc();
+    if (!f->picture.f || !f->last_picture.f)
+        return AVERROR(ENOMEM);
+
+    /* the tables read from the extradata are owned by the main context */
+    for (i = 0; i < f->quant_table_count; i++) {
+        const size_t size = f->context_count[i] * sizeof(*f->initial_states[i]);
+        uint8_t (*states)[CONTEXT_SIZE] = av_malloc(size);
+
+        if (!states)
+            return AVERROR(ENOMEM);
+        memcpy(states, f->initial_states[i], size);
+        f->initial_states[i] = states;
+    }
+
+    return ffv1_init_slice_contexts(f);
+}
+
+static int ffv1_update_thread_context(AVCodecContext *dst,
+                                      const AVCodecContext *src)
 {
-    FFV1Context *s = avctx->priv_data;;
+    FFV1Context *fsrc = src->priv_data;
+    FFV1Context *fdst = dst->priv_data;
+    int i, j, ret;
 
-    av_frame_free(&s->last_picture);
+    if (dst == src)
+        return 0;
+
+    /* the tables of version 2 and later, which only change with the
+     * extradata, the copies own their initial states */
+    for (i = fsrc->quant_table_count; i < fdst->quant_table_count; i++)
+        av_freep(&fdst->initial_states[i]);
+    for (i = 0; i < fsrc->quant_table_count; i++) {
+        const size_t size = fsrc->context_count[i] *
+                            sizeof(*fsrc->initial_states[i]);
+
+        if (i >= fdst->quant_table_count ||
+            fdst->context_count[i] != fsrc->context_count[i]) {
+            av_freep(&fdst->initial_states[i]);
+            fdst->initial_states[i] = av_malloc(size);
+            if (!fdst->initial_states[i]) {
+                fdst->quant_table_count = i;
+                return AVERROR(ENOMEM);
+            }
+        }
+        memcpy(fdst->initial_states[i], fsrc->initial_states[i], size);
+    }
+    fdst->quant_table_count = fsrc->quant_table_count;
+    memcpy(fdst->context_count, fsrc->context_count,
+           sizeof(fdst->context_count));
+    memcpy(fdst->quant_tables, fsrc->quant_tables, sizeof(fdst->quant_tables));
+
+    fdst->version        = fsrc->version;
+    fdst->minor_version  = fsrc->minor_version;
+    fdst->ac             = fsrc->ac;
+    fdst->colorspace     = fsrc->colorspace;
+    fdst->chroma_planes  = fsrc->chroma_planes;
+    fdst->chroma_h_shift = fsrc->chroma_h_shift;
+    fdst->chroma_v_shift = fsrc->chroma_v_shift;
+    fdst->transparency   = fsrc->transparency;
+    fdst->plane_count    = fsrc->plane_count;
+    fdst->packed_at_lsb  = fsrc->packed_at_lsb;
+    fdst->slice_count    = fsrc->slice_count;
+    fdst->key_frame_ok   = fsrc->key_frame_ok;
+    memcpy(fdst->state_transition, fsrc->state_transition,
+           sizeof(fdst->state_transition));
+    memcpy(fdst->quant_table, fsrc->quant_table, sizeof(fdst->quant_table));
+
+    /* The slice parameters are set by the headers of keyframes before the
+     * setup is finished, except the ones of the version 3 slice headers. */
+    for (i = 0; i < fsrc->slice_count; i++) {
+        FFV1Context *fsdst       = fdst->slice_context[i];
+        const FFV1Context *fssrc = fsrc->slice_context[i];
+
+        fsdst->ac            = fssrc->ac;
+        fsdst->packed_at_lsb = fssrc->packed_at_lsb;
+        if (fsrc->version > 2)
+            continue;
+
+        fsdst->slice_x      = fssrc->slice_x;
+        fsdst->slice_y      = fssrc->slice_y;
+        fsdst->slice_width  = fssrc->slice_width;
+        fsdst->slice_height = fssrc->slice_height;
+        for (j = 0; j < fsrc->plane_count; j++) {
+            PlaneContext *pdst       = &fsdst->plane[j];
+            const PlaneContext *psrc = &fssrc->plane[j];
+
+            memcpy(pdst->quant_table, psrc->quant_table,
+                   sizeof(pdst->quant_table));
+            pdst->quant_table_index = psrc->quant_table_index;
+            if (pdst->context_count < psrc->context_count) {
+                av_freep(&pdst->state);
+                av_freep(&pdst->vlc_state);
+            }
+            pdst->context_count = psrc->context_count;
+        }
+    }
+
+    av_buffer_unref(&fdst->last_states);
+    if (fsrc->states) {
+        fdst->last_states = av_buffer_ref(fsrc->states);
+        if (!fdst->last_states)
+            return AVERROR(ENOMEM);
+    }
+    fdst->last_state_stride = fsrc->state_stride;
+
+    ff_thread_release_buffer(dst, &fdst->picture);
+    if (fsrc->picture.f->data[0]) {
+        ret = ff_thread_ref_frame(&fdst->picture, &fsrc->picture);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+#endif
+
+static av_cold int ffv1_decode_close(AVCodecContext *avctx)
+{
+    FFV1Context *s = avctx->priv_data;
+
+    if (s->picture.f)
+        ff_thread_release_buffer(avctx, &s->picture);
+    av_frame_free(&s->picture.f);
+    if (s->last_picture.f)
+        ff_thread_release_buffer(avctx, &s->last_picture);
+    av_frame_free(&s->last_picture.f);
+    av_buffer_unref(&s->states);
+    av_buffer_unref(&s->last_states);
+    av_buffer_pool_uninit(&s->state_pool);
 
     ffv1_close(avctx);
 
@@ -972,6 +1252,8 @@ AVCodec ff_ffv1_decoder = {
     .init           = ffv1_decode_init,
     .close          = ffv1_decode_close,
     .decode         = ffv1_decode_frame,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(ffv1_decode_init_thread_copy),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(ffv1_update_thread_context),
     .capabilities   = AV_CODEC_CAP_DR1 /*| AV_CODEC_CAP_DRAW_HORIZ_BAND*/ |
-                      AV_CODEC_CAP_SLICE_THREADS,
+                      AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS,
 };
@@ -0,0 +1,42 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "ffv1dsp.h"
+#include "mathops.h"
+
+static void sub_median_pred_c(int16_t *dst, const int16_t *src,
+                              const int16_t *top, int w)
+{
+    int x;
+
+    for (x = 0; x < w; x++) {
+        const int L = src[x - 1];
+
+        dst[x] = src[x] - mid_pred(L, L + top[x] - top[x - 1], top[x]);
+    }
+}
+
+av_cold void ff_ffv1dsp_init(FFV1DSPContext *c)
+{
+    c->sub_median_pred = sub_median_pred_c;
+
+    if (ARCH_X86)
+        ff_ffv1dsp_init_x86(c);
+}
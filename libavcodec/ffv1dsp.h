@@ -0,0 +1,39 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_FFV1DSP_H
+#define AVCODEC_FFV1DSP_H
+
+#include <stdint.h>
+
+typedef struct FFV1DSPContext {
+    /**
+     * Compute the median prediction residuals of a line, not yet folded to
+     * the sample bit depth. Samples must be below 1 << 14.
+     * @param dst residuals, aligned to 32 and padded to a multiple of 16
+     * @param src current line, src[-1] is the left border
+     * @param top previous line, top[-1] is the left border
+     */
+    void (*sub_median_pred)(int16_t *dst, const int16_t *src,
+                            const int16_t *top, int w);
+} FFV1DSPContext;
+
+void ff_ffv1dsp_init(FFV1DSPContext *c);
+void ff_ffv1dsp_init_x86(FFV1DSPContext *c);
+
+#endif /* AVCODEC_FFV1DSP_H */
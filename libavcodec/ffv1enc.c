@@ -183,11 +183,21 @@ static av_always_inline int encode_line(FFV1Context *s, int w,
         }
     }
 
+    top_contexts(s->context_buffer, sample[1], sample[2], p->quant_table, w);
+    if (bits <= 14) {
+        s->dsp.sub_median_pred(s->diff_buffer, sample[0], sample[1], w);
+    } else {
+        for (x = 0; x < w; x++)
+            s->diff_buffer[x] = sample[0][x] - predict(sample[0] + x,
+                                                       sample[1] + x);
+    }
+
     for (x = 0; x < w; x++) {
         int diff, context;
 
-        context = get_context(p, sample[0] + x, sample[1] + x, sample[2] + x);
-        diff    = sample[0][x] - predict(sample[0] + x, sample[1] + x);
+        context = get_context(p, sample[0] + x, sample[1] + x,
+                              s->context_buffer[x]);
+        diff    = s->diff_buffer[x];
 
         if (context < 0) {
             context = -context;
@@ -384,7 +394,7 @@ static void write_header(FFV1Context *f)
         if (f->ac == AC_RANGE_CUSTOM_TAB) {
             for (i = 1; i < 256; i++)
                 put_symbol(c, state,
-                           f->state_transition[i] - c->one_state[i], 1);
+                           f->state_transition[i] - c->next_state[1][i], 1);
         }
         put_symbol(c, state, f->colorspace, 0); // YUV cs type
         if (f->version > 0)
@@ -425,7 +435,7 @@ static int write_extradata(FFV1Context *f)
     put_symbol(c, state, f->ac, 0);
     if (f->ac == AC_RANGE_CUSTOM_TAB)
         for (i = 1; i < 256; i++)
-            put_symbol(c, state, f->state_transition[i] - c->one_state[i], 1);
+            put_symbol(c, state, f->state_transition[i] - c->next_state[1][i], 1);
 
     put_symbol(c, state, f->colorspace, 0); // YUV cs type
     put_symbol(c, state, f->bits_per_raw_sample, 0);
@@ -957,8 +967,8 @@ static int ffv1_encode_frame(AVCodecContext *avctx, AVPacket *pkt,
     if (f->ac == AC_RANGE_CUSTOM_TAB) {
         int i;
         for (i = 1; i < 256; i++) {
-            c->one_state[i]        = f->state_transition[i];
-            c->zero_state[256 - i] = 256 - c->one_state[i];
+            c->next_state[1][i]       = f->state_transition[i];
+            c->next_state[0][256 - i] = 256 - c->next_state[1][i];
         }
     }
 
@@ -33,6 +33,7 @@
 #include "avcodec.h"
 #include "h264dec.h"
 #include "h264_ps.h"
+#include "prof.h"
 #include "qpeldsp.h"
 #include "thread.h"
 
@@ -801,6 +802,7 @@ void ff_h264_hl_decode_mb(const H264Context *h, H264SliceContext *sl)
     const int mb_type = h->cur_pic.mb_type[mb_xy];
     int is_complex    = CONFIG_SMALL || sl->is_complex ||
                         IS_INTRA_PCM(mb_type) || sl->qscale == 0;
+    uint64_t prof_start = ff_prof_start(h->avctx);
 
     if (CHROMA444(h)) {
         if (is_complex || h->pixel_shift)
@@ -813,4 +815,6 @@ void ff_h264_hl_decode_mb(const H264Context *h, H264SliceContext *sl)
         hl_decode_mb_simple_16(h, sl);
     } else
         hl_decode_mb_simple_8(h, sl);
+
+    ff_prof_stop(h->avctx, FF_PROF_H264_RECON, prof_start);
 }
@@ -44,6 +44,7 @@
 #include "h264_ps.h"
 #include "mathops.h"
 #include "mpegutils.h"
+#include "prof.h"
 #include "rectangle.h"
 #include "thread.h"
 
@@ -1120,7 +1121,7 @@ static int h264_export_frame_props(H264Context *h)
          h->sei.display_orientation.vflip)) {
         H264SEIDisplayOrientation *o = &h->sei.display_orientation;
         double angle = o->anticlockwise_rotation * 360 / (double) (1 << 16);
-        AVFrameSideData *rotation = av_frame_new_side_data(cur->f,
+        AVFrameSideData *rotation = ff_frame_new_side_data(h->avctx, cur->f,
                                                            AV_FRAME_DATA_DISPLAYMATRIX,
                                                            sizeof(int32_t) * 9);
         if (!rotation)
@@ -1132,7 +1133,8 @@ static int h264_export_frame_props(H264Context *h)
     }
 
     if (h->sei.afd.present) {
-        AVFrameSideData *sd = av_frame_new_side_data(cur->f, AV_FRAME_DATA_AFD,
+        AVFrameSideData *sd = ff_frame_new_side_data(h->avctx, cur->f,
+                                                     AV_FRAME_DATA_AFD,
                                                      sizeof(uint8_t));
         if (!sd)
             return AVERROR(ENOMEM);
@@ -1143,7 +1145,7 @@ static int h264_export_frame_props(H264Context *h)
 
     if (h->sei.a53_caption.a53_caption) {
         H264SEIA53Caption *a53 = &h->sei.a53_caption;
-        AVFrameSideData *sd = av_frame_new_side_data(cur->f,
+        AVFrameSideData *sd = ff_frame_new_side_data(h->avctx, cur->f,
                                                      AV_FRAME_DATA_A53_CC,
                                                      a53->a53_caption_size);
         if (!sd)
@@ -2201,6 +2203,8 @@ static void loop_filter(const H264Context *h, H264SliceContext *sl, int start_x,
         return;
 
     if (sl->deblocking_filter) {
+        uint64_t prof_start = ff_prof_start(h->avctx);
+
         for (mb_x = start_x; mb_x < end_x; mb_x++)
             for (mb_y = end_mb_y - FRAME_MBAFF(h); mb_y <= end_mb_y; mb_y++) {
                 int mb_xy, mb_type;
@@ -2250,6 +2254,8 @@ static void loop_filter(const H264Context *h, H264SliceContext *sl, int start_x,
                                            dest_cr, linesize, uvlinesize);
                 }
             }
+
+        ff_prof_stop(h->avctx, FF_PROF_H264_DEBLOCK, prof_start);
     }
     sl->slice_type  = old_slice_type;
     sl->mb_x         = end_x;
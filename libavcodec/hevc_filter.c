@@ -27,6 +27,7 @@
 
 #include "cabac_functions.h"
 #include "hevcdec.h"
+#include "prof.h"
 
 #define LUMA 0
 #define CB 1
@@ -727,9 +728,13 @@ void ff_hevc_deblocking_boundary_strengths(HEVCContext *s, int x0, int y0,
 
 void ff_hevc_hls_filter(HEVCContext *s, int x, int y)
 {
+    uint64_t prof_start = ff_prof_start(s->avctx);
+
     deblocking_filter_CTB(s, x, y);
     if (s->ps.sps->sao_enabled)
         sao_filter_CTB(s, x, y);
+
+    ff_prof_stop(s->avctx, FF_PROF_HEVC_FILTER, prof_start);
 }
 
 void ff_hevc_hls_filters(HEVCContext *s, int x_ctb, int y_ctb, int ctb_size)
@@ -40,6 +40,8 @@
 
 #define VLC_BITS 11
 
+#define MAX_SLICES 32
+
 #if HAVE_BIGENDIAN
 #define B 3
 #define G 2
@@ -86,6 +88,12 @@ typedef struct HYuvContext {
     BswapDSPContext bdsp;
     HuffYUVDSPContext hdsp;
     HuffYUVEncDSPContext hencdsp;
+
+    /* slice threaded encoding */
+    const AVFrame *frame;                   //frame being encoded
+    int slice_start, slice_end;             //range of rows coded by this context
+    int nb_slices;
+    struct HYuvContext *slice_context[MAX_SLICES];
 } HYuvContext;
 
 void ff_huffyuv_common_init(AVCodecContext *s);
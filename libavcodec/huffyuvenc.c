@@ -35,6 +35,9 @@
 #include "internal.h"
 #include "put_bits.h"
 
+/* minimum number of lines coded by a slice context */
+#define MIN_SLICE_LINES 16
+
 static inline int sub_left_prediction(HYuvContext *s, uint8_t *dst,
                                       uint8_t *src, int w, int left)
 {
@@ -144,10 +147,25 @@ static int store_table(HYuvContext *s, const uint8_t *len, uint8_t *buf)
     return index;
 }
 
+static av_cold void free_slice_contexts(HYuvContext *s)
+{
+    int i;
+
+    for (i = 1; i < s->nb_slices; i++) {
+        HYuvContext *sc = s->slice_context[i];
+        if (!sc)
+            continue;
+        ff_huffyuv_common_end(sc);
+        av_freep(&sc->bitstream_buffer);
+        av_freep(&s->slice_context[i]);
+    }
+    s->nb_slices = 1;
+}
+
 static av_cold int encode_init(AVCodecContext *avctx)
 {
     HYuvContext *s = avctx->priv_data;
-    int i, j;
+    int i, j, ret;
 
     ff_huffyuv_common_init(avctx);
     ff_huffyuvencdsp_init(&s->hencdsp);
@@ -296,12 +314,45 @@ FF_ENABLE_DEPRECATION_WARNINGS
                 s->stats[i][j]= 0;
     }
 
-    ff_huffyuv_alloc_temp(s);
+    ret = ff_huffyuv_alloc_temp(s);
+    if (ret < 0)
+        return ret;
+
+    s->slice_context[0] = s;
+    s->nb_slices = 1;
+    if (avctx->active_thread_type & FF_THREAD_SLICE)
+        s->nb_slices = av_clip(avctx->thread_count, 1, MAX_SLICES);
+    for (i = 1; i < s->nb_slices; i++) {
+        HYuvContext *sc = av_mallocz(sizeof(*sc));
+        if (!sc) {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+        s->slice_context[i] = sc;
+        sc->avctx  = avctx;
+        sc->width  = s->width;
+        sc->height = s->height;
+        sc->bitstream_bpp = s->bitstream_bpp;
+        ret = ff_huffyuv_alloc_temp(sc);
+        if (ret < 0)
+            goto fail;
+    }
 
     s->picture_number=0;
 
     return 0;
+fail:
+    free_slice_contexts(s);
+    return ret;
 }
+
+/* codes are at most 31 bits, two of them fit in one put_bits64() */
+static inline void put_code_pair(PutBitContext *pb, int len0, uint32_t code0,
+                                 int len1, uint32_t code1)
+{
+    put_bits64(pb, len0 + len1, (uint64_t)code0 << len1 | code1);
+}
+
 static int encode_422_bitstream(HYuvContext *s, int offset, int count)
 {
     int i;
@@ -319,6 +370,11 @@ static int encode_422_bitstream(HYuvContext *s, int offset, int count)
             int y1 = y[2 * i + 1];\
             int u0 = u[i];\
             int v0 = v[i];
+#define WRITE4\
+            put_code_pair(&s->pb, s->len[0][y0], s->bits[0][y0],\
+                                  s->len[1][u0], s->bits[1][u0]);\
+            put_code_pair(&s->pb, s->len[0][y1], s->bits[0][y1],\
+                                  s->len[2][v0], s->bits[2][v0]);
 
     count /= 2;
 
@@ -337,21 +393,15 @@ static int encode_422_bitstream(HYuvContext *s, int offset, int count)
         for (i = 0; i < count; i++) {
             LOAD4;
             s->stats[0][y0]++;
-            put_bits(&s->pb, s->len[0][y0], s->bits[0][y0]);
             s->stats[1][u0]++;
-            put_bits(&s->pb, s->len[1][u0], s->bits[1][u0]);
             s->stats[0][y1]++;
-            put_bits(&s->pb, s->len[0][y1], s->bits[0][y1]);
             s->stats[2][v0]++;
-            put_bits(&s->pb, s->len[2][v0], s->bits[2][v0]);
+            WRITE4;
         }
     } else {
         for(i = 0; i < count; i++) {
             LOAD4;
-            put_bits(&s->pb, s->len[0][y0], s->bits[0][y0]);
-            put_bits(&s->pb, s->len[1][u0], s->bits[1][u0]);
-            put_bits(&s->pb, s->len[0][y1], s->bits[0][y1]);
-            put_bits(&s->pb, s->len[2][v0], s->bits[2][v0]);
+            WRITE4;
         }
     }
     return 0;
@@ -373,8 +423,8 @@ static int encode_gray_bitstream(HYuvContext *s, int count)
             s->stats[0][y0]++;\
             s->stats[0][y1]++;
 #define WRITE2\
-            put_bits(&s->pb, s->len[0][y0], s->bits[0][y0]);\
-            put_bits(&s->pb, s->len[0][y1], s->bits[0][y1]);
+            put_code_pair(&s->pb, s->len[0][y0], s->bits[0][y0],\
+                                  s->len[0][y1], s->bits[0][y1]);
 
     count /= 2;
 
@@ -426,11 +476,13 @@ static inline int encode_bgra_bitstream(HYuvContext *s, int count, int planes)
         s->stats[2][a]++;
 
 #define WRITE_GBRA                                                      \
-    put_bits(&s->pb, s->len[1][g], s->bits[1][g]);                      \
-    put_bits(&s->pb, s->len[0][b], s->bits[0][b]);                      \
-    put_bits(&s->pb, s->len[2][r], s->bits[2][r]);                      \
+    put_code_pair(&s->pb, s->len[1][g], s->bits[1][g],                  \
+                          s->len[0][b], s->bits[0][b]);                 \
     if (planes == 4)                                                    \
-        put_bits(&s->pb, s->len[2][a], s->bits[2][a]);
+        put_code_pair(&s->pb, s->len[2][r], s->bits[2][r],              \
+                              s->len[2][a], s->bits[2][a]);             \
+    else                                                                \
+        put_bits(&s->pb, s->len[2][r], s->bits[2][r]);
 
     if ((s->flags & AV_CODEC_FLAG_PASS1) &&
         (s->avctx->flags2 & AV_CODEC_FLAG2_NO_OUTPUT)) {
@@ -453,204 +505,371 @@ static inline int encode_bgra_bitstream(HYuvContext *s, int count, int planes)
     return 0;
 }
 
-static int encode_frame(AVCodecContext *avctx, AVPacket *pkt,
-                        const AVFrame *pict, int *got_packet)
+/*
+ * The rows after the header are coded in lines: one per chroma row for YUV,
+ * one per row for RGB. The predictor state at the start of a line only
+ * depends on the source pixels of the previous line, so the lines can be
+ * split in slices coded in parallel.
+ */
+static int first_line(HYuvContext *s)
 {
-    HYuvContext *s = avctx->priv_data;
-    const int width = s->width;
-    const int width2 = s->width>>1;
-    const int height = s->height;
-    const int fake_ystride = s->interlaced ? pict->linesize[0]*2  : pict->linesize[0];
-    const int fake_ustride = s->interlaced ? pict->linesize[1]*2  : pict->linesize[1];
-    const int fake_vstride = s->interlaced ? pict->linesize[2]*2  : pict->linesize[2];
-    const AVFrame * const p = pict;
-    int i, j, size = 0, ret;
-
-    if (!pkt->data &&
-        (ret = av_new_packet(pkt, width * height * 3 * 4 + AV_INPUT_BUFFER_MIN_SIZE)) < 0) {
-        av_log(avctx, AV_LOG_ERROR, "Error allocating output packet.\n");
-        return ret;
-    }
+    if (s->bitstream_bpp < 24 && s->predictor == MEDIAN)
+        return s->interlaced ? 3 : 2;
+    return 1;
+}
 
-    if (s->context) {
-        for (i = 0; i < 3; i++) {
-            ff_huff_gen_len_table(s->len[i], s->stats[i]);
-            if (ff_huffyuv_generate_bits_table(s->bits[i], s->len[i]) < 0)
-                return -1;
-            size += store_table(s, s->len[i], &pkt->data[size]);
-        }
+static int end_line(HYuvContext *s)
+{
+    int first = first_line(s);
 
-        for (i = 0; i < 3; i++)
-            for (j = 0; j < 256; j++)
-                s->stats[i][j] >>= 1;
+    if (s->bitstream_bpp == 12) {
+        if (s->predictor != MEDIAN)
+            return s->height / 2 + 1;
+        return first < s->height ? FFMAX(first + 1, s->height / 2 + 1) : first;
     }
+    return FFMAX(first, s->height);
+}
 
-    init_put_bits(&s->pb, pkt->data + size, pkt->size - size);
-
-    if (avctx->pix_fmt == AV_PIX_FMT_YUV422P ||
-        avctx->pix_fmt == AV_PIX_FMT_YUV420P) {
-        int lefty, leftu, leftv, y, cy;
-
-        put_bits(&s->pb, 8, leftv = p->data[2][0]);
-        put_bits(&s->pb, 8, lefty = p->data[0][1]);
-        put_bits(&s->pb, 8, leftu = p->data[1][0]);
-        put_bits(&s->pb, 8,         p->data[0][0]);
+/* the last left predicted value of a row, as left by sub_left_prediction() */
+static inline int last_left(const uint8_t *row, int stride, int plane)
+{
+    return plane ? (uint8_t)(row[0] - row[-stride]) : row[0];
+}
 
-        lefty = sub_left_prediction(s, s->temp[0], p->data[0], width , 0);
-        leftu = sub_left_prediction(s, s->temp[1], p->data[1], width2, 0);
-        leftv = sub_left_prediction(s, s->temp[2], p->data[2], width2, 0);
+static void encode_yuv_header(HYuvContext *s)
+{
+    const AVFrame *p = s->frame;
+    const int width  = s->width;
+    const int width2 = s->width >> 1;
+    const int fake_ystride = s->interlaced ? p->linesize[0] * 2 : p->linesize[0];
+    const int fake_ustride = s->interlaced ? p->linesize[1] * 2 : p->linesize[1];
+    const int fake_vstride = s->interlaced ? p->linesize[2] * 2 : p->linesize[2];
+    int lefty, leftu, leftv;
+
+    put_bits(&s->pb, 8, leftv = p->data[2][0]);
+    put_bits(&s->pb, 8, lefty = p->data[0][1]);
+    put_bits(&s->pb, 8, leftu = p->data[1][0]);
+    put_bits(&s->pb, 8,         p->data[0][0]);
+
+    lefty = sub_left_prediction(s, s->temp[0], p->data[0], width , 0);
+    leftu = sub_left_prediction(s, s->temp[1], p->data[1], width2, 0);
+    leftv = sub_left_prediction(s, s->temp[2], p->data[2], width2, 0);
+
+    encode_422_bitstream(s, 2, width-2);
+
+    if (s->predictor==MEDIAN) {
+        int lefttopy, lefttopu, lefttopv;
+        if (s->interlaced) {
+            lefty = sub_left_prediction(s, s->temp[0], p->data[0] + p->linesize[0], width , lefty);
+            leftu = sub_left_prediction(s, s->temp[1], p->data[1] + p->linesize[1], width2, leftu);
+            leftv = sub_left_prediction(s, s->temp[2], p->data[2] + p->linesize[2], width2, leftv);
+
+            encode_422_bitstream(s, 0, width);
+        }
 
-        encode_422_bitstream(s, 2, width-2);
+        lefty = sub_left_prediction(s, s->temp[0], p->data[0] + fake_ystride, 4, lefty);
+        leftu = sub_left_prediction(s, s->temp[1], p->data[1] + fake_ustride, 2, leftu);
+        leftv = sub_left_prediction(s, s->temp[2], p->data[2] + fake_vstride, 2, leftv);
 
-        if (s->predictor==MEDIAN) {
-            int lefttopy, lefttopu, lefttopv;
-            cy = y = 1;
-            if (s->interlaced) {
-                lefty = sub_left_prediction(s, s->temp[0], p->data[0] + p->linesize[0], width , lefty);
-                leftu = sub_left_prediction(s, s->temp[1], p->data[1] + p->linesize[1], width2, leftu);
-                leftv = sub_left_prediction(s, s->temp[2], p->data[2] + p->linesize[2], width2, leftv);
+        encode_422_bitstream(s, 0, 4);
 
-                encode_422_bitstream(s, 0, width);
-                y++; cy++;
-            }
+        lefttopy = p->data[0][3];
+        lefttopu = p->data[1][1];
+        lefttopv = p->data[2][1];
+        s->hencdsp.sub_hfyu_median_pred(s->temp[0], p->data[0] + 4, p->data[0] + fake_ystride + 4, width  - 4, &lefty, &lefttopy);
+        s->hencdsp.sub_hfyu_median_pred(s->temp[1], p->data[1] + 2, p->data[1] + fake_ustride + 2, width2 - 2, &leftu, &lefttopu);
+        s->hencdsp.sub_hfyu_median_pred(s->temp[2], p->data[2] + 2, p->data[2] + fake_vstride + 2, width2 - 2, &leftv, &lefttopv);
+        encode_422_bitstream(s, 0, width - 4);
+    }
+}
 
-            lefty = sub_left_prediction(s, s->temp[0], p->data[0] + fake_ystride, 4, lefty);
-            leftu = sub_left_prediction(s, s->temp[1], p->data[1] + fake_ustride, 2, leftu);
-            leftv = sub_left_prediction(s, s->temp[2], p->data[2] + fake_vstride, 2, leftv);
-
-            encode_422_bitstream(s, 0, 4);
-
-            lefttopy = p->data[0][3];
-            lefttopu = p->data[1][1];
-            lefttopv = p->data[2][1];
-            s->hencdsp.sub_hfyu_median_pred(s->temp[0], p->data[0] + 4, p->data[0] + fake_ystride + 4, width  - 4, &lefty, &lefttopy);
-            s->hencdsp.sub_hfyu_median_pred(s->temp[1], p->data[1] + 2, p->data[1] + fake_ustride + 2, width2 - 2, &leftu, &lefttopu);
-            s->hencdsp.sub_hfyu_median_pred(s->temp[2], p->data[2] + 2, p->data[2] + fake_vstride + 2, width2 - 2, &leftv, &lefttopv);
-            encode_422_bitstream(s, 0, width - 4);
-            y++; cy++;
-
-            for (; y < height; y++,cy++) {
-                uint8_t *ydst, *udst, *vdst;
-
-                if (s->bitstream_bpp == 12) {
-                    while (2 * cy > y) {
-                        ydst = p->data[0] + p->linesize[0] * y;
-                        s->hencdsp.sub_hfyu_median_pred(s->temp[0], ydst - fake_ystride, ydst, width, &lefty, &lefttopy);
-                        encode_gray_bitstream(s, width);
-                        y++;
-                    }
-                    if (y >= height) break;
+static void encode_yuv_lines(HYuvContext *s, int start, int end)
+{
+    const AVFrame *p = s->frame;
+    const int width  = s->width;
+    const int width2 = s->width >> 1;
+    const int height = s->height;
+    const int fake_ystride = s->interlaced ? p->linesize[0] * 2 : p->linesize[0];
+    const int fake_ustride = s->interlaced ? p->linesize[1] * 2 : p->linesize[1];
+    const int fake_vstride = s->interlaced ? p->linesize[2] * 2 : p->linesize[2];
+    int lefty, leftu, leftv, y, cy;
+
+    if (s->predictor == MEDIAN) {
+        int lefttopy, lefttopu, lefttopv;
+
+        y = s->bitstream_bpp == 12 && start > first_line(s) ? 2 * start - 2 : start - 1;
+        lefty    = p->data[0][p->linesize[0] * y + width - 1];
+        lefttopy = p->data[0][p->linesize[0] * y - fake_ystride + width - 1];
+        cy = start - 1;
+        leftu    = p->data[1][p->linesize[1] * cy + width2 - 1];
+        lefttopu = p->data[1][p->linesize[1] * cy - fake_ustride + width2 - 1];
+        leftv    = p->data[2][p->linesize[2] * cy + width2 - 1];
+        lefttopv = p->data[2][p->linesize[2] * cy - fake_vstride + width2 - 1];
+
+        for (cy = start, y++; cy < end; y++, cy++) {
+            uint8_t *ydst, *udst, *vdst;
+
+            if (s->bitstream_bpp == 12) {
+                while (2 * cy > y) {
+                    ydst = p->data[0] + p->linesize[0] * y;
+                    s->hencdsp.sub_hfyu_median_pred(s->temp[0], ydst - fake_ystride, ydst, width, &lefty, &lefttopy);
+                    encode_gray_bitstream(s, width);
+                    y++;
                 }
-                ydst = p->data[0] + p->linesize[0] * y;
-                udst = p->data[1] + p->linesize[1] * cy;
-                vdst = p->data[2] + p->linesize[2] * cy;
-
-                s->hencdsp.sub_hfyu_median_pred(s->temp[0], ydst - fake_ystride, ydst, width,  &lefty, &lefttopy);
-                s->hencdsp.sub_hfyu_median_pred(s->temp[1], udst - fake_ustride, udst, width2, &leftu, &lefttopu);
-                s->hencdsp.sub_hfyu_median_pred(s->temp[2], vdst - fake_vstride, vdst, width2, &leftv, &lefttopv);
-
-                encode_422_bitstream(s, 0, width);
+                if (y >= height) break;
             }
-        } else {
-            for (cy = y = 1; y < height; y++, cy++) {
-                uint8_t *ydst, *udst, *vdst;
+            ydst = p->data[0] + p->linesize[0] * y;
+            udst = p->data[1] + p->linesize[1] * cy;
+            vdst = p->data[2] + p->linesize[2] * cy;
 
-                /* encode a luma only line & y++ */
-                if (s->bitstream_bpp == 12) {
-                    ydst = p->data[0] + p->linesize[0] * y;
+            s->hencdsp.sub_hfyu_median_pred(s->temp[0], ydst - fake_ystride, ydst, width,  &lefty, &lefttopy);
+            s->hencdsp.sub_hfyu_median_pred(s->temp[1], udst - fake_ustride, udst, width2, &leftu, &lefttopu);
+            s->hencdsp.sub_hfyu_median_pred(s->temp[2], vdst - fake_vstride, vdst, width2, &leftv, &lefttopv);
+
+            encode_422_bitstream(s, 0, width);
+        }
+    } else {
+        int plane = s->predictor == PLANE && s->interlaced < start - 1;
 
-                    if (s->predictor == PLANE && s->interlaced < y) {
-                        s->hencdsp.diff_bytes(s->temp[1], ydst, ydst - fake_ystride, width);
+        y  = s->bitstream_bpp == 12 ? 2 * start - 2 : start - 1;
+        cy = start - 1;
+        lefty = last_left(p->data[0] + p->linesize[0] * y  + width  - 1, fake_ystride, plane);
+        leftu = last_left(p->data[1] + p->linesize[1] * cy + width2 - 1, fake_ustride, plane);
+        leftv = last_left(p->data[2] + p->linesize[2] * cy + width2 - 1, fake_vstride, plane);
 
-                        lefty = sub_left_prediction(s, s->temp[0], s->temp[1], width , lefty);
-                    } else {
-                        lefty = sub_left_prediction(s, s->temp[0], ydst, width , lefty);
-                    }
-                    encode_gray_bitstream(s, width);
-                    y++;
-                    if (y >= height) break;
-                }
+        for (cy = start; cy < end; cy++) {
+            uint8_t *ydst, *udst, *vdst;
 
+            /* encode a luma only line & y++ */
+            if (s->bitstream_bpp == 12) {
+                y    = 2 * cy - 1;
                 ydst = p->data[0] + p->linesize[0] * y;
-                udst = p->data[1] + p->linesize[1] * cy;
-                vdst = p->data[2] + p->linesize[2] * cy;
 
-                if (s->predictor == PLANE && s->interlaced < cy) {
-                    s->hencdsp.diff_bytes(s->temp[1],          ydst, ydst - fake_ystride, width);
-                    s->hencdsp.diff_bytes(s->temp[2],          udst, udst - fake_ustride, width2);
-                    s->hencdsp.diff_bytes(s->temp[2] + width2, vdst, vdst - fake_vstride, width2);
+                if (s->predictor == PLANE && s->interlaced < y) {
+                    s->hencdsp.diff_bytes(s->temp[1], ydst, ydst - fake_ystride, width);
 
                     lefty = sub_left_prediction(s, s->temp[0], s->temp[1], width , lefty);
-                    leftu = sub_left_prediction(s, s->temp[1], s->temp[2], width2, leftu);
-                    leftv = sub_left_prediction(s, s->temp[2], s->temp[2] + width2, width2, leftv);
                 } else {
                     lefty = sub_left_prediction(s, s->temp[0], ydst, width , lefty);
-                    leftu = sub_left_prediction(s, s->temp[1], udst, width2, leftu);
-                    leftv = sub_left_prediction(s, s->temp[2], vdst, width2, leftv);
                 }
+                encode_gray_bitstream(s, width);
+                y++;
+                if (y >= height) break;
+            } else {
+                y = cy;
+            }
+
+            ydst = p->data[0] + p->linesize[0] * y;
+            udst = p->data[1] + p->linesize[1] * cy;
+            vdst = p->data[2] + p->linesize[2] * cy;
 
-                encode_422_bitstream(s, 0, width);
+            if (s->predictor == PLANE && s->interlaced < cy) {
+                s->hencdsp.diff_bytes(s->temp[1],          ydst, ydst - fake_ystride, width);
+                s->hencdsp.diff_bytes(s->temp[2],          udst, udst - fake_ustride, width2);
+                s->hencdsp.diff_bytes(s->temp[2] + width2, vdst, vdst - fake_vstride, width2);
+
+                lefty = sub_left_prediction(s, s->temp[0], s->temp[1], width , lefty);
+                leftu = sub_left_prediction(s, s->temp[1], s->temp[2], width2, leftu);
+                leftv = sub_left_prediction(s, s->temp[2], s->temp[2] + width2, width2, leftv);
+            } else {
+                lefty = sub_left_prediction(s, s->temp[0], ydst, width , lefty);
+                leftu = sub_left_prediction(s, s->temp[1], udst, width2, leftu);
+                leftv = sub_left_prediction(s, s->temp[2], vdst, width2, leftv);
             }
+
+            encode_422_bitstream(s, 0, width);
         }
-    } else if(avctx->pix_fmt == AV_PIX_FMT_RGB32) {
-        uint8_t *data = p->data[0] + (height - 1) * p->linesize[0];
-        const int stride = -p->linesize[0];
-        const int fake_stride = -fake_ystride;
-        int y;
-        int leftr, leftg, leftb, lefta;
+    }
+}
+
+static void encode_rgb_header(HYuvContext *s)
+{
+    const AVFrame *p = s->frame;
+    uint8_t *data = p->data[0] + (s->height - 1) * p->linesize[0];
+    int leftr, leftg, leftb, lefta;
 
+    if (s->bitstream_bpp == 32) {
         put_bits(&s->pb, 8, lefta = data[A]);
         put_bits(&s->pb, 8, leftr = data[R]);
         put_bits(&s->pb, 8, leftg = data[G]);
         put_bits(&s->pb, 8, leftb = data[B]);
 
-        sub_left_prediction_bgr32(s, s->temp[0], data + 4, width - 1,
+        sub_left_prediction_bgr32(s, s->temp[0], data + 4, s->width - 1,
                                   &leftr, &leftg, &leftb, &lefta);
-        encode_bgra_bitstream(s, width - 1, 4);
-
-        for (y = 1; y < s->height; y++) {
-            uint8_t *dst = data + y*stride;
-            if (s->predictor == PLANE && s->interlaced < y) {
-                s->hencdsp.diff_bytes(s->temp[1], dst, dst - fake_stride, width * 4);
-                sub_left_prediction_bgr32(s, s->temp[0], s->temp[1], width,
-                                          &leftr, &leftg, &leftb, &lefta);
-            } else {
-                sub_left_prediction_bgr32(s, s->temp[0], dst, width,
-                                          &leftr, &leftg, &leftb, &lefta);
-            }
-            encode_bgra_bitstream(s, width, 4);
-        }
-    } else if (avctx->pix_fmt == AV_PIX_FMT_RGB24) {
-        uint8_t *data = p->data[0] + (height - 1) * p->linesize[0];
-        const int stride = -p->linesize[0];
-        const int fake_stride = -fake_ystride;
-        int y;
-        int leftr, leftg, leftb;
-
+        encode_bgra_bitstream(s, s->width - 1, 4);
+    } else {
         put_bits(&s->pb, 8, leftr = data[0]);
         put_bits(&s->pb, 8, leftg = data[1]);
         put_bits(&s->pb, 8, leftb = data[2]);
         put_bits(&s->pb, 8, 0);
 
-        sub_left_prediction_rgb24(s, s->temp[0], data + 3, width - 1,
+        sub_left_prediction_rgb24(s, s->temp[0], data + 3, s->width - 1,
                                   &leftr, &leftg, &leftb);
-        encode_bgra_bitstream(s, width-1, 3);
+        encode_bgra_bitstream(s, s->width - 1, 3);
+    }
+}
 
-        for (y = 1; y < s->height; y++) {
-            uint8_t *dst = data + y * stride;
-            if (s->predictor == PLANE && s->interlaced < y) {
-                s->hencdsp.diff_bytes(s->temp[1], dst, dst - fake_stride,
-                                      width * 3);
+static void encode_rgb_lines(HYuvContext *s, int start, int end)
+{
+    const AVFrame *p = s->frame;
+    const int width = s->width;
+    const int planes = s->bitstream_bpp / 8;
+    uint8_t *data = p->data[0] + (s->height - 1) * p->linesize[0];
+    const int stride = -p->linesize[0];
+    const int fake_stride = s->interlaced ? 2 * stride : stride;
+    const uint8_t *last = data + (start - 1) * stride + (width - 1) * planes;
+    int plane = s->predictor == PLANE && s->interlaced < start - 1;
+    int leftr, leftg, leftb, lefta;
+    int y;
+
+    if (planes == 4) {
+        leftr = last_left(last + R, fake_stride, plane);
+        leftg = last_left(last + G, fake_stride, plane);
+        leftb = last_left(last + B, fake_stride, plane);
+        lefta = last_left(last + A, fake_stride, plane);
+    } else {
+        leftr = last_left(last + 0, fake_stride, plane);
+        leftg = last_left(last + 1, fake_stride, plane);
+        leftb = last_left(last + 2, fake_stride, plane);
+    }
+
+    for (y = start; y < end; y++) {
+        uint8_t *dst = data + y * stride;
+        if (s->predictor == PLANE && s->interlaced < y) {
+            s->hencdsp.diff_bytes(s->temp[1], dst, dst - fake_stride, width * planes);
+            if (planes == 4)
+                sub_left_prediction_bgr32(s, s->temp[0], s->temp[1], width,
+                                          &leftr, &leftg, &leftb, &lefta);
+            else
                 sub_left_prediction_rgb24(s, s->temp[0], s->temp[1], width,
                                           &leftr, &leftg, &leftb);
-            } else {
+        } else {
+            if (planes == 4)
+                sub_left_prediction_bgr32(s, s->temp[0], dst, width,
+                                          &leftr, &leftg, &leftb, &lefta);
+            else
                 sub_left_prediction_rgb24(s, s->temp[0], dst, width,
                                           &leftr, &leftg, &leftb);
-            }
-            encode_bgra_bitstream(s, width, 3);
         }
+        encode_bgra_bitstream(s, width, planes);
+    }
+}
+
+static int encode_slice(AVCodecContext *avctx, void *arg)
+{
+    HYuvContext *s = *(HYuvContext **)arg;
+
+    if (s->bitstream_bpp < 24)
+        encode_yuv_lines(s, s->slice_start, s->slice_end);
+    else
+        encode_rgb_lines(s, s->slice_start, s->slice_end);
+    emms_c();
+
+    return 0;
+}
+
+/* Give a slice context the state of the main one for the current frame. */
+static void init_slice_context(HYuvContext *s, HYuvContext *sc)
+{
+    uint8_t *temp[3] = { sc->temp[0], sc->temp[1], sc->temp[2] };
+    uint8_t *buf = sc->bitstream_buffer;
+    unsigned int buf_size = sc->bitstream_buffer_size;
+
+    memcpy(sc, s, sizeof(*sc));
+    memcpy(sc->temp, temp, sizeof(temp));
+    sc->bitstream_buffer      = buf;
+    sc->bitstream_buffer_size = buf_size;
+    memset(sc->stats, 0, sizeof(sc->stats));
+}
+
+/* Append the bits written by a slice context. */
+static void append_bits(PutBitContext *dst, const PutBitContext *src)
+{
+    const uint8_t *ptr = src->buf;
+    int bits = 32 - src->bit_left;
+
+    if (dst->bit_left == 32) {
+        memcpy(dst->buf_ptr, ptr, src->buf_ptr - ptr);
+        dst->buf_ptr += src->buf_ptr - ptr;
     } else {
-        av_log(avctx, AV_LOG_ERROR, "Format not supported!\n");
+        for (; ptr < src->buf_ptr; ptr += 4)
+            put_bits64(dst, 32, AV_RB32(ptr));
+    }
+    if (bits)
+        put_bits(dst, bits, src->bit_buf & ((1U << bits) - 1));
+}
+
+static int encode_frame(AVCodecContext *avctx, AVPacket *pkt,
+                        const AVFrame *pict, int *got_packet)
+{
+    HYuvContext *s = avctx->priv_data;
+    const int width = s->width;
+    const int height = s->height;
+    int first = first_line(s), end = end_line(s);
+    int i, j, size = 0, nb_slices, ret;
+
+    if (!pkt->data &&
+        (ret = av_new_packet(pkt, width * height * 3 * 4 + AV_INPUT_BUFFER_MIN_SIZE)) < 0) {
+        av_log(avctx, AV_LOG_ERROR, "Error allocating output packet.\n");
+        return ret;
+    }
+
+    if (s->context) {
+        for (i = 0; i < 3; i++) {
+            ff_huff_gen_len_table(s->len[i], s->stats[i]);
+            if (ff_huffyuv_generate_bits_table(s->bits[i], s->len[i]) < 0)
+                return -1;
+            size += store_table(s, s->len[i], &pkt->data[size]);
+        }
+
+        for (i = 0; i < 3; i++)
+            for (j = 0; j < 256; j++)
+                s->stats[i][j] >>= 1;
+    }
+
+    init_put_bits(&s->pb, pkt->data + size, pkt->size - size);
+
+    s->frame = pict;
+    if (s->bitstream_bpp < 24)
+        encode_yuv_header(s);
+    else
+        encode_rgb_header(s);
+
+    nb_slices = av_clip(FFMIN(s->nb_slices, (end - first) / MIN_SLICE_LINES),
+                        1, MAX_SLICES);
+    for (i = 0; i < nb_slices; i++) {
+        HYuvContext *sc = s->slice_context[i];
+
+        if (i)
+            init_slice_context(s, sc);
+        sc->slice_start = first + (end - first) *  i      / nb_slices;
+        sc->slice_end   = first + (end - first) * (i + 1) / nb_slices;
+        if (i) {
+            /* a code is at most 31 bits, there are at most 4 * width codes
+             * per line */
+            int buf_size = (sc->slice_end - sc->slice_start) * 16 * width;
+
+            av_fast_malloc(&sc->bitstream_buffer, &sc->bitstream_buffer_size,
+                           buf_size);
+            if (!sc->bitstream_buffer)
+                return AVERROR(ENOMEM);
+            init_put_bits(&sc->pb, sc->bitstream_buffer, buf_size);
+        }
+    }
+    avctx->execute(avctx, encode_slice, s->slice_context, NULL, nb_slices,
+                   sizeof(*s->slice_context));
+
+    for (i = 1; i < nb_slices; i++) {
+        HYuvContext *sc = s->slice_context[i];
+
+        if (s->context || (s->flags & AV_CODEC_FLAG_PASS1)) {
+            int k;
+            for (j = 0; j < 3; j++)
+                for (k = 0; k < 256; k++)
+                    s->stats[j][k] += sc->stats[j][k];
+        }
+        if (!(avctx->flags2 & AV_CODEC_FLAG2_NO_OUTPUT))
+            append_bits(&s->pb, &sc->pb);
     }
     emms_c();
 
@@ -692,6 +911,7 @@ static av_cold int encode_end(AVCodecContext *avctx)
 {
     HYuvContext *s = avctx->priv_data;
 
+    free_slice_contexts(s);
     ff_huffyuv_common_end(s);
 
     av_freep(&avctx->extradata);
@@ -734,6 +954,7 @@ AVCodec ff_huffyuv_encoder = {
     .init           = encode_init,
     .encode2        = encode_frame,
     .close          = encode_end,
+    .capabilities   = AV_CODEC_CAP_SLICE_THREADS,
     .pix_fmts       = (const enum AVPixelFormat[]){
         AV_PIX_FMT_YUV422P, AV_PIX_FMT_RGB24,
         AV_PIX_FMT_RGB32, AV_PIX_FMT_NONE
@@ -761,6 +982,7 @@ AVCodec ff_ffvhuff_encoder = {
     .init           = encode_init,
     .encode2        = encode_frame,
     .close          = encode_end,
+    .capabilities   = AV_CODEC_CAP_SLICE_THREADS,
     .pix_fmts       = (const enum AVPixelFormat[]){
         AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV422P, AV_PIX_FMT_RGB24,
         AV_PIX_FMT_RGB32, AV_PIX_FMT_NONE
@@ -79,6 +79,10 @@
 
 #define FF_SIGNBIT(x) (x >> CHAR_BIT * sizeof(x) - 1)
 
+/* frame side data pools hold buffers of 64, 256, 1024 and 4096 bytes */
+#define FF_SIDE_DATA_POOLS     4
+#define FF_SIDE_DATA_POOL_MIN 64
+
 typedef struct FramePool {
     /**
      * Pools for each data plane. For audio all the planes have the same size,
@@ -98,6 +102,13 @@ typedef struct FramePool {
     int samples;
 } FramePool;
 
+/**
+ * A thread-safe list of unreferenced AVFrame structures, so that the
+ * temporary frames of the generic code do not allocate memory in steady
+ * state.
+ */
+typedef struct FFFramePool FFFramePool;
+
 typedef struct DecodeSimpleContext {
     AVPacket *in_pkt;
     AVFrame  *out_frame;
@@ -142,6 +153,25 @@ typedef struct AVCodecInternal {
 
     FramePool *pool;
 
+    /**
+     * Temporary frames used by the generic code, shared with the frame
+     * threading copies of the context.
+     */
+    FFFramePool *frame_pool;
+
+    /**
+     * Pools backing small frame side data, see ff_frame_new_side_data().
+     * Each is created on first use, and each frame threading copy of the
+     * context has its own.
+     */
+    AVBufferPool *side_data_pools[FF_SIDE_DATA_POOLS];
+
+    /**
+     * Hot path profiling counters, only allocated with FF_DEBUG_PROF.
+     * Each frame threading copy of the context has its own, see prof.h.
+     */
+    struct FFProfCounters *prof;
+
     void *thread_ctx;
 
     DecodeSimpleContext ds;
@@ -180,6 +210,14 @@ typedef struct AVCodecInternal {
      * of the packet (that should be submitted in the next decode call */
     size_t compat_decode_partial_size;
     AVFrame *compat_decode_frame;
+
+    /**
+     * avcodec_decode_audio_batch() state: the entry being decoded, a frame
+     * reused across calls and a dummy buffer the output frames reference.
+     */
+    struct AVAudioDecodeBatchEntry *batch_entry;
+    AVFrame *batch_frame;
+    AVBufferRef *batch_buf;
 } AVCodecInternal;
 
 struct AVCodecDefault {
@@ -246,6 +284,22 @@ int ff_get_buffer(AVCodecContext *avctx, AVFrame *frame, int flags);
  */
 int ff_reget_buffer(AVCodecContext *avctx, AVFrame *frame);
 
+FFFramePool *ff_frame_pool_alloc(void);
+
+/**
+ * Get a frame from the pool, allocating a new one if the pool is empty.
+ * It may be released to the pool or freed with av_frame_free().
+ */
+AVFrame *ff_frame_pool_get(FFFramePool *pool);
+
+/**
+ * Unreference a frame and return it to the pool. The frame must be released
+ * before the pool is freed.
+ */
+void ff_frame_pool_release(FFFramePool *pool, AVFrame **frame);
+
+void ff_frame_pool_free(FFFramePool **pool);
+
 const uint8_t *avpriv_find_start_code(const uint8_t *restrict p,
                                       const uint8_t *end,
                                       uint32_t *restrict state);
@@ -268,6 +322,16 @@ int ff_set_sar(AVCodecContext *avctx, AVRational sar);
 int ff_side_data_update_matrix_encoding(AVFrame *frame,
                                         enum AVMatrixEncoding matrix_encoding);
 
+/**
+ * Add a new side data to a frame, taking the buffer from a pool of the
+ * codec context when it is small enough. The pooled buffers return to the
+ * context when the last frame referencing them is released, so decoders
+ * attaching side data to every frame do not allocate it each time.
+ */
+AVFrameSideData *ff_frame_new_side_data(AVCodecContext *avctx, AVFrame *frame,
+                                        enum AVFrameSideDataType type,
+                                        int size);
+
 /**
  * Select the (possibly hardware accelerated) pixel format.
  * This is a wrapper around AVCodecContext.get_format() and should be used
@@ -62,6 +62,15 @@ typedef struct Jpeg2000Tile {
     uint16_t tp_idx;                    // Tile-part index
 } Jpeg2000Tile;
 
+/* A codeblock to decode, one slice thread job each */
+typedef struct Jpeg2000CblkJob {
+    Jpeg2000Component   *comp;
+    Jpeg2000CodingStyle *codsty;
+    Jpeg2000Band        *band;
+    Jpeg2000Cblk        *cblk;
+    int                  bandpos;
+} Jpeg2000CblkJob;
+
 typedef struct Jpeg2000DecoderContext {
     AVClass         *class;
     AVCodecContext  *avctx;
@@ -89,6 +98,10 @@ typedef struct Jpeg2000DecoderContext {
     Jpeg2000Tile    *tile;
     Jpeg2000DSPContext dsp;
 
+    Jpeg2000CblkJob *cblk_jobs;
+    unsigned int    cblk_jobs_size;
+    AVFrame         *picture;
+
     /*options parameters*/
     int             reduction_factor;
 } Jpeg2000DecoderContext;
@@ -1079,62 +1092,84 @@ static inline void mct_decode(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile)
     s->dsp.mct_decode[tile->codsty[0].transform](src[0], src[1], src[2], csize);
 }
 
-static inline void tile_codeblocks(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile)
+/* List the codeblocks of all the tiles, or only count them if jobs is NULL. */
+static int list_cblk_jobs(Jpeg2000DecoderContext *s, Jpeg2000CblkJob *jobs)
 {
+    int tileno, compno, reslevelno, bandno, nb_jobs = 0;
+
+    for (tileno = 0; tileno < s->numXtiles * s->numYtiles; tileno++) {
+        Jpeg2000Tile *tile = s->tile + tileno;
+
+        for (compno = 0; compno < s->ncomponents; compno++) {
+            Jpeg2000Component *comp     = tile->comp + compno;
+            Jpeg2000CodingStyle *codsty = tile->codsty + compno;
+
+            for (reslevelno = 0; reslevelno < codsty->nreslevels2decode; reslevelno++) {
+                Jpeg2000ResLevel *rlevel = comp->reslevel + reslevelno;
+
+                for (bandno = 0; bandno < rlevel->nbands; bandno++) {
+                    Jpeg2000Band *band = rlevel->band + bandno;
+                    int nb_precincts, precno, cblkno;
+
+                    if (band->coord[0][0] == band->coord[0][1] ||
+                        band->coord[1][0] == band->coord[1][1])
+                        continue;
+
+                    nb_precincts = rlevel->num_precincts_x * rlevel->num_precincts_y;
+                    for (precno = 0; precno < nb_precincts; precno++) {
+                        Jpeg2000Prec *prec = band->prec + precno;
+
+                        for (cblkno = 0;
+                             cblkno < prec->nb_codeblocks_width * prec->nb_codeblocks_height;
+                             cblkno++, nb_jobs++) {
+                            if (!jobs)
+                                continue;
+                            jobs[nb_jobs].comp    = comp;
+                            jobs[nb_jobs].codsty  = codsty;
+                            jobs[nb_jobs].band    = band;
+                            jobs[nb_jobs].cblk    = prec->cblk + cblkno;
+                            jobs[nb_jobs].bandpos = bandno + (reslevelno > 0);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return nb_jobs;
+}
+
+static int decode_cblk_job(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    Jpeg2000DecoderContext *s = arg;
+    Jpeg2000CblkJob *job      = s->cblk_jobs + jobnr;
+    Jpeg2000Cblk *cblk        = job->cblk;
     Jpeg2000T1Context t1;
+    int x = cblk->coord[0][0];
+    int y = cblk->coord[1][0];
 
-    int compno, reslevelno, bandno;
+    decode_cblk(s, job->codsty, &t1, cblk,
+                cblk->coord[0][1] - x, cblk->coord[1][1] - y, job->bandpos);
 
-    /* Loop on tile components */
+    if (job->codsty->transform == FF_DWT97)
+        dequantization_float(x, y, cblk, job->comp, &t1, job->band);
+    else
+        dequantization_int(x, y, cblk, job->comp, &t1, job->band);
 
-    for (compno = 0; compno < s->ncomponents; compno++) {
-        Jpeg2000Component *comp     = tile->comp + compno;
-        Jpeg2000CodingStyle *codsty = tile->codsty + compno;
-        /* Loop on resolution levels */
-        for (reslevelno = 0; reslevelno < codsty->nreslevels2decode; reslevelno++) {
-            Jpeg2000ResLevel *rlevel = comp->reslevel + reslevelno;
-            /* Loop on bands */
-            for (bandno = 0; bandno < rlevel->nbands; bandno++) {
-                uint16_t nb_precincts, precno;
-                Jpeg2000Band *band = rlevel->band + bandno;
-                int cblkno = 0, bandpos;
-                bandpos = bandno + (reslevelno > 0);
-
-                if (band->coord[0][0] == band->coord[0][1] ||
-                    band->coord[1][0] == band->coord[1][1])
-                    continue;
+    return 0;
+}
 
-                nb_precincts = rlevel->num_precincts_x * rlevel->num_precincts_y;
-                /* Loop on precincts */
-                for (precno = 0; precno < nb_precincts; precno++) {
-                    Jpeg2000Prec *prec = band->prec + precno;
-
-                    /* Loop on codeblocks */
-                    for (cblkno = 0;
-                         cblkno < prec->nb_codeblocks_width * prec->nb_codeblocks_height;
-                         cblkno++) {
-                        int x, y;
-                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
-                        decode_cblk(s, codsty, &t1, cblk,
-                                    cblk->coord[0][1] - cblk->coord[0][0],
-                                    cblk->coord[1][1] - cblk->coord[1][0],
-                                    bandpos);
-
-                        x = cblk->coord[0][0];
-                        y = cblk->coord[1][0];
-
-                        if (codsty->transform == FF_DWT97)
-                            dequantization_float(x, y, cblk, comp, &t1, band);
-                        else
-                            dequantization_int(x, y, cblk, comp, &t1, band);
-                   } /* end cblk */
-                } /*end prec */
-            } /* end band */
-        } /* end reslevel */
-
-        /* inverse DWT */
-        ff_dwt_decode(&comp->dwt, codsty->transform == FF_DWT97 ? (void*)comp->f_data : (void*)comp->i_data);
-    } /*end comp */
+/* inverse DWT of one component of one tile */
+static int dwt_job(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    Jpeg2000DecoderContext *s   = arg;
+    Jpeg2000Tile *tile          = s->tile + jobnr / s->ncomponents;
+    Jpeg2000Component *comp     = tile->comp   + jobnr % s->ncomponents;
+    Jpeg2000CodingStyle *codsty = tile->codsty + jobnr % s->ncomponents;
+
+    ff_dwt_decode(&comp->dwt, codsty->transform == FF_DWT97 ? (void*)comp->f_data : (void*)comp->i_data);
+
+    return 0;
 }
 
 #define WRITE_FRAME(D, PIXEL)                                                                     \
@@ -1192,21 +1227,48 @@ WRITE_FRAME(16, uint16_t)
 
 #undef WRITE_FRAME
 
-static int jpeg2000_decode_tile(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile,
-                                AVFrame *picture)
+static int decode_tile_job(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
 {
-    tile_codeblocks(s, tile);
+    Jpeg2000DecoderContext *s = arg;
+    Jpeg2000Tile *tile        = s->tile + jobnr;
 
     /* inverse MCT transformation */
     if (tile->codsty[0].mct)
         mct_decode(s, tile);
 
     if (s->precision <= 8) {
-        write_frame_8(s, tile, picture);
+        write_frame_8(s, tile, s->picture);
     } else {
-        write_frame_16(s, tile, picture);
+        write_frame_16(s, tile, s->picture);
+    }
+
+    return 0;
+}
+
+/* Tier-1 decoding, inverse DWT and output, each stage parallel over
+ * codeblocks, tile components and tiles respectively. */
+static int jpeg2000_decode_tiles(Jpeg2000DecoderContext *s, AVFrame *picture)
+{
+    AVCodecContext *avctx = s->avctx;
+    int nb_tiles = s->numXtiles * s->numYtiles;
+    int nb_jobs  = list_cblk_jobs(s, NULL);
+
+    if (nb_jobs) {
+        av_fast_malloc(&s->cblk_jobs, &s->cblk_jobs_size,
+                       nb_jobs * sizeof(*s->cblk_jobs));
+        if (!s->cblk_jobs)
+            return AVERROR(ENOMEM);
+        list_cblk_jobs(s, s->cblk_jobs);
+
+        avctx->execute2(avctx, decode_cblk_job, s, NULL, nb_jobs);
     }
 
+    avctx->execute2(avctx, dwt_job, s, NULL, nb_tiles * s->ncomponents);
+
+    s->picture = picture;
+    avctx->execute2(avctx, decode_tile_job, s, NULL, nb_tiles);
+    s->picture = NULL;
+
     return 0;
 }
 
@@ -1384,7 +1446,7 @@ static int jpeg2000_decode_frame(AVCodecContext *avctx, void *data,
     Jpeg2000DecoderContext *s = avctx->priv_data;
     ThreadFrame frame = { .f = data };
     AVFrame *picture = data;
-    int tileno, ret;
+    int ret;
 
     s->avctx     = avctx;
     bytestream2_init(&s->g, avpkt->data, avpkt->size);
@@ -1428,9 +1490,8 @@ static int jpeg2000_decode_frame(AVCodecContext *avctx, void *data,
 
     if (ret = jpeg2000_read_bitstream_packets(s))
         goto end;
-    for (tileno = 0; tileno < s->numXtiles * s->numYtiles; tileno++)
-        if (ret = jpeg2000_decode_tile(s, s->tile + tileno, picture))
-            goto end;
+    if (ret = jpeg2000_decode_tiles(s, picture))
+        goto end;
 
     jpeg2000_dec_cleanup(s);
 
@@ -1443,6 +1504,16 @@ end:
     return ret;
 }
 
+static av_cold int jpeg2000_decode_close(AVCodecContext *avctx)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+
+    av_freep(&s->cblk_jobs);
+    s->cblk_jobs_size = 0;
+
+    return 0;
+}
+
 static av_cold void jpeg2000_init_static_data(AVCodec *codec)
 {
     ff_jpeg2000_init_tier1_luts();
@@ -1470,11 +1541,13 @@ AVCodec ff_jpeg2000_decoder = {
     .long_name        = NULL_IF_CONFIG_SMALL("JPEG 2000"),
     .type             = AVMEDIA_TYPE_VIDEO,
     .id               = AV_CODEC_ID_JPEG2000,
-    .capabilities     = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_DR1,
+    .capabilities     = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS |
+                        AV_CODEC_CAP_DR1,
     .priv_data_size   = sizeof(Jpeg2000DecoderContext),
     .init_static_data = jpeg2000_init_static_data,
     .init             = jpeg2000_decode_init,
     .decode           = jpeg2000_decode_frame,
+    .close            = jpeg2000_decode_close,
     .priv_class       = &class,
     .profiles         = NULL_IF_CONFIG_SMALL(ff_jpeg2000_profiles)
 };
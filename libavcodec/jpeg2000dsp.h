@@ -27,9 +27,15 @@
 #include "jpeg2000dwt.h"
 
 typedef struct Jpeg2000DSPContext {
+    /**
+     * Inverse multiple component transform, in place.
+     * The buffers must be readable and writable up to csize rounded up to
+     * a multiple of 8.
+     */
     void (*mct_decode[FF_DWT_NB])(void *src0, void *src1, void *src2, int csize);
 } Jpeg2000DSPContext;
 
 void ff_jpeg2000dsp_init(Jpeg2000DSPContext *c);
+void ff_jpeg2000dsp_init_x86(Jpeg2000DSPContext *c);
 
 #endif /* AVCODEC_JPEG2000DSP_H */
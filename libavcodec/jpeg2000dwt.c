@@ -25,6 +25,8 @@
  * Discrete wavelet transform
  */
 
+#include "config.h"
+#include "libavutil/attributes.h"
 #include "libavutil/common.h"
 #include "libavutil/mem.h"
 #include "jpeg2000dwt.h"
@@ -95,11 +97,49 @@ static void sr_1d53(int *p, int i0, int i1)
         p[2 * i + 1] += (p[2 * i] + p[2 * i + 2]) >> 1;
 }
 
+static void lift53_low_c(int32_t *p, int n)
+{
+    int i, j;
+
+    for (i = 0; i < n; i++, p += 2 * FF_DWT_COLS)
+        for (j = 0; j < FF_DWT_COLS; j++)
+            p[j] -= (p[j - FF_DWT_COLS] + p[j + FF_DWT_COLS] + 2) >> 2;
+}
+
+static void lift53_high_c(int32_t *p, int n)
+{
+    int i, j;
+
+    for (i = 0; i < n; i++, p += 2 * FF_DWT_COLS)
+        for (j = 0; j < FF_DWT_COLS; j++)
+            p[j] += (p[j - FF_DWT_COLS] + p[j + FF_DWT_COLS]) >> 1;
+}
+
+/* sr_1d53() on FF_DWT_COLS interleaved columns */
+static void sr_cols53(DWTContext *s, int32_t *p, int i0, int i1)
+{
+    int j;
+
+    if (i1 == i0 + 1)
+        return;
+
+    for (j = 0; j < FF_DWT_COLS; j++) {
+        p[(i0 - 1) * FF_DWT_COLS + j] = p[(i0 + 1) * FF_DWT_COLS + j];
+        p[ i1      * FF_DWT_COLS + j] = p[(i1 - 2) * FF_DWT_COLS + j];
+        p[(i0 - 2) * FF_DWT_COLS + j] = p[(i0 + 2) * FF_DWT_COLS + j];
+        p[(i1 + 1) * FF_DWT_COLS + j] = p[(i1 - 3) * FF_DWT_COLS + j];
+    }
+
+    s->lift53_low(p + 2 * (i0 / 2) * FF_DWT_COLS, i1 / 2 + 1 - i0 / 2);
+    s->lift53_high(p + (2 * (i0 / 2) + 1) * FF_DWT_COLS, i1 / 2 - i0 / 2);
+}
+
 static void dwt_decode53(DWTContext *s, int *t)
 {
     int lev;
     int w     = s->linelen[s->ndeclevels - 1][0];
     int32_t *line = s->i_linebuf;
+    int32_t *cols = s->i_colbuf + 3 * FF_DWT_COLS;
     line += 3;
 
     for (lev = 0; lev < s->ndeclevels; lev++) {
@@ -127,8 +167,26 @@ static void dwt_decode53(DWTContext *s, int *t)
         }
 
         // VER_SD
+        l = cols + mv * FF_DWT_COLS;
+        for (lp = 0; lp + FF_DWT_COLS <= lh; lp += FF_DWT_COLS) {
+            int i, j = 0, k;
+            // copy with interleaving
+            for (i = mv; i < lv; i += 2, j++)
+                for (k = 0; k < FF_DWT_COLS; k++)
+                    l[i * FF_DWT_COLS + k] = t[w * j + lp + k];
+            for (i = 1 - mv; i < lv; i += 2, j++)
+                for (k = 0; k < FF_DWT_COLS; k++)
+                    l[i * FF_DWT_COLS + k] = t[w * j + lp + k];
+
+            sr_cols53(s, cols, mv, mv + lv);
+
+            for (i = 0; i < lv; i++)
+                for (k = 0; k < FF_DWT_COLS; k++)
+                    t[w * i + lp + k] = l[i * FF_DWT_COLS + k];
+        }
+
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (; lp < lh; lp++) {
             int i, j = 0;
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
@@ -166,11 +224,46 @@ static void sr_1d97_float(float *p, int i0, int i1)
         p[2 * i + 1] += F_LFTG_ALPHA * (p[2 * i]     + p[2 * i + 2]);
 }
 
+static void lift97_float_c(float *p, int n, float c)
+{
+    int i, j;
+
+    for (i = 0; i < n; i++, p += 2 * FF_DWT_COLS)
+        for (j = 0; j < FF_DWT_COLS; j++)
+            p[j] -= c * (p[j - FF_DWT_COLS] + p[j + FF_DWT_COLS]);
+}
+
+/* sr_1d97_float() on FF_DWT_COLS interleaved columns, the additions are
+ * done as subtractions of the negated product, which rounds the same */
+static void sr_cols97_float(DWTContext *s, float *p, int i0, int i1)
+{
+    int i, j;
+
+    if (i1 == i0 + 1)
+        return;
+
+    for (i = 1; i <= 4; i++)
+        for (j = 0; j < FF_DWT_COLS; j++) {
+            p[(i0 - i)     * FF_DWT_COLS + j] = p[(i0 + i)     * FF_DWT_COLS + j];
+            p[(i1 + i - 1) * FF_DWT_COLS + j] = p[(i1 - i - 1) * FF_DWT_COLS + j];
+        }
+
+    s->lift97_float(p + 2 * (i0 / 2 - 1) * FF_DWT_COLS,
+                    i1 / 2 + 2 - (i0 / 2 - 1),  F_LFTG_DELTA);
+    s->lift97_float(p + (2 * (i0 / 2 - 1) + 1) * FF_DWT_COLS,
+                    i1 / 2 + 1 - (i0 / 2 - 1),  F_LFTG_GAMMA);
+    s->lift97_float(p + 2 * (i0 / 2) * FF_DWT_COLS,
+                    i1 / 2 + 1 - i0 / 2,       -F_LFTG_BETA);
+    s->lift97_float(p + (2 * (i0 / 2) + 1) * FF_DWT_COLS,
+                    i1 / 2 - i0 / 2,           -F_LFTG_ALPHA);
+}
+
 static void dwt_decode97_float(DWTContext *s, float *t)
 {
     int lev;
     int w       = s->linelen[s->ndeclevels - 1][0];
     float *line = s->f_linebuf;
+    float *cols = s->f_colbuf + 5 * FF_DWT_COLS;
     float *data = t;
     /* position at index O of line range [0-5,w+5] cf. extend function */
     line += 5;
@@ -199,8 +292,26 @@ static void dwt_decode97_float(DWTContext *s, float *t)
         }
 
         // VER_SD
+        l = cols + mv * FF_DWT_COLS;
+        for (lp = 0; lp + FF_DWT_COLS <= lh; lp += FF_DWT_COLS) {
+            int i, j = 0, k;
+            // copy with interleaving
+            for (i = mv; i < lv; i += 2, j++)
+                for (k = 0; k < FF_DWT_COLS; k++)
+                    l[i * FF_DWT_COLS + k] = data[w * j + lp + k] * F_LFTG_K;
+            for (i = 1 - mv; i < lv; i += 2, j++)
+                for (k = 0; k < FF_DWT_COLS; k++)
+                    l[i * FF_DWT_COLS + k] = data[w * j + lp + k] * F_LFTG_X;
+
+            sr_cols97_float(s, cols, mv, mv + lv);
+
+            for (i = 0; i < lv; i++)
+                for (k = 0; k < FF_DWT_COLS; k++)
+                    data[w * i + lp + k] = l[i * FF_DWT_COLS + k];
+        }
+
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (; lp < lh; lp++) {
             int i, j = 0;
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
@@ -313,7 +424,8 @@ int ff_jpeg2000_dwt_init(DWTContext *s, uint16_t border[2][2],
     switch (type) {
     case FF_DWT97:
         s->f_linebuf = av_malloc((maxlen + 12) * sizeof(*s->f_linebuf));
-        if (!s->f_linebuf)
+        s->f_colbuf  = av_malloc((maxlen + 12) * FF_DWT_COLS * sizeof(*s->f_colbuf));
+        if (!s->f_linebuf || !s->f_colbuf)
             return AVERROR(ENOMEM);
         break;
      case FF_DWT97_INT:
@@ -323,12 +435,21 @@ int ff_jpeg2000_dwt_init(DWTContext *s, uint16_t border[2][2],
         break;
     case FF_DWT53:
         s->i_linebuf = av_malloc((maxlen +  6) * sizeof(*s->i_linebuf));
-        if (!s->i_linebuf)
+        s->i_colbuf  = av_malloc((maxlen +  6) * FF_DWT_COLS * sizeof(*s->i_colbuf));
+        if (!s->i_linebuf || !s->i_colbuf)
             return AVERROR(ENOMEM);
         break;
     default:
         return -1;
     }
+
+    s->lift97_float = lift97_float_c;
+    s->lift53_low   = lift53_low_c;
+    s->lift53_high  = lift53_high_c;
+
+    if (ARCH_X86)
+        ff_jpeg2000dwt_init_x86(s);
+
     return 0;
 }
 
@@ -354,4 +475,6 @@ void ff_dwt_destroy(DWTContext *s)
 {
     av_freep(&s->f_linebuf);
     av_freep(&s->i_linebuf);
+    av_freep(&s->f_colbuf);
+    av_freep(&s->i_colbuf);
 }
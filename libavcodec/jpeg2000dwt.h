@@ -30,6 +30,7 @@
 #include <stdint.h>
 
 #define FF_DWT_MAX_DECLVLS 32 ///< max number of decomposition levels
+#define FF_DWT_COLS         4 ///< columns per vertical pass group
 
 enum DWTType {
     FF_DWT97,
@@ -46,6 +47,22 @@ typedef struct DWTContext {
     uint8_t type;                        ///< 0 for 9/7; 1 for 5/3
     int32_t *i_linebuf;                  ///< int buffer used by transform
     float   *f_linebuf;                  ///< float buffer used by transform
+
+    /**
+     * Column buffers: the vertical pass is done on FF_DWT_COLS columns at a
+     * time, stored interleaved so that each row is one vector.
+     */
+    int32_t *i_colbuf;
+    float   *f_colbuf;
+
+    /**
+     * Lifting steps on the column buffers. p points to the first updated row,
+     * the n updated rows are every other row and each of them is combined
+     * with the rows right above and below it. Rows are 16-byte aligned.
+     */
+    void (*lift97_float)(float *p, int n, float c);   ///< p -= c * (above + below)
+    void (*lift53_low)(int32_t *p, int n);            ///< p -= (above + below + 2) >> 2
+    void (*lift53_high)(int32_t *p, int n);           ///< p += (above + below) >> 1
 } DWTContext;
 
 /**
@@ -62,4 +79,6 @@ int ff_dwt_decode(DWTContext *s, void *t);
 
 void ff_dwt_destroy(DWTContext *s);
 
+void ff_jpeg2000dwt_init_x86(DWTContext *s);
+
 #endif /* AVCODEC_JPEG2000DWT_H */
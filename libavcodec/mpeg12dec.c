@@ -1560,7 +1560,7 @@ static int mpeg_field_start(MpegEncContext *s, const uint8_t *buf, int buf_size)
             }
         }
 
-        pan_scan = av_frame_new_side_data(s->current_picture_ptr->f,
+        pan_scan = ff_frame_new_side_data(avctx, s->current_picture_ptr->f,
                                           AV_FRAME_DATA_PANSCAN,
                                           sizeof(s1->pan_scan));
         if (!pan_scan)
@@ -1568,7 +1568,7 @@ static int mpeg_field_start(MpegEncContext *s, const uint8_t *buf, int buf_size)
         memcpy(pan_scan->data, &s1->pan_scan, sizeof(s1->pan_scan));
 
         if (s1->a53_caption) {
-            AVFrameSideData *sd = av_frame_new_side_data(
+            AVFrameSideData *sd = ff_frame_new_side_data(avctx,
                 s->current_picture_ptr->f, AV_FRAME_DATA_A53_CC,
                 s1->a53_caption_size);
             if (sd)
@@ -1587,7 +1587,7 @@ static int mpeg_field_start(MpegEncContext *s, const uint8_t *buf, int buf_size)
 
         if (s1->has_afd) {
             AVFrameSideData *sd =
-                av_frame_new_side_data(s->current_picture_ptr->f,
+                ff_frame_new_side_data(avctx, s->current_picture_ptr->f,
                                        AV_FRAME_DATA_AFD, 1);
             if (!sd)
                 return AVERROR(ENOMEM);
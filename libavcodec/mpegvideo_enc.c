@@ -50,6 +50,7 @@
 #include "mjpegenc.h"
 #include "msmpeg4.h"
 #include "pixblockdsp.h"
+#include "prof.h"
 #include "qpeldsp.h"
 #include "faandct.h"
 #include "thread.h"
@@ -2554,6 +2555,7 @@ static int pre_estimate_motion_thread(AVCodecContext *c, void *arg){
 
 static int estimate_motion_thread(AVCodecContext *c, void *arg){
     MpegEncContext *s= *(void**)arg;
+    uint64_t prof_start;
 
     s->me.dia_size= s->avctx->dia_size;
     s->first_slice_line=1;
@@ -2567,10 +2569,12 @@ static int estimate_motion_thread(AVCodecContext *c, void *arg){
             s->block_index[3]+=2;
 
             /* compute motion vector & mb_type and store in context */
+            prof_start = ff_prof_start(c);
             if(s->pict_type==AV_PICTURE_TYPE_B)
                 ff_estimate_b_frame_motion(s, s->mb_x, s->mb_y);
             else
                 ff_estimate_p_frame_motion(s, s->mb_x, s->mb_y);
+            ff_prof_stop(c, FF_PROF_ME, prof_start);
         }
         s->first_slice_line=0;
     }
@@ -26,15 +26,7 @@
 
 static int null_filter(AVBSFContext *ctx, AVPacket *out)
 {
-    AVPacket *in;
-    int ret;
-
-    ret = ff_bsf_get_packet(ctx, &in);
-    if (ret < 0)
-        return ret;
-    av_packet_move_ref(out, in);
-    av_packet_free(&in);
-    return 0;
+    return ff_bsf_get_packet_ref(ctx, out);
 }
 
 const AVBitStreamFilter ff_null_bsf = {
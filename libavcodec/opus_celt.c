@@ -30,6 +30,7 @@
 
 #include "imdct15.h"
 #include "opus.h"
+#include "opusdsp.h"
 
 enum CeltSpread {
     CELT_SPREAD_NONE,
@@ -63,6 +64,7 @@ struct CeltContext {
     AVCodecContext    *avctx;
     IMDCT15Context    *imdct[4];
     AVFloatDSPContext  dsp;
+    OpusDSPContext     opusdsp;
     int output_channels;
 
     // values that have inter-frame effect and must be reset on flush
@@ -991,14 +993,6 @@ static inline int celt_pulses2bits(const uint8_t *cache, int pulses)
    return (pulses == 0) ? 0 : cache[pulses] + 1;
 }
 
-static inline void celt_normalize_residual(const int * restrict iy, float * restrict X,
-                                           int N, float g)
-{
-    int i;
-    for (i = 0; i < N; i++)
-        X[i] = g * iy[i];
-}
-
 static void celt_exp_rotation1(float *X, unsigned int len, unsigned int stride,
                                float c, float s)
 {
@@ -1302,7 +1296,7 @@ static inline float celt_decode_pulses(OpusRangeCoder *rc, int *y, unsigned int
 
 /** Decode pulse vector and combine the result with the pitch vector to produce
     the final normalised signal in the current band. */
-static inline unsigned int celt_alg_unquant(OpusRangeCoder *rc, float *X,
+static inline unsigned int celt_alg_unquant(CeltContext *s, OpusRangeCoder *rc, float *X,
                                             unsigned int N, unsigned int K,
                                             enum CeltSpread spread,
                                             unsigned int blocks, float gain)
@@ -1310,7 +1304,7 @@ static inline unsigned int celt_alg_unquant(OpusRangeCoder *rc, float *X,
     int y[176];
 
     gain /= sqrtf(celt_decode_pulses(rc, y, N, K));
-    celt_normalize_residual(y, X, N, gain);
+    s->opusdsp.dequant_pvq(X, y, N, gain);
     celt_exp_rotation(X, N, blocks, K, spread);
     return celt_extract_collapse_mask(y, N, blocks);
 }
@@ -1597,7 +1591,7 @@ static unsigned int celt_decode_band(CeltContext *s, OpusRangeCoder *rc,
 
         if (q != 0) {
             /* Finally do the actual quantization */
-            cm = celt_alg_unquant(rc, X, N, (q < 8) ? q : (8 + (q & 7)) << ((q >> 3) - 1),
+            cm = celt_alg_unquant(s, rc, X, N, (q < 8) ? q : (8 + (q & 7)) << ((q >> 3) - 1),
                                   s->spread, blocks, gain);
         } else {
             /* If there's no pulse, fill the band anyway */
@@ -1729,36 +1723,13 @@ static void celt_postfilter_apply_transition(CeltFrame *frame, float *data)
     }
 }
 
-static void celt_postfilter_apply(CeltFrame *frame,
+static void celt_postfilter_apply(CeltContext *s, CeltFrame *frame,
                                   float *data, int len)
 {
-    const int T = frame->pf_period;
-    float g0, g1, g2;
-    float x0, x1, x2, x3, x4;
-    int i;
-
     if (frame->pf_gains[0] == 0.0 || len <= 0)
         return;
 
-    g0 = frame->pf_gains[0];
-    g1 = frame->pf_gains[1];
-    g2 = frame->pf_gains[2];
-
-    x4 = data[-T - 2];
-    x3 = data[-T - 1];
-    x2 = data[-T];
-    x1 = data[-T + 1];
-
-    for (i = 0; i < len; i++) {
-        x0 = data[i - T + 2];
-        data[i] += g0 * x2        +
-                   g1 * (x1 + x3) +
-                   g2 * (x0 + x4);
-        x4 = x3;
-        x3 = x2;
-        x2 = x1;
-        x1 = x0;
-    }
+    s->opusdsp.postfilter(data, frame->pf_period, frame->pf_gains, len);
 }
 
 static void celt_postfilter(CeltContext *s, CeltFrame *frame)
@@ -1775,7 +1746,7 @@ static void celt_postfilter(CeltContext *s, CeltFrame *frame)
 
     if (len > CELT_OVERLAP) {
         celt_postfilter_apply_transition(frame, frame->buf + 1024 + CELT_OVERLAP);
-        celt_postfilter_apply(frame, frame->buf + 1024 + 2 * CELT_OVERLAP,
+        celt_postfilter_apply(s, frame, frame->buf + 1024 + 2 * CELT_OVERLAP,
                               len - 2 * CELT_OVERLAP);
 
         frame->pf_period_old = frame->pf_period;
@@ -2106,12 +2077,9 @@ int ff_celt_decode_frame(CeltContext *s, OpusRangeCoder *rc,
         celt_postfilter(s, frame);
 
         /* deemphasis and output scaling */
-        for (j = 0; j < frame_size; j++) {
-            float tmp = frame->buf[1024 - frame_size + j] + m;
-            m = tmp * CELT_DEEMPH_COEFF;
-            output[i][j] = tmp / 32768.;
-        }
-        frame->deemph_coeff = m;
+        frame->deemph_coeff = s->opusdsp.deemphasis(output[i],
+                                                    frame->buf + 1024 - frame_size,
+                                                    frame_size, m);
     }
 
     if (coded_channels == 1)
@@ -2209,6 +2177,7 @@ int ff_celt_init(AVCodecContext *avctx, CeltContext **ps, int output_channels)
     }
 
     avpriv_float_dsp_init(&s->dsp, avctx->flags & AV_CODEC_FLAG_BITEXACT);
+    ff_opus_dsp_init(&s->opusdsp);
 
     ff_celt_flush(s);
 
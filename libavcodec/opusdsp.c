@@ -0,0 +1,78 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "opus.h"
+#include "opusdsp.h"
+
+static void postfilter_c(float *data, int period, const float *gains, int len)
+{
+    const float g0 = gains[0];
+    const float g1 = gains[1];
+    const float g2 = gains[2];
+    float x0, x1, x2, x3, x4;
+    int i;
+
+    x4 = data[-period - 2];
+    x3 = data[-period - 1];
+    x2 = data[-period];
+    x1 = data[-period + 1];
+
+    for (i = 0; i < len; i++) {
+        x0 = data[i - period + 2];
+        data[i] += g0 * x2        +
+                   g1 * (x1 + x3) +
+                   g2 * (x0 + x4);
+        x4 = x3;
+        x3 = x2;
+        x2 = x1;
+        x1 = x0;
+    }
+}
+
+static float deemphasis_c(float *out, const float *in, int len, float coeff)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        float tmp = in[i] + coeff;
+        coeff  = tmp * CELT_DEEMPH_COEFF;
+        out[i] = tmp / 32768.;
+    }
+
+    return coeff;
+}
+
+static void dequant_pvq_c(float *X, const int *iy, int N, float gain)
+{
+    int i;
+
+    for (i = 0; i < N; i++)
+        X[i] = gain * iy[i];
+}
+
+av_cold void ff_opus_dsp_init(OpusDSPContext *s)
+{
+    s->postfilter  = postfilter_c;
+    s->deemphasis  = deemphasis_c;
+    s->dequant_pvq = dequant_pvq_c;
+
+    if (ARCH_X86)
+        ff_opus_dsp_init_x86(s);
+}
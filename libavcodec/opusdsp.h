@@ -0,0 +1,50 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_OPUSDSP_H
+#define AVCODEC_OPUSDSP_H
+
+typedef struct OpusDSPContext {
+    /**
+     * Apply the CELT pitch postfilter with constant period and gains.
+     * @param data   samples to filter in place, preceded by at least
+     *               period + 2 samples of history
+     * @param period pitch period, at least 15
+     * @param gains  the three filter taps
+     * @param len    number of samples, a multiple of 16
+     */
+    void (*postfilter)(float *data, int period, const float *gains, int len);
+
+    /**
+     * Apply the CELT deemphasis filter and scale to the [-1, 1] range.
+     * @param len   number of samples, a multiple of 4
+     * @param coeff filter state left by the previous call
+     * @return filter state for the next call
+     */
+    float (*deemphasis)(float *out, const float *in, int len, float coeff);
+
+    /**
+     * Convert the decoded PVQ pulses to a scaled float vector.
+     */
+    void (*dequant_pvq)(float *X, const int *iy, int N, float gain);
+} OpusDSPContext;
+
+void ff_opus_dsp_init(OpusDSPContext *s);
+void ff_opus_dsp_init_x86(OpusDSPContext *s);
+
+#endif /* AVCODEC_OPUSDSP_H */
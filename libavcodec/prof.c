@@ -0,0 +1,111 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <inttypes.h>
+
+#include "libavutil/log.h"
+#include "libavutil/mem.h"
+
+#include "avcodec.h"
+#include "internal.h"
+#include "prof.h"
+
+static const char *const group_names[FF_PROF_NB] = {
+    [FF_PROF_DECODE]         = "decode",
+    [FF_PROF_ENCODE]         = "encode",
+    [FF_PROF_H264_RECON]     = "h264 recon",
+    [FF_PROF_H264_DEBLOCK]   = "h264 deblock",
+    [FF_PROF_HEVC_CTB]       = "hevc ctb",
+    [FF_PROF_HEVC_FILTER]    = "hevc filter",
+    [FF_PROF_VP9_BLOCK]      = "vp9 block",
+    [FF_PROF_VP9_LOOPFILTER] = "vp9 loopfilter",
+    [FF_PROF_ME]             = "motion est",
+};
+
+int ff_prof_init(AVCodecContext *avctx)
+{
+    FFProfCounters *prof;
+    int i;
+
+    if (!(avctx->debug & FF_DEBUG_PROF))
+        return 0;
+
+    prof = av_malloc(sizeof(*prof));
+    if (!prof)
+        return AVERROR(ENOMEM);
+
+    for (i = 0; i < FF_PROF_NB; i++) {
+        atomic_init(&prof->ticks[i], 0);
+        atomic_init(&prof->calls[i], 0);
+    }
+
+    avctx->internal->prof = prof;
+    return 0;
+}
+
+void ff_prof_merge(FFProfCounters *dst, FFProfCounters **src)
+{
+    int i;
+
+    if (!*src)
+        return;
+    if (!dst) {
+        av_freep(src);
+        return;
+    }
+
+    for (i = 0; i < FF_PROF_NB; i++) {
+        atomic_fetch_add_explicit(&dst->ticks[i],
+                                  atomic_load_explicit(&(*src)->ticks[i], memory_order_relaxed),
+                                  memory_order_relaxed);
+        atomic_fetch_add_explicit(&dst->calls[i],
+                                  atomic_load_explicit(&(*src)->calls[i], memory_order_relaxed),
+                                  memory_order_relaxed);
+    }
+
+    av_freep(src);
+}
+
+void ff_prof_uninit(AVCodecContext *avctx)
+{
+    FFProfCounters *prof = avctx->internal->prof;
+    uint64_t total;
+    int i;
+
+    if (!prof)
+        return;
+
+    total = atomic_load(&prof->ticks[av_codec_is_encoder(avctx->codec) ?
+                                     FF_PROF_ENCODE : FF_PROF_DECODE]);
+
+    av_log(avctx, AV_LOG_INFO, "%-16s %12s %16s %12s %7s\n", "group", "calls",
+           FF_PROF_UNIT, FF_PROF_UNIT "/call", "share");
+    for (i = 0; i < FF_PROF_NB; i++) {
+        uint64_t calls = atomic_load(&prof->calls[i]);
+        uint64_t ticks = atomic_load(&prof->ticks[i]);
+
+        if (!calls)
+            continue;
+
+        av_log(avctx, AV_LOG_INFO, "%-16s %12"PRIu64" %16"PRIu64" %12"PRIu64" %6.1f%%\n",
+               group_names[i], calls, ticks, ticks / calls,
+               total ? 100.0 * ticks / total : 0.0);
+    }
+
+    av_freep(&avctx->internal->prof);
+}
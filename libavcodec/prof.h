@@ -0,0 +1,103 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Hot path profiling counters, enabled at runtime with -debug prof.
+ *
+ * Each frame threading copy of a codec context gets its own set of
+ * counters, they are merged into the main context when the threads are
+ * torn down and printed by avcodec_close(). Slice threads share the
+ * counters of their context and update them atomically.
+ */
+
+#ifndef AVCODEC_PROF_H
+#define AVCODEC_PROF_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+#include "libavutil/attributes.h"
+#include "libavutil/time.h"
+#include "libavutil/timer.h"
+
+#include "avcodec.h"
+#include "internal.h"
+
+#ifdef AV_READ_TIME
+#define FF_PROF_TIME()  AV_READ_TIME()
+#define FF_PROF_UNIT    "cycles"
+#else
+#define FF_PROF_TIME()  av_gettime_relative()
+#define FF_PROF_UNIT    "us"
+#endif
+
+enum FFProfGroup {
+    FF_PROF_DECODE,             ///< decode() callback of the codec
+    FF_PROF_ENCODE,             ///< encode2() callback of the codec
+    FF_PROF_H264_RECON,         ///< H.264 MB reconstruction (H264DSP idct, H264Pred, H264Qpel)
+    FF_PROF_H264_DEBLOCK,       ///< H.264 loop filter (H264DSP)
+    FF_PROF_HEVC_CTB,           ///< HEVC CTB parsing and reconstruction (HEVCDSP, HEVCPred)
+    FF_PROF_HEVC_FILTER,        ///< HEVC deblocking and SAO (HEVCDSP)
+    FF_PROF_VP9_BLOCK,          ///< VP9 superblock parsing and reconstruction (VP9DSP)
+    FF_PROF_VP9_LOOPFILTER,     ///< VP9 loop filter (VP9DSP)
+    FF_PROF_ME,                 ///< motion estimation (me_cmp)
+    FF_PROF_NB,
+};
+
+typedef struct FFProfCounters {
+    atomic_uint_fast64_t ticks[FF_PROF_NB];
+    atomic_uint_fast64_t calls[FF_PROF_NB];
+} FFProfCounters;
+
+/**
+ * Allocate the counters of avctx if FF_DEBUG_PROF is set.
+ */
+int ff_prof_init(AVCodecContext *avctx);
+
+/**
+ * Add the counters of src to dst and free src. If dst is NULL, src is only
+ * freed.
+ */
+void ff_prof_merge(FFProfCounters *dst, FFProfCounters **src);
+
+/**
+ * Print the counters of avctx and free them.
+ */
+void ff_prof_uninit(AVCodecContext *avctx);
+
+static av_always_inline uint64_t ff_prof_start(const AVCodecContext *avctx)
+{
+    return avctx->internal->prof ? FF_PROF_TIME() : 0;
+}
+
+static av_always_inline void ff_prof_stop(const AVCodecContext *avctx,
+                                          enum FFProfGroup group,
+                                          uint64_t start)
+{
+    FFProfCounters *prof = avctx->internal->prof;
+
+    if (prof) {
+        atomic_fetch_add_explicit(&prof->ticks[group], FF_PROF_TIME() - start,
+                                  memory_order_relaxed);
+        atomic_fetch_add_explicit(&prof->calls[group], 1,
+                                  memory_order_relaxed);
+    }
+}
+
+#endif /* AVCODEC_PROF_H */
@@ -36,6 +36,7 @@
 #include "avcodec.h"
 #include "hwaccel.h"
 #include "internal.h"
+#include "prof.h"
 #include "pthread_internal.h"
 #include "thread.h"
 #include "version.h"
@@ -143,6 +144,8 @@ static attribute_align_arg void *frame_worker_thread(void *arg)
     const AVCodec *codec = avctx->codec;
 
     while (1) {
+        uint64_t prof_start;
+
         if (atomic_load(&p->state) == STATE_INPUT_READY) {
             pthread_mutex_lock(&p->mutex);
             while (atomic_load(&p->state) == STATE_INPUT_READY) {
@@ -177,7 +180,9 @@ static attribute_align_arg void *frame_worker_thread(void *arg)
 
         av_frame_unref(p->frame);
         p->got_frame = 0;
-        p->result = codec->decode(avctx, p->frame, &p->got_frame, &p->avpkt);
+        prof_start = ff_prof_start(avctx);
+        p->result  = codec->decode(avctx, p->frame, &p->got_frame, &p->avpkt);
+        ff_prof_stop(avctx, FF_PROF_DECODE, prof_start);
 
         if ((p->result < 0 || !p->got_frame) && p->frame->buf[0]) {
             if (avctx->internal->allocate_progress)
@@ -245,6 +250,11 @@ static int update_context_from_thread(AVCodecContext *dst, AVCodecContext *src,
 
         dst->bits_per_raw_sample = src->bits_per_raw_sample;
         dst->ticks_per_frame     = src->ticks_per_frame;
+
+        dst->sample_rate    = src->sample_rate;
+        dst->sample_fmt     = src->sample_fmt;
+        dst->channels       = src->channels;
+        dst->channel_layout = src->channel_layout;
         dst->color_primaries     = src->color_primaries;
 
         dst->color_trc   = src->color_trc;
@@ -591,7 +601,7 @@ void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
 {
     FrameThreadContext *fctx = avctx->internal->thread_ctx;
     const AVCodec *codec = avctx->codec;
-    int i;
+    int i, j;
 
     park_frame_worker_threads(fctx, thread_count);
 
@@ -636,6 +646,11 @@ void ff_frame_thread_free(AVCodecContext *avctx, int thread_count)
 
         av_buffer_unref(&p->avctx->hw_frames_ctx);
 
+        if (p->avctx->internal) {
+            for (j = 0; j < FF_SIDE_DATA_POOLS; j++)
+                av_buffer_pool_uninit(&p->avctx->internal->side_data_pools[j]);
+            ff_prof_merge(avctx->internal->prof, &p->avctx->internal->prof);
+        }
         av_freep(&p->avctx->internal);
         av_freep(&p->avctx);
     }
@@ -731,6 +746,13 @@ int ff_frame_thread_init(AVCodecContext *avctx)
         copy->internal->thread_ctx = p;
         copy->internal->last_pkt_props = &p->avpkt;
 
+        memset(copy->internal->side_data_pools, 0,
+               sizeof(copy->internal->side_data_pools));
+        copy->internal->prof = NULL;
+        err = ff_prof_init(copy);
+        if (err < 0)
+            goto error;
+
         if (!i) {
             src = copy;
 
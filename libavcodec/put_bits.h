@@ -192,6 +192,51 @@ static void av_unused put_bits32(PutBitContext *s, uint32_t value)
 #endif
 }
 
+/**
+ * Write up to 64 bits into a bitstream.
+ * Several codes can be concatenated into value and written at once, which
+ * needs at most two stores to the buffer.
+ */
+static inline void put_bits64(PutBitContext *s, int n, uint64_t value)
+{
+    assert(n == 64 || (n < 64 && value < (UINT64_C(1) << n)));
+
+#ifdef BITSTREAM_WRITER_LE
+    if (n < 32) {
+        put_bits(s, n, value);
+    } else {
+        put_bits32(s, value);
+        if (n < 64)
+            put_bits(s, n - 32, value >> 32);
+        else
+            put_bits32(s, value >> 32);
+    }
+#else
+    if (n < s->bit_left) {
+        s->bit_buf   = (s->bit_buf << n) | value;
+        s->bit_left -= n;
+    } else if (n == 64 || n > 32 + s->bit_left) {
+        put_bits64(s, n - 32, value >> 32);
+        put_bits64(s, 32, value & 0xffffffff);
+    } else {
+        /* the low 32 - bit_left bits of bit_buf are pending */
+        int pending  = 32 - s->bit_left + n;
+        uint64_t buf = ((uint64_t)s->bit_buf << n) | value;
+
+        AV_WB32(s->buf_ptr, buf >> (pending - 32));
+        s->buf_ptr += 4;
+        pending    -= 32;
+        if (pending >= 32) {
+            AV_WB32(s->buf_ptr, buf >> (pending - 32));
+            s->buf_ptr += 4;
+            pending    -= 32;
+        }
+        s->bit_buf  = buf;
+        s->bit_left = 32 - pending;
+    }
+#endif
+}
+
 /**
  * Return the pointer to the byte where the bitstream writer will put
  * the next bit.
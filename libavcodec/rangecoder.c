@@ -65,8 +65,7 @@ void ff_build_rac_states(RangeCoder *c, int factor, int max_p)
     int64_t p;
     int last_p8, p8, i;
 
-    memset(c->zero_state, 0, sizeof(c->zero_state));
-    memset(c->one_state, 0, sizeof(c->one_state));
+    memset(c->next_state, 0, sizeof(c->next_state));
 
     last_p8 = 0;
     p       = one / 2;
@@ -75,14 +74,14 @@ void ff_build_rac_states(RangeCoder *c, int factor, int max_p)
         if (p8 <= last_p8)
             p8 = last_p8 + 1;
         if (last_p8 && last_p8 < 256 && p8 <= max_p)
-            c->one_state[last_p8] = p8;
+            c->next_state[1][last_p8] = p8;
 
         p      += ((one - p) * factor + one / 2) >> 32;
         last_p8 = p8;
     }
 
     for (i = 256 - max_p; i <= max_p; i++) {
-        if (c->one_state[i])
+        if (c->next_state[1][i])
             continue;
 
         p  = (i * one + 128) >> 8;
@@ -92,11 +91,11 @@ void ff_build_rac_states(RangeCoder *c, int factor, int max_p)
             p8 = i + 1;
         if (p8 > max_p)
             p8 = max_p;
-        c->one_state[i] = p8;
+        c->next_state[1][i] = p8;
     }
 
     for (i = 1; i < 255; i++)
-        c->zero_state[i] = 256 - c->one_state[256 - i];
+        c->next_state[0][i] = 256 - c->next_state[1][256 - i];
 }
 
 /* Return the number of bytes written. */
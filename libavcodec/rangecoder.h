@@ -37,8 +37,7 @@ typedef struct RangeCoder {
     int range;
     int outstanding_count;
     int outstanding_byte;
-    uint8_t zero_state[256];
-    uint8_t one_state[256];
+    uint8_t next_state[2][256]; ///< state transitions after a 0 and a 1
     uint8_t *bytestream_start;
     uint8_t *bytestream;
     uint8_t *bytestream_end;
@@ -91,11 +90,11 @@ static inline void put_rac(RangeCoder *c, uint8_t *const state, int bit)
     assert(range1 > 0);
     if (!bit) {
         c->range -= range1;
-        *state    = c->zero_state[*state];
+        *state    = c->next_state[0][*state];
     } else {
         c->low  += c->range - range1;
         c->range = range1;
-        *state   = c->one_state[*state];
+        *state   = c->next_state[1][*state];
     }
 
     renorm_encoder(c);
@@ -112,22 +111,21 @@ static inline void refill(RangeCoder *c)
     }
 }
 
+/* The decoded bit is usually not predictable, so it is turned into a mask
+ * and a transition table index instead of a branch. */
 static inline int get_rac(RangeCoder *c, uint8_t *const state)
 {
     int range1 = (c->range * (*state)) >> 8;
+    int range0 = c->range - range1;
+    int bit    = c->low >= range0;
+    int mask   = -bit;
 
-    c->range -= range1;
-    if (c->low < c->range) {
-        *state = c->zero_state[*state];
-        refill(c);
-        return 0;
-    } else {
-        c->low  -= c->range;
-        *state   = c->one_state[*state];
-        c->range = range1;
-        refill(c);
-        return 1;
-    }
+    c->low  -= range0 & mask;
+    c->range = range0 + ((range1 - range0) & mask);
+    *state   = c->next_state[bit][*state];
+    refill(c);
+
+    return bit;
 }
 
 #endif /* AVCODEC_RANGECODER_H */
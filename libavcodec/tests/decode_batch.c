@@ -0,0 +1,335 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Check avcodec_decode_audio_batch() against avcodec_send_packet() and
+ * avcodec_receive_frame() on many short speech streams. With -b, also
+ * time both APIs.
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/channel_layout.h"
+#include "libavutil/common.h"
+#include "libavutil/frame.h"
+#include "libavutil/mem.h"
+#include "libavutil/samplefmt.h"
+#include "libavutil/time.h"
+
+#include "libavcodec/avcodec.h"
+
+#define NB_STREAMS 64
+#define NB_PACKETS 50
+
+static const struct {
+    enum AVCodecID id;
+    int sample_rate;
+} codecs[] = {
+    { AV_CODEC_ID_PCM_MULAW,  8000 },
+    { AV_CODEC_ID_PCM_ALAW,   8000 },
+    { AV_CODEC_ID_ADPCM_G722, 16000 },
+};
+
+typedef struct TestContext {
+    AVPacket *pkts[NB_STREAMS][NB_PACKETS];
+    AVCodecContext *dec[NB_STREAMS];
+    AVAudioDecodeBatchEntry entries[NB_STREAMS];
+    AVAudioDecodeBatchEntry *entry_ptrs[NB_STREAMS];
+    uint8_t *out[NB_STREAMS];
+    int out_size;
+} TestContext;
+
+static int encode_stream(TestContext *t, int idx, enum AVCodecID id, int sample_rate)
+{
+    AVCodec *codec = avcodec_find_encoder(id);
+    AVCodecContext *enc;
+    AVFrame *frame;
+    int i, j, nb_pkts = 0, ret;
+
+    enc   = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    if (!enc || !frame) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    enc->sample_fmt     = AV_SAMPLE_FMT_S16;
+    enc->sample_rate    = sample_rate;
+    enc->channels       = 1;
+    enc->channel_layout = AV_CH_LAYOUT_MONO;
+    ret = avcodec_open2(enc, codec, NULL);
+    if (ret < 0)
+        goto end;
+
+    frame->format         = enc->sample_fmt;
+    frame->channel_layout = enc->channel_layout;
+    frame->sample_rate    = sample_rate;
+    frame->nb_samples     = enc->frame_size ? enc->frame_size : sample_rate / 50;
+    ret = av_frame_get_buffer(frame, 0);
+    if (ret < 0)
+        goto end;
+
+    for (i = 0; nb_pkts < NB_PACKETS; i++) {
+        int16_t *samples = (int16_t *)frame->data[0];
+
+        for (j = 0; j < frame->nb_samples; j++) {
+            double t = (double)(i * frame->nb_samples + j) / sample_rate;
+            samples[j] = 10000 * sin(2 * M_PI * (200 + 10 * idx) * t);
+        }
+        frame->pts = i * frame->nb_samples;
+
+        ret = avcodec_send_frame(enc, frame);
+        if (ret < 0)
+            goto end;
+
+        while (nb_pkts < NB_PACKETS) {
+            AVPacket *pkt = av_packet_alloc();
+            if (!pkt) {
+                ret = AVERROR(ENOMEM);
+                goto end;
+            }
+            ret = avcodec_receive_packet(enc, pkt);
+            if (ret < 0) {
+                av_packet_free(&pkt);
+                break;
+            }
+            t->pkts[idx][nb_pkts++] = pkt;
+        }
+        if (ret < 0 && ret != AVERROR(EAGAIN))
+            goto end;
+    }
+    ret = 0;
+
+end:
+    av_frame_free(&frame);
+    avcodec_free_context(&enc);
+    return ret;
+}
+
+static int open_decoders(TestContext *t, enum AVCodecID id, int sample_rate)
+{
+    AVCodec *codec = avcodec_find_decoder(id);
+    int i, ret;
+
+    for (i = 0; i < NB_STREAMS; i++) {
+        avcodec_free_context(&t->dec[i]);
+        t->dec[i] = avcodec_alloc_context3(codec);
+        if (!t->dec[i])
+            return AVERROR(ENOMEM);
+        t->dec[i]->sample_rate = sample_rate;
+        t->dec[i]->channels    = 1;
+        ret = avcodec_open2(t->dec[i], codec, NULL);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
+static int decode_send_receive(TestContext *t, AVFrame *frame, int *nb_samples)
+{
+    int i, j, ret;
+
+    for (j = 0; j < NB_PACKETS; j++) {
+        for (i = 0; i < NB_STREAMS; i++) {
+            ret = avcodec_send_packet(t->dec[i], t->pkts[i][j]);
+            if (ret < 0)
+                return ret;
+
+            while ((ret = avcodec_receive_frame(t->dec[i], frame)) >= 0) {
+                int bps    = av_get_bytes_per_sample(frame->format);
+                int size   = frame->nb_samples * bps;
+                int offset = nb_samples[i] * bps;
+
+                if (offset + size > t->out_size)
+                    return AVERROR(ENOSPC);
+                memcpy(t->out[i] + offset, frame->data[0], size);
+                nb_samples[i] += frame->nb_samples;
+                av_frame_unref(frame);
+            }
+            if (ret != AVERROR(EAGAIN))
+                return ret;
+        }
+    }
+
+    return 0;
+}
+
+/* With a shift, the output is not aligned and is copied from internal
+ * buffers instead of being decoded in place. */
+static int decode_batch(TestContext *t, int *nb_samples, int shift)
+{
+    int i, j;
+
+    for (j = 0; j < NB_PACKETS; j++) {
+        for (i = 0; i < NB_STREAMS; i++) {
+            AVAudioDecodeBatchEntry *e = &t->entries[i];
+            int bps = av_get_bytes_per_sample(t->dec[i]->sample_fmt);
+
+            e->avctx       = t->dec[i];
+            e->pkt         = t->pkts[i][j];
+            e->data[0]     = t->out[i] + (shift + nb_samples[i]) * bps;
+            e->max_samples = t->out_size / bps - shift - nb_samples[i];
+        }
+
+        if (avcodec_decode_audio_batch(t->entry_ptrs, NB_STREAMS) != NB_STREAMS) {
+            for (i = 0; i < NB_STREAMS; i++)
+                if (t->entries[i].ret < 0)
+                    return t->entries[i].ret;
+        }
+
+        for (i = 0; i < NB_STREAMS; i++)
+            nb_samples[i] += t->entries[i].nb_samples;
+    }
+
+    return 0;
+}
+
+static int test_codec(TestContext *t, enum AVCodecID id, int sample_rate,
+                      int bench)
+{
+    uint8_t *ref[NB_STREAMS] = { NULL };
+    int ref_samples[NB_STREAMS], nb_samples[NB_STREAMS];
+    int64_t time_ref = 0, time_batch = 0;
+    AVFrame *frame;
+    int i, n, shift, ret;
+
+    frame = av_frame_alloc();
+    if (!frame)
+        return AVERROR(ENOMEM);
+
+    for (i = 0; i < NB_STREAMS; i++) {
+        ret = encode_stream(t, i, id, sample_rate);
+        if (ret < 0)
+            goto end;
+    }
+
+    for (n = 0; n < FFMAX(bench, 1); n++) {
+        int64_t start;
+
+        ret = open_decoders(t, id, sample_rate);
+        if (ret < 0)
+            goto end;
+        memset(ref_samples, 0, sizeof(ref_samples));
+
+        start = av_gettime_relative();
+        ret = decode_send_receive(t, frame, ref_samples);
+        time_ref += av_gettime_relative() - start;
+        if (ret < 0)
+            goto end;
+
+        for (i = 0; i < NB_STREAMS; i++) {
+            if (!ref[i] && !(ref[i] = av_malloc(t->out_size))) {
+                ret = AVERROR(ENOMEM);
+                goto end;
+            }
+            memcpy(ref[i], t->out[i], t->out_size);
+            memset(t->out[i], 0, t->out_size);
+        }
+
+        for (shift = 0; shift < 2; shift++) {
+            int bps = av_get_bytes_per_sample(t->dec[0]->sample_fmt);
+
+            ret = open_decoders(t, id, sample_rate);
+            if (ret < 0)
+                goto end;
+            memset(nb_samples, 0, sizeof(nb_samples));
+
+            start = av_gettime_relative();
+            ret = decode_batch(t, nb_samples, shift);
+            if (!shift)
+                time_batch += av_gettime_relative() - start;
+            if (ret < 0)
+                goto end;
+
+            for (i = 0; i < NB_STREAMS; i++) {
+                if (nb_samples[i] != ref_samples[i] ||
+                    memcmp(ref[i], t->out[i] + shift * bps,
+                           nb_samples[i] * bps)) {
+                    fprintf(stderr, "%s: stream %d differs%s\n",
+                            avcodec_find_decoder(id)->name, i,
+                            shift ? " with unaligned output" : "");
+                    ret = AVERROR_BUG;
+                    goto end;
+                }
+                memset(t->out[i], 0, t->out_size);
+            }
+        }
+    }
+
+    if (bench)
+        printf("%-12s send/receive %8"PRId64" us  batch %8"PRId64" us\n",
+               avcodec_find_decoder(id)->name, time_ref / bench, time_batch / bench);
+
+end:
+    for (i = 0; i < NB_STREAMS; i++) {
+        for (n = 0; n < NB_PACKETS; n++)
+            av_packet_free(&t->pkts[i][n]);
+        avcodec_free_context(&t->dec[i]);
+        av_freep(&ref[i]);
+    }
+    av_frame_free(&frame);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static TestContext t;
+    int bench = 0;
+    int i, ret = 0;
+
+    if (argc > 1 && !strcmp(argv[1], "-b"))
+        bench = argc > 2 ? atoi(argv[2]) : 100;
+
+    avcodec_register_all();
+
+    for (i = 0; i < NB_STREAMS; i++)
+        t.entry_ptrs[i] = &t.entries[i];
+
+    t.out_size = 16000 * 2 * (NB_PACKETS + 1) / 50;
+    for (i = 0; i < NB_STREAMS; i++) {
+        t.out[i] = av_mallocz(t.out_size);
+        if (!t.out[i]) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+    }
+
+    for (i = 0; i < FF_ARRAY_ELEMS(codecs); i++) {
+        if (!avcodec_find_encoder(codecs[i].id) ||
+            !avcodec_find_decoder(codecs[i].id))
+            continue;
+
+        ret = test_codec(&t, codecs[i].id, codecs[i].sample_rate, bench);
+        if (ret < 0) {
+            fprintf(stderr, "%s: failed\n", avcodec_find_decoder(codecs[i].id)->name);
+            goto end;
+        }
+    }
+
+end:
+    for (i = 0; i < NB_STREAMS; i++)
+        av_freep(&t.out[i]);
+    return ret < 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Check the decode calls counted with -debug prof, also when the counters
+ * of the frame threading copies of the context are merged at close.
+ */
+
+#include <inttypes.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/frame.h"
+#include "libavutil/log.h"
+
+#include "libavcodec/avcodec.h"
+
+#define NB_PACKETS 20
+
+static AVCodecParameters *par;
+static AVPacket *pkts[NB_PACKETS];
+static int64_t decode_calls;
+
+static void log_callback(void *avcl, int level, const char *fmt, va_list vl)
+{
+    char line[256];
+    int64_t calls;
+
+    vsnprintf(line, sizeof(line), fmt, vl);
+    if (sscanf(line, "decode %"SCNd64, &calls) == 1)
+        decode_calls = calls;
+}
+
+static int encode_packets(void)
+{
+    AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_FFV1);
+    AVCodecContext *enc;
+    AVFrame *frame;
+    int i, x, y, nb_pkts = 0, ret;
+
+    enc   = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    if (!enc || !frame) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    enc->width     = 64;
+    enc->height    = 48;
+    enc->pix_fmt   = AV_PIX_FMT_YUV420P;
+    enc->time_base = (AVRational){ 1, 25 };
+    enc->gop_size  = 5;
+    ret = avcodec_open2(enc, codec, NULL);
+    if (ret < 0)
+        goto end;
+
+    ret = avcodec_parameters_from_context(par, enc);
+    if (ret < 0)
+        goto end;
+
+    frame->format = enc->pix_fmt;
+    frame->width  = enc->width;
+    frame->height = enc->height;
+    ret = av_frame_get_buffer(frame, 0);
+    if (ret < 0)
+        goto end;
+
+    for (i = 0; nb_pkts < NB_PACKETS; i++) {
+        for (y = 0; y < enc->height; y++)
+            for (x = 0; x < enc->width; x++)
+                frame->data[0][y * frame->linesize[0] + x] = x * y + i * 3;
+        for (y = 0; y < enc->height / 2; y++) {
+            memset(frame->data[1] + y * frame->linesize[1], 128 + i, enc->width / 2);
+            memset(frame->data[2] + y * frame->linesize[2], 128 - i, enc->width / 2);
+        }
+        frame->pts = i;
+
+        ret = avcodec_send_frame(enc, frame);
+        if (ret < 0)
+            goto end;
+
+        while (nb_pkts < NB_PACKETS) {
+            AVPacket *pkt = av_packet_alloc();
+            if (!pkt) {
+                ret = AVERROR(ENOMEM);
+                goto end;
+            }
+            ret = avcodec_receive_packet(enc, pkt);
+            if (ret < 0) {
+                av_packet_free(&pkt);
+                break;
+            }
+            pkts[nb_pkts++] = pkt;
+        }
+        if (ret < 0 && ret != AVERROR(EAGAIN))
+            goto end;
+    }
+    ret = 0;
+
+end:
+    av_frame_free(&frame);
+    avcodec_free_context(&enc);
+    return ret;
+}
+
+static int decode_packets(int threads)
+{
+    AVCodec *codec = avcodec_find_decoder(AV_CODEC_ID_FFV1);
+    AVCodecContext *dec;
+    AVFrame *frame;
+    int i, nb_frames = 0, ret;
+
+    dec   = avcodec_alloc_context3(codec);
+    frame = av_frame_alloc();
+    if (!dec || !frame) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    ret = avcodec_parameters_to_context(dec, par);
+    if (ret < 0)
+        goto end;
+
+    dec->debug        = FF_DEBUG_PROF;
+    dec->thread_count = threads;
+    dec->thread_type  = FF_THREAD_FRAME;
+    ret = avcodec_open2(dec, codec, NULL);
+    if (ret < 0)
+        goto end;
+
+    for (i = 0; i <= NB_PACKETS; i++) {
+        ret = avcodec_send_packet(dec, i < NB_PACKETS ? pkts[i] : NULL);
+        if (ret < 0)
+            goto end;
+        while ((ret = avcodec_receive_frame(dec, frame)) >= 0) {
+            nb_frames++;
+            av_frame_unref(frame);
+        }
+        if (ret != AVERROR(EAGAIN) && ret != AVERROR_EOF)
+            goto end;
+    }
+
+    /* the counters are printed when the decoder is closed */
+    decode_calls = -1;
+    avcodec_free_context(&dec);
+
+    if (nb_frames != NB_PACKETS || decode_calls != NB_PACKETS) {
+        fprintf(stderr, "%d threads: %d frames, %"PRId64" decode calls "
+                "counted, expected %d\n", threads, nb_frames, decode_calls,
+                NB_PACKETS);
+        ret = 1;
+        goto end;
+    }
+    ret = 0;
+
+end:
+    av_frame_free(&frame);
+    avcodec_free_context(&dec);
+    return ret;
+}
+
+int main(void)
+{
+    int i, ret;
+
+    avcodec_register_all();
+
+    par = avcodec_parameters_alloc();
+    if (!par)
+        return 1;
+
+    ret = encode_packets();
+    if (ret < 0) {
+        fprintf(stderr, "Encoding the test packets failed\n");
+    } else {
+        av_log_set_callback(log_callback);
+        ret = decode_packets(1);
+        if (!ret)
+            ret = decode_packets(3);
+    }
+
+    for (i = 0; i < NB_PACKETS; i++)
+        av_packet_free(&pkts[i]);
+    avcodec_parameters_free(&par);
+
+    return !!ret;
+}
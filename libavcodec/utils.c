@@ -38,12 +38,14 @@
 #include "libavutil/pixdesc.h"
 #include "libavutil/imgutils.h"
 #include "libavutil/samplefmt.h"
+#include "libavutil/thread.h"
 #include "libavutil/dict.h"
 #include "avcodec.h"
 #include "decode.h"
 #include "libavutil/opt.h"
 #include "me_cmp.h"
 #include "mpegvideo.h"
+#include "prof.h"
 #include "thread.h"
 #include "internal.h"
 #include "bytestream.h"
@@ -145,6 +147,34 @@ int ff_set_sar(AVCodecContext *avctx, AVRational sar)
     return 0;
 }
 
+AVFrameSideData *ff_frame_new_side_data(AVCodecContext *avctx, AVFrame *frame,
+                                        enum AVFrameSideDataType type,
+                                        int size)
+{
+    AVBufferRef *buf;
+    int i;
+
+    for (i = 0; i < FF_SIDE_DATA_POOLS; i++)
+        if (size <= FF_SIDE_DATA_POOL_MIN << 2 * i)
+            break;
+    if (size < 0 || i == FF_SIDE_DATA_POOLS || !avctx->internal)
+        return av_frame_new_side_data(frame, type, size);
+
+    if (!avctx->internal->side_data_pools[i]) {
+        avctx->internal->side_data_pools[i] =
+            av_buffer_pool_init(FF_SIDE_DATA_POOL_MIN << 2 * i, NULL);
+        if (!avctx->internal->side_data_pools[i])
+            return NULL;
+    }
+
+    buf = av_buffer_pool_get(avctx->internal->side_data_pools[i]);
+    if (!buf)
+        return NULL;
+    buf->size = size;
+
+    return av_frame_new_side_data_from_buf(frame, type, buf);
+}
+
 int ff_side_data_update_matrix_encoding(AVFrame *frame,
                                         enum AVMatrixEncoding matrix_encoding)
 {
@@ -152,9 +182,14 @@ int ff_side_data_update_matrix_encoding(AVFrame *frame,
     enum AVMatrixEncoding *data;
 
     side_data = av_frame_get_side_data(frame, AV_FRAME_DATA_MATRIXENCODING);
-    if (!side_data)
+    if (!side_data) {
         side_data = av_frame_new_side_data(frame, AV_FRAME_DATA_MATRIXENCODING,
                                            sizeof(enum AVMatrixEncoding));
+    } else if (av_buffer_make_writable(&side_data->buf) < 0) {
+        side_data = NULL;
+    } else {
+        side_data->data = side_data->buf->data;
+    }
 
     if (!side_data)
         return AVERROR(ENOMEM);
@@ -341,7 +376,7 @@ int avcodec_default_execute2(AVCodecContext *c, int (*func)(AVCodecContext *c2,
 
 int attribute_align_arg avcodec_open2(AVCodecContext *avctx, const AVCodec *codec, AVDictionary **options)
 {
-    int ret = 0;
+    int i, ret = 0;
     AVDictionary *tmp = NULL;
 
     if (avcodec_is_open(avctx))
@@ -395,6 +430,12 @@ int attribute_align_arg avcodec_open2(AVCodecContext *avctx, const AVCodec *code
         goto free_and_end;
     }
 
+    avctx->internal->frame_pool = ff_frame_pool_alloc();
+    if (!avctx->internal->frame_pool) {
+        ret = AVERROR(ENOMEM);
+        goto free_and_end;
+    }
+
     avctx->internal->to_free = av_frame_alloc();
     if (!avctx->internal->to_free) {
         ret = AVERROR(ENOMEM);
@@ -511,6 +552,10 @@ int attribute_align_arg avcodec_open2(AVCodecContext *avctx, const AVCodec *code
         avctx->time_base.den = avctx->sample_rate;
     }
 
+    ret = ff_prof_init(avctx);
+    if (ret < 0)
+        goto free_and_end;
+
     if (HAVE_THREADS) {
         ret = ff_thread_init(avctx);
         if (ret < 0) {
@@ -706,13 +751,89 @@ FF_ENABLE_DEPRECATION_WARNINGS
 
         av_packet_free(&avctx->internal->ds.in_pkt);
 
+        for (i = 0; i < FF_SIDE_DATA_POOLS; i++)
+            av_buffer_pool_uninit(&avctx->internal->side_data_pools[i]);
+        ff_frame_pool_free(&avctx->internal->frame_pool);
         av_freep(&avctx->internal->pool);
+        av_freep(&avctx->internal->prof);
     }
     av_freep(&avctx->internal);
     avctx->codec = NULL;
     goto end;
 }
 
+struct FFFramePool {
+    AVMutex mutex;
+    AVFrame **frames;
+    int nb_frames;
+    int nb_allocated;
+};
+
+av_cold FFFramePool *ff_frame_pool_alloc(void)
+{
+    FFFramePool *pool = av_mallocz(sizeof(*pool));
+
+    if (!pool)
+        return NULL;
+
+    ff_mutex_init(&pool->mutex, NULL);
+
+    return pool;
+}
+
+AVFrame *ff_frame_pool_get(FFFramePool *pool)
+{
+    AVFrame *frame = NULL;
+
+    ff_mutex_lock(&pool->mutex);
+    if (pool->nb_frames)
+        frame = pool->frames[--pool->nb_frames];
+    ff_mutex_unlock(&pool->mutex);
+
+    return frame ? frame : av_frame_alloc();
+}
+
+void ff_frame_pool_release(FFFramePool *pool, AVFrame **frame)
+{
+    if (!frame || !*frame)
+        return;
+
+    av_frame_unref(*frame);
+
+    ff_mutex_lock(&pool->mutex);
+    if (pool->nb_frames == pool->nb_allocated) {
+        int nb_allocated = FFMAX(2 * pool->nb_allocated, 4);
+        AVFrame **tmp = av_realloc_array(pool->frames, nb_allocated,
+                                         sizeof(*tmp));
+        if (tmp) {
+            pool->frames       = tmp;
+            pool->nb_allocated = nb_allocated;
+        }
+    }
+    if (pool->nb_frames < pool->nb_allocated) {
+        pool->frames[pool->nb_frames++] = *frame;
+        *frame = NULL;
+    }
+    ff_mutex_unlock(&pool->mutex);
+
+    av_freep(frame);
+}
+
+av_cold void ff_frame_pool_free(FFFramePool **ppool)
+{
+    FFFramePool *pool = *ppool;
+    int i;
+
+    if (!pool)
+        return;
+
+    for (i = 0; i < pool->nb_frames; i++)
+        av_frame_free(&pool->frames[i]);
+    av_freep(&pool->frames);
+    ff_mutex_destroy(&pool->mutex);
+    av_freep(ppool);
+}
+
 void avsubtitle_free(AVSubtitle *sub)
 {
     int i;
@@ -743,9 +864,12 @@ av_cold int avcodec_close(AVCodecContext *avctx)
             ff_thread_free(avctx);
         if (avctx->codec && avctx->codec->close)
             avctx->codec->close(avctx);
+        ff_prof_uninit(avctx);
         av_frame_free(&avctx->internal->to_free);
         av_frame_free(&avctx->internal->compat_decode_frame);
         av_frame_free(&avctx->internal->buffer_frame);
+        av_frame_free(&avctx->internal->batch_frame);
+        av_buffer_unref(&avctx->internal->batch_buf);
         av_packet_free(&avctx->internal->buffer_pkt);
         av_packet_free(&avctx->internal->last_pkt_props);
 
@@ -755,6 +879,10 @@ av_cold int avcodec_close(AVCodecContext *avctx)
             av_buffer_pool_uninit(&pool->pools[i]);
         av_freep(&avctx->internal->pool);
 
+        for (i = 0; i < FF_SIDE_DATA_POOLS; i++)
+            av_buffer_pool_uninit(&avctx->internal->side_data_pools[i]);
+        ff_frame_pool_free(&avctx->internal->frame_pool);
+
         if (avctx->hwaccel && avctx->hwaccel->uninit)
             avctx->hwaccel->uninit(avctx);
         av_freep(&avctx->internal->hwaccel_priv_data);
@@ -26,6 +26,7 @@
 #include "avcodec.h"
 #include "get_bits.h"
 #include "internal.h"
+#include "prof.h"
 #include "videodsp.h"
 #include "vp56.h"
 #include "vp9.h"
@@ -1348,11 +1349,14 @@ static int vp9_decode_frame(AVCodecContext *avctx, void *output,
                     for (col = s->tiling.tile_col_start;
                          col < s->tiling.tile_col_end;
                          col += 8, yoff2 += 64, uvoff2 += 32, lflvl++) {
+                        uint64_t prof_start;
+
                         // FIXME integrate with lf code (i.e. zero after each
                         // use, similar to invtxfm coefficients, or similar)
                         if (s->pass != 1)
                             memset(lflvl->mask, 0, sizeof(lflvl->mask));
 
+                        prof_start = ff_prof_start(avctx);
                         if (s->pass == 2) {
                             ret = decode_superblock_mem(avctx, row, col, lflvl,
                                                         yoff2, uvoff2, BL_64X64);
@@ -1360,6 +1364,7 @@ static int vp9_decode_frame(AVCodecContext *avctx, void *output,
                             ret = decode_subblock(avctx, row, col, lflvl,
                                                   yoff2, uvoff2, BL_64X64);
                         }
+                        ff_prof_stop(avctx, FF_PROF_VP9_BLOCK, prof_start);
                         if (ret < 0)
                             goto fail;
                     }
@@ -1389,12 +1394,15 @@ static int vp9_decode_frame(AVCodecContext *avctx, void *output,
 
                 // loopfilter one row
                 if (s->filter.level) {
+                    uint64_t prof_start = ff_prof_start(avctx);
+
                     yoff2  = yoff;
                     uvoff2 = uvoff;
                     lflvl  = s->lflvl;
                     for (col = 0; col < s->cols;
                          col += 8, yoff2 += 64, uvoff2 += 32, lflvl++)
                         loopfilter_subblock(avctx, lflvl, row, col, yoff2, uvoff2);
+                    ff_prof_stop(avctx, FF_PROF_VP9_LOOPFILTER, prof_start);
                 }
 
                 // FIXME maybe we can make this more finegrained by running the
@@ -0,0 +1,99 @@
+;******************************************************************************
+;* SIMD optimized AAC encoder DSP functions
+;*
+;* This file is part of Libav.
+;*
+;* Libav is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* Libav is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with Libav; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+pf_abs_mask: times 4 dd 0x7fffffff
+pd_0_4054:   times 2 dq 0.4054
+
+SECTION .text
+
+;*******************************************************************
+;void ff_abs_pow34_sse(float *out, const float *in, int size);
+;*******************************************************************
+INIT_XMM sse
+cglobal abs_pow34, 3, 3, 3, out, in, size
+    mova   m2, [pf_abs_mask]
+    movsxdifnidn sizeq, sized
+    shl    sizeq, 2
+    add    inq, sizeq
+    add    outq, sizeq
+    neg    sizeq
+.loop:
+    movu   m0, [inq+sizeq]
+    andps  m0, m2
+    sqrtps m1, m0
+    mulps  m0, m1
+    sqrtps m0, m0
+    movu   [outq+sizeq], m0
+    add    sizeq, mmsize
+    jl .loop
+    RET
+
+;*******************************************************************
+;void ff_aac_quantize_bands_sse2(int *out, const float *in, const float *scaled,
+;                                int size, int is_signed, int maxval, float Q34);
+;*******************************************************************
+; The product is rounded to single precision and the rest is done in double
+; precision, as in the C version.
+INIT_XMM sse2
+cglobal aac_quantize_bands, 5, 5, 7, out, in, scaled, size, is_signed, maxval, Q34
+%if UNIX64 == 0
+    movss      m0, Q34m
+    cvtsi2sd   m3, dword maxvalm
+%else
+    cvtsi2sd   m3, maxvald
+%endif
+    shufps     m0, m0, 0
+    movlhps    m3, m3
+    neg        is_signedd
+    movd       m4, is_signedd
+    pshufd     m4, m4, 0
+    pxor       m6, m6
+    movsxdifnidn sizeq, sized
+    shl        sizeq, 2
+    add        inq, sizeq
+    add        outq, sizeq
+    add        scaledq, sizeq
+    neg        sizeq
+.loop:
+    movu       m1, [scaledq+sizeq]
+    mulps      m1, m0
+    cvtps2pd   m2, m1
+    movhlps    m1, m1
+    cvtps2pd   m1, m1
+    addpd      m2, [pd_0_4054]
+    addpd      m1, [pd_0_4054]
+    minpd      m2, m3
+    minpd      m1, m3
+    cvttpd2dq  m2, m2
+    cvttpd2dq  m1, m1
+    punpcklqdq m2, m1
+    movu       m5, [inq+sizeq]
+    cmpltps    m5, m6
+    pand       m5, m4
+    pxor       m2, m5
+    psubd      m2, m5
+    movu       [outq+sizeq], m2
+    add        sizeq, mmsize
+    jl .loop
+    RET
@@ -0,0 +1,226 @@
+;******************************************************************************
+;* SIMD optimized MPEG-4 Parametric Stereo decoding functions
+;*
+;* This file is part of Libav.
+;*
+;* Libav is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* Libav is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with Libav; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+ps_p1m1p1m1: dd 0, 0x80000000, 0, 0x80000000
+ps_m1p1m1p1: dd 0x80000000, 0, 0x80000000, 0
+
+SECTION .text
+
+;*************************************************************************
+;void ff_ps_add_squares_sse3(float *dst, const float (*src)[2], int n);
+;*************************************************************************
+INIT_XMM sse3
+cglobal ps_add_squares, 3, 3, 2, dst, src, n
+    movsxdifnidn nq, nd
+    shl      nq, 3
+    add    srcq, nq
+    neg      nq
+.loop:
+    movu     m0, [srcq+nq]
+    movu     m1, [srcq+nq+mmsize]
+    mulps    m0, m0
+    mulps    m1, m1
+    haddps   m0, m1
+    movu     m1, [dstq]
+    addps    m0, m1
+    movu [dstq], m0
+    add    dstq, mmsize
+    add      nq, mmsize*2
+    jl .loop
+    REP_RET
+
+;*************************************************************************
+;void ff_ps_mul_pair_single_sse(float (*dst)[2], float (*src0)[2],
+;                               float *src1, int n);
+;*************************************************************************
+INIT_XMM sse
+cglobal ps_mul_pair_single, 4, 4, 4, dst, src0, src1, n
+    movsxdifnidn nq, nd
+    shl      nq, 3
+    add   src0q, nq
+    add    dstq, nq
+    neg      nq
+.loop:
+    movu     m0, [src0q+nq]
+    movu     m1, [src0q+nq+mmsize]
+    movu     m2, [src1q]
+    unpckhps m3, m2, m2
+    unpcklps m2, m2
+    mulps    m0, m2
+    mulps    m1, m3
+    movu [dstq+nq], m0
+    movu [dstq+nq+mmsize], m1
+    add   src1q, mmsize
+    add      nq, mmsize*2
+    jl .loop
+    REP_RET
+
+;*************************************************************************
+;void ff_ps_hybrid_analysis_sse3(float (*out)[2], float (*in)[2],
+;                                const float (*filter)[8][2],
+;                                int stride, int n);
+;*************************************************************************
+; The inputs are symmetric around in[6], so the sums and differences of
+; in[j] and in[12 - j] are computed once and arranged to match the filter
+; layout, leaving two multiplies per coefficient pair for each output.
+
+; %1 = in[j], in[j + 1] on input, { re(s), -im(d) } pairs on output
+; %2 = in[12 - j], in[11 - j] on input, { im(s), re(d) } pairs on output
+%macro PS_HYBRID_PREPARE 2
+    subps    m8, %1, %2
+    addps    %1, %2
+    shufps   %2, %1, m8, q2031
+    shufps   %2, %2, q3120
+    xorps    m8, m7
+    shufps   %1, m8, q3120
+    shufps   %1, %1, q3120
+%endmacro
+
+%if ARCH_X86_64
+INIT_XMM sse3
+cglobal ps_hybrid_analysis, 5, 5, 11, out, in, filter, stride, n
+    movsxdifnidn strideq, strided
+    shl     strideq, 3
+    mova         m7, [ps_p1m1p1m1]
+    movu         m0, [inq]
+    movu         m1, [inq+16]
+    movu         m2, [inq+32]
+    movu         m3, [inq+88]
+    movu         m4, [inq+72]
+    movu         m5, [inq+56]
+    shufps       m3, m3, q1032
+    shufps       m4, m4, q1032
+    shufps       m5, m5, q1032
+    PS_HYBRID_PREPARE m0, m3
+    PS_HYBRID_PREPARE m1, m4
+    PS_HYBRID_PREPARE m2, m5
+    movsd        m6, [inq+48]
+.loop:
+    movu         m7, [filterq]
+    mulps        m8, m7, m3
+    mulps        m7, m0
+    movu         m9, [filterq+16]
+    mulps       m10, m9, m4
+    mulps        m9, m1
+    addps        m7, m9
+    addps        m8, m10
+    movu         m9, [filterq+32]
+    mulps       m10, m9, m5
+    mulps        m9, m2
+    addps        m7, m9
+    addps        m8, m10
+    haddps       m7, m8
+    haddps       m7, m7
+    movss        m9, [filterq+48]
+    SPLATD       m9
+    mulps        m9, m6
+    addps        m7, m9
+    movlps   [outq], m7
+    add        outq, strideq
+    add     filterq, 64
+    dec          nd
+    jg .loop
+    REP_RET
+%endif
+
+;*************************************************************************
+;void ff_ps_stereo_interpolate_sse3(float (*l)[2], float (*r)[2],
+;                                   float h[2][4], float h_step[2][4],
+;                                   int len);
+;*************************************************************************
+; One sample per iteration, the gains are accumulated as in the C version.
+INIT_XMM sse3
+cglobal ps_stereo_interpolate, 5, 5, 6, l, r, h, h_step, n
+    movu         m0, [hq]
+    movu         m2, [h_stepq]
+    unpckhps     m1, m0, m0
+    unpckhps     m3, m2, m2
+    unpcklps     m0, m0
+    unpcklps     m2, m2
+    movsxdifnidn nq, nd
+    shl          nq, 3
+    add          lq, nq
+    add          rq, nq
+    neg          nq
+.loop:
+    addps        m0, m2
+    addps        m1, m3
+    movddup      m4, [lq+nq]
+    movddup      m5, [rq+nq]
+    mulps        m4, m0
+    mulps        m5, m1
+    addps        m4, m5
+    movlps  [lq+nq], m4
+    movhps  [rq+nq], m4
+    add          nq, 8
+    jl .loop
+    REP_RET
+
+%if ARCH_X86_64
+INIT_XMM sse3
+cglobal ps_stereo_interpolate_ipdopd, 5, 5, 12, l, r, h, h_step, n
+    movu         m0, [hq]
+    movu         m2, [hq+16]
+    movu         m4, [h_stepq]
+    movu         m6, [h_stepq+16]
+    unpckhps     m1, m0, m0
+    unpckhps     m3, m2, m2
+    unpckhps     m5, m4, m4
+    unpckhps     m7, m6, m6
+    unpcklps     m0, m0
+    unpcklps     m2, m2
+    unpcklps     m4, m4
+    unpcklps     m6, m6
+    mova         m8, [ps_m1p1m1p1]
+    xorps        m2, m8
+    xorps        m3, m8
+    xorps        m6, m8
+    xorps        m7, m8
+    movsxdifnidn nq, nd
+    shl          nq, 3
+    add          lq, nq
+    add          rq, nq
+    neg          nq
+.loop:
+    addps        m0, m4
+    addps        m1, m5
+    addps        m2, m6
+    addps        m3, m7
+    movddup      m8, [lq+nq]
+    movddup      m9, [rq+nq]
+    pshufd      m10, m8, q2301
+    pshufd      m11, m9, q2301
+    mulps        m8, m0
+    mulps        m9, m1
+    mulps       m10, m2
+    mulps       m11, m3
+    addps        m8, m9
+    addps        m8, m10
+    addps        m8, m11
+    movlps  [lq+nq], m8
+    movhps  [rq+nq], m8
+    add          nq, 8
+    jl .loop
+    REP_RET
+%endif
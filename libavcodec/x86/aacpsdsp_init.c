@@ -0,0 +1,53 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/aacpsdsp.h"
+
+void ff_ps_add_squares_sse3(float *dst, const float (*src)[2], int n);
+void ff_ps_mul_pair_single_sse(float (*dst)[2], float (*src0)[2],
+                               float *src1, int n);
+void ff_ps_hybrid_analysis_sse3(float (*out)[2], float (*in)[2],
+                                const float (*filter)[8][2],
+                                int stride, int n);
+void ff_ps_stereo_interpolate_sse3(float (*l)[2], float (*r)[2],
+                                   float h[2][4], float h_step[2][4],
+                                   int len);
+void ff_ps_stereo_interpolate_ipdopd_sse3(float (*l)[2], float (*r)[2],
+                                          float h[2][4], float h_step[2][4],
+                                          int len);
+
+av_cold void ff_psdsp_init_x86(PSDSPContext *s)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE(cpu_flags)) {
+        s->mul_pair_single = ff_ps_mul_pair_single_sse;
+    }
+    if (EXTERNAL_SSE3(cpu_flags)) {
+        s->add_squares           = ff_ps_add_squares_sse3;
+        s->stereo_interpolate[0] = ff_ps_stereo_interpolate_sse3;
+#if ARCH_X86_64
+        s->hybrid_analysis       = ff_ps_hybrid_analysis_sse3;
+        s->stereo_interpolate[1] = ff_ps_stereo_interpolate_ipdopd_sse3;
+#endif
+    }
+}
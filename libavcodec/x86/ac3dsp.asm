@@ -39,6 +39,10 @@ pd_151: times 4 dd 151
 pb_revwords: SHUFFLE_MASK_W 7, 6, 5, 4, 3, 2, 1, 0
 pd_16384: times 4 dd 16384
 
+; used in ff_ac3_compute_bap()
+pb_16: times 16 db 16
+pb_63: times 16 db 63
+
 SECTION .text
 
 ;-----------------------------------------------------------------------------
@@ -550,3 +554,55 @@ INIT_XMM ssse3
 APPLY_WINDOW_INT16 1
 INIT_XMM ssse3, atom
 APPLY_WINDOW_INT16 1
+
+;-----------------------------------------------------------------------------
+; void ff_ac3_compute_bap(uint8_t *bap, const int16_t *psd, const int16_t *mask,
+;                         const uint8_t *bap_tab, int len)
+;
+; len must be a multiple of 16 and greater than 0. The 64-entry table is
+; looked up in four 16-byte slices; indices past the end of a slice return
+; an earlier entry, which is no greater than the wanted one as long as the
+; table is non-decreasing.
+;-----------------------------------------------------------------------------
+
+INIT_XMM ssse3
+cglobal ac3_compute_bap, 5, 5, 8, bap, psd, mask, tab, len
+    movu          m4, [tabq]
+    movu          m5, [tabq+16]
+    movu          m6, [tabq+32]
+    movu          m7, [tabq+48]
+    mova          m3, [pb_16]
+    movsxdifnidn lenq, lend
+    add         bapq, lenq
+    lea         psdq, [psdq+lenq*2]
+    lea        maskq, [maskq+lenq*2]
+    neg         lenq
+.loop:
+    movu          m0, [ psdq+lenq*2]
+    movu          m1, [ psdq+lenq*2+mmsize]
+    movu          m2, [maskq+lenq*2]
+    psubsw        m0, m2
+    movu          m2, [maskq+lenq*2+mmsize]
+    psubsw        m1, m2
+    psraw         m0, 5
+    psraw         m1, 5
+    packuswb      m0, m1
+    pminub        m0, [pb_63]
+    mova          m1, m4
+    pshufb        m1, m0
+    psubb         m0, m3
+    mova          m2, m5
+    pshufb        m2, m0
+    pmaxub        m1, m2
+    psubb         m0, m3
+    mova          m2, m6
+    pshufb        m2, m0
+    pmaxub        m1, m2
+    psubb         m0, m3
+    mova          m2, m7
+    pshufb        m2, m0
+    pmaxub        m1, m2
+    movu  [bapq+lenq], m1
+    add         lenq, mmsize
+    jl .loop
+    REP_RET
@@ -19,12 +19,15 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <string.h>
+
 #include "libavutil/attributes.h"
 #include "libavutil/mem.h"
 #include "libavutil/x86/asm.h"
 #include "libavutil/x86/cpu.h"
 #include "libavcodec/ac3.h"
 #include "libavcodec/ac3dsp.h"
+#include "libavcodec/ac3tab.h"
 
 void ff_ac3_exponent_min_mmx   (uint8_t *exp, int num_reuse_blocks, int nb_coefs);
 void ff_ac3_exponent_min_mmxext(uint8_t *exp, int num_reuse_blocks, int nb_coefs);
@@ -63,6 +66,55 @@ void ff_apply_window_int16_ssse3(int16_t *output, const int16_t *input,
 void ff_apply_window_int16_ssse3_atom(int16_t *output, const int16_t *input,
                                       const int16_t *window, unsigned int len);
 
+void ff_ac3_compute_bap_ssse3(uint8_t *bap, const int16_t *psd,
+                              const int16_t *mask, const uint8_t *bap_tab,
+                              int len);
+
+#if HAVE_SSSE3_EXTERNAL
+/* The masking curve is expanded to one value per bin, after which the
+ * table look-up runs 16 bins at a time. */
+static void ac3_bit_alloc_calc_bap_ssse3(int16_t *mask, int16_t *psd,
+                                         int start, int end,
+                                         int snr_offset, int floor,
+                                         const uint8_t *bap_tab, uint8_t *bap)
+{
+    LOCAL_ALIGNED_16(int16_t, bin_mask, [AC3_MAX_COEFS]);
+    int bin, band, band_end, len = end - start;
+
+    /* special case, if snr offset is -960, set all bap's to zero */
+    if (snr_offset == -960) {
+        memset(bap, 0, AC3_MAX_COEFS);
+        return;
+    }
+
+    bin  = start;
+    band = ff_ac3_bin_to_band_tab[start];
+    do {
+        int m = (FFMAX(mask[band] - snr_offset - floor, 0) & 0x1FE0) + floor;
+        band_end = ff_ac3_band_start_tab[++band];
+        band_end = FFMIN(band_end, end);
+
+        for (; bin < band_end; bin++)
+            bin_mask[bin] = m;
+    } while (end > band_end);
+
+    if (len < 16) {
+        for (bin = start; bin < end; bin++) {
+            int address = av_clip_uintp2((psd[bin] - bin_mask[bin]) >> 5, 6);
+            bap[bin] = bap_tab[address];
+        }
+        return;
+    }
+
+    ff_ac3_compute_bap_ssse3(bap + start, psd + start, bin_mask + start,
+                             bap_tab, len & ~15);
+    /* the tail overlaps the last full chunk, recomputing the same values */
+    if (len & 15)
+        ff_ac3_compute_bap_ssse3(bap + end - 16, psd + end - 16,
+                                 bin_mask + end - 16, bap_tab, 16);
+}
+#endif /* HAVE_SSSE3_EXTERNAL */
+
 av_cold void ff_ac3dsp_init_x86(AC3DSPContext *c, int bit_exact)
 {
     int cpu_flags = av_get_cpu_flags();
@@ -111,6 +163,9 @@ av_cold void ff_ac3dsp_init_x86(AC3DSPContext *c, int bit_exact)
 
     if (EXTERNAL_SSSE3(cpu_flags)) {
         c->ac3_max_msb_abs_int16 = ff_ac3_max_msb_abs_int16_ssse3;
+#if HAVE_SSSE3_EXTERNAL
+        c->bit_alloc_calc_bap = ac3_bit_alloc_calc_bap_ssse3;
+#endif
         if (cpu_flags & AV_CPU_FLAG_ATOM) {
             c->apply_window_int16 = ff_apply_window_int16_ssse3_atom;
         } else {
@@ -0,0 +1,63 @@
+;******************************************************************************
+;* SIMD optimized FFV1 functions
+;*
+;* This file is part of Libav.
+;*
+;* Libav is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* Libav is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with Libav; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+;*******************************************************************
+;void ff_ffv1_sub_median_pred(int16_t *dst, const int16_t *src,
+;                             const int16_t *top, int w);
+;*******************************************************************
+; median(L, L + T - LT, T) is L + T - LT clamped between L and T
+%macro SUB_MEDIAN_PRED 0
+cglobal ffv1_sub_median_pred, 4, 4, 4, dst, src, top, w
+    movsxdifnidn wq, wd
+    add    wq, wq
+    add    dstq, wq
+    add    srcq, wq
+    add    topq, wq
+    neg    wq
+.loop:
+    movu   m0, [srcq + wq - 2]
+    movu   m1, [topq + wq]
+    movu   m2, [topq + wq - 2]
+    psubw  m2, m1
+    mova   m3, m0
+    psubw  m3, m2
+    mova   m2, m0
+    pminsw m0, m1
+    pmaxsw m2, m1
+    pmaxsw m3, m0
+    pminsw m3, m2
+    movu   m0, [srcq + wq]
+    psubw  m0, m3
+    mova   [dstq + wq], m0
+    add    wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+SUB_MEDIAN_PRED
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+SUB_MEDIAN_PRED
+%endif
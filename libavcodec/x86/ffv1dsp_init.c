@@ -0,0 +1,38 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/ffv1dsp.h"
+
+void ff_ffv1_sub_median_pred_sse2(int16_t *dst, const int16_t *src,
+                                  const int16_t *top, int w);
+void ff_ffv1_sub_median_pred_avx2(int16_t *dst, const int16_t *src,
+                                  const int16_t *top, int w);
+
+av_cold void ff_ffv1dsp_init_x86(FFV1DSPContext *c)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags))
+        c->sub_median_pred = ff_ffv1_sub_median_pred_sse2;
+    if (EXTERNAL_AVX2(cpu_flags))
+        c->sub_median_pred = ff_ffv1_sub_median_pred_avx2;
+}
@@ -0,0 +1,163 @@
+;******************************************************************************
+;* SIMD optimized JPEG 2000 DSP functions
+;*
+;* This file is part of Libav.
+;*
+;* Libav is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* Libav is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with Libav; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pf_ict0: times 8 dd 1.402
+pf_ict1: times 8 dd 0.34413
+pf_ict2: times 8 dd 0.71414
+pf_ict3: times 8 dd 1.772
+
+pd_2:    times 4 dd 2
+
+SECTION .text
+
+;***********************************************************************
+;void ff_ict_float(void *src0, void *src1, void *src2, int csize);
+;***********************************************************************
+%macro ICT_FLOAT 0
+cglobal ict_float, 4, 4, 6, src0, src1, src2, csize
+    movsxdifnidn csizeq, csized
+    shl    csizeq, 2
+    add    src0q, csizeq
+    add    src1q, csizeq
+    add    src2q, csizeq
+    neg    csizeq
+.loop:
+    movu   m0, [src0q + csizeq]
+    movu   m1, [src1q + csizeq]
+    movu   m2, [src2q + csizeq]
+    mulps  m3, m2, [pf_ict0]
+    addps  m3, m0
+    mulps  m4, m1, [pf_ict1]
+    subps  m5, m0, m4
+    mulps  m4, m2, [pf_ict2]
+    subps  m5, m4
+    mulps  m1, [pf_ict3]
+    addps  m1, m0
+    movu   [src0q + csizeq], m3
+    movu   [src1q + csizeq], m5
+    movu   [src2q + csizeq], m1
+    add    csizeq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse
+ICT_FLOAT
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+ICT_FLOAT
+%endif
+
+;***********************************************************************
+;void ff_rct_int(void *src0, void *src1, void *src2, int csize);
+;***********************************************************************
+%macro RCT_INT 0
+cglobal rct_int, 4, 4, 4, src0, src1, src2, csize
+    movsxdifnidn csizeq, csized
+    shl    csizeq, 2
+    add    src0q, csizeq
+    add    src1q, csizeq
+    add    src2q, csizeq
+    neg    csizeq
+.loop:
+    movu   m0, [src0q + csizeq]
+    movu   m1, [src1q + csizeq]
+    movu   m2, [src2q + csizeq]
+    paddd  m3, m1, m2
+    psrad  m3, 2
+    psubd  m0, m3
+    paddd  m2, m0
+    paddd  m1, m0
+    movu   [src0q + csizeq], m2
+    movu   [src1q + csizeq], m0
+    movu   [src2q + csizeq], m1
+    add    csizeq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+RCT_INT
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+RCT_INT
+%endif
+
+;***********************************************************************
+;void ff_dwt_lift97_float(float *p, int n, float c);
+;***********************************************************************
+INIT_XMM sse
+cglobal dwt_lift97_float, 2, 2, 3, p, n, c
+%if ARCH_X86_32
+    movss  m0, cm
+%elif WIN64
+    movaps m0, m2
+%endif
+    shufps m0, m0, 0
+.loop:
+    mova   m1, [pq - 16]
+    addps  m1, [pq + 16]
+    mulps  m1, m0
+    mova   m2, [pq]
+    subps  m2, m1
+    mova   [pq], m2
+    add    pq, 32
+    dec    nd
+    jg .loop
+    RET
+
+;***********************************************************************
+;void ff_dwt_lift53_low(int32_t *p, int n);
+;***********************************************************************
+INIT_XMM sse2
+cglobal dwt_lift53_low, 2, 2, 3, p, n
+    mova   m2, [pd_2]
+.loop:
+    mova   m0, [pq - 16]
+    paddd  m0, [pq + 16]
+    paddd  m0, m2
+    psrad  m0, 2
+    mova   m1, [pq]
+    psubd  m1, m0
+    mova   [pq], m1
+    add    pq, 32
+    dec    nd
+    jg .loop
+    RET
+
+;***********************************************************************
+;void ff_dwt_lift53_high(int32_t *p, int n);
+;***********************************************************************
+INIT_XMM sse2
+cglobal dwt_lift53_high, 2, 2, 1, p, n
+.loop:
+    mova   m0, [pq - 16]
+    paddd  m0, [pq + 16]
+    psrad  m0, 1
+    paddd  m0, [pq]
+    mova   [pq], m0
+    add    pq, 32
+    dec    nd
+    jg .loop
+    RET
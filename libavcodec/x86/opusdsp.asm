@@ -0,0 +1,163 @@
+;******************************************************************************
+;* SIMD optimized Opus decoder DSP functions
+;*
+;* This file is part of Libav.
+;*
+;* Libav is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* Libav is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with Libav; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+; powers of CELT_DEEMPH_COEFF
+pf_deemph_a:     times 4 dd 0x3f599a00
+pf_deemph_a2:    times 4 dd 0x3f38f671
+pf_deemph_pows:          dd 0x3f800000, 0x3f599a00, 0x3f38f671, 0x3f1d382a
+pf_deemph_scale: times 4 dd 0x38000000
+
+SECTION .text
+
+;*******************************************************************
+;void ff_opus_postfilter(float *data, int period, const float *gains, int len);
+;*******************************************************************
+%macro OPUS_POSTFILTER 0
+cglobal opus_postfilter, 4, 4, 8, data, period, gains, len
+    VBROADCASTSS m5, [gainsq + 0]
+    VBROADCASTSS m6, [gainsq + 4]
+    VBROADCASTSS m7, [gainsq + 8]
+    movsxdifnidn periodq, periodd
+    movsxdifnidn lenq, lend
+    shl    periodq, 2
+    shl    lenq, 2
+    add    dataq, lenq
+    mov    gainsq, dataq
+    sub    gainsq, periodq
+    neg    lenq
+; The period is at least 15, so every input sample of a vector has already
+; been filtered.
+.loop:
+    movu   m0, [gainsq + lenq - 8]
+    movu   m1, [gainsq + lenq - 4]
+    movu   m2, [gainsq + lenq]
+    movu   m3, [gainsq + lenq + 4]
+    movu   m4, [gainsq + lenq + 8]
+    addps  m1, m3
+    addps  m0, m4
+    mulps  m2, m5
+    FMULADD_PS m2, m1, m6, m2, m3
+    FMULADD_PS m2, m0, m7, m2, m4
+    movu   m3, [dataq + lenq]
+    addps  m2, m3
+    movu   [dataq + lenq], m2
+    add    lenq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse
+OPUS_POSTFILTER
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+OPUS_POSTFILTER
+%endif
+%if HAVE_FMA3_EXTERNAL
+INIT_YMM fma3
+OPUS_POSTFILTER
+%endif
+
+;*******************************************************************
+;float ff_opus_deemphasis(float *out, const float *in, int len, float coeff);
+;*******************************************************************
+; The recursion y[i] = x[i] + a * y[i - 1] is evaluated four samples at a
+; time with a prefix scan, the state is carried broadcast in m0.
+INIT_XMM sse2
+cglobal opus_deemphasis, 3, 3, 8, out, in, len, coeff
+%if ARCH_X86_32
+    movss  m0, coeffm
+%elif WIN64
+    movaps m0, m3
+%endif
+    shufps m0, m0, 0
+    mova   m4, [pf_deemph_a]
+    mova   m5, [pf_deemph_a2]
+    mova   m6, [pf_deemph_pows]
+    mova   m7, [pf_deemph_scale]
+    movsxdifnidn lenq, lend
+    shl    lenq, 2
+    add    inq, lenq
+    add    outq, lenq
+    neg    lenq
+.loop:
+    movu   m1, [inq + lenq]
+    movaps m2, m1
+    pslldq m2, 4
+    mulps  m2, m4
+    addps  m1, m2
+    movaps m2, m1
+    pslldq m2, 8
+    mulps  m2, m5
+    addps  m1, m2
+    mulps  m0, m6
+    addps  m1, m0
+    movaps m0, m1
+    shufps m0, m0, q3333
+    mulps  m0, m4
+    mulps  m1, m7
+    movu   [outq + lenq], m1
+    add    lenq, mmsize
+    jl .loop
+%if ARCH_X86_32
+    movss  r0m, m0
+    fld    dword r0m
+%endif
+    RET
+
+;*******************************************************************
+;void ff_opus_dequant_pvq(float *X, const int *iy, int N, float gain);
+;*******************************************************************
+INIT_XMM sse2
+cglobal opus_dequant_pvq, 3, 3, 2, X, iy, N, gain
+%if ARCH_X86_32
+    movss  m0, gainm
+%elif WIN64
+    movaps m0, m3
+%endif
+    shufps m0, m0, 0
+    movsxdifnidn Nq, Nd
+    sub    Nq, 4
+    jl .tail
+.loop:
+    movu     m1, [iyq]
+    cvtdq2ps m1, m1
+    mulps    m1, m0
+    movu     [Xq], m1
+    add    iyq, mmsize
+    add    Xq, mmsize
+    sub    Nq, 4
+    jge .loop
+.tail:
+    add    Nq, 4
+    jz .end
+.tail_loop:
+    cvtsi2ss m1, dword [iyq]
+    mulss  m1, m0
+    movss  [Xq], m1
+    add    iyq, 4
+    add    Xq, 4
+    dec    Nq
+    jg .tail_loop
+.end:
+    RET
@@ -0,0 +1,96 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+
+#include "libavutil/attributes.h"
+#include "libavutil/common.h"
+
+#include "overlay.h"
+
+/* x / 255 rounded to nearest, for x + 128 in the 16 bit range */
+#define DIV255(x) ((((x) + 128) + (((x) + 128) >> 8)) >> 8)
+
+void ff_overlay_blend_row_c(uint8_t *dst, const uint8_t *src,
+                            const uint8_t *alpha, int w)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] = DIV255(dst[i] * (255 - alpha[i]) + src[i] * alpha[i]);
+}
+
+void ff_overlay_blend_row_premult_c(uint8_t *dst, const uint8_t *src,
+                                    const uint8_t *alpha, int w)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] = FFMIN(src[i] + DIV255(dst[i] * (255 - alpha[i])), 255);
+}
+
+void ff_overlay_blend_row_premult_chroma_c(uint8_t *dst, const uint8_t *src,
+                                           const uint8_t *alpha, int w)
+{
+    int i;
+
+    for (i = 0; i < w; i++)
+        dst[i] = av_clip_uint8(src[i] + DIV255((dst[i] - 128) * (255 - alpha[i])));
+}
+
+void ff_overlay_blend_rgba_c(uint8_t *dst, const uint8_t *src, int w)
+{
+    int i;
+
+    for (i = 0; i < w; i++) {
+        int a = src[3];
+
+        dst[0] = DIV255(dst[0] * (255 - a) + src[0] * a);
+        dst[1] = DIV255(dst[1] * (255 - a) + src[1] * a);
+        dst[2] = DIV255(dst[2] * (255 - a) + src[2] * a);
+        dst[3] = DIV255(dst[3] * (255 - a) +    255 * a);
+        dst += 4;
+        src += 4;
+    }
+}
+
+void ff_overlay_blend_rgba_premult_c(uint8_t *dst, const uint8_t *src, int w)
+{
+    int i, j;
+
+    for (i = 0; i < w; i++) {
+        int a = src[3];
+
+        for (j = 0; j < 4; j++)
+            dst[j] = FFMIN(src[j] + DIV255(dst[j] * (255 - a)), 255);
+        dst += 4;
+        src += 4;
+    }
+}
+
+av_cold void ff_overlay_init(OverlayDSPContext *dsp)
+{
+    dsp->blend_row                = ff_overlay_blend_row_c;
+    dsp->blend_row_premult        = ff_overlay_blend_row_premult_c;
+    dsp->blend_row_premult_chroma = ff_overlay_blend_row_premult_chroma_c;
+    dsp->blend_rgba               = ff_overlay_blend_rgba_c;
+    dsp->blend_rgba_premult       = ff_overlay_blend_rgba_premult_c;
+
+    if (ARCH_X86)
+        ff_overlay_init_x86(dsp);
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_OVERLAY_H
+#define AVFILTER_OVERLAY_H
+
+#include <stdint.h>
+
+/**
+ * Alpha blending primitives of the overlay filter.
+ *
+ * All the functions blend w pixels of src on top of dst in place, the
+ * divisions by 255 are rounded to nearest. Fully transparent pixels leave
+ * dst untouched, so they may be skipped; for premultiplied alpha this
+ * requires their samples to be 0 (128 for chroma).
+ */
+typedef struct OverlayDSPContext {
+    /**
+     * Straight alpha blending of one plane, alpha has the resolution of
+     * the plane: dst = (dst * (255 - alpha) + src * alpha) / 255
+     */
+    void (*blend_row)(uint8_t *dst, const uint8_t *src,
+                      const uint8_t *alpha, int w);
+
+    /**
+     * Premultiplied alpha blending of a luma plane:
+     * dst = src + dst * (255 - alpha) / 255, saturated
+     */
+    void (*blend_row_premult)(uint8_t *dst, const uint8_t *src,
+                              const uint8_t *alpha, int w);
+
+    /**
+     * Premultiplied alpha blending of a chroma plane, the samples are
+     * centered on 128: dst = src + (dst - 128) * (255 - alpha) / 255, clipped
+     */
+    void (*blend_row_premult_chroma)(uint8_t *dst, const uint8_t *src,
+                                     const uint8_t *alpha, int w);
+
+    /**
+     * Straight alpha blending of packed RGBA, the alpha of dst becomes
+     * alpha + dst_alpha * (255 - alpha) / 255.
+     */
+    void (*blend_rgba)(uint8_t *dst, const uint8_t *src, int w);
+
+    /**
+     * Premultiplied alpha blending of packed RGBA, all the components
+     * including alpha are computed as src + dst * (255 - alpha) / 255.
+     */
+    void (*blend_rgba_premult)(uint8_t *dst, const uint8_t *src, int w);
+} OverlayDSPContext;
+
+void ff_overlay_init(OverlayDSPContext *dsp);
+void ff_overlay_init_x86(OverlayDSPContext *dsp);
+
+void ff_overlay_blend_row_c(uint8_t *dst, const uint8_t *src,
+                            const uint8_t *alpha, int w);
+void ff_overlay_blend_row_premult_c(uint8_t *dst, const uint8_t *src,
+                                    const uint8_t *alpha, int w);
+void ff_overlay_blend_row_premult_chroma_c(uint8_t *dst, const uint8_t *src,
+                                           const uint8_t *alpha, int w);
+void ff_overlay_blend_rgba_c(uint8_t *dst, const uint8_t *src, int w);
+void ff_overlay_blend_rgba_premult_c(uint8_t *dst, const uint8_t *src, int w);
+
+#endif /* AVFILTER_OVERLAY_H */
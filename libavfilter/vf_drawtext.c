@@ -42,6 +42,8 @@
 #include "libavutil/common.h"
 #include "libavutil/file.h"
 #include "libavutil/eval.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/mathematics.h"
 #include "libavutil/random_seed.h"
@@ -54,6 +56,7 @@
 #include "drawutils.h"
 #include "formats.h"
 #include "internal.h"
+#include "overlay.h"
 #include "video.h"
 
 #include <ft2build.h>
@@ -106,6 +109,35 @@ enum var_name {
     VAR_VARS_NB
 };
 
+/**
+ * Layout of a character of the text.
+ */
+typedef struct TextChar {
+    uint32_t code;
+    struct Glyph *glyph;
+    int draw;                       ///< whether the glyph is drawn
+    int x, y;                       ///< position of the glyph bitmap relative to the text
+
+    /* layout state before this character, to resume the layout from it */
+    int pen_x, pen_y;
+    int str_w;
+    uint32_t prev_code;
+    struct Glyph *prev_glyph;
+} TextChar;
+
+typedef struct Span {
+    int start, end;
+} Span;
+
+enum CanvasPlane {
+    CANVAS_LUMA,                    ///< Y, or premultiplied RGBA for packed RGB formats
+    CANVAS_U,
+    CANVAS_V,
+    CANVAS_ALPHA,
+    CANVAS_CHROMA_ALPHA,
+    CANVAS_NB_PLANES
+};
+
 typedef struct DrawTextContext {
     const AVClass *class;
 #if CONFIG_LIBFONTCONFIG
@@ -116,8 +148,13 @@ typedef struct DrawTextContext {
     uint8_t *expanded_text;         ///< used to contain the strftime()-expanded text
     size_t   expanded_text_size;    ///< size in bytes of the expanded_text buffer
     int ft_load_flags;              ///< flags used for loading fonts, see FT_LOAD_*
-    FT_Vector *positions;           ///< positions for each element in the text
-    size_t nb_positions;            ///< number of elements of positions array
+    TextChar *chars;                ///< layout of each character of the text
+    TextChar *prev_chars;           ///< layout of the previously drawn text
+    int nb_chars;                   ///< number of elements of the chars array
+    int nb_prev_chars;              ///< number of elements of the prev_chars array
+    int chars_size;                 ///< allocated size of chars and prev_chars
+    char *layout_text;              ///< text the layout was computed for
+    int text_height, baseline;
     char *textfile;                 ///< file with text to be drawn
     int x, y;                       ///< position to start drawing text
     int w, h;                       ///< dimension of the text block
@@ -156,6 +193,21 @@ typedef struct DrawTextContext {
     AVExpr *a_pexpr;
     int alpha;
     AVLFG  prng;                    ///< random
+
+    /**
+     * The box, the shadow and the text pre-blended in the output pixel
+     * format with premultiplied alpha. Only the parts of it touched by the
+     * characters that changed are rendered again, blending it onto the
+     * frames is done with the overlay DSP.
+     */
+    uint8_t *canvas[CANVAS_NB_PLANES];
+    int canvas_linesize[CANVAS_NB_PLANES];
+    Span *canvas_span[2];           ///< non transparent part of each luma and chroma row
+    int canvas_x, canvas_y;         ///< position of the canvas relative to the text
+    int canvas_w, canvas_h;
+    int canvas_alpha;               ///< alpha the canvas was rendered with
+    int dirty[4];                   ///< area of the canvas to render again, x0, y0, x1, y1
+    OverlayDSPContext dsp;
 } DrawTextContext;
 
 #define OFFSET(x) offsetof(DrawTextContext, x)
@@ -230,7 +282,8 @@ static const struct ft_error {
 typedef struct Glyph {
     FT_Glyph *glyph;
     uint32_t code;
-    FT_Bitmap bitmap; ///< array holding bitmaps of font
+    uint8_t *coverage; ///< 8 bit coverage of the rendered glyph
+    int width, height; ///< dimensions of coverage
     FT_BBox bbox;
     int advance;
     int bitmap_left;
@@ -244,6 +297,39 @@ static int glyph_cmp(void *key, const void *b)
     return diff > 0 ? 1 : diff < 0 ? -1 : 0;
 }
 
+/**
+ * Convert the bitmap rendered by FreeType to the 8 bit coverage of glyph.
+ */
+static int glyph_fill_coverage(Glyph *glyph, const FT_Bitmap *bitmap)
+{
+    int r, c;
+
+    if ((bitmap->pixel_mode != FT_PIXEL_MODE_MONO &&
+         bitmap->pixel_mode != FT_PIXEL_MODE_GRAY) ||
+        !bitmap->rows || !bitmap->width)
+        return 0;
+
+    glyph->coverage = av_malloc(bitmap->rows * bitmap->width);
+    if (!glyph->coverage)
+        return AVERROR(ENOMEM);
+    glyph->width  = bitmap->width;
+    glyph->height = bitmap->rows;
+
+    for (r = 0; r < bitmap->rows; r++) {
+        const uint8_t *src = bitmap->buffer + r * bitmap->pitch;
+        uint8_t *dst       = glyph->coverage + r * glyph->width;
+
+        for (c = 0; c < bitmap->width; c++) {
+            if (bitmap->pixel_mode == FT_PIXEL_MODE_MONO)
+                dst[c] = src[c >> 3] & (0x80 >> (c & 7)) ? 255 : 0;
+            else
+                dst[c] = src[c];
+        }
+    }
+
+    return 0;
+}
+
 /**
  * Load glyphs corresponding to the UTF-32 codepoint code.
  */
@@ -271,7 +357,8 @@ static int load_glyph(AVFilterContext *ctx, Glyph **glyph_ptr, uint32_t code)
         goto error;
     }
 
-    glyph->bitmap      = s->face->glyph->bitmap;
+    if ((ret = glyph_fill_coverage(glyph, &s->face->glyph->bitmap)) < 0)
+        goto error;
     glyph->bitmap_left = s->face->glyph->bitmap_left;
     glyph->bitmap_top  = s->face->glyph->bitmap_top;
     glyph->advance     = s->face->glyph->advance.x >> 6;
@@ -291,8 +378,12 @@ static int load_glyph(AVFilterContext *ctx, Glyph **glyph_ptr, uint32_t code)
     return 0;
 
 error:
-    if (glyph)
+    if (glyph) {
+        if (glyph->glyph && *glyph->glyph)
+            FT_Done_Glyph(*glyph->glyph);
         av_freep(&glyph->glyph);
+        av_freep(&glyph->coverage);
+    }
     av_freep(&glyph);
     av_freep(&node);
     return ret;
@@ -466,6 +557,8 @@ static av_cold int init(AVFilterContext *ctx)
     }
     s->tabsize *= glyph->advance;
 
+    ff_overlay_init(&s->dsp);
+
     return 0;
 }
 
@@ -487,6 +580,11 @@ static int query_formats(AVFilterContext *ctx)
 
 static int glyph_enu_free(void *opaque, void *elem)
 {
+    Glyph *glyph = elem;
+
+    FT_Done_Glyph(*glyph->glyph);
+    av_freep(&glyph->glyph);
+    av_freep(&glyph->coverage);
     av_free(elem);
     return 0;
 }
@@ -499,9 +597,16 @@ static av_cold void uninit(AVFilterContext *ctx)
     av_expr_free(s->x_pexpr);
     av_expr_free(s->y_pexpr);
     av_expr_free(s->d_pexpr);
-    s->x_pexpr = s->y_pexpr = s->d_pexpr = NULL;
+    av_expr_free(s->a_pexpr);
+    s->x_pexpr = s->y_pexpr = s->d_pexpr = s->a_pexpr = NULL;
     av_freep(&s->expanded_text);
-    av_freep(&s->positions);
+    av_freep(&s->chars);
+    av_freep(&s->prev_chars);
+    av_freep(&s->layout_text);
+    for (i = 0; i < CANVAS_NB_PLANES; i++)
+        av_freep(&s->canvas[i]);
+    av_freep(&s->canvas_span[0]);
+    av_freep(&s->canvas_span[1]);
     av_tree_enumerate(s->glyphs, NULL, NULL, glyph_enu_free);
     av_tree_destroy(s->glyphs);
     s->glyphs = 0;
@@ -547,11 +652,47 @@ static int expand_strftime(DrawTextContext *s)
     return 0;
 }
 
+static void dirty_reset(DrawTextContext *s)
+{
+    s->dirty[0] = s->dirty[1] = INT_MAX;
+    s->dirty[2] = s->dirty[3] = INT_MIN;
+}
+
+static void dirty_add_rect(DrawTextContext *s, int x0, int y0, int x1, int y1)
+{
+    s->dirty[0] = FFMIN(s->dirty[0], x0);
+    s->dirty[1] = FFMIN(s->dirty[1], y0);
+    s->dirty[2] = FFMAX(s->dirty[2], x1);
+    s->dirty[3] = FFMAX(s->dirty[3], y1);
+}
+
+/**
+ * Mark the area covered by a character and its shadow for redraw.
+ */
+static void dirty_add_char(DrawTextContext *s, const TextChar *c)
+{
+    const Glyph *glyph = c->glyph;
+
+    if (!c->draw || !glyph->coverage)
+        return;
+
+    dirty_add_rect(s, c->x, c->y, c->x + glyph->width, c->y + glyph->height);
+    if (s->shadowx || s->shadowy)
+        dirty_add_rect(s, c->x + s->shadowx, c->y + s->shadowy,
+                       c->x + s->shadowx + glyph->width,
+                       c->y + s->shadowy + glyph->height);
+}
+
+/**
+ * Lay out the text. The layout of the previous text is kept up to the
+ * first character that changed, and the area of the characters that moved
+ * or changed is marked for redraw.
+ */
 static int dtext_prepare_text(AVFilterContext *ctx)
 {
     DrawTextContext *s = ctx->priv;
     uint32_t code = 0, prev_code = 0;
-    int x = 0, y = 0, i = 0, ret;
+    int x = 0, y = 0, i, n, start, ret;
     int text_height, baseline;
     char *text;
     uint8_t *p;
@@ -569,42 +710,69 @@ static int dtext_prepare_text(AVFilterContext *ctx)
 
     text = s->expanded_text ? s->expanded_text : s->text;
 
-    if ((len = strlen(text)) > s->nb_positions) {
-        FT_Vector *p = av_realloc(s->positions,
-                                  len * sizeof(*s->positions));
-        if (!p) {
-            av_freep(s->positions);
-            s->nb_positions = 0;
-            return AVERROR(ENOMEM);
-        } else {
-            s->positions = p;
-            s->nb_positions = len;
-        }
+    if (s->layout_text && !strcmp(text, s->layout_text))
+        return 0;
+
+    if ((len = strlen(text)) > s->chars_size) {
+        if ((ret = av_reallocp_array(&s->chars, len, sizeof(*s->chars))) < 0 ||
+            (ret = av_reallocp_array(&s->prev_chars, len, sizeof(*s->prev_chars))) < 0)
+            goto fail;
+        s->chars_size = len;
     }
 
-    /* load and cache glyphs */
-    for (i = 0, p = text; *p; i++) {
+    FFSWAP(TextChar *, s->chars, s->prev_chars);
+    s->nb_prev_chars = s->nb_chars;
+    s->nb_chars      = 0;
+
+    /* load and cache glyphs, reusing the unchanged beginning of the text */
+    for (n = 0, start = 0, p = text; *p; ) {
+        TextChar *c = &s->chars[n];
+
         GET_UTF8(code, *p++, continue;);
 
-        /* get glyph */
-        dummy.code = code;
-        glyph = av_tree_find(s->glyphs, &dummy, glyph_cmp, NULL);
-        if (!glyph) {
-            ret = load_glyph(ctx, &glyph, code);
-            if (ret)
-                return ret;
+        if (n == start && n < s->nb_prev_chars && s->prev_chars[n].code == code) {
+            *c = s->prev_chars[n];
+            start++;
+        } else {
+            c->code    = code;
+            dummy.code = code;
+            c->glyph   = av_tree_find(s->glyphs, &dummy, glyph_cmp, NULL);
+            if (!c->glyph && (ret = load_glyph(ctx, &c->glyph, code)) < 0)
+                goto fail;
         }
 
-        y_min = FFMIN(glyph->bbox.yMin, y_min);
-        y_max = FFMAX(glyph->bbox.yMax, y_max);
+        y_min = FFMIN(c->glyph->bbox.yMin, y_min);
+        y_max = FFMAX(c->glyph->bbox.yMax, y_max);
+        n++;
     }
+    if (!n)
+        y_min = y_max = 0;
     text_height = y_max - y_min;
     baseline    = y_max;
 
-    /* compute and save position for each glyph */
-    glyph = NULL;
-    for (i = 0, p = text; *p; i++) {
-        GET_UTF8(code, *p++, continue;);
+    if (text_height != s->text_height || baseline != s->baseline)
+        start = 0;
+
+    /* compute and save position for each glyph, starting again from the
+     * character before the first change, which may be the \r of a \r\n */
+    i = FFMAX(start - 1, 0);
+    if (i) {
+        x         = s->chars[i].pen_x;
+        y         = s->chars[i].pen_y;
+        str_w     = s->chars[i].str_w;
+        prev_code = s->chars[i].prev_code;
+        glyph     = s->chars[i].prev_glyph;
+    }
+    for (; i < n; i++) {
+        TextChar *c = &s->chars[i];
+
+        c->pen_x      = x;
+        c->pen_y      = y;
+        c->str_w      = str_w;
+        c->prev_code  = prev_code;
+        c->prev_glyph = glyph;
+        c->draw       = 0;
+        code          = c->code;
 
         /* skip the \n in the sequence \r\n */
         if (prev_code == '\r' && code == '\n')
@@ -612,16 +780,14 @@ static int dtext_prepare_text(AVFilterContext *ctx)
 
         prev_code = code;
         if (is_newline(code)) {
-            str_w = FFMAX(str_w, x - s->x);
+            str_w = FFMAX(str_w, x);
             y += text_height;
             x = 0;
             continue;
         }
 
-        /* get glyph */
         prev_glyph = glyph;
-        dummy.code = code;
-        glyph = av_tree_find(s->glyphs, &dummy, glyph_cmp, NULL);
+        glyph      = c->glyph;
 
         /* kerning */
         if (s->use_kerning && prev_glyph && glyph->code) {
@@ -637,8 +803,9 @@ static int dtext_prepare_text(AVFilterContext *ctx)
         }
 
         /* save position */
-        s->positions[i].x = x + glyph->bitmap_left;
-        s->positions[i].y = y - glyph->bitmap_top + baseline;
+        c->x    = x + glyph->bitmap_left;
+        c->y    = y - glyph->bitmap_top + baseline;
+        c->draw = code != '\t';
         if (code == '\t') x  = (x / s->tabsize + 1)*s->tabsize;
         else              x += glyph->advance;
     }
@@ -646,12 +813,47 @@ static int dtext_prepare_text(AVFilterContext *ctx)
     str_w = FFMIN(width - 1, FFMAX(str_w, x));
     y     = FFMIN(y + text_height, height - 1);
 
+    /* mark what changed since the previous layout for redraw */
+    for (i = FFMAX(start - 1, 0); i < FFMAX(n, s->nb_prev_chars); i++) {
+        const TextChar *c = i < n                ? &s->chars[i]      : NULL;
+        const TextChar *o = i < s->nb_prev_chars ? &s->prev_chars[i] : NULL;
+
+        if (c && o && c->draw == o->draw && c->glyph == o->glyph &&
+            c->x == o->x && c->y == o->y)
+            continue;
+        if (c)
+            dirty_add_char(s, c);
+        if (o)
+            dirty_add_char(s, o);
+    }
+    if (s->draw_box && (str_w != s->w || y != s->h))
+        dirty_add_rect(s, 0, 0, FFMAX(str_w, s->w), FFMAX(y, s->h));
+
+    s->nb_chars    = n;
+    s->text_height = text_height;
+    s->baseline    = baseline;
+
+    av_free(s->layout_text);
+    if (!(s->layout_text = av_strdup(text)))
+        return AVERROR(ENOMEM);
+
     s->w = str_w;
     s->var_values[VAR_TEXT_W] = s->var_values[VAR_TW] = s->w;
     s->h = y;
     s->var_values[VAR_TEXT_H] = s->var_values[VAR_TH] = s->h;
 
     return 0;
+
+fail:
+    /* start again from scratch on the next frame */
+    s->nb_chars = s->nb_prev_chars = 0;
+    av_freep(&s->layout_text);
+    if (ret == AVERROR(ENOMEM)) {
+        av_freep(&s->chars);
+        av_freep(&s->prev_chars);
+        s->chars_size = 0;
+    }
+    return ret;
 }
 
 
@@ -683,7 +885,8 @@ static int config_input(AVFilterLink *inlink)
     av_expr_free(s->x_pexpr);
     av_expr_free(s->y_pexpr);
     av_expr_free(s->d_pexpr);
-    s->x_pexpr = s->y_pexpr = s->d_pexpr = NULL;
+    av_expr_free(s->a_pexpr);
+    s->x_pexpr = s->y_pexpr = s->d_pexpr = s->a_pexpr = NULL;
     if ((ret = av_expr_parse(&s->x_pexpr, s->x_expr, var_names,
                              NULL, NULL, fun2_names, fun2, 0, ctx)) < 0 ||
         (ret = av_expr_parse(&s->y_pexpr, s->y_expr, var_names,
@@ -714,180 +917,427 @@ static int config_input(AVFilterLink *inlink)
         s->shadowcolor[3] = rgba[3];
     }
 
+    /* lay out and render everything again */
+    av_freep(&s->layout_text);
+    s->nb_chars = 0;
+    s->canvas_x = s->canvas_y = s->canvas_w = s->canvas_h = 0;
+    dirty_reset(s);
+
     s->draw = 1;
 
     return dtext_prepare_text(ctx);
 }
 
-#define GET_BITMAP_VAL(r, c)                                            \
-    bitmap->pixel_mode == FT_PIXEL_MODE_MONO ?                          \
-        (bitmap->buffer[(r) * bitmap->pitch + ((c)>>3)] & (0x80 >> ((c)&7))) * 255 : \
-         bitmap->buffer[(r) * bitmap->pitch +  (c)]
-
-#define SET_PIXEL_YUV(frame, yuva_color, val, x, y, hsub, vsub) {           \
-    luma_pos    = ((x)          ) + ((y)          ) * frame->linesize[0]; \
-    alpha = yuva_color[3] * alpha_mul * (val) * 129 / 255; \
-    frame->data[0][luma_pos]    = (alpha * yuva_color[0] + (255*255*129 - alpha) * frame->data[0][luma_pos]   ) >> 23; \
-    if (((x) & ((1<<(hsub)) - 1)) == 0 && ((y) & ((1<<(vsub)) - 1)) == 0) {\
-        chroma_pos1 = ((x) >> (hsub)) + ((y) >> (vsub)) * frame->linesize[1]; \
-        chroma_pos2 = ((x) >> (hsub)) + ((y) >> (vsub)) * frame->linesize[2]; \
-        frame->data[1][chroma_pos1] = (alpha * yuva_color[1] + (255*255*129 - alpha) * frame->data[1][chroma_pos1]) >> 23; \
-        frame->data[2][chroma_pos2] = (alpha * yuva_color[2] + (255*255*129 - alpha) * frame->data[2][chroma_pos2]) >> 23; \
-    }\
-}
+/* x / 255 rounded to nearest */
+#define DIV255(x) ((((x) + 128) + (((x) + 128) >> 8)) >> 8)
 
-static inline int draw_glyph_yuv(AVFrame *frame, FT_Bitmap *bitmap, unsigned int x,
-                                 unsigned int y, unsigned int width, unsigned int height,
-                                 const uint8_t yuva_color[4], int hsub, int vsub,
-                                 int alpha_mul)
+/* number of pixels composited on the canvas at once */
+#define ROW_CHUNK 256
+
+/**
+ * Composite n pixels of coverage with the given color on the row y of the
+ * canvas, starting at column x. The color is YUVA, or RGBA for packed RGB
+ * formats, its alpha is scaled by alpha_mul / 255.
+ */
+static void composite_row(DrawTextContext *s, int x, int y,
+                          const uint8_t *coverage, int n,
+                          const uint8_t color[4], int alpha_mul)
 {
-    int r, c, alpha;
-    unsigned int luma_pos, chroma_pos1, chroma_pos2;
-    uint8_t src_val;
-
-    for (r = 0; r < bitmap->rows && r+y < height; r++) {
-        for (c = 0; c < bitmap->width && c+x < width; c++) {
-            /* get intensity value in the glyph bitmap (source) */
-            src_val = GET_BITMAP_VAL(r, c);
-            if (!src_val)
-                continue;
-
-            SET_PIXEL_YUV(frame, yuva_color, src_val, c+x, y+r, hsub, vsub);
+    LOCAL_ALIGNED_32(uint8_t, alpha, [ROW_CHUNK]);
+    LOCAL_ALIGNED_32(uint8_t, src,   [ROW_CHUNK * 4]);
+    int hmask = (1 << s->hsub) - 1;
+    int k = color[3] * alpha_mul;
+    int i, j, m, len;
+
+    for (; n > 0; n -= len, x += len, coverage += len) {
+        len = FFMIN(n, ROW_CHUNK);
+
+        for (i = 0; i < len; i++)
+            alpha[i] = (coverage[i] * k + 255 * 255 / 2) / (255 * 255);
+
+        if (s->is_packed_rgb) {
+            uint8_t *dst = s->canvas[0] + y * s->canvas_linesize[0] + x * 4;
+
+            for (i = 0; i < len; i++) {
+                for (j = 0; j < 3; j++)
+                    src[4 * i + j] = DIV255(color[j] * alpha[i]);
+                src[4 * i + 3] = alpha[i];
+            }
+            s->dsp.blend_rgba_premult(dst, src, len);
+            continue;
+        }
+
+        for (i = 0; i < len; i++)
+            src[i] = DIV255(color[0] * alpha[i]);
+        s->dsp.blend_row_premult(s->canvas[CANVAS_LUMA] +
+                                 y * s->canvas_linesize[CANVAS_LUMA] + x,
+                                 src, alpha, len);
+        s->dsp.blend_row_premult(s->canvas[CANVAS_ALPHA] +
+                                 y * s->canvas_linesize[CANVAS_ALPHA] + x,
+                                 alpha, alpha, len);
+
+        /* chroma is point sampled at the top left of each block */
+        if (y & ((1 << s->vsub) - 1))
+            continue;
+        for (i = -x & hmask, m = 0; i < len; i += 1 << s->hsub, m++) {
+            src[ROW_CHUNK     + m] = 128 + DIV255((color[1] - 128) * alpha[i]);
+            src[ROW_CHUNK * 2 + m] = 128 + DIV255((color[2] - 128) * alpha[i]);
+            src[ROW_CHUNK * 3 + m] = alpha[i];
+        }
+        if (m) {
+            int off = (x + hmask) >> s->hsub;
+            int row = y >> s->vsub;
+
+            for (j = 0; j < 2; j++)
+                s->dsp.blend_row_premult_chroma(s->canvas[CANVAS_U + j] +
+                                                row * s->canvas_linesize[CANVAS_U + j] + off,
+                                                src + ROW_CHUNK * (j + 1),
+                                                src + ROW_CHUNK * 3, m);
+            s->dsp.blend_row_premult(s->canvas[CANVAS_CHROMA_ALPHA] +
+                                     row * s->canvas_linesize[CANVAS_CHROMA_ALPHA] + off,
+                                     src + ROW_CHUNK * 3, src + ROW_CHUNK * 3, m);
         }
     }
+}
 
-    return 0;
+/**
+ * Composite the glyphs offset by dx, dy with the given color, clipped to
+ * the area x0, y0, x1, y1 of the canvas.
+ */
+static void composite_glyphs(DrawTextContext *s, const uint8_t color[4],
+                             int dx, int dy, int x0, int y0, int x1, int y1)
+{
+    int i, r;
+
+    for (i = 0; i < s->nb_chars; i++) {
+        const TextChar *c = &s->chars[i];
+        const Glyph *glyph = c->glyph;
+        int gx, gy, c0, c1, r1;
+
+        if (!c->draw || !glyph->coverage)
+            continue;
+
+        gx = c->x + dx - s->canvas_x;
+        gy = c->y + dy - s->canvas_y;
+        c0 = FFMAX(x0 - gx, 0);
+        c1 = FFMIN(x1 - gx, glyph->width);
+        r1 = FFMIN(y1 - gy, glyph->height);
+        if (c0 >= c1)
+            continue;
+
+        for (r = FFMAX(y0 - gy, 0); r < r1; r++)
+            composite_row(s, gx + c0, gy + r,
+                          glyph->coverage + r * glyph->width + c0, c1 - c0,
+                          color, s->alpha);
+    }
 }
 
-#define SET_PIXEL_RGB(frame, rgba_color, val, x, y, pixel_step, r_off, g_off, b_off, a_off) { \
-    p   = frame->data[0] + (x) * pixel_step + ((y) * frame->linesize[0]); \
-    alpha = rgba_color[3] * alpha_mul * (val) * 129 / 255;                           \
-    *(p+r_off) = (alpha * rgba_color[0] + (255*255*129 - alpha) * *(p+r_off)) >> 23; \
-    *(p+g_off) = (alpha * rgba_color[1] + (255*255*129 - alpha) * *(p+g_off)) >> 23; \
-    *(p+b_off) = (alpha * rgba_color[2] + (255*255*129 - alpha) * *(p+b_off)) >> 23; \
+/**
+ * Find the part of a row of alpha values which is not fully transparent.
+ */
+static Span alpha_span(const uint8_t *alpha, int w, int step)
+{
+    Span span = { 0, w };
+
+    while (span.start < span.end && !alpha[span.start * step])
+        span.start++;
+    while (span.end > span.start && !alpha[(span.end - 1) * step])
+        span.end--;
+
+    return span;
 }
 
-static inline int draw_glyph_rgb(AVFrame *frame, FT_Bitmap *bitmap,
-                                 unsigned int x, unsigned int y,
-                                 unsigned int width, unsigned int height, int pixel_step,
-                                 const uint8_t rgba_color[4], const uint8_t rgba_map[4],
-                                 int alpha_mul)
+/**
+ * Compute the area covered by the box and by the glyphs with their shadow,
+ * relative to the text and aligned to the chroma subsampling.
+ */
+static void canvas_bounds(DrawTextContext *s, int bounds[4])
 {
-    int r, c, alpha;
-    uint8_t *p;
-    uint8_t src_val;
+    int i;
+
+    bounds[0] = bounds[1] = INT_MAX;
+    bounds[2] = bounds[3] = INT_MIN;
+
+    if (s->draw_box) {
+        bounds[0] = bounds[1] = 0;
+        bounds[2] = s->w;
+        bounds[3] = s->h;
+    }
+
+    for (i = 0; i < s->nb_chars; i++) {
+        const TextChar *c = &s->chars[i];
+        int x0 = c->x, y0 = c->y, x1, y1;
 
-    for (r = 0; r < bitmap->rows && r+y < height; r++) {
-        for (c = 0; c < bitmap->width && c+x < width; c++) {
-            /* get intensity value in the glyph bitmap (source) */
-            src_val = GET_BITMAP_VAL(r, c);
-            if (!src_val)
-                continue;
+        if (!c->draw || !c->glyph->coverage)
+            continue;
 
-            SET_PIXEL_RGB(frame, rgba_color, src_val, c+x, y+r, pixel_step,
-                          rgba_map[0], rgba_map[1], rgba_map[2], rgba_map[3]);
+        x1 = x0 + c->glyph->width;
+        y1 = y0 + c->glyph->height;
+        if (s->shadowx || s->shadowy) {
+            x0 = FFMIN(x0, x0 + s->shadowx);
+            y0 = FFMIN(y0, y0 + s->shadowy);
+            x1 = FFMAX(x1, x1 + s->shadowx);
+            y1 = FFMAX(y1, y1 + s->shadowy);
         }
+        bounds[0] = FFMIN(bounds[0], x0);
+        bounds[1] = FFMIN(bounds[1], y0);
+        bounds[2] = FFMAX(bounds[2], x1);
+        bounds[3] = FFMAX(bounds[3], y1);
     }
 
+    if (bounds[0] >= bounds[2] || bounds[1] >= bounds[3]) {
+        bounds[0] = bounds[1] = bounds[2] = bounds[3] = 0;
+        return;
+    }
+
+    bounds[0] &= ~((1 << s->hsub) - 1);
+    bounds[1] &= ~((1 << s->vsub) - 1);
+    bounds[2]  = FFALIGN(bounds[2], 1 << s->hsub);
+    bounds[3]  = FFALIGN(bounds[3], 1 << s->vsub);
+}
+
+static int canvas_alloc(DrawTextContext *s, const int bounds[4])
+{
+    int w = bounds[2] - bounds[0];
+    int h = bounds[3] - bounds[1];
+    int i;
+
+    for (i = 0; i < CANVAS_NB_PLANES; i++)
+        av_freep(&s->canvas[i]);
+    av_freep(&s->canvas_span[0]);
+    av_freep(&s->canvas_span[1]);
+
+    s->canvas_x = bounds[0];
+    s->canvas_y = bounds[1];
+    s->canvas_w = w;
+    s->canvas_h = h;
+
+    if (!w || !h)
+        return 0;
+
+    if (s->is_packed_rgb) {
+        s->canvas_linesize[0] = FFALIGN(w * 4, 32);
+        s->canvas[0] = av_malloc(s->canvas_linesize[0] * h);
+        if (!s->canvas[0])
+            goto fail;
+    } else {
+        for (i = 0; i < CANVAS_NB_PLANES; i++) {
+            int chroma = i == CANVAS_U || i == CANVAS_V ||
+                         i == CANVAS_CHROMA_ALPHA;
+
+            s->canvas_linesize[i] = FFALIGN(chroma ? w >> s->hsub : w, 32);
+            s->canvas[i] = av_malloc(s->canvas_linesize[i] *
+                                     (chroma ? h >> s->vsub : h));
+            if (!s->canvas[i])
+                goto fail;
+        }
+        s->canvas_span[1] = av_malloc_array(h >> s->vsub, sizeof(*s->canvas_span[1]));
+        if (!s->canvas_span[1])
+            goto fail;
+    }
+    s->canvas_span[0] = av_malloc_array(h, sizeof(*s->canvas_span[0]));
+    if (!s->canvas_span[0])
+        goto fail;
+
     return 0;
+
+fail:
+    for (i = 0; i < CANVAS_NB_PLANES; i++)
+        av_freep(&s->canvas[i]);
+    av_freep(&s->canvas_span[0]);
+    av_freep(&s->canvas_span[1]);
+    s->canvas_w = s->canvas_h = 0;
+    return AVERROR(ENOMEM);
 }
 
-static inline void drawbox(AVFrame *frame, unsigned int x, unsigned int y,
-                           unsigned int width, unsigned int height,
-                           uint8_t *line[4], int pixel_step[4], uint8_t color[4],
-                           int hsub, int vsub, int is_rgba_packed, uint8_t rgba_map[4],
-                           int alpha_mul)
+/**
+ * Render again the area x0, y0, x1, y1 of the canvas, relative to the text.
+ */
+static void canvas_render(DrawTextContext *s, int x0, int y0, int x1, int y1)
 {
-    int i, j, alpha;
-
-    if (color[3] != 0xFF || alpha_mul != 0xFF) {
-        if (is_rgba_packed) {
-            uint8_t *p;
-            for (j = 0; j < height; j++)
-                for (i = 0; i < width; i++)
-                    SET_PIXEL_RGB(frame, color, 255, i+x, y+j, pixel_step[0],
-                                  rgba_map[0], rgba_map[1], rgba_map[2], rgba_map[3]);
-        } else {
-            unsigned int luma_pos, chroma_pos1, chroma_pos2;
-            for (j = 0; j < height; j++)
-                for (i = 0; i < width; i++)
-                    SET_PIXEL_YUV(frame, color, 255, i+x, y+j, hsub, vsub);
+    uint8_t opaque[ROW_CHUNK];
+    int hsub = s->hsub, vsub = s->vsub;
+    int x, y, i;
+
+    /* to canvas coordinates, aligned to the chroma subsampling */
+    x0 = FFMAX(x0 - s->canvas_x, 0) & ~((1 << hsub) - 1);
+    y0 = FFMAX(y0 - s->canvas_y, 0) & ~((1 << vsub) - 1);
+    x1 = FFMIN(FFALIGN(x1 - s->canvas_x, 1 << hsub), s->canvas_w);
+    y1 = FFMIN(FFALIGN(y1 - s->canvas_y, 1 << vsub), s->canvas_h);
+    if (x0 >= x1 || y0 >= y1)
+        return;
+
+    for (y = y0; y < y1; y++) {
+        if (s->is_packed_rgb) {
+            memset(s->canvas[0] + y * s->canvas_linesize[0] + x0 * 4,
+                   0, (x1 - x0) * 4);
+            continue;
         }
-    } else {
-        ff_draw_rectangle(frame->data, frame->linesize,
-                          line, pixel_step, hsub, vsub,
-                          x, y, width, height);
+        memset(s->canvas[CANVAS_LUMA] + y * s->canvas_linesize[CANVAS_LUMA] + x0,
+               0, x1 - x0);
+        memset(s->canvas[CANVAS_ALPHA] + y * s->canvas_linesize[CANVAS_ALPHA] + x0,
+               0, x1 - x0);
+        if (y & ((1 << vsub) - 1))
+            continue;
+        for (i = 0; i < 3; i++) {
+            int plane = i < 2 ? CANVAS_U + i : CANVAS_CHROMA_ALPHA;
+
+            memset(s->canvas[plane] + (y >> vsub) * s->canvas_linesize[plane] + (x0 >> hsub),
+                   i < 2 ? 128 : 0, (x1 - x0) >> hsub);
+        }
+    }
+
+    if (s->draw_box) {
+        const uint8_t *color = s->is_packed_rgb ? s->boxcolor_rgba : s->boxcolor;
+        int bx0 = FFMAX(x0, -s->canvas_x);
+        int by0 = FFMAX(y0, -s->canvas_y);
+        int bx1 = FFMIN(x1, s->w - s->canvas_x);
+        int by1 = FFMIN(y1, s->h - s->canvas_y);
+
+        memset(opaque, 255, sizeof(opaque));
+        for (y = by0; y < by1; y++)
+            for (x = bx0; x < bx1; x += ROW_CHUNK)
+                composite_row(s, x, y, opaque, FFMIN(bx1 - x, ROW_CHUNK),
+                              color, s->alpha);
     }
+
+    if (s->shadowx || s->shadowy)
+        composite_glyphs(s, s->is_packed_rgb ? s->shadowcolor_rgba : s->shadowcolor,
+                         s->shadowx, s->shadowy, x0, y0, x1, y1);
+    composite_glyphs(s, s->is_packed_rgb ? s->fontcolor_rgba : s->fontcolor,
+                     0, 0, x0, y0, x1, y1);
+
+    for (y = y0; y < y1; y++) {
+        if (s->is_packed_rgb)
+            s->canvas_span[0][y] =
+                alpha_span(s->canvas[0] + y * s->canvas_linesize[0] + 3,
+                           s->canvas_w, 4);
+        else
+            s->canvas_span[0][y] =
+                alpha_span(s->canvas[CANVAS_ALPHA] + y * s->canvas_linesize[CANVAS_ALPHA],
+                           s->canvas_w, 1);
+    }
+    if (!s->is_packed_rgb)
+        for (y = y0 >> vsub; y < y1 >> vsub; y++)
+            s->canvas_span[1][y] =
+                alpha_span(s->canvas[CANVAS_CHROMA_ALPHA] +
+                           y * s->canvas_linesize[CANVAS_CHROMA_ALPHA],
+                           s->canvas_w >> hsub, 1);
 }
 
-static int draw_glyphs(DrawTextContext *s, AVFrame *frame,
-                       int width, int height,
-                       const uint8_t rgbcolor[4], const uint8_t yuvcolor[4],
-                       int x, int y)
+/**
+ * Blend n premultiplied RGBA pixels of the canvas on a packed RGB row.
+ */
+static void blit_packed(DrawTextContext *s, uint8_t *dst, const uint8_t *src,
+                        int n)
 {
-    char *text = s->expanded_text;
-    uint32_t code = 0;
-    int i;
-    uint8_t *p;
-    Glyph *glyph = NULL;
+    int step = s->pixel_step[0];
+    int i, j;
 
-    for (i = 0, p = text; *p; i++) {
-        Glyph dummy = { 0 };
-        GET_UTF8(code, *p++, continue;);
+    if (step == 4 && s->rgba_map[0] == 0 && s->rgba_map[1] == 1 &&
+        s->rgba_map[2] == 2 && s->rgba_map[3] == 3) {
+        s->dsp.blend_rgba_premult(dst, src, n);
+        return;
+    }
+
+    for (i = 0; i < n; i++, dst += step, src += 4) {
+        int a = src[3];
 
-        /* skip new line chars, just go to new line */
-        if (code == '\n' || code == '\r' || code == '\t')
+        if (!a)
             continue;
+        for (j = 0; j < (step == 4 ? 4 : 3); j++) {
+            uint8_t *d = dst + s->rgba_map[j];
+            *d = FFMIN(src[j] + DIV255(*d * (255 - a)), 255);
+        }
+    }
+}
 
-        dummy.code = code;
-        glyph = av_tree_find(s->glyphs, &dummy, glyph_cmp, NULL);
+static void canvas_blit(DrawTextContext *s, AVFrame *frame)
+{
+    int fx = s->x + s->canvas_x;
+    int fy = s->y + s->canvas_y;
+    int y, p;
 
-        if (glyph->bitmap.pixel_mode != FT_PIXEL_MODE_MONO &&
-            glyph->bitmap.pixel_mode != FT_PIXEL_MODE_GRAY)
-            return AVERROR(EINVAL);
+    for (y = FFMAX(-fy, 0); y < FFMIN(s->canvas_h, frame->height - fy); y++) {
+        Span span = s->canvas_span[0][y];
+        int start = FFMAX(span.start, -fx);
+        int end   = FFMIN(span.end, frame->width - fx);
+        uint8_t *dst = frame->data[0] + (fy + y) * frame->linesize[0];
 
-        if (s->is_packed_rgb) {
-            draw_glyph_rgb(frame, &glyph->bitmap,
-                           s->positions[i].x+x, s->positions[i].y+y, width, height,
-                           s->pixel_step[0], rgbcolor, s->rgba_map, s->alpha);
-        } else {
-            draw_glyph_yuv(frame, &glyph->bitmap,
-                           s->positions[i].x+x, s->positions[i].y+y, width, height,
-                           yuvcolor, s->hsub, s->vsub, s->alpha);
-        }
+        if (start >= end)
+            continue;
+
+        if (s->is_packed_rgb)
+            blit_packed(s, dst + (fx + start) * s->pixel_step[0],
+                        s->canvas[0] + y * s->canvas_linesize[0] + start * 4,
+                        end - start);
+        else
+            s->dsp.blend_row_premult(dst + fx + start,
+                                     s->canvas[CANVAS_LUMA] +
+                                     y * s->canvas_linesize[CANVAS_LUMA] + start,
+                                     s->canvas[CANVAS_ALPHA] +
+                                     y * s->canvas_linesize[CANVAS_ALPHA] + start,
+                                     end - start);
     }
 
-    return 0;
+    if (s->is_packed_rgb)
+        return;
+
+    /* the canvas position is aligned to the chroma subsampling */
+    fx >>= s->hsub;
+    fy >>= s->vsub;
+    for (y = FFMAX(-fy, 0);
+         y < FFMIN(s->canvas_h >> s->vsub, AV_CEIL_RSHIFT(frame->height, s->vsub) - fy);
+         y++) {
+        Span span = s->canvas_span[1][y];
+        int start = FFMAX(span.start, -fx);
+        int end   = FFMIN(span.end, AV_CEIL_RSHIFT(frame->width, s->hsub) - fx);
+
+        if (start >= end)
+            continue;
+
+        for (p = 1; p < 3; p++)
+            s->dsp.blend_row_premult_chroma(frame->data[p] + (fy + y) * frame->linesize[p] +
+                                            fx + start,
+                                            s->canvas[p] + y * s->canvas_linesize[p] + start,
+                                            s->canvas[CANVAS_CHROMA_ALPHA] +
+                                            y * s->canvas_linesize[CANVAS_CHROMA_ALPHA] + start,
+                                            end - start);
+    }
 }
 
-static int draw_text(AVFilterContext *ctx, AVFrame *frame,
-                     int width, int height)
+/**
+ * Draw the text on the frame. The box, the shadow and the text are rendered
+ * once on a canvas with premultiplied alpha, only the areas changed by a new
+ * layout are rendered again, and the canvas is then blended on each frame.
+ */
+static int draw_text(AVFilterContext *ctx, AVFrame *frame)
 {
     DrawTextContext *s = ctx->priv;
-    int ret;
+    int bounds[4], ret;
 
-    /* draw box */
-    if (s->draw_box)
-        drawbox(frame, s->x, s->y, s->w, s->h,
-                s->box_line, s->pixel_step, s->boxcolor,
-                s->hsub, s->vsub, s->is_packed_rgb,
-                s->rgba_map, s->alpha);
-
-    if (s->shadowx || s->shadowy) {
-        if ((ret = draw_glyphs(s, frame, width, height,
-                               s->shadowcolor_rgba,
-                               s->shadowcolor,
-                               s->x + s->shadowx,
-                               s->y + s->shadowy)) < 0)
+    canvas_bounds(s, bounds);
+    if (bounds[0] != s->canvas_x || bounds[1] != s->canvas_y ||
+        bounds[2] - bounds[0] != s->canvas_w ||
+        bounds[3] - bounds[1] != s->canvas_h) {
+        if ((ret = canvas_alloc(s, bounds)) < 0)
             return ret;
+        s->canvas_alpha = -1;
     }
+    if (!s->canvas_w || !s->canvas_h)
+        return 0;
 
-    if ((ret = draw_glyphs(s, frame, width, height,
-                           s->fontcolor_rgba,
-                           s->fontcolor,
-                           s->x,
-                           s->y)) < 0)
-        return ret;
+    if (s->alpha != s->canvas_alpha) {
+        s->canvas_alpha = s->alpha;
+        dirty_add_rect(s, s->canvas_x, s->canvas_y,
+                       s->canvas_x + s->canvas_w, s->canvas_y + s->canvas_h);
+    }
+    if (s->dirty[0] < s->dirty[2] && s->dirty[1] < s->dirty[3]) {
+        canvas_render(s, s->dirty[0], s->dirty[1], s->dirty[2], s->dirty[3]);
+        dirty_reset(s);
+    }
+
+    canvas_blit(s, frame);
 
     return 0;
 }
@@ -966,8 +1416,10 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
             (int)s->var_values[VAR_N], s->var_values[VAR_T],
             s->x, s->y, s->x+s->w, s->y+s->h);
 
-    if (s->draw)
-        draw_text(inlink->dst, frame, frame->width, frame->height);
+    if (s->draw && (ret = draw_text(ctx, frame)) < 0) {
+        av_frame_free(&frame);
+        return ret;
+    }
 
     s->var_values[VAR_N] += 1.0;
 
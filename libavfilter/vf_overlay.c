@@ -31,11 +31,14 @@
 #include "libavutil/eval.h"
 #include "libavutil/avstring.h"
 #include "libavutil/avassert.h"
+#include "libavutil/internal.h"
 #include "libavutil/pixdesc.h"
 #include "libavutil/imgutils.h"
 #include "libavutil/mathematics.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "internal.h"
+#include "overlay.h"
 #include "video.h"
 
 static const char *const var_names[] = {
@@ -70,6 +73,22 @@ static const char * const eof_action_str[] = {
     "repeat", "endall", "pass"
 };
 
+enum OverlayFormat {
+    OVERLAY_FORMAT_YUV420,
+    OVERLAY_FORMAT_YUV422,
+    OVERLAY_FORMAT_YUV444,
+    OVERLAY_FORMAT_RGBA,
+    OVERLAY_FORMAT_NB
+};
+
+enum OverlayAlpha {
+    OVERLAY_ALPHA_STRAIGHT,
+    OVERLAY_ALPHA_PREMULTIPLIED,
+};
+
+/* number of chroma alpha samples computed at once */
+#define ALPHA_CHUNK 512
+
 #define MAIN    0
 #define OVERLAY 1
 
@@ -77,12 +96,15 @@ typedef struct OverlayContext {
     const AVClass *class;
     int x, y;                   ///< position of overlaid picture
 
-    int max_plane_step[4];      ///< steps per pixel for each plane
     int hsub, vsub;             ///< chroma subsampling values
 
     char *x_expr, *y_expr;
 
     enum EOFAction eof_action;  ///< action to take on EOF from source
+    enum OverlayFormat format;  ///< pixel format pair used for blending
+    enum OverlayAlpha alpha;    ///< alpha mode of the overlay input
+
+    OverlayDSPContext dsp;
 
     AVFrame *main;
     AVFrame *over_prev, *over_next;
@@ -97,10 +119,26 @@ static av_cold void uninit(AVFilterContext *ctx)
     av_frame_free(&s->over_next);
 }
 
+static av_cold int init(AVFilterContext *ctx)
+{
+    OverlayContext *s = ctx->priv;
+
+    ff_overlay_init(&s->dsp);
+
+    return 0;
+}
+
 static int query_formats(AVFilterContext *ctx)
 {
-    static const enum AVPixelFormat inout_pix_fmts[] = { AV_PIX_FMT_YUV420P,  AV_PIX_FMT_NONE };
-    static const enum AVPixelFormat blend_pix_fmts[] = { AV_PIX_FMT_YUVA420P, AV_PIX_FMT_NONE };
+    static const enum AVPixelFormat main_pix_fmts[OVERLAY_FORMAT_NB] = {
+        AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUV444P, AV_PIX_FMT_RGBA,
+    };
+    static const enum AVPixelFormat overlay_pix_fmts[OVERLAY_FORMAT_NB] = {
+        AV_PIX_FMT_YUVA420P, AV_PIX_FMT_YUVA422P, AV_PIX_FMT_YUVA444P, AV_PIX_FMT_RGBA,
+    };
+    OverlayContext *s = ctx->priv;
+    enum AVPixelFormat inout_pix_fmts[] = { main_pix_fmts[s->format],    AV_PIX_FMT_NONE };
+    enum AVPixelFormat blend_pix_fmts[] = { overlay_pix_fmts[s->format], AV_PIX_FMT_NONE };
     AVFilterFormats *inout_formats = ff_make_format_list(inout_pix_fmts);
     AVFilterFormats *blend_formats = ff_make_format_list(blend_pix_fmts);
 
@@ -116,7 +154,6 @@ static int config_input_main(AVFilterLink *inlink)
     OverlayContext *s = inlink->dst->priv;
     const AVPixFmtDescriptor *pix_desc = av_pix_fmt_desc_get(inlink->format);
 
-    av_image_fill_max_pixsteps(s->max_plane_step, NULL, pix_desc);
     s->hsub = pix_desc->log2_chroma_w;
     s->vsub = pix_desc->log2_chroma_h;
 
@@ -195,79 +232,181 @@ static int config_output(AVFilterLink *outlink)
     return 0;
 }
 
+typedef struct ThreadData {
+    AVFrame *dst;
+    const AVFrame *src;
+    int x, y, w, h;             ///< overlay area within dst
+} ThreadData;
+
+/**
+ * Find the range [*start, *end) of a row outside of which all the alpha
+ * values are zero, step is the distance between two alpha values.
+ */
+static void alpha_span(const uint8_t *a, int w, int step, int *start, int *end)
+{
+    int i = 0, j = w;
+
+    while (i < w && !a[i * step])
+        i++;
+    while (j > i && !a[(j - 1) * step])
+        j--;
+
+    *start = i;
+    *end   = j;
+}
+
+/**
+ * Average the alpha of the luma samples covered by the chroma samples
+ * [k, k + n) of chroma row j.
+ */
+static void chroma_alpha(const OverlayContext *s, uint8_t *dst,
+                         const uint8_t *a, ptrdiff_t stride,
+                         int k, int n, int wp, int last_row)
+{
+    int hsub = s->hsub;
+    int vsub = s->vsub && !last_row;
+    int i;
+
+    for (i = 0; i < n; i++, k++) {
+        const uint8_t *p = a + (k << hsub);
+        int alpha_h = hsub && k + 1 < wp ? (p[0] + p[1])      >> 1 : p[0];
+        int alpha_v = vsub               ? (p[0] + p[stride]) >> 1 : p[0];
+
+        if (hsub && vsub && k + 1 < wp)
+            dst[i] = (p[0] + p[stride] + p[1] + p[stride + 1]) >> 2;
+        else if (s->hsub || s->vsub)
+            dst[i] = (alpha_v + alpha_h) >> 1;
+        else
+            dst[i] = p[0];
+    }
+}
+
+static int blend_slice_yuv(AVFilterContext *ctx, void *arg, int jobnr,
+                           int nb_jobs)
+{
+    OverlayContext *s = ctx->priv;
+    ThreadData *td    = arg;
+    AVFrame *dst      = td->dst;
+    const AVFrame *src = td->src;
+    int hp            = AV_CEIL_RSHIFT(td->h, s->vsub);
+    int wp            = AV_CEIL_RSHIFT(td->w, s->hsub);
+    int slice_start   = hp *  jobnr      / nb_jobs;
+    int slice_end     = hp * (jobnr + 1) / nb_jobs;
+    void (*blend_luma)(uint8_t *dst, const uint8_t *src,
+                       const uint8_t *alpha, int w);
+    void (*blend_chroma)(uint8_t *dst, const uint8_t *src,
+                         const uint8_t *alpha, int w);
+    LOCAL_ALIGNED_32(uint8_t, alpha, [ALPHA_CHUNK]);
+    int i, j, k, y;
+
+    if (s->alpha == OVERLAY_ALPHA_PREMULTIPLIED) {
+        blend_luma   = s->dsp.blend_row_premult;
+        blend_chroma = s->dsp.blend_row_premult_chroma;
+    } else {
+        blend_luma   = s->dsp.blend_row;
+        blend_chroma = s->dsp.blend_row;
+    }
+
+    for (j = slice_start; j < slice_end; j++) {
+        int y0 = j << s->vsub;
+        int y1 = FFMIN(y0 + (1 << s->vsub), td->h);
+        int x0 = td->w, x1 = 0;
+        int k0, k1;
+
+        for (y = y0; y < y1; y++) {
+            const uint8_t *a = src->data[3] + y * src->linesize[3];
+            int start, end;
+
+            alpha_span(a, td->w, 1, &start, &end);
+            if (start >= end)
+                continue;
+
+            blend_luma(dst->data[0] + (td->y + y) * dst->linesize[0] + td->x + start,
+                       src->data[0] + y * src->linesize[0] + start,
+                       a + start, end - start);
+            x0 = FFMIN(x0, start);
+            x1 = FFMAX(x1, end);
+        }
+
+        /* fully transparent rows */
+        if (x0 >= x1)
+            continue;
+
+        k0 = x0 >> s->hsub;
+        k1 = ((x1 - 1) >> s->hsub) + 1;
+
+        for (k = k0; k < k1; k += ALPHA_CHUNK) {
+            const uint8_t *a = src->data[3] + y0 * src->linesize[3];
+            int n = FFMIN(ALPHA_CHUNK, k1 - k);
+
+            if (s->hsub || s->vsub) {
+                chroma_alpha(s, alpha, a, src->linesize[3], k, n, wp, j + 1 >= hp);
+                a = alpha;
+            } else {
+                a += k;
+            }
+
+            for (i = 1; i < 3; i++)
+                blend_chroma(dst->data[i] + ((td->y >> s->vsub) + j) * dst->linesize[i] +
+                             (td->x >> s->hsub) + k,
+                             src->data[i] + j * src->linesize[i] + k, a, n);
+        }
+    }
+
+    return 0;
+}
+
+static int blend_slice_rgba(AVFilterContext *ctx, void *arg, int jobnr,
+                            int nb_jobs)
+{
+    OverlayContext *s = ctx->priv;
+    ThreadData *td    = arg;
+    int slice_start   = td->h *  jobnr      / nb_jobs;
+    int slice_end     = td->h * (jobnr + 1) / nb_jobs;
+    void (*blend)(uint8_t *dst, const uint8_t *src, int w);
+    int y;
+
+    blend = s->alpha == OVERLAY_ALPHA_PREMULTIPLIED ? s->dsp.blend_rgba_premult :
+                                                      s->dsp.blend_rgba;
+
+    for (y = slice_start; y < slice_end; y++) {
+        const uint8_t *sp = td->src->data[0] + y * td->src->linesize[0];
+        uint8_t *dp       = td->dst->data[0] + (td->y + y) * td->dst->linesize[0] +
+                            td->x * 4;
+        int start, end;
+
+        alpha_span(sp + 3, td->w, 4, &start, &end);
+        if (start < end)
+            blend(dp + start * 4, sp + start * 4, end - start);
+    }
+
+    return 0;
+}
+
 static void blend_frame(AVFilterContext *ctx,
                         AVFrame *dst, AVFrame *src,
                         int x, int y)
 {
     OverlayContext *s = ctx->priv;
-    int i, j, k;
-    int width, height;
-    int overlay_end_y = y + src->height;
-    int end_y, start_y;
-
-    width = FFMIN(dst->width - x, src->width);
-    end_y = FFMIN(dst->height, overlay_end_y);
-    start_y = FFMAX(y, 0);
-    height = end_y - start_y;
-
-    if (dst->format == AV_PIX_FMT_BGR24 || dst->format == AV_PIX_FMT_RGB24) {
-        uint8_t *dp = dst->data[0] + x * 3 + start_y * dst->linesize[0];
-        uint8_t *sp = src->data[0];
-        int b = dst->format == AV_PIX_FMT_BGR24 ? 2 : 0;
-        int r = dst->format == AV_PIX_FMT_BGR24 ? 0 : 2;
-        if (y < 0)
-            sp += -y * src->linesize[0];
-        for (i = 0; i < height; i++) {
-            uint8_t *d = dp, *s = sp;
-            for (j = 0; j < width; j++) {
-                d[r] = (d[r] * (0xff - s[3]) + s[0] * s[3] + 128) >> 8;
-                d[1] = (d[1] * (0xff - s[3]) + s[1] * s[3] + 128) >> 8;
-                d[b] = (d[b] * (0xff - s[3]) + s[2] * s[3] + 128) >> 8;
-                d += 3;
-                s += 4;
-            }
-            dp += dst->linesize[0];
-            sp += src->linesize[0];
-        }
+    ThreadData td;
+    int rows;
+
+    td.dst = dst;
+    td.src = src;
+    td.x   = x;
+    td.y   = y;
+    td.w   = FFMIN(dst->width  - x, src->width);
+    td.h   = FFMIN(dst->height - y, src->height);
+    if (td.w <= 0 || td.h <= 0)
+        return;
+
+    if (s->format == OVERLAY_FORMAT_RGBA) {
+        ctx->internal->execute(ctx, blend_slice_rgba, &td, NULL,
+                               FFMIN(td.h, ctx->graph->nb_threads));
     } else {
-        for (i = 0; i < 3; i++) {
-            int hsub = i ? s->hsub : 0;
-            int vsub = i ? s->vsub : 0;
-            uint8_t *dp = dst->data[i] + (x >> hsub) +
-                (start_y >> vsub) * dst->linesize[i];
-            uint8_t *sp = src->data[i];
-            uint8_t *ap = src->data[3];
-            int wp = FFALIGN(width, 1<<hsub) >> hsub;
-            int hp = FFALIGN(height, 1<<vsub) >> vsub;
-            if (y < 0) {
-                sp += ((-y) >> vsub) * src->linesize[i];
-                ap += -y * src->linesize[3];
-            }
-            for (j = 0; j < hp; j++) {
-                uint8_t *d = dp, *s = sp, *a = ap;
-                for (k = 0; k < wp; k++) {
-                    // average alpha for color components, improve quality
-                    int alpha_v, alpha_h, alpha;
-                    if (hsub && vsub && j+1 < hp && k+1 < wp) {
-                        alpha = (a[0] + a[src->linesize[3]] +
-                                 a[1] + a[src->linesize[3]+1]) >> 2;
-                    } else if (hsub || vsub) {
-                        alpha_h = hsub && k+1 < wp ?
-                            (a[0] + a[1]) >> 1 : a[0];
-                        alpha_v = vsub && j+1 < hp ?
-                            (a[0] + a[src->linesize[3]]) >> 1 : a[0];
-                        alpha = (alpha_v + alpha_h) >> 1;
-                    } else
-                        alpha = a[0];
-                    *d = (*d * (0xff - alpha) + *s++ * alpha + 128) >> 8;
-                    d++;
-                    a += 1 << hsub;
-                }
-                dp += dst->linesize[i];
-                sp += src->linesize[i];
-                ap += (1 << vsub) * src->linesize[3];
-            }
-        }
+        rows = AV_CEIL_RSHIFT(td.h, s->vsub);
+        ctx->internal->execute(ctx, blend_slice_yuv, &td, NULL,
+                               FFMIN(rows, ctx->graph->nb_threads));
     }
 }
 
@@ -376,6 +515,18 @@ static const AVOption options[] = {
         { "repeat", "Repeat the previous frame.",   0, AV_OPT_TYPE_CONST, { .i64 = EOF_ACTION_REPEAT }, .flags = FLAGS, "eof_action" },
         { "endall", "End both streams.",            0, AV_OPT_TYPE_CONST, { .i64 = EOF_ACTION_ENDALL }, .flags = FLAGS, "eof_action" },
         { "pass",   "Pass through the main input.", 0, AV_OPT_TYPE_CONST, { .i64 = EOF_ACTION_PASS },   .flags = FLAGS, "eof_action" },
+    { "format", "Pixel format used for blending.",
+        OFFSET(format), AV_OPT_TYPE_INT, { .i64 = OVERLAY_FORMAT_YUV420 },
+        0, OVERLAY_FORMAT_NB - 1, .flags = FLAGS, "format" },
+        { "yuv420", "yuv420p main, yuva420p overlay.", 0, AV_OPT_TYPE_CONST, { .i64 = OVERLAY_FORMAT_YUV420 }, .flags = FLAGS, "format" },
+        { "yuv422", "yuv422p main, yuva422p overlay.", 0, AV_OPT_TYPE_CONST, { .i64 = OVERLAY_FORMAT_YUV422 }, .flags = FLAGS, "format" },
+        { "yuv444", "yuv444p main, yuva444p overlay.", 0, AV_OPT_TYPE_CONST, { .i64 = OVERLAY_FORMAT_YUV444 }, .flags = FLAGS, "format" },
+        { "rgba",   "rgba main and overlay.",          0, AV_OPT_TYPE_CONST, { .i64 = OVERLAY_FORMAT_RGBA },   .flags = FLAGS, "format" },
+    { "alpha", "Alpha mode of the overlay.",
+        OFFSET(alpha), AV_OPT_TYPE_INT, { .i64 = OVERLAY_ALPHA_STRAIGHT },
+        OVERLAY_ALPHA_STRAIGHT, OVERLAY_ALPHA_PREMULTIPLIED, .flags = FLAGS, "alpha" },
+        { "straight",      "Straight alpha.",      0, AV_OPT_TYPE_CONST, { .i64 = OVERLAY_ALPHA_STRAIGHT },      .flags = FLAGS, "alpha" },
+        { "premultiplied", "Premultiplied alpha.", 0, AV_OPT_TYPE_CONST, { .i64 = OVERLAY_ALPHA_PREMULTIPLIED }, .flags = FLAGS, "alpha" },
     { NULL },
 };
 
@@ -419,6 +570,7 @@ AVFilter ff_vf_overlay = {
     .name      = "overlay",
     .description = NULL_IF_CONFIG_SMALL("Overlay a video source on top of the input."),
 
+    .init      = init,
     .uninit    = uninit,
 
     .priv_size = sizeof(OverlayContext),
@@ -428,4 +580,5 @@ AVFilter ff_vf_overlay = {
 
     .inputs    = avfilter_vf_overlay_inputs,
     .outputs   = avfilter_vf_overlay_outputs,
+    .flags     = AVFILTER_FLAG_SLICE_THREADS,
 };
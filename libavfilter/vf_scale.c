@@ -34,6 +34,7 @@
 #include "libavutil/eval.h"
 #include "libavutil/internal.h"
 #include "libavutil/mathematics.h"
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
 #include "libswscale/swscale.h"
@@ -88,6 +89,13 @@ typedef struct ScaleContext {
     char *w_expr;               ///< width  expression string
     char *h_expr;               ///< height expression string
     char *flags_str;
+
+    /**
+     * Output scaled in advance by a scale filter fed by the same split,
+     * and a reference to its source.
+     */
+    AVFrame *pending;
+    AVFrame *pending_src;
 } ScaleContext;
 
 static av_cold int init(AVFilterContext *ctx)
@@ -112,6 +120,8 @@ static av_cold void uninit(AVFilterContext *ctx)
     ScaleContext *scale = ctx->priv;
     sws_freeContext(scale->sws);
     scale->sws = NULL;
+    av_frame_free(&scale->pending);
+    av_frame_free(&scale->pending_src);
 }
 
 static int query_formats(AVFilterContext *ctx)
@@ -231,6 +241,9 @@ static int config_props(AVFilterLink *outlink)
     scale->input_is_pal = desc->flags & AV_PIX_FMT_FLAG_PAL ||
                           desc->flags & AV_PIX_FMT_FLAG_PSEUDOPAL;
 
+    av_frame_free(&scale->pending);
+    av_frame_free(&scale->pending_src);
+
     if (scale->sws)
         sws_freeContext(scale->sws);
     if (inlink->w == outlink->w && inlink->h == outlink->h &&
@@ -260,12 +273,155 @@ fail:
     return ret;
 }
 
+static AVFrame *alloc_out_frame(AVFilterContext *ctx, const AVFrame *in)
+{
+    AVFilterLink *inlink  = ctx->inputs[0];
+    AVFilterLink *outlink = ctx->outputs[0];
+    AVFrame *out;
+
+    out = ff_get_video_buffer(outlink, outlink->w, outlink->h);
+    if (!out)
+        return NULL;
+
+    av_frame_copy_props(out, in);
+    out->width  = outlink->w;
+    out->height = outlink->h;
+
+    av_reduce(&out->sample_aspect_ratio.num, &out->sample_aspect_ratio.den,
+              (int64_t)in->sample_aspect_ratio.num * outlink->h * inlink->w,
+              (int64_t)in->sample_aspect_ratio.den * outlink->w * inlink->h,
+              INT_MAX);
+
+    return out;
+}
+
+/**
+ * Find the scale filters that the split feeding ctx passes the frame to
+ * after ctx, with the same input. Their contexts are put in filters,
+ * starting with ctx itself.
+ */
+static int find_siblings(AVFilterContext *ctx, const AVFrame *in,
+                         AVFilterContext **filters)
+{
+    AVFilterLink *inlink = ctx->inputs[0];
+    AVFilterContext *split = inlink->src;
+    int i, nb_filters = 1;
+
+    filters[0] = ctx;
+    if (!in->buf[0] || strcmp(split->filter->name, "split"))
+        return nb_filters;
+
+    for (i = 0; i < split->nb_outputs && split->outputs[i] != inlink; i++)
+        ;
+    for (i++; i < split->nb_outputs; i++) {
+        AVFilterLink *link = split->outputs[i];
+        ScaleContext *s;
+
+        if (!link || link->dst->filter != ctx->filter)
+            continue;
+        s = link->dst->priv;
+        if (s->sws && link->w == inlink->w && link->h == inlink->h &&
+            link->format == inlink->format)
+            filters[nb_filters++] = link->dst;
+    }
+
+    return nb_filters;
+}
+
+/**
+ * Scale the source of ctx for the scale filters fed by the same split
+ * at once with sws_scale_multi(), so that it is read and unpacked only
+ * once. The outputs of the other filters are kept until the split passes
+ * them the frame.
+ */
+static int scale_frame(AVFilterContext *ctx, AVFrame *in, AVFrame **out)
+{
+    AVFilterContext **filters;
+    struct SwsContext **sws = NULL;
+    AVFrame **frames = NULL;
+    uint8_t *const **dst = NULL;
+    const int **dst_stride = NULL;
+    int i, nb_filters, ret = 0;
+
+    filters = av_malloc_array(ctx->inputs[0]->src->nb_outputs + 1,
+                              sizeof(*filters));
+    if (!filters)
+        return AVERROR(ENOMEM);
+    nb_filters = find_siblings(ctx, in, filters);
+
+    if (nb_filters == 1) {
+        ScaleContext *scale = ctx->priv;
+
+        av_free(filters);
+        if (!(*out = alloc_out_frame(ctx, in)))
+            return AVERROR(ENOMEM);
+        sws_scale(scale->sws, (const uint8_t *const *)in->data, in->linesize,
+                  0, in->height, (*out)->data, (*out)->linesize);
+        return 0;
+    }
+
+    sws        = av_malloc_array(nb_filters, sizeof(*sws));
+    frames     = av_mallocz_array(nb_filters, sizeof(*frames));
+    dst        = av_malloc_array(nb_filters, sizeof(*dst));
+    dst_stride = av_malloc_array(nb_filters, sizeof(*dst_stride));
+    if (!sws || !frames || !dst || !dst_stride) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    for (i = 0; i < nb_filters; i++) {
+        ScaleContext *s = filters[i]->priv;
+
+        frames[i] = alloc_out_frame(filters[i], in);
+        if (!frames[i]) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        sws[i]        = s->sws;
+        dst[i]        = frames[i]->data;
+        dst_stride[i] = frames[i]->linesize;
+    }
+
+    ret = sws_scale_multi(sws, nb_filters, (const uint8_t *const *)in->data,
+                          in->linesize, 0, in->height, dst, dst_stride);
+    if (ret < 0)
+        goto end;
+
+    for (i = 1; i < nb_filters; i++) {
+        ScaleContext *s = filters[i]->priv;
+
+        av_frame_free(&s->pending);
+        av_frame_free(&s->pending_src);
+        s->pending_src = av_frame_clone(in);
+        if (!s->pending_src) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        s->pending = frames[i];
+        frames[i]  = NULL;
+    }
+    *out      = frames[0];
+    frames[0] = NULL;
+
+end:
+    if (frames)
+        for (i = 0; i < nb_filters; i++)
+            av_frame_free(&frames[i]);
+    av_free(filters);
+    av_free(sws);
+    av_free(frames);
+    av_free(dst);
+    av_free(dst_stride);
+    return ret;
+}
+
 static int filter_frame(AVFilterLink *link, AVFrame *in)
 {
     ScaleContext *scale = link->dst->priv;
     AVFilterLink *outlink = link->dst->outputs[0];
-    AVFrame *out;
+    AVFrame *out = NULL;
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(link->format);
+    int ret;
 
     if (!scale->sws)
         return ff_filter_frame(outlink, in);
@@ -273,23 +429,23 @@ static int filter_frame(AVFilterLink *link, AVFrame *in)
     scale->hsub = desc->log2_chroma_w;
     scale->vsub = desc->log2_chroma_h;
 
-    out = ff_get_video_buffer(outlink, outlink->w, outlink->h);
-    if (!out) {
-        av_frame_free(&in);
-        return AVERROR(ENOMEM);
+    /* already scaled by a filter earlier in the same split */
+    if (scale->pending) {
+        if (in->buf[0] &&
+            in->buf[0]->buffer == scale->pending_src->buf[0]->buffer &&
+            !memcmp(in->data, scale->pending_src->data, sizeof(in->data))) {
+            out = scale->pending;
+            scale->pending = NULL;
+        } else {
+            av_frame_free(&scale->pending);
+        }
+        av_frame_free(&scale->pending_src);
     }
 
-    av_frame_copy_props(out, in);
-    out->width  = outlink->w;
-    out->height = outlink->h;
-
-    av_reduce(&out->sample_aspect_ratio.num, &out->sample_aspect_ratio.den,
-              (int64_t)in->sample_aspect_ratio.num * outlink->h * link->w,
-              (int64_t)in->sample_aspect_ratio.den * outlink->w * link->h,
-              INT_MAX);
-
-    sws_scale(scale->sws, in->data, in->linesize, 0, in->height,
-              out->data, out->linesize);
+    if (!out && (ret = scale_frame(link->dst, in, &out)) < 0) {
+        av_frame_free(&in);
+        return ret;
+    }
 
     av_frame_free(&in);
     return ff_filter_frame(outlink, out);
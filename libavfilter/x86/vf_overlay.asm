@@ -0,0 +1,178 @@
+;*****************************************************************************
+;* x86-optimized functions for overlay filter
+;*
+;* This file is part of Libav.
+;*
+;* Libav is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* Libav is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with Libav; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+pw_128:       times 16 dw 128
+pw_255:       times 16 dw 255
+pb_alpha:     times  8 db 0, 0, 0, 255
+pw_alpha:     times  4 dw 0, 0, 0, 255
+
+SECTION .text
+
+; %1 = x + 128 (in/out), %2 = tmp, %3 = shift instruction
+; %1 = round(x / 255)
+%macro DIV255 3
+    mova       %2, %1
+    %3         %2, 8
+    paddw      %1, %2
+    %3         %1, 8
+%endmacro
+
+; dst = (dst * (255 - alpha) + src * alpha) / 255
+; %1 = dst (in/out), %2 = src (clobbered), %3 = alpha, %4 = tmp, all words
+%macro BLEND_STRAIGHT 4
+    pmullw     %2, %3
+    mova       %4, [pw_255]
+    psubw      %4, %3
+    pmullw     %1, %4
+    paddw      %1, %2
+    paddw      %1, [pw_128]
+    DIV255     %1, %4, psrlw
+%endmacro
+
+; dst = src + dst * (255 - alpha) / 255
+; %1 = dst (in/out), %2 = src, %3 = alpha, %4 = tmp, all words
+%macro BLEND_PREMULT 4
+    mova       %4, [pw_255]
+    psubw      %4, %3
+    pmullw     %1, %4
+    paddw      %1, [pw_128]
+    DIV255     %1, %4, psrlw
+    paddw      %1, %2
+%endmacro
+
+; dst = src + (dst - 128) * (255 - alpha) / 255
+%macro BLEND_PREMULT_CHROMA 4
+    psubw      %1, [pw_128]
+    mova       %4, [pw_255]
+    psubw      %4, %3
+    pmullw     %1, %4
+    paddw      %1, [pw_128]
+    DIV255     %1, %4, psraw
+    paddw      %1, %2
+%endmacro
+
+; void ff_overlay_blend_row(uint8_t *dst, const uint8_t *src,
+;                           const uint8_t *alpha, int w)
+; w is a multiple of mmsize
+; %1 = function suffix, %2 = blend macro
+%macro BLEND_ROW 2
+cglobal overlay_blend_row%1, 4, 5, 8, dst, src, alpha, w
+    movsxdifnidn wq, wd
+    add        dstq, wq
+    add        srcq, wq
+    add      alphaq, wq
+    neg          wq
+    pxor         m7, m7
+
+.loop:
+    movu         m0, [alphaq + wq]
+    mova         m1, m0
+    pcmpeqb      m1, m7
+    pmovmskb    r4d, m1
+    ; skip fully transparent blocks
+    cmp         r4d, (1 << mmsize) - 1
+    je .next
+
+    movu         m2, [dstq + wq]
+    movu         m3, [srcq + wq]
+    punpcklbw    m1, m0, m7
+    punpckhbw    m0, m7
+    punpcklbw    m4, m2, m7
+    punpckhbw    m2, m7
+    punpcklbw    m5, m3, m7
+    punpckhbw    m3, m7
+    %2           m4, m5, m1, m6
+    %2           m2, m3, m0, m6
+    packuswb     m4, m2
+    movu [dstq + wq], m4
+
+.next:
+    add          wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+; void ff_overlay_blend_rgba(uint8_t *dst, const uint8_t *src, int w)
+; w is a multiple of mmsize / 4
+; %1 = function suffix, %2 = blend macro
+%macro BLEND_RGBA 2
+cglobal overlay_blend_rgba%1, 3, 4, 8, dst, src, w
+    movsxdifnidn wq, wd
+    shl          wq, 2
+    add        dstq, wq
+    add        srcq, wq
+    neg          wq
+    pxor         m7, m7
+
+.loop:
+    movu         m0, [srcq + wq]
+    mova         m1, m0
+    pand         m1, [pb_alpha]
+    pcmpeqb      m1, m7
+    pmovmskb    r3d, m1
+    ; skip fully transparent blocks
+    cmp         r3d, (1 << mmsize) - 1
+    je .next
+
+    movu         m2, [dstq + wq]
+    punpcklbw    m1, m0, m7
+    punpckhbw    m0, m7
+    ; broadcast the alpha of each pixel to its 4 components
+    pshuflw      m3, m1, q3333
+    pshufhw      m3, m3, q3333
+    pshuflw      m4, m0, q3333
+    pshufhw      m4, m4, q3333
+%ifidn %1, _premult
+%else
+    ; the alpha of dst is blended with a source value of 255
+    por          m1, [pw_alpha]
+    por          m0, [pw_alpha]
+%endif
+    punpcklbw    m5, m2, m7
+    punpckhbw    m2, m7
+    %2           m5, m1, m3, m6
+    %2           m2, m0, m4, m6
+    packuswb     m5, m2
+    movu [dstq + wq], m5
+
+.next:
+    add          wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+%macro OVERLAY_FUNCS 0
+BLEND_ROW  ,                BLEND_STRAIGHT
+BLEND_ROW  _premult,        BLEND_PREMULT
+BLEND_ROW  _premult_chroma, BLEND_PREMULT_CHROMA
+BLEND_RGBA ,                BLEND_STRAIGHT
+BLEND_RGBA _premult,        BLEND_PREMULT
+%endmacro
+
+INIT_XMM sse2
+OVERLAY_FUNCS
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+OVERLAY_FUNCS
+%endif
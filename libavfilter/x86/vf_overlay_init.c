@@ -0,0 +1,87 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+
+#include "libavfilter/overlay.h"
+
+/* The assembly only handles whole vectors, the remaining pixels of a row
+ * are blended in C. */
+#define BLEND_ROW(name, opt, n)                                               \
+void ff_overlay_ ## name ## _ ## opt(uint8_t *dst, const uint8_t *src,        \
+                                     const uint8_t *alpha, int w);            \
+static void name ## _ ## opt(uint8_t *dst, const uint8_t *src,                \
+                             const uint8_t *alpha, int w)                     \
+{                                                                             \
+    int w_simd = w & ~((n) - 1);                                              \
+                                                                              \
+    if (w_simd)                                                               \
+        ff_overlay_ ## name ## _ ## opt(dst, src, alpha, w_simd);             \
+    if (w > w_simd)                                                           \
+        ff_overlay_ ## name ## _c(dst + w_simd, src + w_simd,                 \
+                                  alpha + w_simd, w - w_simd);                \
+}
+
+#define BLEND_RGBA(name, opt, n)                                              \
+void ff_overlay_ ## name ## _ ## opt(uint8_t *dst, const uint8_t *src,        \
+                                     int w);                                  \
+static void name ## _ ## opt(uint8_t *dst, const uint8_t *src, int w)         \
+{                                                                             \
+    int w_simd = w & ~((n) - 1);                                              \
+                                                                              \
+    if (w_simd)                                                               \
+        ff_overlay_ ## name ## _ ## opt(dst, src, w_simd);                    \
+    if (w > w_simd)                                                           \
+        ff_overlay_ ## name ## _c(dst + 4 * w_simd, src + 4 * w_simd,         \
+                                  w - w_simd);                                \
+}
+
+#define OVERLAY_FUNCS(opt, mmsize)                                            \
+BLEND_ROW(blend_row,                opt, mmsize)                              \
+BLEND_ROW(blend_row_premult,        opt, mmsize)                              \
+BLEND_ROW(blend_row_premult_chroma, opt, mmsize)                              \
+BLEND_RGBA(blend_rgba,              opt, mmsize / 4)                          \
+BLEND_RGBA(blend_rgba_premult,      opt, mmsize / 4)
+
+#define ASSIGN_FUNCS(opt)                                                     \
+    dsp->blend_row                = blend_row_ ## opt;                        \
+    dsp->blend_row_premult        = blend_row_premult_ ## opt;                \
+    dsp->blend_row_premult_chroma = blend_row_premult_chroma_ ## opt;         \
+    dsp->blend_rgba               = blend_rgba_ ## opt;                       \
+    dsp->blend_rgba_premult       = blend_rgba_premult_ ## opt;
+
+#if HAVE_X86ASM
+OVERLAY_FUNCS(sse2, 16)
+OVERLAY_FUNCS(avx2, 32)
+#endif /* HAVE_X86ASM */
+
+av_cold void ff_overlay_init_x86(OverlayDSPContext *dsp)
+{
+#if HAVE_X86ASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        ASSIGN_FUNCS(sse2)
+    }
+    if (EXTERNAL_AVX2(cpu_flags)) {
+        ASSIGN_FUNCS(avx2)
+    }
+#endif /* HAVE_X86ASM */
+}
@@ -0,0 +1,347 @@
+/*
+ * Asynchronous read-ahead protocol
+ *
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Asynchronous read-ahead protocol
+ *
+ * A worker thread reads the nested resource into a ring buffer ahead of
+ * the read position, so that the I/O overlaps with demuxing. Data already
+ * consumed stays in the ring until it is overwritten, so short backward
+ * and forward seeks are served from memory.
+ */
+
+#include "config.h"
+
+#if HAVE_PTHREADS
+#include <pthread.h>
+#elif HAVE_W32THREADS
+#include "compat/w32pthreads.h"
+#endif
+
+#include "libavutil/avstring.h"
+#include "libavutil/common.h"
+#include "libavutil/error.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+
+#include "avformat.h"
+#include "url.h"
+
+#define READ_CHUNK_SIZE 65536
+
+typedef struct AsyncContext {
+    const AVClass *class;
+    URLContext *inner;
+    int buffer_size;
+
+    uint8_t *ring;
+    int read_idx;           ///< ring index of the read position
+    int unread;             ///< bytes available after the read position
+    int retained;           ///< bytes kept before the read position
+    int64_t pos;            ///< logical position of the read position
+    int64_t logical_size;
+
+    int inner_eof;
+    int inner_error;
+
+    int seek_request;
+    int seek_completed;
+    int64_t seek_pos;
+    int64_t seek_ret;
+
+    int abort_request;
+    AVIOInterruptCB interrupt_callback;
+
+    pthread_t worker;
+    int worker_started;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond_main;
+    pthread_cond_t cond_worker;
+} AsyncContext;
+
+static int async_check_interrupt(void *arg)
+{
+    URLContext *h   = arg;
+    AsyncContext *c = h->priv_data;
+
+    if (c->abort_request)
+        return 1;
+
+    return ff_check_interrupt(&c->interrupt_callback);
+}
+
+static void reset_ring(AsyncContext *c, int64_t pos)
+{
+    c->read_idx    = 0;
+    c->unread      = 0;
+    c->retained    = 0;
+    c->pos         = pos;
+    c->inner_eof   = 0;
+    c->inner_error = 0;
+}
+
+static void *async_worker(void *arg)
+{
+    URLContext *h   = arg;
+    AsyncContext *c = h->priv_data;
+
+    pthread_mutex_lock(&c->mutex);
+    while (!c->abort_request) {
+        int write_idx, to_read, ret;
+
+        if (c->seek_request) {
+            int64_t pos = c->seek_pos, seek_ret;
+
+            pthread_mutex_unlock(&c->mutex);
+            seek_ret = ffurl_seek(c->inner, pos, SEEK_SET);
+            pthread_mutex_lock(&c->mutex);
+
+            if (seek_ret >= 0)
+                reset_ring(c, seek_ret);
+            c->seek_ret       = seek_ret;
+            c->seek_request   = 0;
+            c->seek_completed = 1;
+            pthread_cond_signal(&c->cond_main);
+            continue;
+        }
+
+        if (c->inner_eof || c->inner_error || c->unread == c->buffer_size) {
+            pthread_cond_wait(&c->cond_worker, &c->mutex);
+            continue;
+        }
+
+        write_idx = (c->read_idx + c->unread) % c->buffer_size;
+        to_read   = FFMIN(c->buffer_size - c->unread, READ_CHUNK_SIZE);
+        to_read   = FFMIN(to_read, c->buffer_size - write_idx);
+
+        /* Claim the region: the main thread may not seek back into it
+         * while it is being filled. */
+        c->retained = FFMIN(c->retained, c->buffer_size - c->unread - to_read);
+
+        pthread_mutex_unlock(&c->mutex);
+        ret = ffurl_read(c->inner, c->ring + write_idx, to_read);
+        pthread_mutex_lock(&c->mutex);
+
+        if (c->seek_request)
+            continue;
+
+        if (ret > 0)
+            c->unread += ret;
+        else if (!ret || ret == AVERROR_EOF)
+            c->inner_eof = 1;
+        else
+            c->inner_error = ret;
+        pthread_cond_signal(&c->cond_main);
+    }
+    pthread_mutex_unlock(&c->mutex);
+
+    return NULL;
+}
+
+static int async_open(URLContext *h, const char *arg, int flags,
+                      AVDictionary **options)
+{
+    AsyncContext *c = h->priv_data;
+    AVIOInterruptCB cb = { async_check_interrupt, h };
+    int ret;
+
+    av_strstart(arg, "async:", &arg);
+
+    if (flags & AVIO_FLAG_WRITE) {
+        av_log(h, AV_LOG_ERROR, "The async protocol is read-only\n");
+        return AVERROR(ENOSYS);
+    }
+
+    c->ring = av_malloc(c->buffer_size);
+    if (!c->ring)
+        return AVERROR(ENOMEM);
+
+    /* The nested context is polled from the worker thread, interrupt it on
+     * close as well as through the caller callback. */
+    c->interrupt_callback = h->interrupt_callback;
+    ret = ffurl_open(&c->inner, arg, flags, &cb, options, h->protocols, h);
+    if (ret < 0) {
+        av_log(h, AV_LOG_ERROR, "Unable to open resource: %s\n", arg);
+        goto fail;
+    }
+
+    h->is_streamed  = c->inner->is_streamed;
+    c->logical_size = ffurl_size(c->inner);
+    reset_ring(c, 0);
+
+    if ((ret = pthread_mutex_init(&c->mutex, NULL))) {
+        ret = AVERROR(ret);
+        goto fail;
+    }
+    if ((ret = pthread_cond_init(&c->cond_main, NULL))) {
+        ret = AVERROR(ret);
+        goto fail_mutex;
+    }
+    if ((ret = pthread_cond_init(&c->cond_worker, NULL))) {
+        ret = AVERROR(ret);
+        goto fail_cond_main;
+    }
+    if ((ret = pthread_create(&c->worker, NULL, async_worker, h))) {
+        ret = AVERROR(ret);
+        goto fail_cond_worker;
+    }
+    c->worker_started = 1;
+
+    return 0;
+
+fail_cond_worker:
+    pthread_cond_destroy(&c->cond_worker);
+fail_cond_main:
+    pthread_cond_destroy(&c->cond_main);
+fail_mutex:
+    pthread_mutex_destroy(&c->mutex);
+fail:
+    ffurl_close(c->inner);
+    c->inner = NULL;
+    av_freep(&c->ring);
+    return ret;
+}
+
+static int async_close(URLContext *h)
+{
+    AsyncContext *c = h->priv_data;
+
+    if (c->worker_started) {
+        pthread_mutex_lock(&c->mutex);
+        c->abort_request = 1;
+        pthread_cond_signal(&c->cond_worker);
+        pthread_mutex_unlock(&c->mutex);
+
+        pthread_join(c->worker, NULL);
+
+        pthread_cond_destroy(&c->cond_worker);
+        pthread_cond_destroy(&c->cond_main);
+        pthread_mutex_destroy(&c->mutex);
+        c->worker_started = 0;
+    }
+
+    ffurl_close(c->inner);
+    c->inner = NULL;
+    av_freep(&c->ring);
+
+    return 0;
+}
+
+static int async_read(URLContext *h, unsigned char *buf, int size)
+{
+    AsyncContext *c = h->priv_data;
+    int ret;
+
+    pthread_mutex_lock(&c->mutex);
+    while (!c->unread && !c->inner_eof && !c->inner_error)
+        pthread_cond_wait(&c->cond_main, &c->mutex);
+
+    if (c->unread) {
+        int len = FFMIN(size, c->unread);
+        int first = FFMIN(len, c->buffer_size - c->read_idx);
+
+        memcpy(buf, c->ring + c->read_idx, first);
+        memcpy(buf + first, c->ring, len - first);
+
+        c->read_idx  = (c->read_idx + len) % c->buffer_size;
+        c->unread   -= len;
+        c->retained += len;
+        c->pos      += len;
+        ret = len;
+
+        pthread_cond_signal(&c->cond_worker);
+    } else {
+        ret = c->inner_error ? c->inner_error : AVERROR_EOF;
+    }
+    pthread_mutex_unlock(&c->mutex);
+
+    return ret;
+}
+
+static int64_t async_seek(URLContext *h, int64_t pos, int whence)
+{
+    AsyncContext *c = h->priv_data;
+    int64_t ret;
+
+    if (whence == AVSEEK_SIZE)
+        return c->logical_size;
+
+    pthread_mutex_lock(&c->mutex);
+
+    if (whence == SEEK_CUR)
+        pos += c->pos;
+    else if (whence == SEEK_END && c->logical_size >= 0)
+        pos += c->logical_size;
+    else if (whence != SEEK_SET)
+        pos = -1;
+
+    if (pos < 0) {
+        ret = AVERROR(EINVAL);
+    } else if (pos >= c->pos - c->retained && pos <= c->pos + c->unread) {
+        /* inside the window, no I/O needed */
+        int delta = pos - c->pos;
+
+        c->read_idx  = (c->read_idx + delta + c->buffer_size) % c->buffer_size;
+        c->unread   -= delta;
+        c->retained += delta;
+        c->pos       = pos;
+        ret          = pos;
+    } else if (h->is_streamed) {
+        ret = AVERROR(ENOSYS);
+    } else {
+        c->seek_pos       = pos;
+        c->seek_request   = 1;
+        c->seek_completed = 0;
+        pthread_cond_signal(&c->cond_worker);
+        while (!c->seek_completed)
+            pthread_cond_wait(&c->cond_main, &c->mutex);
+        ret = c->seek_ret;
+    }
+
+    pthread_mutex_unlock(&c->mutex);
+
+    return ret;
+}
+
+#define OFFSET(x) offsetof(AsyncContext, x)
+#define D AV_OPT_FLAG_DECODING_PARAM
+static const AVOption options[] = {
+    { "async_buffer_size", "Size of the read-ahead window in bytes", OFFSET(buffer_size),
+      AV_OPT_TYPE_INT, { .i64 = 4 * 1024 * 1024 }, READ_CHUNK_SIZE, INT_MAX / 2, D },
+    { NULL }
+};
+
+static const AVClass async_class = {
+    .class_name = "async",
+    .item_name  = av_default_item_name,
+    .option     = options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
+
+const URLProtocol ff_async_protocol = {
+    .name            = "async",
+    .url_open2       = async_open,
+    .url_read        = async_read,
+    .url_seek        = async_seek,
+    .url_close       = async_close,
+    .priv_data_size  = sizeof(AsyncContext),
+    .priv_data_class = &async_class,
+};
@@ -872,6 +872,17 @@ fail:
     return AVERROR(ENOMEM);
 }
 
+URLContext *ffio_geturlcontext(AVIOContext *s)
+{
+    AVIOInternal *internal;
+
+    if (!s || s->read_packet != io_read_packet)
+        return NULL;
+
+    internal = s->opaque;
+    return internal->h;
+}
+
 int ffio_set_buf_size(AVIOContext *s, int buf_size)
 {
     uint8_t *buffer;
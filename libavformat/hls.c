@@ -32,8 +32,10 @@
 #include "libavutil/dict.h"
 #include "libavutil/time.h"
 #include "avformat.h"
+#include "http.h"
 #include "internal.h"
 #include "avio_internal.h"
+#include "url.h"
 
 #define INITIAL_BUFFER_SIZE 32768
 
@@ -73,6 +75,7 @@ struct variant {
     AVIOContext pb;
     uint8_t* read_buffer;
     AVIOContext *input;
+    int input_read_done;
     AVFormatContext *parent;
     int index;
     AVFormatContext *ctx;
@@ -93,6 +96,7 @@ struct variant {
 };
 
 typedef struct HLSContext {
+    const AVClass *class;
     AVFormatContext *ctx;
     int n_variants;
     struct variant **variants;
@@ -104,6 +108,7 @@ typedef struct HLSContext {
     int seek_flags;
     AVIOInterruptCB *interrupt_callback;
     AVDictionary *avio_opts;
+    int http_persistent;
 } HLSContext;
 
 static int read_chomp_line(AVIOContext *s, char *buf, int maxlen)
@@ -228,6 +233,32 @@ static int open_url(AVFormatContext *s, AVIOContext **pb, const char *url,
     return ret;
 }
 
+static int is_http_input(AVIOContext *pb)
+{
+    URLContext *uc = ffio_geturlcontext(pb);
+
+    return uc && (!strcmp(uc->prot->name, "http") ||
+                  !strcmp(uc->prot->name, "https"));
+}
+
+/* Request the next url on the connection the previous segment was read
+ * from. The whole previous reply must have been consumed. */
+static int open_url_keepalive(AVIOContext *pb, const char *url)
+{
+    int ret;
+
+    if (!is_http_input(pb) ||
+        !ff_http_can_reuse_connection(ffio_geturlcontext(pb), url))
+        return AVERROR(ENOSYS);
+
+    ret = ff_http_do_new_request(ffio_geturlcontext(pb), url);
+    if (ret < 0)
+        return ret;
+    pb->eof_reached = 0;
+
+    return 0;
+}
+
 static int parse_playlist(HLSContext *c, const char *url,
                           struct variant *var, AVIOContext *in)
 {
@@ -362,6 +393,15 @@ static int open_input(struct variant *var)
 {
     HLSContext *c = var->parent->priv_data;
     struct segment *seg = var->segments[var->cur_seq_no - var->start_seq_no];
+
+    var->input_read_done = 0;
+    if (var->input) {
+        if (seg->key_type == KEY_NONE &&
+            open_url_keepalive(var->input, seg->url) >= 0)
+            return 0;
+        ff_format_io_close(var->parent, &var->input);
+    }
+
     if (seg->key_type == KEY_NONE) {
         return open_url(var->parent, &var->input, seg->url, c->avio_opts);
     } else if (seg->key_type == KEY_AES_128) {
@@ -409,7 +449,7 @@ static int read_data(void *opaque, uint8_t *buf, int buf_size)
     int ret, i;
 
 restart:
-    if (!v->input) {
+    if (!v->input || v->input_read_done) {
         /* If this is a live stream and the reload interval has elapsed since
          * the last playlist reload, reload the variant playlists now. */
         int64_t reload_interval = v->n_segments > 0 ?
@@ -451,7 +491,10 @@ reload:
     ret = avio_read(v->input, buf, buf_size);
     if (ret > 0)
         return ret;
-    ff_format_io_close(c->ctx, &v->input);
+    if (c->http_persistent && ret == AVERROR_EOF && is_http_input(v->input))
+        v->input_read_done = 1;
+    else
+        ff_format_io_close(c->ctx, &v->input);
     v->cur_seq_no++;
 
     c->end_of_segment = 1;
@@ -484,6 +527,13 @@ static int save_avio_options(AVFormatContext *s)
 
     while (*opt) {
         if (av_opt_get(s->pb, *opt, AV_OPT_SEARCH_CHILDREN, &buf) >= 0) {
+            /* An empty header string would be sent as a blank line, which
+             * ends the request early on a persistent connection. */
+            if (!*buf) {
+                av_freep(&buf);
+                opt++;
+                continue;
+            }
             ret = av_dict_set(&c->avio_opts, *opt, buf,
                               AV_DICT_DONT_STRDUP_VAL);
             if (ret < 0)
@@ -519,6 +569,10 @@ static int hls_read_header(AVFormatContext *s)
     if ((ret = save_avio_options(s)) < 0)
         goto fail;
 
+    if (c->http_persistent &&
+        (ret = av_dict_set(&c->avio_opts, "multiple_requests", "1", 0)) < 0)
+        goto fail;
+
     if (c->n_variants == 0) {
         av_log(NULL, AV_LOG_WARNING, "Empty playlist\n");
         ret = AVERROR_EOF;
@@ -662,6 +716,7 @@ static int recheck_discard_flags(AVFormatContext *s, int first)
         } else if (first && !v->cur_needed && v->needed) {
             if (v->input)
                 ff_format_io_close(s, &v->input);
+            v->input_read_done = 0;
             v->needed = 0;
             changed = 1;
             av_log(s, AV_LOG_INFO, "No longer receiving variant %d\n", i);
@@ -810,6 +865,7 @@ static int hls_read_seek(AVFormatContext *s, int stream_index,
                       0 : c->first_timestamp;
         if (var->input)
             ff_format_io_close(s, &var->input);
+        var->input_read_done = 0;
         av_packet_unref(&var->pkt);
         reset_packet(&var->pkt);
         var->pb.eof_reached = 0;
@@ -847,10 +903,26 @@ static int hls_probe(AVProbeData *p)
     return 0;
 }
 
+#define OFFSET(x) offsetof(HLSContext, x)
+#define FLAGS AV_OPT_FLAG_DECODING_PARAM
+static const AVOption hls_options[] = {
+    { "http_persistent", "Use persistent HTTP connections to fetch segments",
+      OFFSET(http_persistent), AV_OPT_TYPE_INT, { .i64 = 1 }, 0, 1, FLAGS },
+    { NULL },
+};
+
+static const AVClass hls_class = {
+    .class_name = "hls demuxer",
+    .item_name  = av_default_item_name,
+    .option     = hls_options,
+    .version    = LIBAVUTIL_VERSION_INT,
+};
+
 AVInputFormat ff_hls_demuxer = {
     .name           = "hls,applehttp",
     .long_name      = NULL_IF_CONFIG_SMALL("Apple HTTP Live Streaming"),
     .priv_data_size = sizeof(HLSContext),
+    .priv_class     = &hls_class,
     .read_probe     = hls_probe,
     .read_header    = hls_read_header,
     .read_packet    = hls_read_packet,
@@ -251,6 +251,25 @@ fail:
     return AVERROR(EIO);
 }
 
+int ff_http_can_reuse_connection(URLContext *h, const char *uri)
+{
+    HTTPContext *s = h->priv_data;
+    char hostname1[1024], hostname2[1024], proto1[10], proto2[10];
+    int port1, port2;
+
+    /* The server is about to drop the connection, or the end of the
+     * chunked reply may still be pending. */
+    if (!s->hd || s->willclose || s->chunksize >= 0)
+        return 0;
+
+    av_url_split(proto1, sizeof(proto1), NULL, 0, hostname1, sizeof(hostname1),
+                 &port1, NULL, 0, s->location);
+    av_url_split(proto2, sizeof(proto2), NULL, 0, hostname2, sizeof(hostname2),
+                 &port2, NULL, 0, uri);
+    return !strcmp(proto1, proto2) && !strcmp(hostname1, hostname2) &&
+           port1 == port2;
+}
+
 int ff_http_do_new_request(URLContext *h, const char *uri)
 {
     HTTPContext *s = h->priv_data;
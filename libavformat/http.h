@@ -37,6 +37,19 @@
  */
 void ff_http_init_auth_state(URLContext *dest, const URLContext *src);
 
+/**
+ * Check whether a request for uri can be sent on the current connection
+ * with ff_http_do_new_request(). The connection must still be open, the
+ * server must not have announced that it closes it, the previous reply
+ * must not be chunked and uri must be on the same host and port. The
+ * caller must have read the previous reply to its end.
+ *
+ * @param h pointer to the resource
+ * @param uri uri of the next request
+ * @return 1 if the connection can be reused, 0 otherwise
+ */
+int ff_http_can_reuse_connection(URLContext *h, const char *uri);
+
 /**
  * Send a new HTTP request, reusing the old connection.
  *
@@ -143,6 +143,7 @@ typedef struct MOVStreamContext {
     int64_t track_end;    ///< used for dts generation in fragmented movie files
     unsigned int rap_group_count;
     MOVSbgp *rap_group;
+    int index_pending;    ///< sample tables kept, index not built yet
 
     /** extradata array (and size) for multiple stsd */
     uint8_t **extradata;
@@ -176,6 +177,8 @@ typedef struct MOVContext {
     int export_all;
     int export_xmp;
     int enable_drefs;
+    int lazy_index;
+    int64_t read_position; ///< dts of the last sample read, in AV_TIME_BASE
 
     int32_t movie_display_matrix[3][3]; ///< display matrix from mvhd
 } MOVContext;
@@ -241,6 +241,11 @@ typedef struct MatroskaCluster {
     EbmlList blocks;
 } MatroskaCluster;
 
+typedef struct MatroskaClusterPos {
+    int64_t  pos;
+    uint64_t timecode;
+} MatroskaClusterPos;
+
 typedef struct MatroskaDemuxContext {
     AVFormatContext *ctx;
 
@@ -283,6 +288,11 @@ typedef struct MatroskaDemuxContext {
 
     /* File has SSA subtitles which prevent incremental cluster parsing. */
     int contains_ssa;
+
+    /* Clusters seen so far, sorted by position, used to seek past the index. */
+    MatroskaClusterPos *cluster_index;
+    int nb_cluster_index;
+    unsigned int cluster_index_allocated;
 } MatroskaDemuxContext;
 
 typedef struct MatroskaBlock {
@@ -2700,6 +2710,80 @@ end:
     return res;
 }
 
+static int matroska_add_cluster_pos(MatroskaDemuxContext *matroska,
+                                    int64_t pos, uint64_t timecode)
+{
+    MatroskaClusterPos *clusters = matroska->cluster_index;
+    int lo = 0, hi = matroska->nb_cluster_index;
+
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (clusters[mid].pos < pos)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo < matroska->nb_cluster_index && clusters[lo].pos == pos)
+        return 0;
+
+    if (matroska->nb_cluster_index >= INT_MAX / sizeof(*clusters) - 1)
+        return AVERROR(ENOMEM);
+    clusters = av_fast_realloc(matroska->cluster_index,
+                               &matroska->cluster_index_allocated,
+                               (matroska->nb_cluster_index + 1) * sizeof(*clusters));
+    if (!clusters)
+        return AVERROR(ENOMEM);
+    matroska->cluster_index = clusters;
+
+    memmove(&clusters[lo + 1], &clusters[lo],
+            (matroska->nb_cluster_index - lo) * sizeof(*clusters));
+    clusters[lo].pos      = pos;
+    clusters[lo].timecode = timecode;
+    matroska->nb_cluster_index++;
+    return 0;
+}
+
+/*
+ * Extend the cluster index past timestamp by reading only the header and
+ * the timecode of the clusters following the last known one.
+ * Gives up on anything but a cluster of known size starting with its timecode.
+ */
+static void matroska_skim_clusters(MatroskaDemuxContext *matroska,
+                                   uint64_t timestamp)
+{
+    AVIOContext *pb = matroska->ctx->pb;
+
+    while (matroska->nb_cluster_index) {
+        MatroskaClusterPos *last = &matroska->cluster_index[matroska->nb_cluster_index - 1];
+        uint64_t id, length, timecode;
+        int64_t pos;
+        int res;
+
+        if (last->timecode > timestamp)
+            break;
+
+        if (avio_seek(pb, last->pos, SEEK_SET) < 0 ||
+            ebml_read_num(matroska, pb, 4, &id) < 0 ||
+            ebml_read_length(matroska, pb, &length) <= 0 ||
+            length == 0xffffffffffffffULL)
+            break;
+        pos = avio_tell(pb) + length;
+
+        if (avio_seek(pb, pos, SEEK_SET) < 0 ||
+            (res = ebml_read_num(matroska, pb, 4, &id)) < 0 ||
+            (id | 1 << 7 * res) != MATROSKA_ID_CLUSTER ||
+            ebml_read_length(matroska, pb, &length) <= 0 ||
+            (res = ebml_read_num(matroska, pb, 4, &id)) < 0 ||
+            (id | 1 << 7 * res) != MATROSKA_ID_CLUSTERTIMECODE ||
+            ebml_read_length(matroska, pb, &length) <= 0 ||
+            ebml_read_uint(pb, length, &timecode) < 0)
+            break;
+
+        if (matroska_add_cluster_pos(matroska, pos, timecode) < 0)
+            break;
+    }
+}
+
 static int matroska_parse_cluster_incremental(MatroskaDemuxContext *matroska)
 {
     EbmlList *blocks_list;
@@ -2724,10 +2808,13 @@ static int matroska_parse_cluster_incremental(MatroskaDemuxContext *matroska)
                          matroska_clusters_incremental,
                          &matroska->current_cluster);
         /* Try parsing the block again. */
-        if (res == 1)
+        if (res == 1) {
+            matroska_add_cluster_pos(matroska, matroska->current_cluster_pos,
+                                     matroska->current_cluster.timecode);
             res = ebml_parse(matroska,
                              matroska_cluster_incremental_parsing,
                              &matroska->current_cluster);
+        }
     }
 
     if (!res &&
@@ -2772,6 +2859,8 @@ static int matroska_parse_cluster(MatroskaDemuxContext *matroska)
     res         = ebml_parse(matroska, matroska_clusters, &cluster);
     blocks_list = &cluster.blocks;
     blocks      = blocks_list->elem;
+    if (!res && blocks_list->nb_elem)
+        matroska_add_cluster_pos(matroska, pos, cluster.timecode);
     for (i = 0; i < blocks_list->nb_elem && !res; i++)
         if (blocks[i].bin.size > 0 && blocks[i].bin.data) {
             int is_keyframe = blocks[i].non_simple ? !blocks[i].reference : -1;
@@ -2807,6 +2896,80 @@ static int matroska_read_packet(AVFormatContext *s, AVPacket *pkt)
     return ret;
 }
 
+/*
+ * Convert a timestamp of st to a cluster timecode. The stream time base
+ * already includes the track timecode scale, the block timestamps are the
+ * cluster timecode plus the block offset minus the codec delay.
+ */
+static uint64_t matroska_stream_to_cluster_time(MatroskaDemuxContext *matroska,
+                                                AVStream *st, int64_t timestamp)
+{
+    MatroskaTrack *tracks = matroska->tracks.elem;
+    int i;
+
+    for (i = 0; i < matroska->tracks.nb_elem; i++) {
+        if (tracks[i].stream == st) {
+            timestamp += tracks[i].codec_delay;
+            break;
+        }
+    }
+    return FFMAX(timestamp, 0);
+}
+
+/*
+ * Parse the clusters around timestamp found through the cluster index, so
+ * that the stream index covers a target past its last entry without
+ * parsing all the clusters in between.
+ */
+static void matroska_index_from_clusters(MatroskaDemuxContext *matroska,
+                                         AVStream *st, int64_t timestamp)
+{
+    AVIOContext *pb  = matroska->ctx->pb;
+    int64_t last_pos = st->index_entries[st->nb_index_entries - 1].pos;
+    int64_t end      = INT64_MAX;
+    uint64_t cluster_time = matroska_stream_to_cluster_time(matroska, st, timestamp);
+    MatroskaClusterPos *clusters;
+    int lo = 0, hi, index;
+
+    matroska_skim_clusters(matroska, cluster_time);
+    clusters = matroska->cluster_index;
+
+    /* last cluster starting at or before timestamp */
+    hi = matroska->nb_cluster_index;
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+        if (clusters[mid].timecode <= cluster_time)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    /* also parse the following one, for forward seeks */
+    if (lo + 1 < matroska->nb_cluster_index)
+        end = clusters[lo + 1].pos;
+
+    /* Walk back until a keyframe at or before timestamp is found. */
+    for (lo--; lo >= 0 && clusters[lo].pos > last_pos; lo--) {
+        if (avio_seek(pb, clusters[lo].pos, SEEK_SET) < 0)
+            break;
+        matroska->current_id = 0;
+        while (avio_tell(pb) < end) {
+            /* without a known end, stop once the index goes past timestamp */
+            if (end == INT64_MAX &&
+                st->index_entries[st->nb_index_entries - 1].timestamp >= timestamp)
+                break;
+            matroska_clear_queue(matroska);
+            if (matroska_parse_cluster(matroska) < 0)
+                break;
+        }
+        matroska_clear_queue(matroska);
+
+        index = av_index_search_timestamp(st, timestamp, AVSEEK_FLAG_BACKWARD);
+        if (index >= 0 && st->index_entries[index].pos >= clusters[lo].pos)
+            break;
+        end = clusters[lo].pos;
+    }
+}
+
 static int matroska_read_seek(AVFormatContext *s, int stream_index,
                               int64_t timestamp, int flags)
 {
@@ -2825,6 +2988,10 @@ static int matroska_read_seek(AVFormatContext *s, int stream_index,
         return 0;
     timestamp = FFMAX(timestamp, st->index_entries[0].timestamp);
 
+    if (timestamp > st->index_entries[st->nb_index_entries - 1].timestamp &&
+        matroska->nb_cluster_index)
+        matroska_index_from_clusters(matroska, st, timestamp);
+
     if ((index = av_index_search_timestamp(st, timestamp, flags)) < 0) {
         avio_seek(s->pb, st->index_entries[st->nb_index_entries - 1].pos,
                   SEEK_SET);
@@ -2882,6 +3049,7 @@ static int matroska_read_close(AVFormatContext *s)
             av_free(tracks[n].audio.buf);
     ebml_free(matroska_cluster, &matroska->current_cluster);
     ebml_free(matroska_segment, matroska);
+    av_freep(&matroska->cluster_index);
 
     return 0;
 }
@@ -2488,6 +2488,45 @@ static void mov_build_index(MOVContext *mov, AVStream *st)
     }
 }
 
+static void mov_free_sample_tables(MOVStreamContext *sc)
+{
+    av_freep(&sc->chunk_offsets);
+    av_freep(&sc->sample_sizes);
+    av_freep(&sc->keyframes);
+    av_freep(&sc->stts_data);
+    av_freep(&sc->stps_data);
+    av_freep(&sc->rap_group);
+}
+
+static int mov_seek_stream(AVFormatContext *s, AVStream *st, int64_t timestamp, int flags);
+
+/**
+ * Build the complete index of a track whose sample tables were kept by
+ * the lazy_index option, then free the tables. A track joining after
+ * reading started is positioned at its first keyframe at or after the
+ * current read position (a forward search, AVSEEK_FLAG_BACKWARD is not
+ * set), or at its end if there is no such keyframe.
+ */
+static void mov_build_pending_index(AVFormatContext *s, AVStream *st)
+{
+    MOVContext *mov = s->priv_data;
+    MOVStreamContext *sc = st->priv_data;
+
+    if (!sc->index_pending)
+        return;
+    sc->index_pending = 0;
+
+    mov_build_index(mov, st);
+    mov_free_sample_tables(sc);
+
+    if (mov->read_position != AV_NOPTS_VALUE) {
+        int64_t timestamp = av_rescale(mov->read_position, sc->time_scale,
+                                       AV_TIME_BASE);
+        if (mov_seek_stream(s, st, timestamp, 0) < 0)
+            sc->current_sample = st->nb_index_entries;
+    }
+}
+
 static int mov_open_dref(AVFormatContext *s, AVIOContext **pb, char *src,
                          MOVDref *ref)
 {
@@ -2568,7 +2607,10 @@ static int mov_read_trak(MOVContext *c, AVIOContext *pb, MOVAtom atom)
 
     avpriv_set_pts_info(st, 64, 1, sc->time_scale);
 
-    mov_build_index(c, st);
+    if (c->lazy_index)
+        sc->index_pending = 1;
+    else
+        mov_build_index(c, st);
 
     if (sc->dref_id-1 < sc->drefs_count && sc->drefs[sc->dref_id-1].path) {
         MOVDref *dref = &sc->drefs[sc->dref_id - 1];
@@ -2626,12 +2668,8 @@ static int mov_read_trak(MOVContext *c, AVIOContext *pb, MOVAtom atom)
     }
 
     /* Do not need those anymore. */
-    av_freep(&sc->chunk_offsets);
-    av_freep(&sc->sample_sizes);
-    av_freep(&sc->keyframes);
-    av_freep(&sc->stts_data);
-    av_freep(&sc->stps_data);
-    av_freep(&sc->rap_group);
+    if (!sc->index_pending)
+        mov_free_sample_tables(sc);
 
     return 0;
 }
@@ -2977,6 +3015,8 @@ static int mov_read_trun(MOVContext *c, AVIOContext *pb, MOVAtom atom)
     sc = st->priv_data;
     if (sc->pseudo_stream_id+1 != frag->stsd_id)
         return 0;
+    /* fragment samples are appended after the moov ones */
+    mov_build_pending_index(c->fc, st);
     avio_r8(pb); /* version */
     flags = avio_rb24(pb);
     entries = avio_rb32(pb);
@@ -3665,6 +3705,8 @@ static void mov_read_chapters(AVFormatContext *s)
     sc = st->priv_data;
     cur_pos = avio_tell(sc->pb);
 
+    mov_build_pending_index(s, st);
+
     for (i = 0; i < st->nb_index_entries; i++) {
         AVIndexEntry *sample = &st->index_entries[i];
         int64_t end = i+1 < st->nb_index_entries ? st->index_entries[i+1].timestamp : st->duration;
@@ -3767,6 +3809,7 @@ static int mov_read_header(AVFormatContext *s)
     int i;
 
     mov->fc = s;
+    mov->read_position = AV_NOPTS_VALUE;
     /* .mov and .mp4 aren't streamable anyway (only progressive download if moov is before mdat) */
     if (pb->seekable & AVIO_SEEKABLE_NORMAL)
         atom.size = avio_size(pb);
@@ -3869,6 +3912,11 @@ static AVIndexEntry *mov_find_next_sample(AVFormatContext *s, AVStream **st)
     for (i = 0; i < s->nb_streams; i++) {
         AVStream *avst = s->streams[i];
         MOVStreamContext *msc = avst->priv_data;
+        if (msc->index_pending) {
+            if (avst->discard == AVDISCARD_ALL)
+                continue;
+            mov_build_pending_index(s, avst);
+        }
         if (msc->pb && msc->current_sample < avst->nb_index_entries) {
             AVIndexEntry *current_sample = &avst->index_entries[msc->current_sample];
             int64_t dts = av_rescale(current_sample->timestamp, AV_TIME_BASE, msc->time_scale);
@@ -3932,6 +3980,8 @@ static int mov_read_packet(AVFormatContext *s, AVPacket *pkt)
         goto retry;
     }
     sc = st->priv_data;
+    mov->read_position = av_rescale(sample->timestamp, AV_TIME_BASE,
+                                    sc->time_scale);
     /* must be done just before reading, to avoid infinite loop on sample */
     sc->current_sample++;
 
@@ -4067,6 +4117,7 @@ static int mov_read_seek(AVFormatContext *s, int stream_index, int64_t sample_ti
         sample_time = 0;
 
     st = s->streams[stream_index];
+    mov_build_pending_index(s, st);
     sample = mov_seek_stream(s, st, sample_time, flags);
     if (sample < 0)
         return sample;
@@ -4075,16 +4126,21 @@ static int mov_read_seek(AVFormatContext *s, int stream_index, int64_t sample_ti
         /* adjust seek timestamp to found sample timestamp */
         int64_t seek_timestamp = st->index_entries[sample].timestamp;
 
+        mc->read_position = av_rescale_q(seek_timestamp, st->time_base,
+                                         AV_TIME_BASE_Q);
         for (i = 0; i < s->nb_streams; i++) {
             int64_t timestamp;
             st = s->streams[i];
-            if (stream_index == i)
+            if (stream_index == i ||
+                ((MOVStreamContext *)st->priv_data)->index_pending)
                 continue;
 
             timestamp = av_rescale_q(seek_timestamp, s->streams[stream_index]->time_base, st->time_base);
             mov_seek_stream(s, st, timestamp, flags);
         }
     } else {
+        /* tracks joining during the scan below start from their beginning */
+        mc->read_position = AV_NOPTS_VALUE;
         for (i = 0; i < s->nb_streams; i++) {
             MOVStreamContext *sc;
             st = s->streams[i];
@@ -4097,8 +4153,11 @@ static int mov_read_seek(AVFormatContext *s, int stream_index, int64_t sample_ti
             if (!entry)
                 return AVERROR_INVALIDDATA;
             sc = st->priv_data;
-            if (sc->ffindex == stream_index && sc->current_sample == sample)
+            if (sc->ffindex == stream_index && sc->current_sample == sample) {
+                mc->read_position = av_rescale(entry->timestamp, AV_TIME_BASE,
+                                               sc->time_scale);
                 break;
+            }
             sc->current_sample++;
         }
     }
@@ -4118,6 +4177,8 @@ static const AVOption mov_options[] = {
         AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, .flags = FLAGS },
     { "enable_drefs", "Enable external track support.", OFFSET(enable_drefs),
         AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, .flags = FLAGS },
+    { "lazy_index", "Build the full index of a track only when it is first read or seeked",
+        OFFSET(lazy_index), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, .flags = FLAGS },
     { NULL },
 };
 
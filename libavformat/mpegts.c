@@ -1813,11 +1813,14 @@ static int handle_packet(MpegTSContext *ts, const uint8_t *packet)
     int64_t pos;
 
     pid = AV_RB16(packet + 1) & 0x1fff;
-    if (pid && discard_pid(ts, pid))
-        return 0;
     is_start = packet[1] & 0x40;
     tss = ts->pids[pid];
-    if (ts->auto_guess && !tss && is_start) {
+    /* cheap filter lookup first, discard_pid() walks all programs */
+    if (!tss && !(ts->auto_guess && is_start))
+        return 0;
+    if (pid && discard_pid(ts, pid))
+        return 0;
+    if (!tss) {
         add_pes_stream(ts, pid, -1);
         tss = ts->pids[pid];
     }
@@ -1960,6 +1963,31 @@ static void finished_reading_packet(AVFormatContext *s, int raw_packet_size)
         avio_skip(pb, skip);
 }
 
+/**
+ * Skip the packets already in the I/O buffer that no filter is interested
+ * in, without copying them out or going through handle_packet().
+ *
+ * @return number of packets skipped
+ */
+static int skip_unfiltered_packets(MpegTSContext *ts, int max_packets)
+{
+    AVIOContext *pb = ts->stream->pb;
+    uint8_t *p      = pb->buf_ptr;
+    int nb_skipped  = 0;
+
+    while (nb_skipped < max_packets &&
+           pb->buf_end - p >= TS_PACKET_SIZE && p[0] == 0x47) {
+        int pid = AV_RB16(p + 1) & 0x1fff;
+        if (ts->pids[pid] || (ts->auto_guess && (p[1] & 0x40)))
+            break;
+        p += TS_PACKET_SIZE;
+        nb_skipped++;
+    }
+    pb->buf_ptr = p;
+
+    return nb_skipped;
+}
+
 static int handle_packets(MpegTSContext *ts, int nb_packets)
 {
     AVFormatContext *s = ts->stream;
@@ -1993,6 +2021,13 @@ static int handle_packets(MpegTSContext *ts, int nb_packets)
         packet_num++;
         if (nb_packets != 0 && packet_num >= nb_packets)
             break;
+        if (ts->raw_packet_size == TS_PACKET_SIZE) {
+            packet_num += skip_unfiltered_packets(ts, nb_packets ?
+                                                  nb_packets - packet_num :
+                                                  INT_MAX);
+            if (nb_packets != 0 && packet_num >= nb_packets)
+                break;
+        }
         ret = read_packet(s, packet, ts->raw_packet_size, &data);
         if (ret != 0)
             break;
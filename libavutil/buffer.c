@@ -114,8 +114,12 @@ void av_buffer_unref(AVBufferRef **buf)
     av_freep(buf);
 
     if (atomic_fetch_add_explicit(&b->refcount, -1, memory_order_acq_rel) == 1) {
+        /* a pooled buffer may be reused as soon as free() returns */
+        int flags = b->flags;
+
         b->free(b->opaque, b->data);
-        av_freep(&b);
+        if (!(flags & BUFFER_FLAG_NO_FREE))
+            av_freep(&b);
     }
 }
 
@@ -316,9 +320,20 @@ AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
     ff_mutex_lock(&pool->mutex);
     buf = pool->pool;
     if (buf) {
-        ret = av_buffer_create(buf->data, pool->size, pool_release_buffer,
-                               buf, 0);
+        ret = av_mallocz(sizeof(*ret));
         if (ret) {
+            memset(&buf->buffer, 0, sizeof(buf->buffer));
+            buf->buffer.data   = buf->data;
+            buf->buffer.size   = pool->size;
+            buf->buffer.free   = pool_release_buffer;
+            buf->buffer.opaque = buf;
+            buf->buffer.flags  = BUFFER_FLAG_NO_FREE;
+            atomic_init(&buf->buffer.refcount, 1);
+
+            ret->buffer = &buf->buffer;
+            ret->data   = buf->data;
+            ret->size   = pool->size;
+
             pool->pool = buf->next;
             buf->next = NULL;
         }
@@ -33,6 +33,10 @@
  * The buffer was av_realloc()ed, so it is reallocatable.
  */
 #define BUFFER_FLAG_REALLOCATABLE (1 << 1)
+/**
+ * The AVBuffer is embedded in a BufferPoolEntry and must not be freed.
+ */
+#define BUFFER_FLAG_NO_FREE       (1 << 2)
 
 struct AVBuffer {
     uint8_t *data; /**< data described by this buffer */
@@ -71,6 +75,12 @@ typedef struct BufferPoolEntry {
 
     AVBufferPool *pool;
     struct BufferPoolEntry *next;
+
+    /*
+     * Buffer handed out when the entry is reused, so that only the
+     * AVBufferRef is allocated.
+     */
+    AVBuffer buffer;
 } BufferPoolEntry;
 
 struct AVBufferPool {
@@ -27,9 +27,14 @@ AVDownmixInfo *av_downmix_info_update_side_data(AVFrame *frame)
 
     side_data = av_frame_get_side_data(frame, AV_FRAME_DATA_DOWNMIX_INFO);
 
-    if (!side_data)
+    if (!side_data) {
         side_data = av_frame_new_side_data(frame, AV_FRAME_DATA_DOWNMIX_INFO,
                                            sizeof(AVDownmixInfo));
+    } else if (av_buffer_make_writable(&side_data->buf) < 0) {
+        side_data = NULL;
+    } else {
+        side_data->data = side_data->buf->data;
+    }
 
     if (!side_data)
         return NULL;
@@ -116,6 +116,13 @@ typedef struct AVFrameSideData {
     uint8_t *data;
     int      size;
     AVDictionary *metadata;
+    /**
+     * The buffer data is stored in. It may be shared with other frames, so
+     * av_buffer_make_writable() must be called (and data updated) before
+     * writing to a side data obtained from a frame which was not created by
+     * the caller.
+     */
+    AVBufferRef *buf;
 } AVFrameSideData;
 
 /**
@@ -433,7 +440,8 @@ void av_frame_free(AVFrame **frame);
  * Set up a new reference to the data described by the source frame.
  *
  * Copy frame properties from src to dst and create a new reference for each
- * AVBufferRef from src.
+ * AVBufferRef from src. This includes the side data buffers, which are
+ * shared between src and dst afterwards.
  *
  * If src is not reference counted, new buffers are allocated and the data is
  * copied.
@@ -540,7 +548,9 @@ int av_frame_copy(AVFrame *dst, const AVFrame *src);
  * Metadata for the purpose of this function are those fields that do not affect
  * the data layout in the buffers.  E.g. pts, sample rate (for audio) or sample
  * aspect ratio (for video), but not width/height or channel layout.
- * Side data is also copied.
+ * Side data is also copied, its buffers are shared between src and dst.
+ * Call av_buffer_make_writable() on AVFrameSideData.buf (and update
+ * AVFrameSideData.data) before modifying the side data of either frame.
  */
 int av_frame_copy_props(AVFrame *dst, const AVFrame *src);
 
@@ -567,6 +577,21 @@ AVFrameSideData *av_frame_new_side_data(AVFrame *frame,
                                         enum AVFrameSideDataType type,
                                         int size);
 
+/**
+ * Add a new side data to a frame from an existing AVBufferRef, e.g. one
+ * taken from an AVBufferPool.
+ *
+ * @param frame a frame to which the side data should be added
+ * @param type  the type of the added side data
+ * @param buf   an AVBufferRef to add as side data. The ownership of the
+ *              reference is transferred to the frame, also on failure.
+ *
+ * @return newly added side data on success, NULL on error
+ */
+AVFrameSideData *av_frame_new_side_data_from_buf(AVFrame *frame,
+                                                 enum AVFrameSideDataType type,
+                                                 AVBufferRef *buf);
+
 /**
  * @return a pointer to the side data of a given type on success, NULL if there
  * is no side data with such type in this frame.
@@ -0,0 +1,127 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/buffer.h"
+#include "libavutil/downmix_info.h"
+#include "libavutil/frame.h"
+
+#define CHECK(cond)                                                     \
+    do {                                                                \
+        if (!(cond)) {                                                  \
+            fprintf(stderr, "%s:%d: check failed: %s\n",                \
+                    __FILE__, __LINE__, #cond);                         \
+            ret = 1;                                                    \
+            goto end;                                                   \
+        }                                                               \
+    } while (0)
+
+static int test_side_data_from_buf(void)
+{
+    AVFrame *frame = av_frame_alloc();
+    AVBufferRef *buf = av_buffer_alloc(16);
+    AVFrameSideData *sd;
+    int ret = 0;
+
+    CHECK(frame && buf);
+    memset(buf->data, 0x42, buf->size);
+
+    sd = av_frame_new_side_data_from_buf(frame, AV_FRAME_DATA_AFD, buf);
+    CHECK(sd);
+    /* the frame owns the reference now */
+    buf = NULL;
+    CHECK(sd->buf && sd->data == sd->buf->data && sd->size == 16);
+    CHECK(av_buffer_is_writable(sd->buf));
+    CHECK(av_frame_get_side_data(frame, AV_FRAME_DATA_AFD) == sd);
+    CHECK(sd->data[0] == 0x42 && sd->data[15] == 0x42);
+
+end:
+    av_buffer_unref(&buf);
+    av_frame_free(&frame);
+    return ret;
+}
+
+static int test_copy_props_sharing(void)
+{
+    AVFrame *src = av_frame_alloc(), *dst = av_frame_alloc();
+    AVFrameSideData *src_sd, *dst_sd;
+    int ret = 0;
+
+    CHECK(src && dst);
+    src_sd = av_frame_new_side_data(src, AV_FRAME_DATA_AFD, 4);
+    CHECK(src_sd);
+    memset(src_sd->data, 1, 4);
+
+    CHECK(av_frame_copy_props(dst, src) >= 0);
+    dst_sd = av_frame_get_side_data(dst, AV_FRAME_DATA_AFD);
+    CHECK(dst_sd && dst_sd != src_sd);
+    CHECK(dst_sd->buf->buffer == src_sd->buf->buffer);
+    CHECK(dst_sd->data == src_sd->data && dst_sd->size == 4);
+    CHECK(!av_buffer_is_writable(src_sd->buf));
+    CHECK(!av_buffer_is_writable(dst_sd->buf));
+
+    /* writing to a writable copy must not change the source */
+    CHECK(av_buffer_make_writable(&dst_sd->buf) >= 0);
+    dst_sd->data = dst_sd->buf->data;
+    CHECK(dst_sd->data != src_sd->data);
+    memset(dst_sd->data, 2, 4);
+    CHECK(src_sd->data[0] == 1 && src_sd->data[3] == 1);
+    CHECK(av_buffer_is_writable(src_sd->buf));
+
+end:
+    av_frame_free(&src);
+    av_frame_free(&dst);
+    return ret;
+}
+
+static int test_ref_update(void)
+{
+    AVFrame *src = av_frame_alloc(), *dst = av_frame_alloc();
+    AVDownmixInfo *info;
+    int ret = 0;
+
+    CHECK(src && dst);
+    info = av_downmix_info_update_side_data(src);
+    CHECK(info);
+    info->center_mix_level = 0.5;
+
+    CHECK(av_frame_copy_props(dst, src) >= 0);
+    info = av_downmix_info_update_side_data(dst);
+    CHECK(info);
+    info->center_mix_level = 0.25;
+
+    info = (AVDownmixInfo *)av_frame_get_side_data(src, AV_FRAME_DATA_DOWNMIX_INFO)->data;
+    CHECK(info->center_mix_level == 0.5);
+
+end:
+    av_frame_free(&src);
+    av_frame_free(&dst);
+    return ret;
+}
+
+int main(void)
+{
+    if (test_side_data_from_buf() ||
+        test_copy_props_sharing() ||
+        test_ref_update())
+        return 1;
+
+    return 0;
+}
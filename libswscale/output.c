@@ -239,6 +239,95 @@ yuv2NBPS(12, LE, 0, 10, int16_t)
 yuv2NBPS(16, BE, 1, 16, int32_t)
 yuv2NBPS(16, LE, 0, 16, int32_t)
 
+#define output_pixel(pos, val) \
+    if (big_endian) { \
+        AV_WB16(pos, av_clip_uintp2(val >> shift, 10) << 6); \
+    } else { \
+        AV_WL16(pos, av_clip_uintp2(val >> shift, 10) << 6); \
+    }
+
+static av_always_inline void
+yuv2p010l1_c_template(const int16_t *src, uint16_t *dest, int dstW,
+                      int big_endian)
+{
+    int i;
+    int shift = 5;
+
+    for (i = 0; i < dstW; i++) {
+        int val = src[i] + (1 << (shift - 1));
+        output_pixel(&dest[i], val);
+    }
+}
+
+static av_always_inline void
+yuv2p010lX_c_template(const int16_t *filter, int filterSize,
+                      const int16_t **src, uint16_t *dest, int dstW,
+                      int big_endian)
+{
+    int i, j;
+    int shift = 17;
+
+    for (i = 0; i < dstW; i++) {
+        int val = 1 << (shift - 1);
+
+        for (j = 0; j < filterSize; j++)
+            val += src[j][i] * filter[j];
+
+        output_pixel(&dest[i], val);
+    }
+}
+
+static av_always_inline void
+yuv2p010cX_c_template(const int16_t *chrFilter, int chrFilterSize,
+                      const int16_t **chrUSrc, const int16_t **chrVSrc,
+                      uint16_t *dest, int chrDstW, int big_endian)
+{
+    int i, j;
+    int shift = 17;
+
+    for (i = 0; i < chrDstW; i++) {
+        int u = 1 << (shift - 1);
+        int v = 1 << (shift - 1);
+
+        for (j = 0; j < chrFilterSize; j++) {
+            u += chrUSrc[j][i] * chrFilter[j];
+            v += chrVSrc[j][i] * chrFilter[j];
+        }
+
+        output_pixel(&dest[2 * i],     u);
+        output_pixel(&dest[2 * i + 1], v);
+    }
+}
+
+#undef output_pixel
+
+#define yuv2p010(BE_LE, is_be) \
+static void yuv2p010l1_ ## BE_LE ## _c(const int16_t *src, uint8_t *dest, \
+                                       int dstW, const uint8_t *dither, \
+                                       int offset) \
+{ \
+    yuv2p010l1_c_template(src, (uint16_t *) dest, dstW, is_be); \
+} \
+static void yuv2p010lX_ ## BE_LE ## _c(const int16_t *filter, int filterSize, \
+                                       const int16_t **src, uint8_t *dest, \
+                                       int dstW, const uint8_t *dither, \
+                                       int offset) \
+{ \
+    yuv2p010lX_c_template(filter, filterSize, src, (uint16_t *) dest, dstW, \
+                          is_be); \
+} \
+static void yuv2p010cX_ ## BE_LE ## _c(SwsContext *c, const int16_t *chrFilter, \
+                                       int chrFilterSize, \
+                                       const int16_t **chrUSrc, \
+                                       const int16_t **chrVSrc, \
+                                       uint8_t *dest, int chrDstW) \
+{ \
+    yuv2p010cX_c_template(chrFilter, chrFilterSize, chrUSrc, chrVSrc, \
+                          (uint16_t *) dest, chrDstW, is_be); \
+}
+yuv2p010(BE, 1)
+yuv2p010(LE, 0)
+
 static void yuv2planeX_8_c(const int16_t *filter, int filterSize,
                            const int16_t **src, uint8_t *dest, int dstW,
                            const uint8_t *dither, int offset)
@@ -1366,7 +1455,11 @@ av_cold void ff_sws_init_output_funcs(SwsContext *c,
     enum AVPixelFormat dstFormat = c->dstFormat;
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(dstFormat);
 
-    if (is16BPS(dstFormat)) {
+    if (dstFormat == AV_PIX_FMT_P010LE || dstFormat == AV_PIX_FMT_P010BE) {
+        *yuv2plane1 = isBE(dstFormat) ? yuv2p010l1_BE_c : yuv2p010l1_LE_c;
+        *yuv2planeX = isBE(dstFormat) ? yuv2p010lX_BE_c : yuv2p010lX_LE_c;
+        *yuv2nv12cX = isBE(dstFormat) ? yuv2p010cX_BE_c : yuv2p010cX_LE_c;
+    } else if (is16BPS(dstFormat)) {
         *yuv2planeX = isBE(dstFormat) ? yuv2planeX_16BE_c  : yuv2planeX_16LE_c;
         *yuv2plane1 = isBE(dstFormat) ? yuv2plane1_16BE_c  : yuv2plane1_16LE_c;
     } else if (is9_15BPS(dstFormat)) {
@@ -85,6 +85,18 @@ void (*interleaveBytes)(const uint8_t *src1, const uint8_t *src2, uint8_t *dst,
 void (*deinterleaveBytes)(const uint8_t *src, uint8_t *dst1, uint8_t *dst2,
                           int width, int height, int srcStride,
                           int dst1Stride, int dst2Stride);
+void (*interleaveWords)(const uint16_t *src1, const uint16_t *src2,
+                        uint16_t *dst, int width, int shift);
+void (*deinterleaveWords)(const uint16_t *src, uint16_t *dst1,
+                          uint16_t *dst2, int width, int shift);
+void (*shiftWordsLeft)(const uint16_t *src, uint16_t *dst,
+                       int width, int shift);
+void (*shiftWordsRight)(const uint16_t *src, uint16_t *dst,
+                        int width, int shift);
+void (*wordsToBytesDither)(const uint16_t *src, uint8_t *dst, int width,
+                           const uint8_t *dither, int shift);
+void (*bytesToWords)(const uint8_t *src, uint16_t *dst,
+                     int width, int shift);
 void (*vu9_to_vu12)(const uint8_t *src1, const uint8_t *src2,
                     uint8_t *dst1, uint8_t *dst2,
                     int width, int height,
@@ -133,6 +133,23 @@ extern void (*deinterleaveBytes)(const uint8_t *src, uint8_t *dst1, uint8_t *dst
                                  int width, int height, int srcStride,
                                  int dst1Stride, int dst2Stride);
 
+/*
+ * Row functions for native endian 16 bits per component planes.
+ */
+extern void (*interleaveWords)(const uint16_t *src1, const uint16_t *src2,
+                               uint16_t *dst, int width, int shift);
+extern void (*deinterleaveWords)(const uint16_t *src, uint16_t *dst1,
+                                 uint16_t *dst2, int width, int shift);
+extern void (*shiftWordsLeft)(const uint16_t *src, uint16_t *dst,
+                              int width, int shift);
+extern void (*shiftWordsRight)(const uint16_t *src, uint16_t *dst,
+                               int width, int shift);
+/* dst = clip_uint8((src + dither[x & 7]) >> shift), shift > 0 */
+extern void (*wordsToBytesDither)(const uint16_t *src, uint8_t *dst, int width,
+                                  const uint8_t *dither, int shift);
+extern void (*bytesToWords)(const uint8_t *src, uint16_t *dst,
+                            int width, int shift);
+
 extern void (*vu9_to_vu12)(const uint8_t *src1, const uint8_t *src2,
                            uint8_t *dst1, uint8_t *dst2,
                            int width, int height,
@@ -726,6 +726,64 @@ static void deinterleaveBytes_c(const uint8_t *src, uint8_t *dst1, uint8_t *dst2
     }
 }
 
+static void interleaveWords_c(const uint16_t *src1, const uint16_t *src2,
+                              uint16_t *dst, int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++) {
+        dst[2 * w + 0] = src1[w] << shift;
+        dst[2 * w + 1] = src2[w] << shift;
+    }
+}
+
+static void deinterleaveWords_c(const uint16_t *src, uint16_t *dst1,
+                                uint16_t *dst2, int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++) {
+        dst1[w] = src[2 * w + 0] >> shift;
+        dst2[w] = src[2 * w + 1] >> shift;
+    }
+}
+
+static void shiftWordsLeft_c(const uint16_t *src, uint16_t *dst,
+                             int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++)
+        dst[w] = src[w] << shift;
+}
+
+static void shiftWordsRight_c(const uint16_t *src, uint16_t *dst,
+                              int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++)
+        dst[w] = src[w] >> shift;
+}
+
+static void wordsToBytesDither_c(const uint16_t *src, uint8_t *dst, int width,
+                                 const uint8_t *dither, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++)
+        dst[w] = av_clip_uint8((src[w] + dither[w & 7]) >> shift);
+}
+
+static void bytesToWords_c(const uint8_t *src, uint16_t *dst,
+                           int width, int shift)
+{
+    int w;
+
+    for (w = 0; w < width; w++)
+        dst[w] = src[w] << shift;
+}
+
 static inline void vu9_to_vu12_c(const uint8_t *src1, const uint8_t *src2,
                                  uint8_t *dst1, uint8_t *dst2,
                                  int width, int height,
@@ -956,6 +1014,12 @@ static av_cold void rgb2rgb_init_c(void)
     rgb24toyv12        = rgb24toyv12_c;
     interleaveBytes    = interleaveBytes_c;
     deinterleaveBytes  = deinterleaveBytes_c;
+    interleaveWords    = interleaveWords_c;
+    deinterleaveWords  = deinterleaveWords_c;
+    shiftWordsLeft     = shiftWordsLeft_c;
+    shiftWordsRight    = shiftWordsRight_c;
+    wordsToBytesDither = wordsToBytesDither_c;
+    bytesToWords       = bytesToWords_c;
     vu9_to_vu12        = vu9_to_vu12_c;
     yvu9_to_yuy2       = yvu9_to_yuy2_c;
 
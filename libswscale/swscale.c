@@ -29,6 +29,7 @@
 #include "libavutil/cpu.h"
 #include "libavutil/intreadwrite.h"
 #include "libavutil/mathematics.h"
+#include "libavutil/mem.h"
 #include "libavutil/pixdesc.h"
 #include "config.h"
 #include "rgb2rgb.h"
@@ -263,7 +264,9 @@ static av_always_inline void hyscale(SwsContext *c, int16_t *dst, int dstWidth,
     void (*convertRange)(int16_t *, int) = isAlpha ? NULL : c->lumConvertRange;
     const uint8_t *src = src_in[isAlpha ? 3 : 0];
 
-    if (toYV12) {
+    if (c->inputConverted) {
+        /* unpacked by sws_scale_multi() */
+    } else if (toYV12) {
         toYV12(formatConvBuffer, src, srcW, pal);
         src = formatConvBuffer;
     } else if (c->readLumPlanar && !isAlpha) {
@@ -310,7 +313,9 @@ static av_always_inline void hcscale(SwsContext *c, int16_t *dst1,
                                      uint8_t *formatConvBuffer, uint32_t *pal)
 {
     const uint8_t *src1 = src_in[1], *src2 = src_in[2];
-    if (c->chrToYV12) {
+    if (c->inputConverted) {
+        /* unpacked by sws_scale_multi() */
+    } else if (c->chrToYV12) {
         uint8_t *buf2 = formatConvBuffer +
                         FFALIGN(srcW * FFALIGN(c->srcBpc, 8) >> 3, 16);
         c->chrToYV12(formatConvBuffer, buf2, src1, src2, srcW, pal);
@@ -335,6 +340,44 @@ static av_always_inline void hcscale(SwsContext *c, int16_t *dst1,
         c->chrConvertRange(dst1, dst2, dstWidth);
 }
 
+/* Point all the planes of packed formats to the packed data and apply the
+ * chroma line dropping to the strides. */
+static void setup_src_planes(const SwsContext *c, const uint8_t *src[],
+                             int srcStride[])
+{
+    if (isPacked(c->srcFormat)) {
+        src[0] =
+        src[1] =
+        src[2] =
+        src[3] = src[0];
+        srcStride[0] =
+        srcStride[1] =
+        srcStride[2] =
+        srcStride[3] = srcStride[0];
+    }
+    srcStride[1] <<= c->vChrDrop;
+    srcStride[2] <<= c->vChrDrop;
+}
+
+/**
+ * Look up a source line in the ring buffer of a context sharing its
+ * horizontally scaled lines, see sws_scale_multi().
+ *
+ * @return the ring buffer slot holding the line, or -1
+ */
+static int find_shared_line(const int32_t *buf_line, int buf_index,
+                            int last_in_buf, int buf_size, int y)
+{
+    int slot = buf_index - (last_in_buf - y);
+
+    if (!buf_line || y > last_in_buf || last_in_buf - y >= buf_size)
+        return -1;
+    if (slot < 0)
+        slot += buf_size;
+
+    return buf_line[slot] == y ? slot : -1;
+}
+
 #define DEBUG_SWSCALE_BUFFERS 0
 #define DEBUG_BUFFERS(...)                      \
     if (DEBUG_SWSCALE_BUFFERS)                  \
@@ -388,7 +431,10 @@ static int swscale(SwsContext *c, const uint8_t *src[],
     const int chrSrcSliceH           = AV_CEIL_RSHIFT(srcSliceH,   c->chrSrcVSubSample);
     int should_dither                = is9_15BPS(c->srcFormat) ||
                                        is16BPS(c->srcFormat);
-    int lastDstY;
+    const int pixBufSample           = c->dstBpc > 15 ? 4 : 2;
+    SwsContext *const lumShare       = c->lumShare;
+    SwsContext *const chrShare       = c->chrShare;
+    int lastDstY, i;
 
     /* vars which will change and which we need to store back in the context */
     int dstY         = c->dstY;
@@ -397,18 +443,8 @@ static int swscale(SwsContext *c, const uint8_t *src[],
     int lastInLumBuf = c->lastInLumBuf;
     int lastInChrBuf = c->lastInChrBuf;
 
-    if (isPacked(c->srcFormat)) {
-        src[0] =
-        src[1] =
-        src[2] =
-        src[3] = src[0];
-        srcStride[0] =
-        srcStride[1] =
-        srcStride[2] =
-        srcStride[3] = srcStride[0];
-    }
-    srcStride[1] <<= c->vChrDrop;
-    srcStride[2] <<= c->vChrDrop;
+    if (!c->inputConverted)
+        setup_src_planes(c, src, srcStride);
 
     DEBUG_BUFFERS("swscale() %p[%d] %p[%d] %p[%d] %p[%d] -> %p[%d] %p[%d] %p[%d] %p[%d]\n",
                   src[0], srcStride[0], src[1], srcStride[1],
@@ -440,6 +476,12 @@ static int swscale(SwsContext *c, const uint8_t *src[],
         dstY         = 0;
         lastInLumBuf = -1;
         lastInChrBuf = -1;
+        if (c->lumBufLine)
+            for (i = 0; i < vLumBufSize; i++)
+                c->lumBufLine[i] = -1;
+        if (c->chrBufLine)
+            for (i = 0; i < vChrBufSize; i++)
+                c->chrBufLine[i] = -1;
     }
 
     if (!should_dither) {
@@ -501,17 +543,35 @@ static int swscale(SwsContext *c, const uint8_t *src[],
                 src[2] + (lastInLumBuf + 1 - srcSliceY) * srcStride[2],
                 src[3] + (lastInLumBuf + 1 - srcSliceY) * srcStride[3],
             };
+            int slot = -1;
+
             lumBufIndex++;
             assert(lumBufIndex < 2 * vLumBufSize);
             assert(lastInLumBuf + 1 - srcSliceY < srcSliceH);
             assert(lastInLumBuf + 1 - srcSliceY >= 0);
-            hyscale(c, lumPixBuf[lumBufIndex], dstW, src1, srcW, lumXInc,
-                    hLumFilter, hLumFilterPos, hLumFilterSize,
-                    formatConvBuffer, pal, 0);
-            if (CONFIG_SWSCALE_ALPHA && alpPixBuf)
-                hyscale(c, alpPixBuf[lumBufIndex], dstW, src1, srcW,
-                        lumXInc, hLumFilter, hLumFilterPos, hLumFilterSize,
-                        formatConvBuffer, pal, 1);
+            if (lumShare)
+                slot = find_shared_line(lumShare->lumBufLine,
+                                        lumShare->lumBufIndex,
+                                        lumShare->lastInLumBuf,
+                                        lumShare->vLumBufSize,
+                                        lastInLumBuf + 1);
+            if (slot >= 0) {
+                memcpy(lumPixBuf[lumBufIndex], lumShare->lumPixBuf[slot],
+                       dstW * pixBufSample);
+                if (CONFIG_SWSCALE_ALPHA && alpPixBuf)
+                    memcpy(alpPixBuf[lumBufIndex], lumShare->alpPixBuf[slot],
+                           dstW * pixBufSample);
+            } else {
+                hyscale(c, lumPixBuf[lumBufIndex], dstW, src1, srcW, lumXInc,
+                        hLumFilter, hLumFilterPos, hLumFilterSize,
+                        formatConvBuffer, pal, 0);
+                if (CONFIG_SWSCALE_ALPHA && alpPixBuf)
+                    hyscale(c, alpPixBuf[lumBufIndex], dstW, src1, srcW,
+                            lumXInc, hLumFilter, hLumFilterPos, hLumFilterSize,
+                            formatConvBuffer, pal, 1);
+            }
+            if (c->lumBufLine)
+                c->lumBufLine[lumBufIndex % vLumBufSize] = lastInLumBuf + 1;
             lastInLumBuf++;
             DEBUG_BUFFERS("\t\tlumBufIndex %d: lastInLumBuf: %d\n",
                           lumBufIndex, lastInLumBuf);
@@ -523,17 +583,33 @@ static int swscale(SwsContext *c, const uint8_t *src[],
                 src[2] + (lastInChrBuf + 1 - chrSrcSliceY) * srcStride[2],
                 src[3] + (lastInChrBuf + 1 - chrSrcSliceY) * srcStride[3],
             };
+            int slot = -1;
+
             chrBufIndex++;
             assert(chrBufIndex < 2 * vChrBufSize);
             assert(lastInChrBuf + 1 - chrSrcSliceY < (chrSrcSliceH));
             assert(lastInChrBuf + 1 - chrSrcSliceY >= 0);
             // FIXME replace parameters through context struct (some at least)
 
-            if (c->needs_hcscale)
+            if (chrShare)
+                slot = find_shared_line(chrShare->chrBufLine,
+                                        chrShare->chrBufIndex,
+                                        chrShare->lastInChrBuf,
+                                        chrShare->vChrBufSize,
+                                        lastInChrBuf + 1);
+            if (slot >= 0) {
+                memcpy(chrUPixBuf[chrBufIndex], chrShare->chrUPixBuf[slot],
+                       chrDstW * pixBufSample);
+                memcpy(chrVPixBuf[chrBufIndex], chrShare->chrVPixBuf[slot],
+                       chrDstW * pixBufSample);
+            } else if (c->needs_hcscale) {
                 hcscale(c, chrUPixBuf[chrBufIndex], chrVPixBuf[chrBufIndex],
                         chrDstW, src1, chrSrcW, chrXInc,
                         hChrFilter, hChrFilterPos, hChrFilterSize,
                         formatConvBuffer, pal);
+            }
+            if (c->chrBufLine)
+                c->chrBufLine[chrBufIndex % vChrBufSize] = lastInChrBuf + 1;
             lastInChrBuf++;
             DEBUG_BUFFERS("\t\tchrBufIndex %d: lastInChrBuf: %d\n",
                           chrBufIndex, lastInChrBuf);
@@ -781,3 +857,350 @@ SwsFunc ff_getSwsFunc(SwsContext *c)
 
     return swscale;
 }
+
+/* Number of source lines fed to each context in turn by sws_scale_multi(),
+ * small enough for the source and unpacked lines to stay in cache. */
+#define MULTI_BAND_LINES 16
+
+enum MultiMode {
+    MULTI_SWS_SCALE,            ///< scaled with sws_scale() on its own
+    MULTI_BAND,                 ///< fed the source band by band
+    MULTI_BAND_CONVERTED,       ///< fed the shared unpacked band
+};
+
+static int same_input(const SwsContext *a, const SwsContext *b)
+{
+    return a->lumToYV12        == b->lumToYV12        &&
+           a->chrToYV12        == b->chrToYV12        &&
+           a->alpToYV12        == b->alpToYV12        &&
+           a->readLumPlanar    == b->readLumPlanar    &&
+           a->readChrPlanar    == b->readChrPlanar    &&
+           a->readAlpPlanar    == b->readAlpPlanar    &&
+           a->srcBpc           == b->srcBpc           &&
+           a->chrSrcW          == b->chrSrcW          &&
+           a->chrSrcVSubSample == b->chrSrcVSubSample &&
+           a->vChrDrop         == b->vChrDrop;
+}
+
+static int same_lum_hscale(const SwsContext *a, const SwsContext *b)
+{
+    return a->dstW            == b->dstW            &&
+           a->lumXInc         == b->lumXInc         &&
+           a->hLumFilterSize  == b->hLumFilterSize  &&
+           a->hyScale         == b->hyScale         &&
+           a->hyscale_fast    == b->hyscale_fast    &&
+           a->lumConvertRange == b->lumConvertRange &&
+           (a->dstBpc > 15)   == (b->dstBpc > 15)   &&
+           !a->alpPixBuf      == !b->alpPixBuf      &&
+           !memcmp(a->hLumFilterPos, b->hLumFilterPos,
+                   a->dstW * sizeof(*a->hLumFilterPos)) &&
+           !memcmp(a->hLumFilter, b->hLumFilter,
+                   a->dstW * a->hLumFilterSize * sizeof(*a->hLumFilter));
+}
+
+static int same_chr_hscale(const SwsContext *a, const SwsContext *b)
+{
+    return a->needs_hcscale   && b->needs_hcscale   &&
+           a->chrDstW         == b->chrDstW         &&
+           a->chrXInc         == b->chrXInc         &&
+           a->hChrFilterSize  == b->hChrFilterSize  &&
+           a->hcScale         == b->hcScale         &&
+           a->hcscale_fast    == b->hcscale_fast    &&
+           a->chrConvertRange == b->chrConvertRange &&
+           (a->dstBpc > 15)   == (b->dstBpc > 15)   &&
+           !memcmp(a->hChrFilterPos, b->hChrFilterPos,
+                   a->chrDstW * sizeof(*a->hChrFilterPos)) &&
+           !memcmp(a->hChrFilter, b->hChrFilter,
+                   a->chrDstW * a->hChrFilterSize * sizeof(*a->hChrFilter));
+}
+
+/* The ring buffers are sized for slices that do not skip source lines,
+ * a vertical filter with holes (FAST_BILINEAR or point downscaling) may
+ * overrun them when fed short slices. */
+static int has_holes(const int32_t *filter_pos, int filter_size, int h)
+{
+    int i;
+
+    for (i = 1; i < h; i++)
+        if (filter_pos[i] > filter_pos[i - 1] + filter_size)
+            return 1;
+
+    return 0;
+}
+
+/* the same check as sws_scale() does on its image pointers */
+static int check_image_pointers(const uint8_t *const data[4],
+                                enum AVPixelFormat pix_fmt,
+                                const int linesizes[4])
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(pix_fmt);
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        int plane = desc->comp[i].plane;
+        if (!data[plane] || !linesizes[plane])
+            return 0;
+    }
+
+    return 1;
+}
+
+static int alloc_buf_line(int32_t **buf_line, int buf_size)
+{
+    int i;
+
+    if (*buf_line)
+        return 0;
+
+    *buf_line = av_malloc_array(buf_size, sizeof(**buf_line));
+    if (!*buf_line)
+        return AVERROR(ENOMEM);
+    for (i = 0; i < buf_size; i++)
+        (*buf_line)[i] = -1;
+
+    return 0;
+}
+
+/* Run the input converters of c once over a band of h source lines, the
+ * planes without a converter are passed through. */
+static void convert_band(SwsContext *c, uint8_t *buf, int buf_stride,
+                         int need_chr, int need_alp, int h,
+                         const uint8_t *src[4], int srcStride[4],
+                         const uint8_t *conv[4], int convStride[4])
+{
+    const int chrH = AV_CEIL_RSHIFT(h, c->chrSrcVSubSample);
+    uint8_t *lum = buf;
+    uint8_t *u   = lum + buf_stride * h;
+    uint8_t *v   = u   + buf_stride * chrH;
+    uint8_t *alp = v   + buf_stride * chrH;
+    int i, j;
+
+    setup_src_planes(c, src, srcStride);
+    for (i = 0; i < 4; i++) {
+        conv[i]       = src[i];
+        convStride[i] = srcStride[i];
+    }
+
+    if (c->lumToYV12 || c->readLumPlanar) {
+        for (j = 0; j < h; j++) {
+            const uint8_t *line[4] = {
+                src[0] + j * srcStride[0], src[1] + j * srcStride[1],
+                src[2] + j * srcStride[2], src[3] + j * srcStride[3],
+            };
+            if (c->lumToYV12)
+                c->lumToYV12(lum + j * buf_stride, line[0], c->srcW, c->pal_yuv);
+            else
+                c->readLumPlanar(lum + j * buf_stride, line, c->srcW);
+        }
+        conv[0]       = lum;
+        convStride[0] = buf_stride;
+    }
+
+    if (need_alp && (c->alpToYV12 || c->readAlpPlanar)) {
+        for (j = 0; j < h; j++) {
+            const uint8_t *line[4] = {
+                src[0] + j * srcStride[0], src[1] + j * srcStride[1],
+                src[2] + j * srcStride[2], src[3] + j * srcStride[3],
+            };
+            if (c->alpToYV12)
+                c->alpToYV12(alp + j * buf_stride, line[3], c->srcW, c->pal_yuv);
+            else
+                c->readAlpPlanar(alp + j * buf_stride, line, c->srcW);
+        }
+        conv[3]       = alp;
+        convStride[3] = buf_stride;
+    }
+
+    if (need_chr && (c->chrToYV12 || c->readChrPlanar)) {
+        for (j = 0; j < chrH; j++) {
+            const uint8_t *line[4] = {
+                src[0] + j * srcStride[0], src[1] + j * srcStride[1],
+                src[2] + j * srcStride[2], src[3] + j * srcStride[3],
+            };
+            if (c->chrToYV12)
+                c->chrToYV12(u + j * buf_stride, v + j * buf_stride,
+                             line[1], line[2], c->chrSrcW, c->pal_yuv);
+            else
+                c->readChrPlanar(u + j * buf_stride, v + j * buf_stride,
+                                 line, c->chrSrcW);
+        }
+        conv[1]       = u;
+        conv[2]       = v;
+        convStride[1] =
+        convStride[2] = buf_stride;
+    }
+}
+
+int sws_scale_multi(struct SwsContext **ctx, int nb_contexts,
+                    const uint8_t *const srcSlice[], const int srcStride[],
+                    int srcSliceY, int srcSliceH,
+                    uint8_t *const *const dst[], const int *const dstStride[])
+{
+    const AVPixFmtDescriptor *desc;
+    SwsContext *conv_leader = NULL;
+    uint8_t *mode, *conv_buf = NULL;
+    int need_chr = 0, need_alp = 0, band = MULTI_BAND_LINES;
+    int buf_stride = 0, i, j, y, ret = 0;
+
+    if (nb_contexts <= 0 || !ctx[0])
+        return AVERROR(EINVAL);
+    for (i = 1; i < nb_contexts; i++) {
+        if (!ctx[i] || ctx[i]->srcW != ctx[0]->srcW ||
+            ctx[i]->srcH != ctx[0]->srcH ||
+            ctx[i]->srcFormat != ctx[0]->srcFormat) {
+            av_log(ctx[0], AV_LOG_ERROR,
+                   "All the contexts must have the same source.\n");
+            return AVERROR(EINVAL);
+        }
+    }
+    if (srcSliceH == 0)
+        return 0;
+    if (!check_image_pointers(srcSlice, ctx[0]->srcFormat, srcStride)) {
+        av_log(ctx[0], AV_LOG_ERROR, "bad src image pointers\n");
+        return AVERROR(EINVAL);
+    }
+    for (i = 0; i < nb_contexts; i++) {
+        if (!check_image_pointers((const uint8_t *const *)dst[i],
+                                  ctx[i]->dstFormat, dstStride[i])) {
+            av_log(ctx[i], AV_LOG_ERROR, "bad dst image pointers\n");
+            return AVERROR(EINVAL);
+        }
+    }
+    desc = av_pix_fmt_desc_get(ctx[0]->srcFormat);
+
+    mode = av_mallocz(nb_contexts);
+    if (!mode)
+        return AVERROR(ENOMEM);
+
+    /* The generic scaler keeps its state across slices, so the source can
+     * be fed to it band by band. The contexts using the same input
+     * converters as the first one share its unpacked lines. */
+    for (i = 0; i < nb_contexts; i++) {
+        SwsContext *c = ctx[i];
+
+        /* the same check as sws_scale(), whose return value does not tell
+         * an error from a slice without output lines */
+        if (!c->sliceDir && srcSliceY && srcSliceY + srcSliceH != c->srcH) {
+            av_log(c, AV_LOG_ERROR, "Slices start in the middle!\n");
+            ret = AVERROR(EINVAL);
+            goto end;
+        }
+    }
+    for (i = 0; i < nb_contexts; i++) {
+        SwsContext *c = ctx[i];
+
+        /* bottom-up frames are flipped by sws_scale() */
+        if (c->swscale != swscale || c->sliceDir < 0 ||
+            (!c->sliceDir && srcSliceY) || usePal(c->srcFormat) ||
+            has_holes(c->vLumFilterPos, c->vLumFilterSize, c->dstH) ||
+            has_holes(c->vChrFilterPos, c->vChrFilterSize, c->chrDstH))
+            continue;
+
+        mode[i] = MULTI_BAND;
+        band    = FFMAX(band, 1 << c->chrSrcVSubSample);
+        if (!conv_leader)
+            conv_leader = c;
+        if (same_input(c, conv_leader)) {
+            mode[i]   = MULTI_BAND_CONVERTED;
+            need_chr |= c->needs_hcscale;
+            need_alp |= !!c->alpPixBuf;
+        }
+    }
+
+    /* Contexts with the same horizontal filters as an earlier one copy its
+     * scaled lines instead of computing them again. */
+    for (i = 0; i < nb_contexts; i++) {
+        SwsContext *c = ctx[i];
+
+        for (j = 0; mode[i] && j < i; j++) {
+            if (mode[j] != mode[i] || !same_input(c, ctx[j]))
+                continue;
+            if (!c->lumShare && same_lum_hscale(c, ctx[j])) {
+                if ((ret = alloc_buf_line(&ctx[j]->lumBufLine,
+                                          ctx[j]->vLumBufSize)) < 0)
+                    goto end;
+                c->lumShare = ctx[j];
+            }
+            if (!c->chrShare && same_chr_hscale(c, ctx[j])) {
+                if ((ret = alloc_buf_line(&ctx[j]->chrBufLine,
+                                          ctx[j]->vChrBufSize)) < 0)
+                    goto end;
+                c->chrShare = ctx[j];
+            }
+        }
+    }
+
+    if (conv_leader) {
+        buf_stride = FFALIGN(FFALIGN(conv_leader->srcW, 16) *
+                             FFALIGN(conv_leader->srcBpc, 8) / 8 + 16, 16);
+        conv_buf   = av_malloc(buf_stride * 4 * band);
+        if (!conv_buf) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+    }
+
+    for (y = srcSliceY; y < srcSliceY + srcSliceH; y += band) {
+        const int h = FFMIN(band, srcSliceY + srcSliceH - y);
+        const uint8_t *src[4], *conv[4];
+        int stride[4], convStride[4];
+
+        for (i = 0; i < 4; i++) {
+            int shift = (i == 1 || i == 2) ? desc->log2_chroma_h : 0;
+
+            src[i]    = srcSlice[i] ? srcSlice[i] + ((y - srcSliceY) >> shift) *
+                                                    srcStride[i] : NULL;
+            stride[i] = srcStride[i];
+        }
+
+        if (conv_leader) {
+            const uint8_t *tmp[4] = { src[0], src[1], src[2], src[3] };
+            int tmpStride[4]      = { stride[0], stride[1], stride[2], stride[3] };
+
+            convert_band(conv_leader, conv_buf, buf_stride, need_chr, need_alp,
+                         h, tmp, tmpStride, conv, convStride);
+        }
+
+        for (i = 0; i < nb_contexts; i++) {
+            const uint8_t *src2[4];
+            int srcStride2[4];
+            uint8_t *dst2[4];
+            int dstStride2[4];
+
+            if (mode[i] == MULTI_SWS_SCALE)
+                continue;
+
+            for (j = 0; j < 4; j++) {
+                src2[j]       = mode[i] == MULTI_BAND_CONVERTED ? conv[j]       : src[j];
+                srcStride2[j] = mode[i] == MULTI_BAND_CONVERTED ? convStride[j] : stride[j];
+                dst2[j]       = dst[i][j];
+                dstStride2[j] = dstStride[i][j];
+            }
+
+            ctx[i]->inputConverted = mode[i] == MULTI_BAND_CONVERTED;
+            swscale(ctx[i], src2, srcStride2, y, h, dst2, dstStride2);
+            ctx[i]->inputConverted = 0;
+        }
+    }
+
+    /* Track the slice order as sws_scale() does, so that the slices of a
+     * frame can be passed to either function. */
+    for (i = 0; i < nb_contexts; i++)
+        if (mode[i] != MULTI_SWS_SCALE)
+            ctx[i]->sliceDir = srcSliceY + srcSliceH == ctx[i]->srcH ? 0 : 1;
+
+    for (i = 0; i < nb_contexts; i++)
+        if (mode[i] == MULTI_SWS_SCALE)
+            sws_scale(ctx[i], srcSlice, srcStride, srcSliceY, srcSliceH,
+                      dst[i], dstStride[i]);
+
+end:
+    for (i = 0; i < nb_contexts; i++) {
+        ctx[i]->lumShare = NULL;
+        ctx[i]->chrShare = NULL;
+    }
+    av_free(conv_buf);
+    av_free(mode);
+
+    return ret;
+}
@@ -158,6 +158,13 @@ int sws_init_context(struct SwsContext *sws_context, SwsFilter *srcFilter, SwsFi
  */
 void sws_freeContext(struct SwsContext *swsContext);
 
+/**
+ * Free the filters kept by the filter cache for the contexts created later.
+ * The contexts sharing these filters keep using them, the memory is released
+ * with the last one of these contexts.
+ */
+void sws_flush_filter_cache(void);
+
 /**
  * Allocate and return an SwsContext. You need it to perform
  * scaling/conversion operations using sws_scale().
@@ -208,6 +215,41 @@ int sws_scale(struct SwsContext *c, const uint8_t *const srcSlice[],
               const int srcStride[], int srcSliceY, int srcSliceH,
               uint8_t *const dst[], const int dstStride[]);
 
+/**
+ * Scale the image slice in srcSlice to several destinations at once.
+ *
+ * The slice is fed to all the contexts a few lines at a time, so that the
+ * source stays in cache. The contexts using the generic scaler unpack the
+ * source lines only once, and those with the same horizontal scaling
+ * parameters (e.g. the same output width) reuse the horizontally scaled
+ * lines of the first of them.
+ *
+ * Slices have to be provided in sequential order as for sws_scale(), and
+ * the slices of a frame may be passed to sws_scale() and
+ * sws_scale_multi() in turn. Bottom-up slices are scaled with sws_scale()
+ * for each context.
+ *
+ * @param ctx         the scaling contexts, they must all have the same
+ *                    source width, height and pixel format
+ * @param nb_contexts the number of contexts in ctx
+ * @param srcSlice    the array containing the pointers to the planes of
+ *                    the source slice
+ * @param srcStride   the array containing the strides for each plane of
+ *                    the source image
+ * @param srcSliceY   the position in the source image of the slice to
+ *                    process
+ * @param srcSliceH   the height of the source slice
+ * @param dst         the arrays containing the pointers to the planes of
+ *                    each destination image
+ * @param dstStride   the arrays containing the strides for each plane of
+ *                    each destination image
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int sws_scale_multi(struct SwsContext **ctx, int nb_contexts,
+                    const uint8_t *const srcSlice[], const int srcStride[],
+                    int srcSliceY, int srcSliceH,
+                    uint8_t *const *const dst[], const int *const dstStride[]);
+
 /**
  * @param inv_table the yuv2rgb coefficients, normally ff_yuv2rgb_coeffs[x]
  * @return -1 if not supported
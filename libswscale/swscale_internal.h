@@ -306,6 +306,17 @@ typedef struct SwsContext {
     int lastInChrBuf;             ///< Last scaled horizontal chroma     line from source in the ring buffer.
     int lumBufIndex;              ///< Index in ring buffer of the last scaled horizontal luma/alpha line from source.
     int chrBufIndex;              ///< Index in ring buffer of the last scaled horizontal chroma     line from source.
+    int32_t *lumBufLine;          ///< Source line held by each luma/alpha ring buffer slot, tracked if other contexts reuse them.
+    int32_t *chrBufLine;          ///< Source line held by each chroma     ring buffer slot, tracked if other contexts reuse them.
+    //@}
+
+    /**
+     * @name One-to-many scaling state, only set during sws_scale_multi().
+     */
+    //@{
+    struct SwsContext *lumShare;  ///< Context whose scaled horizontal luma/alpha lines can be copied instead of computed.
+    struct SwsContext *chrShare;  ///< Context whose scaled horizontal chroma     lines can be copied instead of computed.
+    int inputConverted;           ///< Set if the source planes already went through the input converters.
     //@}
 
     uint8_t *formatConvBuffer;
@@ -338,6 +349,19 @@ typedef struct SwsContext {
     int vChrFilterSize;           ///< Vertical   filter size for chroma     pixels.
     //@}
 
+    /**
+     * @name Filter cache references
+     * Owners of the filter coefficients and positions above when they are
+     * shared with other contexts through the filter cache, NULL when the
+     * arrays belong to this context.
+     */
+    //@{
+    struct AVBufferRef *hLumFilterRef;
+    struct AVBufferRef *hChrFilterRef;
+    struct AVBufferRef *vLumFilterRef;
+    struct AVBufferRef *vChrFilterRef;
+    //@}
+
     int lumMmxextFilterCodeSize;  ///< Runtime-generated MMXEXT horizontal fast bilinear scaler code size for luma/alpha planes.
     int chrMmxextFilterCodeSize;  ///< Runtime-generated MMXEXT horizontal fast bilinear scaler code size for chroma planes.
     uint8_t *lumMmxextFilterCode; ///< Runtime-generated MMXEXT horizontal fast bilinear scaler code for luma/alpha planes.
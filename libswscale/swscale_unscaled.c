@@ -176,6 +176,70 @@ static int nv12ToPlanarWrapper(SwsContext *c, const uint8_t *src[],
     return srcSliceH;
 }
 
+static int p010ToPlanarWrapper(SwsContext *c, const uint8_t *src[],
+                               int srcStride[], int srcSliceY,
+                               int srcSliceH, uint8_t *dstParam[],
+                               int dstStride[])
+{
+    const int shift = 16 - av_pix_fmt_desc_get(c->dstFormat)->comp[0].depth;
+    const int chrW  = AV_CEIL_RSHIFT(c->srcW, 1);
+    const int chrH  = AV_CEIL_RSHIFT(srcSliceH, 1);
+    const uint8_t *srcY  = src[0];
+    const uint8_t *srcUV = src[1];
+    uint8_t *dstY = dstParam[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstU = dstParam[1] + dstStride[1] * srcSliceY / 2;
+    uint8_t *dstV = dstParam[2] + dstStride[2] * srcSliceY / 2;
+    int i;
+
+    for (i = 0; i < srcSliceH; i++) {
+        shiftWordsRight((const uint16_t *)srcY, (uint16_t *)dstY,
+                        c->srcW, shift);
+        srcY += srcStride[0];
+        dstY += dstStride[0];
+    }
+    for (i = 0; i < chrH; i++) {
+        deinterleaveWords((const uint16_t *)srcUV, (uint16_t *)dstU,
+                          (uint16_t *)dstV, chrW, shift);
+        srcUV += srcStride[1];
+        dstU  += dstStride[1];
+        dstV  += dstStride[2];
+    }
+
+    return srcSliceH;
+}
+
+static int planarToP010Wrapper(SwsContext *c, const uint8_t *src[],
+                               int srcStride[], int srcSliceY,
+                               int srcSliceH, uint8_t *dstParam[],
+                               int dstStride[])
+{
+    const int shift = 16 - av_pix_fmt_desc_get(c->srcFormat)->comp[0].depth;
+    const int chrW  = AV_CEIL_RSHIFT(c->srcW, 1);
+    const int chrH  = AV_CEIL_RSHIFT(srcSliceH, 1);
+    const uint8_t *srcY = src[0];
+    const uint8_t *srcU = src[1];
+    const uint8_t *srcV = src[2];
+    uint8_t *dstY  = dstParam[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstUV = dstParam[1] + dstStride[1] * srcSliceY / 2;
+    int i;
+
+    for (i = 0; i < srcSliceH; i++) {
+        shiftWordsLeft((const uint16_t *)srcY, (uint16_t *)dstY,
+                       c->srcW, shift);
+        srcY += srcStride[0];
+        dstY += dstStride[0];
+    }
+    for (i = 0; i < chrH; i++) {
+        interleaveWords((const uint16_t *)srcU, (const uint16_t *)srcV,
+                        (uint16_t *)dstUV, chrW, shift);
+        srcU  += srcStride[1];
+        srcV  += srcStride[2];
+        dstUV += dstStride[1];
+    }
+
+    return srcSliceH;
+}
+
 static int planarToYuy2Wrapper(SwsContext *c, const uint8_t *src[],
                                int srcStride[], int srcSliceY, int srcSliceH,
                                uint8_t *dstParam[], int dstStride[])
@@ -908,7 +972,16 @@ static int planarCopyWrapper(SwsContext *c, const uint8_t *src[],
                                     srcPtr2, srcStride[plane] / 2, rfunc, \
                                     dither_8x8_3, 2, av_clip_uint8); \
                     }
-                    if (isBE(c->srcFormat)) {
+                    if (isBE(c->srcFormat) == HAVE_BIGENDIAN) {
+                        const uint8_t (*dither)[8] = src_depth == 9 ? dither_8x8_1
+                                                                    : dither_8x8_3;
+                        for (i = 0; i < height; i++) {
+                            wordsToBytesDither(srcPtr2, dstPtr, length,
+                                               dither[i & 7], src_depth == 9 ? 1 : 2);
+                            dstPtr  += dstStride[plane];
+                            srcPtr2 += srcStride[plane] / 2;
+                        }
+                    } else if (isBE(c->srcFormat)) {
                         COPY9_OR_10TO8(AV_RB16);
                     } else {
                         COPY9_OR_10TO8(AV_RL16);
@@ -964,7 +1037,13 @@ static int planarCopyWrapper(SwsContext *c, const uint8_t *src[],
                             srcPtr  += srcStride[plane]; \
                         } \
                     }
-                    if (isBE(c->dstFormat)) {
+                    if (shiftonly && isBE(c->dstFormat) == HAVE_BIGENDIAN) {
+                        for (i = 0; i < height; i++) {
+                            bytesToWords(srcPtr, dstPtr2, length, dst_depth - 8);
+                            dstPtr2 += dstStride[plane] / 2;
+                            srcPtr  += srcStride[plane];
+                        }
+                    } else if (isBE(c->dstFormat)) {
                         COPY8TO9_OR_10(AV_WB16);
                     } else {
                         COPY8TO9_OR_10(AV_WL16);
@@ -976,7 +1055,14 @@ static int planarCopyWrapper(SwsContext *c, const uint8_t *src[],
                     DITHER_COPY(dstPtr,  dstStride[plane],   W8, \
                                 srcPtr2, srcStride[plane] / 2, rfunc, \
                                 dither_8x8_256, 8, av_clip_uint8);
-                if (isBE(c->srcFormat)) {
+                if (isBE(c->srcFormat) == HAVE_BIGENDIAN) {
+                    for (i = 0; i < height; i++) {
+                        wordsToBytesDither(srcPtr2, dstPtr, length,
+                                           dither_8x8_256[i & 7], 8);
+                        dstPtr  += dstStride[plane];
+                        srcPtr2 += srcStride[plane] / 2;
+                    }
+                } else if (isBE(c->srcFormat)) {
                     COPY16TO8(AV_RB16);
                 } else {
                     COPY16TO8(AV_RL16);
@@ -1047,6 +1133,12 @@ void ff_get_unscaled_swscale(SwsContext *c)
         (srcFormat == AV_PIX_FMT_NV12 || srcFormat == AV_PIX_FMT_NV21)) {
         c->swscale = nv12ToPlanarWrapper;
     }
+    /* p010_to_yuv420p10 */
+    if (srcFormat == AV_PIX_FMT_P010 && dstFormat == AV_PIX_FMT_YUV420P10)
+        c->swscale = p010ToPlanarWrapper;
+    /* yuv420p10_to_p010 */
+    if (srcFormat == AV_PIX_FMT_YUV420P10 && dstFormat == AV_PIX_FMT_P010)
+        c->swscale = planarToP010Wrapper;
     /* yuv2bgr */
     if ((srcFormat == AV_PIX_FMT_YUV420P || srcFormat == AV_PIX_FMT_YUV422P ||
          srcFormat == AV_PIX_FMT_YUVA420P) && isAnyRGB(dstFormat) &&
@@ -0,0 +1,152 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check that the contexts sharing their filters through the filter cache
+ * get the same filters as a context generating them from scratch, and that
+ * the cache keeps the filters of recurring sizes.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libswscale/swscale.h"
+#include "libswscale/swscale_internal.h"
+
+static struct SwsContext *get_context(int dst_w, int dst_h)
+{
+    return sws_getContext(352, 288, AV_PIX_FMT_YUV420P, dst_w, dst_h,
+                          AV_PIX_FMT_YUV420P, SWS_BICUBIC, NULL, NULL, NULL);
+}
+
+/* Compare the luma filters of a and b, same tells whether they must also be
+ * the same arrays. */
+static int check_filters(const SwsContext *a, const SwsContext *b, int same)
+{
+    if (a->hLumFilterSize != b->hLumFilterSize ||
+        a->vLumFilterSize != b->vLumFilterSize ||
+        memcmp(a->hLumFilter, b->hLumFilter,
+               a->dstW * a->hLumFilterSize * sizeof(*a->hLumFilter)) ||
+        memcmp(a->hLumFilterPos, b->hLumFilterPos,
+               a->dstW * sizeof(*a->hLumFilterPos)) ||
+        memcmp(a->vLumFilter, b->vLumFilter,
+               a->dstH * a->vLumFilterSize * sizeof(*a->vLumFilter)) ||
+        memcmp(a->vLumFilterPos, b->vLumFilterPos,
+               a->dstH * sizeof(*a->vLumFilterPos))) {
+        fprintf(stderr, "the filters differ\n");
+        return 1;
+    }
+    if (same != (a->hLumFilter == b->hLumFilter &&
+                 a->vLumFilter == b->vLumFilter)) {
+        fprintf(stderr, "the filters are %sshared\n", same ? "not " : "");
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    SwsContext *fresh = NULL, *ref = NULL, *hit = NULL, *other = NULL;
+    SwsFilter *identity = NULL;
+    const int16_t *h_filter, *v_filter;
+    int i, ret = 1;
+
+    /* user vectors bypass the cache */
+    identity = sws_getDefaultFilter(0, 0, 0, 0, 0, 0, 0);
+    if (!identity)
+        goto end;
+    fresh = sws_getContext(352, 288, AV_PIX_FMT_YUV420P, 176, 144,
+                           AV_PIX_FMT_YUV420P, SWS_BICUBIC, identity, NULL,
+                           NULL);
+    ref   = get_context(176, 144);
+    hit   = get_context(176, 144);
+    other = get_context(176, 120);
+    if (!fresh || !ref || !hit || !other) {
+        fprintf(stderr, "cannot create the contexts\n");
+        goto end;
+    }
+
+    if (!ref->hLumFilterRef || !ref->vLumFilterRef ||
+        fresh->hLumFilterRef || fresh->vLumFilterRef) {
+        fprintf(stderr, "unexpected use of the filter cache\n");
+        goto end;
+    }
+    if (check_filters(ref, hit, 1) || check_filters(ref, fresh, 0))
+        goto end;
+    /* only the vertical filters depend on the output height */
+    if (other->hLumFilter != ref->hLumFilter ||
+        other->vLumFilter == ref->vLumFilter) {
+        fprintf(stderr, "wrong cache lookup for a different height\n");
+        goto end;
+    }
+
+    /* the cache keeps the filters once their last user is freed */
+    h_filter = ref->hLumFilter;
+    v_filter = ref->vLumFilter;
+    sws_freeContext(ref);
+    sws_freeContext(hit);
+    hit = NULL;
+    ref = get_context(176, 144);
+    if (!ref) {
+        fprintf(stderr, "cannot create the contexts\n");
+        goto end;
+    }
+    if (ref->hLumFilter != h_filter || ref->vLumFilter != v_filter) {
+        fprintf(stderr, "the filters of a freed context are not reused\n");
+        goto end;
+    }
+
+    /* more sizes than the cache holds, but the recurring one is reused
+     * before it becomes the least recently used entry */
+    for (i = 0; i < 2 * 32; i++) {
+        sws_freeContext(ref);
+        sws_freeContext(hit);
+        hit = get_context(64 + 2 * i, 48 + 2 * i);
+        ref = get_context(176, 144);
+        if (!hit || !ref) {
+            fprintf(stderr, "cannot create the contexts\n");
+            goto end;
+        }
+        if (ref->vLumFilter != v_filter) {
+            fprintf(stderr, "a recently used filter was evicted\n");
+            goto end;
+        }
+    }
+
+    /* once flushed, the filters are generated again */
+    sws_flush_filter_cache();
+    sws_freeContext(hit);
+    hit = get_context(176, 144);
+    if (!hit) {
+        fprintf(stderr, "cannot create the contexts\n");
+        goto end;
+    }
+    if (check_filters(hit, ref, 0) || check_filters(hit, fresh, 0))
+        goto end;
+
+    ret = 0;
+
+end:
+    sws_freeContext(fresh);
+    sws_freeContext(ref);
+    sws_freeContext(hit);
+    sws_freeContext(other);
+    sws_freeFilter(identity);
+    sws_flush_filter_cache();
+    return ret;
+}
@@ -0,0 +1,276 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check that sws_scale_multi() gives the same output as scaling the
+ * source with each context on its own with sws_scale(), also when the
+ * slices of a frame are passed to either function in turn.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/internal.h"
+#include "libavutil/lfg.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+
+#include "libswscale/swscale.h"
+
+#define MAX_CONTEXTS 4
+
+typedef struct Output {
+    int w, h;
+    enum AVPixelFormat format;
+    int flags;
+} Output;
+
+/* The first two outputs share their horizontal filters. The last one has
+ * the source size (0x0), its unscaled conversion falls back to sws_scale(). */
+static const Output outputs[] = {
+    { 176,  49, AV_PIX_FMT_YUV420P, SWS_BICUBIC  },
+    { 176,  97, AV_PIX_FMT_YUV420P, SWS_BICUBIC  },
+    { 320,  75, AV_PIX_FMT_RGB24,   SWS_BILINEAR },
+    {  91,  33, AV_PIX_FMT_GRAY8,   SWS_BICUBIC  },
+    { 640, 195, AV_PIX_FMT_YUV444P, SWS_LANCZOS  },
+    {   0,   0, AV_PIX_FMT_YUV420P, SWS_BICUBIC  },
+};
+
+static const enum AVPixelFormat src_formats[] = {
+    AV_PIX_FMT_YUV420P, AV_PIX_FMT_RGB24, AV_PIX_FMT_YUYV422,
+};
+
+static const int src_heights[] = { 97, 61, 33 };
+
+typedef struct Image {
+    uint8_t *data[4];
+    int linesize[4];
+} Image;
+
+enum ScaleMode {
+    SCALE_SINGLE,       ///< sws_scale() for each context
+    SCALE_MULTI,        ///< sws_scale_multi()
+    SCALE_MIXED,        ///< both in turn, starting with sws_scale()
+    SCALE_MIXED_MULTI,  ///< both in turn, starting with sws_scale_multi()
+};
+
+static int scale_slices(struct SwsContext **ctx, int nb_contexts,
+                        const Image *src, enum AVPixelFormat src_format,
+                        int src_h, int slice_h, Image *dst,
+                        enum ScaleMode mode)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(src_format);
+    uint8_t *const *dst_data[MAX_CONTEXTS];
+    const int *dst_linesize[MAX_CONTEXTS];
+    int i, y, ret;
+
+    for (i = 0; i < nb_contexts; i++) {
+        dst_data[i]     = dst[i].data;
+        dst_linesize[i] = dst[i].linesize;
+    }
+
+    for (y = 0; y < src_h; y += slice_h) {
+        const int h = FFMIN(slice_h, src_h - y);
+        const int n = y / slice_h;
+        const uint8_t *slice[4];
+        int multi = mode == SCALE_MULTI ||
+                    (mode == SCALE_MIXED       &&  (n & 1)) ||
+                    (mode == SCALE_MIXED_MULTI && !(n & 1));
+
+        for (i = 0; i < 4; i++) {
+            int shift = (i == 1 || i == 2) ? desc->log2_chroma_h : 0;
+            slice[i] = src->data[i] ? src->data[i] + (y >> shift) * src->linesize[i]
+                                    : NULL;
+        }
+        if (multi) {
+            ret = sws_scale_multi(ctx, nb_contexts, slice, src->linesize,
+                                  y, h, dst_data, dst_linesize);
+            if (ret < 0)
+                return ret;
+        } else {
+            for (i = 0; i < nb_contexts; i++)
+                sws_scale(ctx[i], slice, src->linesize, y, h,
+                          dst[i].data, dst[i].linesize);
+        }
+    }
+
+    return 0;
+}
+
+static int run_test(enum AVPixelFormat src_format, int src_h, int first,
+                    int nb_contexts, int slice_h, int mixed, AVLFG *rnd)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(src_format);
+    struct SwsContext *multi_ctx[MAX_CONTEXTS] = { NULL };
+    struct SwsContext *ref_ctx[MAX_CONTEXTS]   = { NULL };
+    Image src = { { NULL } }, dst[MAX_CONTEXTS], ref[MAX_CONTEXTS];
+    const int src_w = 352;
+    int i, p, y, size, ret = 0;
+
+    memset(dst, 0, sizeof(dst));
+    memset(ref, 0, sizeof(ref));
+
+    if (av_image_alloc(src.data, src.linesize, src_w, src_h, src_format, 16) < 0)
+        return AVERROR(ENOMEM);
+    for (p = 0; p < 4 && src.data[p]; p++) {
+        int h = (p == 1 || p == 2) ? AV_CEIL_RSHIFT(src_h, desc->log2_chroma_h)
+                                   : src_h;
+        for (y = 0; y < h * src.linesize[p]; y++)
+            src.data[p][y] = av_lfg_get(rnd);
+    }
+
+    for (i = 0; i < nb_contexts; i++) {
+        const Output *o = &outputs[(first + i) % FF_ARRAY_ELEMS(outputs)];
+        int w = o->w ? o->w : src_w, h = o->h ? o->h : src_h;
+
+        multi_ctx[i] = sws_getContext(src_w, src_h, src_format,
+                                      w, h, o->format, o->flags,
+                                      NULL, NULL, NULL);
+        ref_ctx[i]   = sws_getContext(src_w, src_h, src_format,
+                                      w, h, o->format, o->flags,
+                                      NULL, NULL, NULL);
+        if (!multi_ctx[i] || !ref_ctx[i] ||
+            (size = av_image_alloc(dst[i].data, dst[i].linesize,
+                                   w, h, o->format, 16)) < 0 ||
+            av_image_alloc(ref[i].data, ref[i].linesize,
+                           w, h, o->format, 16) < 0) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        /* some converters leave the last chroma line of odd heights */
+        memset(dst[i].data[0], 0, size);
+        memset(ref[i].data[0], 0, size);
+    }
+
+    /* the chroma of a slice starts on a whole chroma line */
+    slice_h = FFALIGN(slice_h, 1 << desc->log2_chroma_h);
+
+    /* two frames, so that the slice order of the first one has to be
+     * tracked in the same way by both functions */
+    ret = scale_slices(multi_ctx, nb_contexts, &src, src_format, src_h,
+                       slice_h, dst, mixed ? SCALE_MIXED : SCALE_MULTI);
+    if (ret >= 0)
+        ret = scale_slices(multi_ctx, nb_contexts, &src, src_format, src_h,
+                           slice_h, dst, mixed ? SCALE_MIXED_MULTI : SCALE_MULTI);
+    if (ret < 0) {
+        fprintf(stderr, "sws_scale_multi() failed\n");
+        goto end;
+    }
+    scale_slices(ref_ctx, nb_contexts, &src, src_format, src_h, slice_h,
+                 ref, SCALE_SINGLE);
+
+    for (i = 0; i < nb_contexts; i++) {
+        const Output *o = &outputs[(first + i) % FF_ARRAY_ELEMS(outputs)];
+        const AVPixFmtDescriptor *odesc = av_pix_fmt_desc_get(o->format);
+        int dst_w = o->w ? o->w : src_w, dst_h = o->h ? o->h : src_h;
+
+        for (p = 0; p < 4 && ref[i].data[p]; p++) {
+            int h = (p == 1 || p == 2) ? AV_CEIL_RSHIFT(dst_h, odesc->log2_chroma_h)
+                                       : dst_h;
+            int w = av_image_get_linesize(o->format, dst_w, p);
+
+            for (y = 0; y < h; y++) {
+                if (memcmp(dst[i].data[p] + y * dst[i].linesize[p],
+                           ref[i].data[p] + y * ref[i].linesize[p], w)) {
+                    fprintf(stderr, "%s %dx%d -> %s %dx%d, %d contexts, "
+                            "slices of %d lines%s: plane %d line %d differs\n",
+                            av_get_pix_fmt_name(src_format), src_w, src_h,
+                            av_get_pix_fmt_name(o->format), dst_w, dst_h,
+                            nb_contexts, slice_h, mixed ? ", mixed" : "",
+                            p, y);
+                    ret = 1;
+                    goto end;
+                }
+            }
+        }
+    }
+
+end:
+    for (i = 0; i < nb_contexts; i++) {
+        sws_freeContext(multi_ctx[i]);
+        sws_freeContext(ref_ctx[i]);
+        av_freep(&dst[i].data[0]);
+        av_freep(&ref[i].data[0]);
+    }
+    av_freep(&src.data[0]);
+
+    return ret;
+}
+
+static int test_errors(void)
+{
+    struct SwsContext *ctx;
+    uint8_t *src[4] = { NULL }, *dst[4] = { NULL };
+    int src_linesize[4], dst_linesize[4];
+    uint8_t *const *dst_data[1] = { dst };
+    const int *dst_lines[1]     = { dst_linesize };
+    int ret = 0;
+
+    ctx = sws_getContext(64, 64, AV_PIX_FMT_YUV420P, 32, 32, AV_PIX_FMT_YUV420P,
+                         SWS_BICUBIC, NULL, NULL, NULL);
+    if (!ctx ||
+        av_image_alloc(src, src_linesize, 64, 64, AV_PIX_FMT_YUV420P, 16) < 0 ||
+        av_image_alloc(dst, dst_linesize, 32, 32, AV_PIX_FMT_YUV420P, 16) < 0) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    /* a missing destination plane */
+    dst[2] = NULL;
+    if (sws_scale_multi(&ctx, 1, (const uint8_t *const *)src, src_linesize,
+                        0, 64, dst_data, dst_lines) >= 0) {
+        fprintf(stderr, "missing destination plane not rejected\n");
+        ret = 1;
+    }
+
+end:
+    sws_freeContext(ctx);
+    av_freep(&src[0]);
+    av_freep(&dst[0]);
+
+    return ret;
+}
+
+int main(void)
+{
+    AVLFG rnd;
+    int f, h, n, first, ret;
+
+    av_lfg_init(&rnd, 0xdeadbeef);
+
+    for (f = 0; f < FF_ARRAY_ELEMS(src_formats); f++)
+        for (h = 0; h < FF_ARRAY_ELEMS(src_heights); h++)
+            for (n = 1; n <= MAX_CONTEXTS; n++)
+                for (first = 0; first < FF_ARRAY_ELEMS(outputs); first += 2) {
+                    /* the whole frame at once, then in slices */
+                    ret = run_test(src_formats[f], src_heights[h], first, n,
+                                   src_heights[h], 0, &rnd);
+                    if (!ret)
+                        ret = run_test(src_formats[f], src_heights[h], first,
+                                       n, 13, 0, &rnd);
+                    if (!ret)
+                        ret = run_test(src_formats[f], src_heights[h], first,
+                                       n, 13, 1, &rnd);
+                    if (ret)
+                        return 1;
+                }
+
+    return test_errors() ? 1 : 0;
+}
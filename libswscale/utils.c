@@ -41,12 +41,14 @@
 #include "libavutil/attributes.h"
 #include "libavutil/avutil.h"
 #include "libavutil/bswap.h"
+#include "libavutil/buffer.h"
 #include "libavutil/cpu.h"
 #include "libavutil/intreadwrite.h"
 #include "libavutil/mathematics.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
 #include "libavutil/ppc/cpu.h"
+#include "libavutil/thread.h"
 #include "libavutil/x86/asm.h"
 #include "libavutil/x86/cpu.h"
 #include "rgb2rgb.h"
@@ -200,8 +202,8 @@ static const FormatEntry format_entries[AV_PIX_FMT_NB] = {
     [AV_PIX_FMT_GBRAP16BE]   = { 1, 0 },
     [AV_PIX_FMT_XYZ12BE]     = { 0, 0, 1 },
     [AV_PIX_FMT_XYZ12LE]     = { 0, 0, 1 },
-    [AV_PIX_FMT_P010LE]      = { 1, 0 },
-    [AV_PIX_FMT_P010BE]      = { 1, 0 },
+    [AV_PIX_FMT_P010LE]      = { 1, 1 },
+    [AV_PIX_FMT_P010BE]      = { 1, 1 },
 };
 
 int sws_isSupportedInput(enum AVPixelFormat pix_fmt)
@@ -629,6 +631,172 @@ fail:
     return ret;
 }
 
+/* Filters built without user vectors only depend on these parameters,
+ * so they are shared between the contexts. The cache holds a reference to
+ * the FILTER_CACHE_SIZE most recently used filters, so the filters of a
+ * recurring size pair outlive the contexts using them. */
+#define FILTER_CACHE_SIZE 32
+
+typedef struct FilterKey {
+    int xInc;
+    int srcW;
+    int dstW;
+    int filterAlign;
+    int one;
+    int flags;
+    int cpu_flags;
+    int is_horizontal;
+    double param[2];
+} FilterKey;
+
+typedef struct CachedFilter {
+    FilterKey key;
+    int16_t *filter;
+    int32_t *filterPos;
+    int filterSize;
+} CachedFilter;
+
+/* ordered from the most to the least recently used entry */
+static AVBufferRef *filter_cache[FILTER_CACHE_SIZE];
+static AVMutex filter_cache_lock;
+static AVOnce filter_cache_once = AV_ONCE_INIT;
+
+static av_cold void filter_cache_init(void)
+{
+    ff_mutex_init(&filter_cache_lock, NULL);
+}
+
+static void free_cached_filter(void *opaque, uint8_t *data)
+{
+    CachedFilter *f = (CachedFilter *)data;
+
+    av_free(f->filter);
+    av_free(f->filterPos);
+    av_free(f);
+}
+
+/* Make entry the most recently used one, dropping the entry at index last. */
+static void filter_cache_promote(AVBufferRef *entry, int last)
+{
+    memmove(&filter_cache[1], &filter_cache[0], last * sizeof(*filter_cache));
+    filter_cache[0] = entry;
+}
+
+static AVBufferRef *filter_cache_find(const FilterKey *key)
+{
+    AVBufferRef *ref = NULL;
+    int i;
+
+    ff_mutex_lock(&filter_cache_lock);
+    for (i = 0; i < FILTER_CACHE_SIZE && filter_cache[i]; i++) {
+        const CachedFilter *f = (const CachedFilter *)filter_cache[i]->data;
+
+        if (!memcmp(&f->key, key, sizeof(*key))) {
+            ref = av_buffer_ref(filter_cache[i]);
+            filter_cache_promote(filter_cache[i], i);
+            break;
+        }
+    }
+    ff_mutex_unlock(&filter_cache_lock);
+
+    return ref;
+}
+
+/* Failing to add the filter only makes the next lookup miss. */
+static void filter_cache_add(AVBufferRef *ref)
+{
+    AVBufferRef *entry = av_buffer_ref(ref);
+
+    if (!entry)
+        return;
+
+    ff_mutex_lock(&filter_cache_lock);
+    av_buffer_unref(&filter_cache[FILTER_CACHE_SIZE - 1]);
+    filter_cache_promote(entry, FILTER_CACHE_SIZE - 1);
+    ff_mutex_unlock(&filter_cache_lock);
+}
+
+void sws_flush_filter_cache(void)
+{
+    int i;
+
+    ff_thread_once(&filter_cache_once, filter_cache_init);
+
+    ff_mutex_lock(&filter_cache_lock);
+    for (i = 0; i < FILTER_CACHE_SIZE; i++)
+        av_buffer_unref(&filter_cache[i]);
+    ff_mutex_unlock(&filter_cache_lock);
+}
+
+/**
+ * Same as initFilter(), but the filter is looked up in the filter cache
+ * first. If *ref is set on return, it owns the arrays, which must not be
+ * modified.
+ */
+static av_cold int initFilterCached(AVBufferRef **ref, int16_t **outFilter,
+                                    int32_t **filterPos, int *outFilterSize,
+                                    int xInc, int srcW, int dstW,
+                                    int filterAlign, int one,
+                                    int flags, int cpu_flags,
+                                    SwsVector *srcFilter, SwsVector *dstFilter,
+                                    double param[2], int is_horizontal)
+{
+    CachedFilter *f;
+    FilterKey key;
+    int ret;
+
+    if (srcFilter || dstFilter)
+        return initFilter(outFilter, filterPos, outFilterSize, xInc, srcW,
+                          dstW, filterAlign, one, flags, cpu_flags,
+                          srcFilter, dstFilter, param, is_horizontal);
+
+    /* zero the padding, the keys are compared with memcmp() */
+    memset(&key, 0, sizeof(key));
+    key.xInc          = xInc;
+    key.srcW          = srcW;
+    key.dstW          = dstW;
+    key.filterAlign   = filterAlign;
+    key.one           = one;
+    key.flags         = flags;
+    key.cpu_flags     = cpu_flags;
+    key.is_horizontal = is_horizontal;
+    key.param[0]      = param[0];
+    key.param[1]      = param[1];
+
+    ff_thread_once(&filter_cache_once, filter_cache_init);
+
+    *ref = filter_cache_find(&key);
+    if (!*ref) {
+        f = av_mallocz(sizeof(*f));
+        if (!f)
+            return AVERROR(ENOMEM);
+        f->key = key;
+
+        ret = initFilter(&f->filter, &f->filterPos, &f->filterSize, xInc,
+                         srcW, dstW, filterAlign, one, flags, cpu_flags,
+                         NULL, NULL, param, is_horizontal);
+        if (ret < 0) {
+            free_cached_filter(NULL, (uint8_t *)f);
+            return ret;
+        }
+
+        *ref = av_buffer_create((uint8_t *)f, sizeof(*f), free_cached_filter,
+                                NULL, AV_BUFFER_FLAG_READONLY);
+        if (!*ref) {
+            free_cached_filter(NULL, (uint8_t *)f);
+            return AVERROR(ENOMEM);
+        }
+        filter_cache_add(*ref);
+    }
+
+    f              = (CachedFilter *)(*ref)->data;
+    *outFilter     = f->filter;
+    *filterPos     = f->filterPos;
+    *outFilterSize = f->filterSize;
+
+    return 0;
+}
+
 #if HAVE_MMXEXT_INLINE
 static av_cold int init_hscaler_mmxext(int dstW, int xInc, uint8_t *filterCode,
                                        int16_t *filter, int32_t *filterPos,
@@ -1159,19 +1327,21 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
             const int filterAlign = X86_MMX(cpu_flags)     ? 4 :
                                     PPC_ALTIVEC(cpu_flags) ? 8 : 1;
 
-            if (initFilter(&c->hLumFilter, &c->hLumFilterPos,
-                           &c->hLumFilterSize, c->lumXInc,
-                           srcW, dstW, filterAlign, 1 << 14,
-                           (flags & SWS_BICUBLIN) ? (flags | SWS_BICUBIC) : flags,
-                           cpu_flags, srcFilter->lumH, dstFilter->lumH,
-                           c->param, 1) < 0)
+            if (initFilterCached(&c->hLumFilterRef,
+                                 &c->hLumFilter, &c->hLumFilterPos,
+                                 &c->hLumFilterSize, c->lumXInc,
+                                 srcW, dstW, filterAlign, 1 << 14,
+                                 (flags & SWS_BICUBLIN) ? (flags | SWS_BICUBIC) : flags,
+                                 cpu_flags, srcFilter->lumH, dstFilter->lumH,
+                                 c->param, 1) < 0)
                 goto fail;
-            if (initFilter(&c->hChrFilter, &c->hChrFilterPos,
-                           &c->hChrFilterSize, c->chrXInc,
-                           c->chrSrcW, c->chrDstW, filterAlign, 1 << 14,
-                           (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
-                           cpu_flags, srcFilter->chrH, dstFilter->chrH,
-                           c->param, 1) < 0)
+            if (initFilterCached(&c->hChrFilterRef,
+                                 &c->hChrFilter, &c->hChrFilterPos,
+                                 &c->hChrFilterSize, c->chrXInc,
+                                 c->chrSrcW, c->chrDstW, filterAlign, 1 << 14,
+                                 (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
+                                 cpu_flags, srcFilter->chrH, dstFilter->chrH,
+                                 c->param, 1) < 0)
                 goto fail;
         }
     } // initialize horizontal stuff
@@ -1181,18 +1351,20 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
         const int filterAlign = X86_MMX(cpu_flags)     ? 2 :
                                 PPC_ALTIVEC(cpu_flags) ? 8 : 1;
 
-        if (initFilter(&c->vLumFilter, &c->vLumFilterPos, &c->vLumFilterSize,
-                       c->lumYInc, srcH, dstH, filterAlign, (1 << 12),
-                       (flags & SWS_BICUBLIN) ? (flags | SWS_BICUBIC) : flags,
-                       cpu_flags, srcFilter->lumV, dstFilter->lumV,
-                       c->param, 0) < 0)
+        if (initFilterCached(&c->vLumFilterRef,
+                             &c->vLumFilter, &c->vLumFilterPos, &c->vLumFilterSize,
+                             c->lumYInc, srcH, dstH, filterAlign, (1 << 12),
+                             (flags & SWS_BICUBLIN) ? (flags | SWS_BICUBIC) : flags,
+                             cpu_flags, srcFilter->lumV, dstFilter->lumV,
+                             c->param, 0) < 0)
             goto fail;
-        if (initFilter(&c->vChrFilter, &c->vChrFilterPos, &c->vChrFilterSize,
-                       c->chrYInc, c->chrSrcH, c->chrDstH,
-                       filterAlign, (1 << 12),
-                       (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
-                       cpu_flags, srcFilter->chrV, dstFilter->chrV,
-                       c->param, 0) < 0)
+        if (initFilterCached(&c->vChrFilterRef,
+                             &c->vChrFilter, &c->vChrFilterPos, &c->vChrFilterSize,
+                             c->chrYInc, c->chrSrcH, c->chrDstH,
+                             filterAlign, (1 << 12),
+                             (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
+                             cpu_flags, srcFilter->chrV, dstFilter->chrV,
+                             c->param, 0) < 0)
             goto fail;
 
 #if HAVE_ALTIVEC
@@ -1697,6 +1869,19 @@ void sws_freeFilter(SwsFilter *filter)
     av_free(filter);
 }
 
+static void free_filter(AVBufferRef **ref, int16_t **filter,
+                        int32_t **filterPos)
+{
+    if (*ref) {
+        av_buffer_unref(ref);
+        *filter    = NULL;
+        *filterPos = NULL;
+    } else {
+        av_freep(filter);
+        av_freep(filterPos);
+    }
+}
+
 void sws_freeContext(SwsContext *c)
 {
     int i;
@@ -1722,20 +1907,18 @@ void sws_freeContext(SwsContext *c)
         av_freep(&c->alpPixBuf);
     }
 
-    av_freep(&c->vLumFilter);
-    av_freep(&c->vChrFilter);
-    av_freep(&c->hLumFilter);
-    av_freep(&c->hChrFilter);
+    av_freep(&c->lumBufLine);
+    av_freep(&c->chrBufLine);
+
+    free_filter(&c->vLumFilterRef, &c->vLumFilter, &c->vLumFilterPos);
+    free_filter(&c->vChrFilterRef, &c->vChrFilter, &c->vChrFilterPos);
+    free_filter(&c->hLumFilterRef, &c->hLumFilter, &c->hLumFilterPos);
+    free_filter(&c->hChrFilterRef, &c->hChrFilter, &c->hChrFilterPos);
 #if HAVE_ALTIVEC
     av_freep(&c->vYCoeffsBank);
     av_freep(&c->vCCoeffsBank);
 #endif
 
-    av_freep(&c->vLumFilterPos);
-    av_freep(&c->vChrFilterPos);
-    av_freep(&c->hLumFilterPos);
-    av_freep(&c->hChrFilterPos);
-
 #if HAVE_MMX_INLINE
 #if USE_MMAP
     if (c->lumMmxextFilterCode)
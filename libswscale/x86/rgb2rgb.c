@@ -137,11 +137,105 @@ DECLARE_ASM_CONST(8, uint64_t, blue_15mask)  = 0x0000001f0000001fULL;
 
 #endif /* HAVE_INLINE_ASM */
 
+#if HAVE_X86ASM
+/* The SIMD versions process n pixels per iteration, the C loops finish the
+ * row. */
+#define INTERLEAVE_WORDS(opt, n)                                               \
+void ff_interleave_words_ ## opt(const uint16_t *src1, const uint16_t *src2,  \
+                                 uint16_t *dst, int width, int shift);        \
+static void interleaveWords_ ## opt(const uint16_t *src1, const uint16_t *src2, \
+                                    uint16_t *dst, int width, int shift)      \
+{                                                                              \
+    int w = width & ~(n - 1);                                                  \
+                                                                               \
+    if (w)                                                                     \
+        ff_interleave_words_ ## opt(src1, src2, dst, w, shift);               \
+    for (; w < width; w++) {                                                   \
+        dst[2 * w + 0] = src1[w] << shift;                                     \
+        dst[2 * w + 1] = src2[w] << shift;                                     \
+    }                                                                          \
+}
+
+#define DEINTERLEAVE_WORDS(opt, n)                                             \
+void ff_deinterleave_words_ ## opt(const uint16_t *src, uint16_t *dst1,       \
+                                   uint16_t *dst2, int width, int shift);     \
+static void deinterleaveWords_ ## opt(const uint16_t *src, uint16_t *dst1,    \
+                                      uint16_t *dst2, int width, int shift)   \
+{                                                                              \
+    int w = width & ~(n - 1);                                                  \
+                                                                               \
+    if (w)                                                                     \
+        ff_deinterleave_words_ ## opt(src, dst1, dst2, w, shift);             \
+    for (; w < width; w++) {                                                   \
+        dst1[w] = src[2 * w + 0] >> shift;                                     \
+        dst2[w] = src[2 * w + 1] >> shift;                                     \
+    }                                                                          \
+}
+
+#define SHIFT_WORDS(dir, name, op, opt, n)                                     \
+void ff_shift_words_ ## dir ## _ ## opt(const uint16_t *src, uint16_t *dst,   \
+                                        int width, int shift);                \
+static void name ## _ ## opt(const uint16_t *src, uint16_t *dst,              \
+                             int width, int shift)                            \
+{                                                                              \
+    int w = width & ~(n - 1);                                                  \
+                                                                               \
+    if (w)                                                                     \
+        ff_shift_words_ ## dir ## _ ## opt(src, dst, w, shift);               \
+    for (; w < width; w++)                                                     \
+        dst[w] = src[w] op shift;                                              \
+}
+
+#define WORDS_TO_BYTES_DITHER(opt, n)                                          \
+void ff_words_to_bytes_dither_ ## opt(const uint16_t *src, uint8_t *dst,      \
+                                      int width, const uint8_t *dither,       \
+                                      int shift);                             \
+static void wordsToBytesDither_ ## opt(const uint16_t *src, uint8_t *dst,     \
+                                       int width, const uint8_t *dither,      \
+                                       int shift)                             \
+{                                                                              \
+    int w = width & ~(n - 1);                                                  \
+                                                                               \
+    if (w)                                                                     \
+        ff_words_to_bytes_dither_ ## opt(src, dst, w, dither, shift);         \
+    for (; w < width; w++)                                                     \
+        dst[w] = av_clip_uint8((src[w] + dither[w & 7]) >> shift);             \
+}
+
+#define BYTES_TO_WORDS(opt, n)                                                 \
+void ff_bytes_to_words_ ## opt(const uint8_t *src, uint16_t *dst,             \
+                               int width, int shift);                         \
+static void bytesToWords_ ## opt(const uint8_t *src, uint16_t *dst,           \
+                                 int width, int shift)                        \
+{                                                                              \
+    int w = width & ~(n - 1);                                                  \
+                                                                               \
+    if (w)                                                                     \
+        ff_bytes_to_words_ ## opt(src, dst, w, shift);                        \
+    for (; w < width; w++)                                                     \
+        dst[w] = src[w] << shift;                                              \
+}
+
+INTERLEAVE_WORDS(sse2, 8)
+DEINTERLEAVE_WORDS(sse4, 8)
+SHIFT_WORDS(left,  shiftWordsLeft,  <<, sse2, 16)
+SHIFT_WORDS(right, shiftWordsRight, >>, sse2, 16)
+WORDS_TO_BYTES_DITHER(sse2, 16)
+BYTES_TO_WORDS(sse2, 16)
+
+INTERLEAVE_WORDS(avx2, 16)
+DEINTERLEAVE_WORDS(avx2, 16)
+SHIFT_WORDS(left,  shiftWordsLeft,  <<, avx2, 32)
+SHIFT_WORDS(right, shiftWordsRight, >>, avx2, 32)
+WORDS_TO_BYTES_DITHER(avx2, 32)
+BYTES_TO_WORDS(avx2, 32)
+#endif /* HAVE_X86ASM */
+
 av_cold void ff_rgb2rgb_init_x86(void)
 {
-#if HAVE_INLINE_ASM
     int cpu_flags = av_get_cpu_flags();
 
+#if HAVE_INLINE_ASM
     if (INLINE_MMX(cpu_flags))
         rgb2rgb_init_mmx();
     if (INLINE_AMD3DNOW(cpu_flags))
@@ -153,4 +247,24 @@ av_cold void ff_rgb2rgb_init_x86(void)
     if (INLINE_AVX(cpu_flags))
         rgb2rgb_init_avx();
 #endif /* HAVE_INLINE_ASM */
+
+#if HAVE_X86ASM
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        interleaveWords    = interleaveWords_sse2;
+        shiftWordsLeft     = shiftWordsLeft_sse2;
+        shiftWordsRight    = shiftWordsRight_sse2;
+        wordsToBytesDither = wordsToBytesDither_sse2;
+        bytesToWords       = bytesToWords_sse2;
+    }
+    if (EXTERNAL_SSE4(cpu_flags))
+        deinterleaveWords  = deinterleaveWords_sse4;
+    if (EXTERNAL_AVX2(cpu_flags)) {
+        interleaveWords    = interleaveWords_avx2;
+        deinterleaveWords  = deinterleaveWords_avx2;
+        shiftWordsLeft     = shiftWordsLeft_avx2;
+        shiftWordsRight    = shiftWordsRight_avx2;
+        wordsToBytesDither = wordsToBytesDither_avx2;
+        bytesToWords       = bytesToWords_avx2;
+    }
+#endif /* HAVE_X86ASM */
 }
@@ -0,0 +1,215 @@
+;******************************************************************************
+;* x86-optimized 16 bits per component plane conversions
+;*
+;* This file is part of Libav.
+;*
+;* Libav is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* Libav is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with Libav; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+; The width must be a non-zero multiple of the number of pixels processed
+; per iteration, the callers in rgb2rgb.c handle the remainder in C.
+
+;-----------------------------------------------------------------------------
+; void ff_interleave_words(const uint16_t *src1, const uint16_t *src2,
+;                          uint16_t *dst, int width, int shift)
+;
+; mmsize / 2 pixels per iteration
+;-----------------------------------------------------------------------------
+%macro INTERLEAVE_WORDS 0
+cglobal interleave_words, 5, 5, 4, src1, src2, dst, w, shift
+    movd               xm3, shiftd
+    movsxdifnidn         wq, wd
+    add                  wq, wq
+    add               src1q, wq
+    add               src2q, wq
+    lea                dstq, [dstq + 2 * wq]
+    neg                  wq
+.loop:
+    movu                 m0, [src1q + wq]
+    movu                 m1, [src2q + wq]
+    psllw                m0, xm3
+    psllw                m1, xm3
+    punpckhwd            m2, m0, m1
+    punpcklwd            m0, m1
+%if cpuflag(avx2)
+    vperm2i128           m1, m0, m2, 0x31
+    vinserti128          m0, m0, xm2, 1
+    movu [dstq + 2 * wq],          m0
+    movu [dstq + 2 * wq + mmsize], m1
+%else
+    movu [dstq + 2 * wq],          m0
+    movu [dstq + 2 * wq + mmsize], m2
+%endif
+    add                  wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; void ff_deinterleave_words(const uint16_t *src, uint16_t *dst1,
+;                            uint16_t *dst2, int width, int shift)
+;
+; mmsize / 2 pixels per iteration
+;-----------------------------------------------------------------------------
+%macro DEINTERLEAVE_WORDS 0
+cglobal deinterleave_words, 5, 5, 5, src, dst1, dst2, w, shift
+    add              shiftd, 16
+    movd                xm4, shiftd
+    movsxdifnidn         wq, wd
+    add                  wq, wq
+    add               dst1q, wq
+    add               dst2q, wq
+    lea                srcq, [srcq + 2 * wq]
+    neg                  wq
+.loop:
+    movu                 m0, [srcq + 2 * wq]
+    movu                 m1, [srcq + 2 * wq + mmsize]
+    psrld                m2, m0, xm4
+    psrld                m3, m1, xm4
+    pslld                m0, 16
+    pslld                m1, 16
+    psrld                m0, xm4
+    psrld                m1, xm4
+    packusdw             m0, m1
+    packusdw             m2, m3
+%if cpuflag(avx2)
+    vpermq               m0, m0, q3120
+    vpermq               m2, m2, q3120
+%endif
+    movu       [dst1q + wq], m0
+    movu       [dst2q + wq], m2
+    add                  wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; void ff_shift_words_{left,right}(const uint16_t *src, uint16_t *dst,
+;                                  int width, int shift)
+;
+; mmsize pixels per iteration
+;-----------------------------------------------------------------------------
+%macro SHIFT_WORDS 2 ; direction, shift instruction
+cglobal shift_words_%1, 4, 4, 3, src, dst, w, shift
+    movd                xm2, shiftd
+    movsxdifnidn         wq, wd
+    add                  wq, wq
+    add                srcq, wq
+    add                dstq, wq
+    neg                  wq
+.loop:
+    movu                 m0, [srcq + wq]
+    movu                 m1, [srcq + wq + mmsize]
+    %2                   m0, xm2
+    %2                   m1, xm2
+    movu        [dstq + wq], m0
+    movu [dstq + wq + mmsize], m1
+    add                  wq, 2 * mmsize
+    jl .loop
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; void ff_words_to_bytes_dither(const uint16_t *src, uint8_t *dst, int width,
+;                               const uint8_t *dither, int shift)
+;
+; mmsize pixels per iteration, the saturating add and pack give the same
+; clipping as the C version for any 16 bits input
+;-----------------------------------------------------------------------------
+%macro WORDS_TO_BYTES_DITHER 0
+cglobal words_to_bytes_dither, 5, 5, 5, src, dst, w, dither, shift
+    movd                xm4, shiftd
+    movq                xm3, [ditherq]
+    pxor                xm2, xm2
+    punpcklbw           xm3, xm2
+%if cpuflag(avx2)
+    vinserti128          m3, m3, xm3, 1
+%endif
+    movsxdifnidn         wq, wd
+    lea                srcq, [srcq + 2 * wq]
+    add                dstq, wq
+    neg                  wq
+.loop:
+    movu                 m0, [srcq + 2 * wq]
+    movu                 m1, [srcq + 2 * wq + mmsize]
+    paddusw              m0, m3
+    paddusw              m1, m3
+    psrlw                m0, xm4
+    psrlw                m1, xm4
+    packuswb             m0, m1
+%if cpuflag(avx2)
+    vpermq               m0, m0, q3120
+%endif
+    movu        [dstq + wq], m0
+    add                  wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------
+; void ff_bytes_to_words(const uint8_t *src, uint16_t *dst,
+;                        int width, int shift)
+;
+; mmsize pixels per iteration
+;-----------------------------------------------------------------------------
+%macro BYTES_TO_WORDS 0
+cglobal bytes_to_words, 4, 4, 4, src, dst, w, shift
+    movd                xm3, shiftd
+    pxor                 m2, m2
+    movsxdifnidn         wq, wd
+    add                srcq, wq
+    lea                dstq, [dstq + 2 * wq]
+    neg                  wq
+.loop:
+%if cpuflag(avx2)
+    pmovzxbw             m0, [srcq + wq]
+    pmovzxbw             m1, [srcq + wq + mmsize / 2]
+%else
+    movu                 m0, [srcq + wq]
+    punpckhbw            m1, m0, m2
+    punpcklbw            m0, m2
+%endif
+    psllw                m0, xm3
+    psllw                m1, xm3
+    movu    [dstq + 2 * wq], m0
+    movu [dstq + 2 * wq + mmsize], m1
+    add                  wq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+INTERLEAVE_WORDS
+SHIFT_WORDS left,  psllw
+SHIFT_WORDS right, psrlw
+WORDS_TO_BYTES_DITHER
+BYTES_TO_WORDS
+
+INIT_XMM sse4
+DEINTERLEAVE_WORDS
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+INTERLEAVE_WORDS
+DEINTERLEAVE_WORDS
+SHIFT_WORDS left,  psllw
+SHIFT_WORDS right, psrlw
+WORDS_TO_BYTES_DITHER
+BYTES_TO_WORDS
+%endif
@@ -21,12 +21,13 @@
 
 %include "libavutil/x86/x86util.asm"
 
-SECTION_RODATA
+SECTION_RODATA 32
 
-max_19bit_int: times 4 dd 0x7ffff
+max_19bit_int: times 8 dd 0x7ffff
 max_19bit_flt: times 4 dd 524287.0
-minshort:      times 8 dw 0x8000
-unicoeff:      times 4 dd 0x20000000
+minshort:      times 16 dw 0x8000
+unicoeff:      times 8 dd 0x20000000
+hscale8_perm:  dd 0, 4, 1, 5, 2, 6, 3, 7
 
 SECTION .text
 
@@ -419,3 +420,260 @@ INIT_XMM ssse3
 SCALE_FUNCS2 6, 6, 8
 INIT_XMM sse4
 SCALE_FUNCS2 6, 6, 8
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+;-----------------------------------------------------------------------------
+; The AVX2 versions scale 8 output pixels per iteration for filterSize 4 and 8
+; and 4 output pixels per iteration for the generic filter sizes, loading the
+; pixels of two output pixels into the two lanes of a ymm register. The
+; horizontal adds work within 128-bit lanes, the results are put back in order
+; before the store. They are only used for widths that are a multiple of 8.
+;-----------------------------------------------------------------------------
+
+; LOAD_8TAPS_AVX2 dst, src_width, pos0, pos1
+; load 8 pixels starting at each pos into one 128-bit lane each
+%macro LOAD_8TAPS_AVX2 4
+%if %2 == 8
+    movq          x%1, [srcq+%3]
+    movhps        x%1, [srcq+%4]
+    pmovzxbw       %1, x%1
+%else ; %2 == 9-16
+    movu          x%1, [srcq+%3*2]
+    vinserti128    %1, %1, [srcq+%4*2], 1
+%endif
+%if %2 == 16 ; pmaddwd needs signed adds, so this moves unsigned -> signed, we'll
+             ; add back 0x8000 * sum(coeffs) after the horizontal add
+    psubw          %1, m6
+%endif
+%endmacro
+
+; LOAD_4TAPS_AVX2 dst, src_width, pos0, pos1, pos2, pos3
+; load 4 pixels starting at each pos into one ymm register
+%macro LOAD_4TAPS_AVX2 6
+%if %2 == 8
+    movd          x%1, [srcq+%3]
+    pinsrd        x%1, [srcq+%4], 1
+    pinsrd        x%1, [srcq+%5], 2
+    pinsrd        x%1, [srcq+%6], 3
+    pmovzxbw       %1, x%1
+%else ; %2 == 9-16
+    movq          x%1, [srcq+%3*2]
+    movhps        x%1, [srcq+%4*2]
+    movq          xm1, [srcq+%5*2]
+    movhps        xm1, [srcq+%6*2]
+    vinserti128    %1, %1, xm1, 1
+%endif
+%if %2 == 16
+    psubw          %1, m6
+%endif
+%endmacro
+
+; SCALE_FUNC_AVX2 source_width, intermediate_nbits, filtersize
+%macro SCALE_FUNC_AVX2 3
+%ifnidn %3, X4
+%ifnidn %3, X8
+%define fixed_taps 1
+%else
+%define fixed_taps 0
+%endif
+%else
+%define fixed_taps 0
+%endif
+
+%if fixed_taps
+cglobal hscale%1to%2_%3, 6, 9, 9, pos0, dst, w, src, filter, fltpos, pos1, pos2, pos3
+%else
+cglobal hscale%1to%2_%3, 7, 13, 10, pos0, dst, w, srcmem, filter, fltpos, fltsize, \
+                                    pos1, pos2, pos3, src, srcend, filter2
+%endif
+%if %1 == 8
+%define srcmul 1
+%else
+%define srcmul 2
+%endif
+    movsxd        wq, wd
+%if %2 == 19
+    mova          m2, [max_19bit_int]
+%endif
+%if %1 == 16
+    mova          m6, [minshort]
+    mova          m7, [unicoeff]
+%endif
+    lea      fltposq, [fltposq+wq*4]
+%if %2 == 15
+    lea         dstq, [dstq+wq*2]
+%else ; %2 == 19
+    lea         dstq, [dstq+wq*4]
+%endif
+    neg           wq
+
+%if fixed_taps
+%if %3 == 8
+    mova          m8, [hscale8_perm]
+%endif
+
+.loop:
+    movsxd     pos0q, dword [fltposq+wq*4+ 0]
+    movsxd     pos1q, dword [fltposq+wq*4+ 4]
+    movsxd     pos2q, dword [fltposq+wq*4+ 8]
+    movsxd     pos3q, dword [fltposq+wq*4+12]
+%if %3 == 4
+    ; m0: dstpix 0-3, m4: dstpix 4-7, 4 srcpix each
+    LOAD_4TAPS_AVX2 m0, %1, pos0q, pos1q, pos2q, pos3q
+    movsxd     pos0q, dword [fltposq+wq*4+16]
+    movsxd     pos1q, dword [fltposq+wq*4+20]
+    movsxd     pos2q, dword [fltposq+wq*4+24]
+    movsxd     pos3q, dword [fltposq+wq*4+28]
+    LOAD_4TAPS_AVX2 m4, %1, pos0q, pos1q, pos2q, pos3q
+
+    pmaddwd       m0, [filterq+mmsize*0]        ; *= filter[{ 0, 1,...,14,15}]
+    pmaddwd       m4, [filterq+mmsize*1]        ; *= filter[{16,17,...,30,31}]
+
+    ; lane 0: dstpix {0,1,4,5}, lane 1: dstpix {2,3,6,7}
+    phaddd        m0, m4
+    vpermq        m0, m0, q3120
+%else ; %3 == 8
+    ; m0: dstpix 0-1, m1: dstpix 2-3, m4: dstpix 4-5, m5: dstpix 6-7
+    LOAD_8TAPS_AVX2 m0, %1, pos0q, pos1q
+    LOAD_8TAPS_AVX2 m1, %1, pos2q, pos3q
+    movsxd     pos0q, dword [fltposq+wq*4+16]
+    movsxd     pos1q, dword [fltposq+wq*4+20]
+    movsxd     pos2q, dword [fltposq+wq*4+24]
+    movsxd     pos3q, dword [fltposq+wq*4+28]
+    LOAD_8TAPS_AVX2 m4, %1, pos0q, pos1q
+    LOAD_8TAPS_AVX2 m5, %1, pos2q, pos3q
+
+    pmaddwd       m0, [filterq+mmsize*0]        ; *= filter[{ 0, 1,...,14,15}]
+    pmaddwd       m1, [filterq+mmsize*1]        ; *= filter[{16,17,...,30,31}]
+    pmaddwd       m4, [filterq+mmsize*2]        ; *= filter[{32,33,...,46,47}]
+    pmaddwd       m5, [filterq+mmsize*3]        ; *= filter[{48,49,...,62,63}]
+
+    ; lane 0: dstpix {0,2,4,6}, lane 1: dstpix {1,3,5,7}
+    phaddd        m0, m1
+    phaddd        m4, m5
+    phaddd        m0, m4
+    vpermd        m0, m8, m0
+%endif ; %3 == 4/8
+    add      filterq, 8*%3*2
+
+%if %1 == 16 ; add 0x8000 * sum(coeffs), i.e. back from signed -> unsigned
+    paddd         m0, m7
+%endif
+
+    ; clip, store
+    psrad         m0, 14 + %1 - %2
+%if %2 == 15
+    vextracti128 xm1, m0, 1
+    packssdw     xm0, xm1
+    movu [dstq+wq*2], xm0
+%else ; %2 == 19
+    pminsd        m0, m2
+    movu [dstq+wq*4], m0
+%endif
+    add           wq, 8
+    jl .loop
+    RET
+
+%else ; generic filter sizes
+
+%ifidn %3, X4
+%define dlt 4
+%else
+%define dlt 0
+%endif
+    movsxd  fltsizeq, fltsized
+    lea      srcendq, [srcmemq+(fltsizeq-dlt)*srcmul] ; &src[filterSize&~4]
+
+.loop:
+    movsxd     pos0q, dword [fltposq+wq*4+ 0]
+    movsxd     pos1q, dword [fltposq+wq*4+ 4]
+    movsxd     pos2q, dword [fltposq+wq*4+ 8]
+    movsxd     pos3q, dword [fltposq+wq*4+12]
+    lea     filter2q, [filterq+fltsizeq*4]      ; coefficients of dstpix 2
+    pxor          m4, m4
+    pxor          m5, m5
+    mov         srcq, srcmemq
+
+.innerloop:
+    ; 8 srcpix of dstpix 0/1 in m0 and of dstpix 2/3 in m1
+    LOAD_8TAPS_AVX2 m0, %1, pos0q, pos1q
+    LOAD_8TAPS_AVX2 m1, %1, pos2q, pos3q
+    movu         xm8, [filterq]
+    vinserti128   m8, m8, [filterq+fltsizeq*2], 1
+    movu         xm9, [filter2q]
+    vinserti128   m9, m9, [filter2q+fltsizeq*2], 1
+    pmaddwd       m0, m8
+    pmaddwd       m1, m9
+    paddd         m4, m0
+    paddd         m5, m1
+    add      filterq, 16
+    add     filter2q, 16
+    add         srcq, 8*srcmul
+    cmp         srcq, srcendq                   ; while (src += 8) < &src[filterSize&~4]
+    jl .innerloop
+
+    ; lane 0: dstpix {0,2}, lane 1: dstpix {1,3}
+    phaddd        m4, m5
+    phaddd        m4, m4
+    vextracti128 xm1, m4, 1
+    punpckldq    xm4, xm1
+
+%ifidn %3, X4
+    ; last 4 srcpix of each dstpix
+    LOAD_4TAPS_AVX2 m0, %1, pos0q, pos1q, pos2q, pos3q
+    movq         xm8, [filterq]
+    movhps       xm8, [filterq+fltsizeq*2]
+    movq         xm9, [filter2q]
+    movhps       xm9, [filter2q+fltsizeq*2]
+    vinserti128   m8, m8, xm9, 1
+    pmaddwd       m0, m8
+    ; lane 0: dstpix {0,1}, lane 1: dstpix {2,3}
+    phaddd        m0, m0
+    vextracti128 xm1, m0, 1
+    punpcklqdq   xm0, xm1
+    paddd        xm4, xm0
+%endif ; %3 == X4
+
+    ; skip the coefficients of dstpix 1-3
+    lea      filterq, [filterq+fltsizeq*4+dlt*2]
+    lea      filterq, [filterq+fltsizeq*2]
+
+%if %1 == 16 ; add 0x8000 * sum(coeffs), i.e. back from signed -> unsigned
+    paddd        xm4, xm7
+%endif
+
+    ; clip, store
+    psrad        xm4, 14 + %1 - %2
+%if %2 == 15
+    packssdw     xm4, xm4
+    movq [dstq+wq*2], xm4
+%else ; %2 == 19
+    pminsd       xm4, xm2
+    movu [dstq+wq*4], xm4
+%endif
+    add           wq, 4
+    jl .loop
+    RET
+%endif ; fixed/generic filter sizes
+%endmacro
+
+; SCALE_FUNCS_AVX2 source_width, intermediate_nbits
+%macro SCALE_FUNCS_AVX2 2
+SCALE_FUNC_AVX2 %1, %2, 4
+SCALE_FUNC_AVX2 %1, %2, 8
+SCALE_FUNC_AVX2 %1, %2, X4
+SCALE_FUNC_AVX2 %1, %2, X8
+%endmacro
+
+INIT_YMM avx2
+SCALE_FUNCS_AVX2  8, 15
+SCALE_FUNCS_AVX2  9, 15
+SCALE_FUNCS_AVX2 10, 15
+SCALE_FUNCS_AVX2 12, 15
+SCALE_FUNCS_AVX2 16, 15
+SCALE_FUNCS_AVX2  8, 19
+SCALE_FUNCS_AVX2  9, 19
+SCALE_FUNCS_AVX2 10, 19
+SCALE_FUNCS_AVX2 12, 19
+SCALE_FUNCS_AVX2 16, 19
+%endif ; ARCH_X86_64 && HAVE_AVX2_EXTERNAL
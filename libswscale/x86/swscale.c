@@ -240,6 +240,9 @@ SCALE_FUNCS_MMX(mmx);
 SCALE_FUNCS_SSE(sse2);
 SCALE_FUNCS_SSE(ssse3);
 SCALE_FUNCS_SSE(sse4);
+#if ARCH_X86_64
+SCALE_FUNCS_SSE(avx2);
+#endif
 
 #define VSCALEX_FUNC(size, opt) \
 void ff_yuv2planeX_ ## size ## _ ## opt(const int16_t *filter, int filterSize, \
@@ -248,7 +251,8 @@ void ff_yuv2planeX_ ## size ## _ ## opt(const int16_t *filter, int filterSize, \
 #define VSCALEX_FUNCS(opt) \
     VSCALEX_FUNC(8,  opt); \
     VSCALEX_FUNC(9,  opt); \
-    VSCALEX_FUNC(10, opt)
+    VSCALEX_FUNC(10, opt); \
+    VSCALEX_FUNC(12, opt)
 
 #if ARCH_X86_32
 VSCALEX_FUNCS(mmxext);
@@ -257,6 +261,10 @@ VSCALEX_FUNCS(sse2);
 VSCALEX_FUNCS(sse4);
 VSCALEX_FUNC(16, sse4);
 VSCALEX_FUNCS(avx);
+#if ARCH_X86_64
+VSCALEX_FUNCS(avx2);
+VSCALEX_FUNC(16, avx2);
+#endif
 
 #define VSCALE_FUNC(size, opt) \
 void ff_yuv2plane1_ ## size ## _ ## opt(const int16_t *src, uint8_t *dst, int dstW, \
@@ -265,6 +273,7 @@ void ff_yuv2plane1_ ## size ## _ ## opt(const int16_t *src, uint8_t *dst, int ds
     VSCALE_FUNC(8,  opt1); \
     VSCALE_FUNC(9,  opt2); \
     VSCALE_FUNC(10, opt2); \
+    VSCALE_FUNC(12, opt2); \
     VSCALE_FUNC(16, opt1)
 
 #if ARCH_X86_32
@@ -273,6 +282,9 @@ VSCALE_FUNCS(mmx, mmxext);
 VSCALE_FUNCS(sse2, sse2);
 VSCALE_FUNC(16, sse4);
 VSCALE_FUNCS(avx, avx);
+#if ARCH_X86_64
+VSCALE_FUNCS(avx2, avx2);
+#endif
 
 #define INPUT_Y_FUNC(fmt, opt) \
 void ff_ ## fmt ## ToY_  ## opt(uint8_t *dst, const uint8_t *src, \
@@ -343,14 +355,21 @@ av_cold void ff_sws_init_swscale_x86(SwsContext *c)
 #define ASSIGN_VSCALEX_FUNC(vscalefn, opt, do_16_case, condition_8bit) \
 switch(c->dstBpc){ \
     case 16:                          do_16_case;                          break; \
-    case 10: if (!isBE(c->dstFormat)) vscalefn = ff_yuv2planeX_10_ ## opt; break; \
+    case 12: if (!isBE(c->dstFormat)) vscalefn = ff_yuv2planeX_12_ ## opt; break; \
+    case 10: if (!isBE(c->dstFormat) && c->dstFormat != AV_PIX_FMT_P010LE) \
+                 vscalefn = ff_yuv2planeX_10_ ## opt; \
+             break; \
     case 9:  if (!isBE(c->dstFormat)) vscalefn = ff_yuv2planeX_9_  ## opt; break; \
     case 8:  if (condition_8bit)      vscalefn = ff_yuv2planeX_8_  ## opt; break; \
     }
 #define ASSIGN_VSCALE_FUNC(vscalefn, opt1, opt2, opt2chk) \
     switch(c->dstBpc){ \
     case 16: if (!isBE(c->dstFormat))            vscalefn = ff_yuv2plane1_16_ ## opt1; break; \
-    case 10: if (!isBE(c->dstFormat) && opt2chk) vscalefn = ff_yuv2plane1_10_ ## opt2; break; \
+    case 12: if (!isBE(c->dstFormat) && opt2chk) vscalefn = ff_yuv2plane1_12_ ## opt2; break; \
+    case 10: if (!isBE(c->dstFormat) && opt2chk && \
+                 c->dstFormat != AV_PIX_FMT_P010LE) \
+                 vscalefn = ff_yuv2plane1_10_ ## opt2; \
+             break; \
     case 9:  if (!isBE(c->dstFormat) && opt2chk) vscalefn = ff_yuv2plane1_9_  ## opt2;  break; \
     case 8:                                      vscalefn = ff_yuv2plane1_8_  ## opt1;  break; \
     }
@@ -494,4 +513,21 @@ switch(c->dstBpc){ \
             break;
         }
     }
+
+#if ARCH_X86_64
+    /* The AVX2 functions process 8 (horizontal) and 16 or 32 (vertical)
+     * pixels per iteration and have no tail handling. */
+    if (EXTERNAL_AVX2(cpu_flags)) {
+        if (!(c->dstW & 7))
+            ASSIGN_SSE_SCALE_FUNC(c->hyScale, c->hLumFilterSize, avx2, avx2);
+        if (!(c->chrDstW & 7))
+            ASSIGN_SSE_SCALE_FUNC(c->hcScale, c->hChrFilterSize, avx2, avx2);
+        if (!((c->dstW | c->chrDstW) & 15))
+            ASSIGN_VSCALEX_FUNC(c->yuv2planeX, avx2,
+                                if (!isBE(c->dstFormat)) c->yuv2planeX = ff_yuv2planeX_16_avx2,
+                                1);
+        if (!((c->dstW | c->chrDstW) & 31))
+            ASSIGN_VSCALE_FUNC(c->yuv2plane1, avx2, avx2, 1);
+    }
+#endif
 }
@@ -0,0 +1,102 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavcodec/aacencdsp.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 1024
+
+#define randomize_float(buf, len)                               \
+    do {                                                        \
+        int i;                                                  \
+        for (i = 0; i < len; i++) {                             \
+            float f = (float)rnd() / (UINT_MAX >> 1) - 1.0f;    \
+            buf[i] = f * 8192.0f;                               \
+        }                                                       \
+    } while (0)
+
+static void test_abs_pow34(AACEncDSPContext *s)
+{
+    LOCAL_ALIGNED_16(float, in,   [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, out0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, out1, [BUF_SIZE]);
+
+    declare_func(void, float *out, const float *in, int size);
+
+    randomize_float(in, BUF_SIZE);
+
+    if (check_func(s->abs_pow34, "abs_pow34")) {
+        call_ref(out0, in, BUF_SIZE);
+        call_new(out1, in, BUF_SIZE);
+        if (memcmp(out0, out1, BUF_SIZE * sizeof(*out0)))
+            fail();
+        bench_new(out1, in, BUF_SIZE);
+    }
+
+    report("abs_pow34");
+}
+
+static void test_quant_bands(AACEncDSPContext *s)
+{
+    LOCAL_ALIGNED_16(float, in,     [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, scaled, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int,   out0,   [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int,   out1,   [BUF_SIZE]);
+    static const int maxval[] = { 1, 2, 4, 7, 12, 16, 8191 };
+    int i, is_signed;
+
+    declare_func(void, int *out, const float *in, const float *scaled,
+                 int size, int is_signed, int maxval, float Q34);
+
+    randomize_float(in, BUF_SIZE);
+    for (i = 0; i < BUF_SIZE; i++)
+        scaled[i] = pow(fabs(in[i]), 0.75);
+
+    for (is_signed = 0; is_signed < 2; is_signed++) {
+        for (i = 0; i < FF_ARRAY_ELEMS(maxval); i++) {
+            float Q34 = (float)rnd() / UINT_MAX;
+
+            if (check_func(s->quant_bands, "quant_bands_%s_%d",
+                           is_signed ? "signed" : "unsigned", maxval[i])) {
+                call_ref(out0, in, scaled, BUF_SIZE, is_signed, maxval[i], Q34);
+                call_new(out1, in, scaled, BUF_SIZE, is_signed, maxval[i], Q34);
+                if (memcmp(out0, out1, BUF_SIZE * sizeof(*out0)))
+                    fail();
+                bench_new(out1, in, scaled, BUF_SIZE, is_signed, maxval[i], Q34);
+            }
+        }
+    }
+
+    report("quant_bands");
+}
+
+void checkasm_check_aacencdsp(void)
+{
+    AACEncDSPContext s;
+
+    ff_aacenc_dsp_init(&s);
+
+    test_abs_pow34(&s);
+    test_quant_bands(&s);
+}
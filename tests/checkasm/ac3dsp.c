@@ -0,0 +1,87 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
+
+#include "libavcodec/ac3.h"
+#include "libavcodec/ac3dec_data.h"
+#include "libavcodec/ac3dsp.h"
+#include "libavcodec/ac3tab.h"
+
+#include "checkasm.h"
+
+static void check_bit_alloc_calc_bap(AC3DSPContext *c)
+{
+    /* a full transform, the coupling range and a short LFE range */
+    static const int ranges[][2] = { { 0, 253 }, { 37, 229 }, { 0, 7 } };
+    LOCAL_ALIGNED_16(int16_t, mask, [AC3_CRITICAL_BANDS]);
+    LOCAL_ALIGNED_16(int16_t, psd,  [AC3_MAX_COEFS]);
+    LOCAL_ALIGNED_16(uint8_t, bap0, [AC3_MAX_COEFS]);
+    LOCAL_ALIGNED_16(uint8_t, bap1, [AC3_MAX_COEFS]);
+    const uint8_t *bap_tabs[2] = { ff_ac3_bap_tab, ff_eac3_hebap_tab };
+    int i, t, r;
+
+    declare_func(void, int16_t *mask, int16_t *psd, int start, int end,
+                 int snr_offset, int floor, const uint8_t *bap_tab,
+                 uint8_t *bap);
+
+    if (check_func(c->bit_alloc_calc_bap, "ac3_bit_alloc_calc_bap")) {
+        for (t = 0; t < FF_ARRAY_ELEMS(bap_tabs); t++) {
+            for (r = 0; r < FF_ARRAY_ELEMS(ranges); r++) {
+                int start = ranges[r][0];
+                int end   = ranges[r][1];
+                int snr_offset = ((((int)(rnd() % 64) - 15) << 4) +
+                                  (int)(rnd() % 16)) << 2;
+                int floor = ff_ac3_floor_tab[rnd() % 8];
+
+                for (i = 0; i < AC3_CRITICAL_BANDS; i++)
+                    mask[i] = rnd() % 3584;
+                /* psd values as computed from 5-bit exponents */
+                for (i = 0; i < AC3_MAX_COEFS; i++)
+                    psd[i] = 3072 - ((rnd() % 25) << 7);
+
+                memset(bap0, 0xFF, AC3_MAX_COEFS);
+                memset(bap1, 0xFF, AC3_MAX_COEFS);
+                call_ref(mask, psd, start, end, snr_offset, floor,
+                         bap_tabs[t], bap0);
+                call_new(mask, psd, start, end, snr_offset, floor,
+                         bap_tabs[t], bap1);
+                if (memcmp(bap0, bap1, AC3_MAX_COEFS))
+                    fail();
+            }
+        }
+        bench_new(mask, psd, 0, 253, 0, ff_ac3_floor_tab[4],
+                  ff_ac3_bap_tab, bap1);
+    }
+
+    report("bit_alloc_calc_bap");
+}
+
+void checkasm_check_ac3dsp(void)
+{
+    AC3DSPContext c;
+
+    ff_ac3_common_init();
+    ff_ac3dsp_init(&c, 0);
+
+    check_bit_alloc_calc_bap(&c);
+}
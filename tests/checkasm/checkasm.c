@@ -64,6 +64,15 @@ static const struct {
     const char *name;
     void (*func)(void);
 } tests[] = {
+#if CONFIG_AAC_DECODER
+    { "aacpsdsp", checkasm_check_aacpsdsp },
+#endif
+#if CONFIG_AAC_ENCODER
+    { "aacencdsp", checkasm_check_aacencdsp },
+#endif
+#if CONFIG_AC3_DECODER
+    { "ac3dsp", checkasm_check_ac3dsp },
+#endif
 #if CONFIG_AUDIODSP
     { "audiodsp", checkasm_check_audiodsp },
 #endif
@@ -77,6 +86,10 @@ static const struct {
     { "dcadsp", checkasm_check_dcadsp },
     { "synth_filter", checkasm_check_synth_filter },
 #endif
+#if CONFIG_FFV1_DECODER
+    { "ffv1dsp", checkasm_check_ffv1dsp },
+#endif
+    { "float_dsp", checkasm_check_float_dsp },
 #if CONFIG_FMTCONVERT
     { "fmtconvert", checkasm_check_fmtconvert },
 #endif
@@ -94,12 +107,43 @@ static const struct {
     { "hevc_idct", checkasm_check_hevc_idct },
     { "hevc_mc", checkasm_check_hevc_mc },
 #endif
+#if CONFIG_HPELDSP
+    { "hpeldsp", checkasm_check_hpeldsp },
+#endif
 #if CONFIG_HUFFYUVDSP
     { "huffyuvdsp", checkasm_check_huffyuvdsp },
 #endif
+#if CONFIG_IDCTDSP
+    { "idctdsp", checkasm_check_idctdsp },
+#endif
+#if CONFIG_JPEG2000_DECODER
+    { "jpeg2000dsp", checkasm_check_jpeg2000dsp },
+#endif
+#if CONFIG_ME_CMP
+    { "me_cmp", checkasm_check_me_cmp },
+#endif
+#if CONFIG_OPUS_DECODER
+    { "opusdsp", checkasm_check_opusdsp },
+#endif
+#if CONFIG_QPELDSP
+    { "qpeldsp", checkasm_check_qpeldsp },
+#endif
+#if CONFIG_RV40_DECODER
+    { "rv40dsp", checkasm_check_rv40dsp },
+#endif
+#if CONFIG_AAC_DECODER
+    { "sbrdsp", checkasm_check_sbrdsp },
+#endif
+#if CONFIG_SWSCALE
+    { "sw_rgb2rgb", checkasm_check_sw_rgb2rgb },
+    { "sw_scale", checkasm_check_sw_scale },
+#endif
 #if CONFIG_V210_ENCODER
     { "v210enc", checkasm_check_v210enc },
 #endif
+#if CONFIG_OVERLAY_FILTER
+    { "vf_overlay", checkasm_check_vf_overlay },
+#endif
 #if CONFIG_VP8DSP
     { "vp8dsp", checkasm_check_vp8dsp },
 #endif
@@ -163,6 +207,7 @@ typedef struct CheckasmFuncVersion {
 typedef struct CheckasmFunc {
     struct CheckasmFunc *child[2];
     CheckasmFuncVersion versions;
+    const char *test_name;
     uint8_t color; /* 0 = red, 1 = black */
     char name[1];
 } CheckasmFunc;
@@ -175,6 +220,7 @@ static struct {
     const char *current_test_name;
     const char *bench_pattern;
     int bench_pattern_len;
+    int bench_csv;
     int num_checked;
     int num_failed;
     int nop_time;
@@ -378,7 +424,11 @@ static void print_benchs(CheckasmFunc *f)
             do {
                 if (v->iterations) {
                     int decicycles = (10*v->cycles/v->iterations - state.nop_time) / 4;
-                    printf("%s_%s: %d.%d\n", f->name, cpu_suffix(v->cpu), decicycles/10, decicycles%10);
+                    if (state.bench_csv)
+                        printf("%s,%s,%s,%d.%d\n", f->test_name, f->name,
+                               cpu_suffix(v->cpu), decicycles/10, decicycles%10);
+                    else
+                        printf("%s_%s: %d.%d\n", f->name, cpu_suffix(v->cpu), decicycles/10, decicycles%10);
                 }
             } while ((v = v->next));
         }
@@ -514,6 +564,8 @@ int main(int argc, char *argv[])
                 state.bench_pattern_len = strlen(state.bench_pattern);
             } else
                 state.bench_pattern = "";
+        } else if (!strcmp(argv[1], "--csv")) {
+            state.bench_csv = 1;
         } else if (!strncmp(argv[1], "--test=", 7)) {
             state.test_name = argv[1] + 7;
         } else {
@@ -539,7 +591,10 @@ int main(int argc, char *argv[])
 #ifdef AV_READ_TIME
         if (state.bench_pattern) {
             state.nop_time = measure_nop_time();
-            printf("nop: %d.%d\n", state.nop_time/10, state.nop_time%10);
+            if (state.bench_csv)
+                printf("test,function,cpu,cycles\n");
+            else
+                printf("nop: %d.%d\n", state.nop_time/10, state.nop_time%10);
             print_benchs(state.funcs);
         }
 #endif
@@ -569,6 +624,8 @@ void *checkasm_check_func(void *func, const char *name, ...)
 
     state.current_func = get_func(&state.funcs, name_buf);
     state.funcs->color = 1;
+    if (!state.current_func->test_name)
+        state.current_func->test_name = state.current_test_name;
     v = &state.current_func->versions;
 
     if (v->func) {
@@ -0,0 +1,75 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
+
+#include "libavcodec/ffv1dsp.h"
+
+#include "checkasm.h"
+
+#define MAX_WIDTH 1024
+/* a line with a border of 3 samples on each side, as in FFV1Context */
+#define LINE_SIZE (MAX_WIDTH + 6)
+
+#define randomize_lines(buf, size, bits)       \
+    do {                                       \
+        int j;                                 \
+        for (j = 0; j < size; j++)             \
+            buf[j] = rnd() & ((1 << bits) - 1); \
+    } while (0)
+
+static void check_sub_median_pred(FFV1DSPContext *c, int w)
+{
+    LOCAL_ALIGNED_32(int16_t, dst0, [MAX_WIDTH + 16]);
+    LOCAL_ALIGNED_32(int16_t, dst1, [MAX_WIDTH + 16]);
+    int16_t lines[2 * LINE_SIZE + 16];
+    int16_t *src = lines + LINE_SIZE + 3;
+    int16_t *top = lines + 3;
+    int bits;
+
+    declare_func(void, int16_t *dst, const int16_t *src,
+                 const int16_t *top, int w);
+
+    if (check_func(c->sub_median_pred, "ffv1_sub_median_pred")) {
+        for (bits = 8; bits <= 14; bits += 2) {
+            randomize_lines(lines, FF_ARRAY_ELEMS(lines), bits);
+
+            call_ref(dst0, src, top, w);
+            call_new(dst1, src, top, w);
+            if (memcmp(dst0, dst1, w * sizeof(*dst0)))
+                fail();
+        }
+        bench_new(dst1, src, top, w);
+    }
+
+    report("sub_median_pred");
+}
+
+void checkasm_check_ffv1dsp(void)
+{
+    FFV1DSPContext c;
+    int w = av_clip(rnd() % MAX_WIDTH, 1, MAX_WIDTH);
+
+    ff_ffv1dsp_init(&c);
+
+    check_sub_median_pred(&c, w);
+}
@@ -0,0 +1,227 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "libavutil/float_dsp.h"
+#include "libavutil/internal.h"
+
+#include "checkasm.h"
+
+#define LEN 256
+
+#define randomize(buf, len) do {                                \
+    int i;                                                      \
+    for (i = 0; i < len; i++)                                   \
+        (buf)[i] = (float)(int32_t)rnd() / INT32_MAX;           \
+} while (0)
+
+#define EPS 0.0001
+#define EPS_SUM 0.01
+
+static void test_vector_fmul(const float *src0, const float *src1)
+{
+    LOCAL_ALIGNED_32(float, dst0, [LEN]);
+    LOCAL_ALIGNED_32(float, dst1, [LEN]);
+
+    declare_func(void, float *dst, const float *src0, const float *src1,
+                 int len);
+
+    call_ref(dst0, src0, src1, LEN);
+    call_new(dst1, src0, src1, LEN);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, LEN))
+        fail();
+    bench_new(dst1, src0, src1, LEN);
+}
+
+static void test_vector_fmac_scalar(const float *src0, const float *src1)
+{
+    LOCAL_ALIGNED_32(float, dst0, [LEN]);
+    LOCAL_ALIGNED_32(float, dst1, [LEN]);
+    float mul = src1[0];
+
+    declare_func(void, float *dst, const float *src, float mul, int len);
+
+    memcpy(dst0, src1, LEN * sizeof(*dst0));
+    memcpy(dst1, src1, LEN * sizeof(*dst1));
+    call_ref(dst0, src0, mul, LEN);
+    call_new(dst1, src0, mul, LEN);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, LEN))
+        fail();
+    bench_new(dst1, src0, mul, LEN);
+}
+
+static void test_vector_fmul_scalar(const float *src0, const float *src1)
+{
+    LOCAL_ALIGNED_32(float, dst0, [LEN]);
+    LOCAL_ALIGNED_32(float, dst1, [LEN]);
+    float mul = src1[0];
+
+    declare_func(void, float *dst, const float *src, float mul, int len);
+
+    call_ref(dst0, src0, mul, LEN);
+    call_new(dst1, src0, mul, LEN);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, LEN))
+        fail();
+    bench_new(dst1, src0, mul, LEN);
+}
+
+static void test_vector_dmul_scalar(void)
+{
+    LOCAL_ALIGNED_32(double, src, [LEN]);
+    LOCAL_ALIGNED_32(double, dst0, [LEN]);
+    LOCAL_ALIGNED_32(double, dst1, [LEN]);
+    double mul;
+    int i;
+
+    declare_func(void, double *dst, const double *src, double mul, int len);
+
+    randomize(src, LEN);
+    mul = (double)(int32_t)rnd() / INT32_MAX;
+
+    call_ref(dst0, src, mul, LEN);
+    call_new(dst1, src, mul, LEN);
+    for (i = 0; i < LEN; i++) {
+        if (fabs(dst0[i] - dst1[i]) > EPS) {
+            fail();
+            break;
+        }
+    }
+    bench_new(dst1, src, mul, LEN);
+}
+
+static void test_vector_fmul_window(const float *src0, const float *src1,
+                                    const float *win)
+{
+    LOCAL_ALIGNED_32(float, dst0, [LEN]);
+    LOCAL_ALIGNED_32(float, dst1, [LEN]);
+
+    declare_func(void, float *dst, const float *src0, const float *src1,
+                 const float *win, int len);
+
+    call_ref(dst0, src0, src1, win, LEN / 2);
+    call_new(dst1, src0, src1, win, LEN / 2);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, LEN))
+        fail();
+    bench_new(dst1, src0, src1, win, LEN / 2);
+}
+
+static void test_vector_fmul_add(const float *src0, const float *src1,
+                                 const float *src2)
+{
+    LOCAL_ALIGNED_32(float, dst0, [LEN]);
+    LOCAL_ALIGNED_32(float, dst1, [LEN]);
+
+    declare_func(void, float *dst, const float *src0, const float *src1,
+                 const float *src2, int len);
+
+    call_ref(dst0, src0, src1, src2, LEN);
+    call_new(dst1, src0, src1, src2, LEN);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, LEN))
+        fail();
+    bench_new(dst1, src0, src1, src2, LEN);
+}
+
+static void test_vector_fmul_reverse(const float *src0, const float *src1)
+{
+    LOCAL_ALIGNED_32(float, dst0, [LEN]);
+    LOCAL_ALIGNED_32(float, dst1, [LEN]);
+
+    declare_func(void, float *dst, const float *src0, const float *src1,
+                 int len);
+
+    call_ref(dst0, src0, src1, LEN);
+    call_new(dst1, src0, src1, LEN);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, LEN))
+        fail();
+    bench_new(dst1, src0, src1, LEN);
+}
+
+static void test_butterflies_float(const float *src0, const float *src1)
+{
+    LOCAL_ALIGNED_32(float, v1_0, [LEN]);
+    LOCAL_ALIGNED_32(float, v1_1, [LEN]);
+    LOCAL_ALIGNED_32(float, v2_0, [LEN]);
+    LOCAL_ALIGNED_32(float, v2_1, [LEN]);
+
+    declare_func(void, float *restrict v1, float *restrict v2, int len);
+
+    memcpy(v1_0, src0, LEN * sizeof(*v1_0));
+    memcpy(v1_1, src0, LEN * sizeof(*v1_1));
+    memcpy(v2_0, src1, LEN * sizeof(*v2_0));
+    memcpy(v2_1, src1, LEN * sizeof(*v2_1));
+    call_ref(v1_0, v2_0, LEN);
+    call_new(v1_1, v2_1, LEN);
+    if (!float_near_abs_eps_array(v1_0, v1_1, EPS, LEN) ||
+        !float_near_abs_eps_array(v2_0, v2_1, EPS, LEN))
+        fail();
+    bench_new(v1_1, v2_1, LEN);
+}
+
+static void test_scalarproduct_float(const float *src0, const float *src1)
+{
+    float res0, res1;
+
+    declare_func_float(float, const float *v1, const float *v2, int len);
+
+    res0 = call_ref(src0, src1, LEN);
+    res1 = call_new(src0, src1, LEN);
+    if (!float_near_abs_eps(res0, res1, EPS_SUM))
+        fail();
+    bench_new(src0, src1, LEN);
+}
+
+void checkasm_check_float_dsp(void)
+{
+    LOCAL_ALIGNED_32(float, src0, [LEN]);
+    LOCAL_ALIGNED_32(float, src1, [LEN]);
+    LOCAL_ALIGNED_32(float, src2, [LEN]);
+    AVFloatDSPContext fdsp;
+
+    avpriv_float_dsp_init(&fdsp, 1);
+
+    randomize(src0, LEN);
+    randomize(src1, LEN);
+    randomize(src2, LEN);
+
+    if (check_func(fdsp.vector_fmul, "vector_fmul"))
+        test_vector_fmul(src0, src1);
+    if (check_func(fdsp.vector_fmac_scalar, "vector_fmac_scalar"))
+        test_vector_fmac_scalar(src0, src1);
+    if (check_func(fdsp.vector_fmul_scalar, "vector_fmul_scalar"))
+        test_vector_fmul_scalar(src0, src1);
+    if (check_func(fdsp.vector_dmul_scalar, "vector_dmul_scalar"))
+        test_vector_dmul_scalar();
+    if (check_func(fdsp.vector_fmul_window, "vector_fmul_window"))
+        test_vector_fmul_window(src0, src1, src2);
+    if (check_func(fdsp.vector_fmul_add, "vector_fmul_add"))
+        test_vector_fmul_add(src0, src1, src2);
+    if (check_func(fdsp.vector_fmul_reverse, "vector_fmul_reverse"))
+        test_vector_fmul_reverse(src0, src1);
+    report("vector_fmul");
+
+    if (check_func(fdsp.butterflies_float, "butterflies_float"))
+        test_butterflies_float(src0, src1);
+    report("butterflies_float");
+
+    if (check_func(fdsp.scalarproduct_float, "scalarproduct_float"))
+        test_scalarproduct_float(src0, src1);
+    report("scalarproduct_float");
+}
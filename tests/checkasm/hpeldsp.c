@@ -0,0 +1,89 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavcodec/hpeldsp.h"
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+#include "checkasm.h"
+
+#define STRIDE 32
+#define BUF_SIZE (STRIDE * 17)
+
+#define randomize_buffers()                         \
+    do {                                            \
+        int i;                                      \
+        for (i = 0; i < BUF_SIZE; i += 4) {         \
+            uint32_t r = rnd();                     \
+            AV_WN32A(src + i, r);                   \
+            r = rnd();                              \
+            AV_WN32A(dst0 + i, r);                  \
+            AV_WN32A(dst1 + i, r);                  \
+        }                                           \
+    } while (0)
+
+static const char *const dxy_names[4] = { "", "_x2", "_y2", "_xy2" };
+
+static void check_pixels_tab(op_pixels_func (*tab)[4], int nb_sizes,
+                             const char *op)
+{
+    LOCAL_ALIGNED_16(uint8_t, src,  [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE]);
+    int i, j;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, uint8_t *block,
+                      const uint8_t *pixels, ptrdiff_t line_size, int h);
+
+    for (i = 0; i < nb_sizes; i++) {
+        int size = 16 >> i;
+
+        for (j = 0; j < 4; j++) {
+            if (check_func(tab[i][j], "%s_pixels%d%s", op, size, dxy_names[j])) {
+                randomize_buffers();
+                call_ref(dst0, src, STRIDE, size);
+                call_new(dst1, src, STRIDE, size);
+                if (memcmp(dst0, dst1, BUF_SIZE))
+                    fail();
+                bench_new(dst1, src, STRIDE, size);
+            }
+        }
+    }
+}
+
+void checkasm_check_hpeldsp(void)
+{
+    HpelDSPContext h;
+
+    ff_hpeldsp_init(&h, AV_CODEC_FLAG_BITEXACT);
+
+    check_pixels_tab(h.put_pixels_tab, 4, "put");
+    report("put_pixels");
+
+    check_pixels_tab(h.avg_pixels_tab, 4, "avg");
+    report("avg_pixels");
+
+    check_pixels_tab(h.put_no_rnd_pixels_tab, 2, "put_no_rnd");
+    check_pixels_tab(&h.avg_no_rnd_pixels_tab, 1, "avg_no_rnd");
+    report("no_rnd_pixels");
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavcodec/idctdsp.h"
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+
+#include "checkasm.h"
+
+#define STRIDE 16
+
+/* The coefficients go beyond the range of the pixels so that the
+ * clamping is tested. */
+#define randomize_buffers()                                 \
+    do {                                                    \
+        int i;                                              \
+        for (i = 0; i < 64; i++)                            \
+            block[i] = (int16_t)(rnd() & 0x3ff) - 0x180;    \
+        for (i = 0; i < 8 * STRIDE; i++)                    \
+            dst0[i] = dst1[i] = rnd();                      \
+    } while (0)
+
+static void check_clamped(void (*func)(const int16_t *block, uint8_t *pixels,
+                                       ptrdiff_t line_size),
+                          const char *name)
+{
+    LOCAL_ALIGNED_16(int16_t, block, [64]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [8 * STRIDE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [8 * STRIDE]);
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, const int16_t *block,
+                      uint8_t *pixels, ptrdiff_t line_size);
+
+    if (check_func(func, "idctdsp.%s", name)) {
+        randomize_buffers();
+        call_ref(block, dst0, STRIDE);
+        call_new(block, dst1, STRIDE);
+        if (memcmp(dst0, dst1, 8 * STRIDE))
+            fail();
+        bench_new(block, dst1, STRIDE);
+    }
+}
+
+void checkasm_check_idctdsp(void)
+{
+    AVCodecContext avctx = { 0 };
+    IDCTDSPContext c;
+
+    avctx.bits_per_raw_sample = 8;
+    ff_idctdsp_init(&c, &avctx);
+
+    check_clamped(c.put_pixels_clamped,        "put_pixels_clamped");
+    check_clamped(c.put_signed_pixels_clamped, "put_signed_pixels_clamped");
+    check_clamped(c.add_pixels_clamped,        "add_pixels_clamped");
+    report("pixels_clamped");
+}
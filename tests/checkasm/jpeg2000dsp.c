@@ -0,0 +1,145 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
+#include "libavcodec/jpeg2000dsp.h"
+#include "libavcodec/jpeg2000dwt.h"
+
+#include "checkasm.h"
+
+#define BUF_SIZE 512
+#define NB_ROWS  64
+#define LIFT_SIZE ((NB_ROWS + 1) * FF_DWT_COLS)
+
+#define randomize_buffers(buf, size, type)                      \
+    do {                                                        \
+        int i;                                                  \
+        for (i = 0; i < size; i++) {                            \
+            if (type == FF_DWT97)                               \
+                ((float *)buf)[i] = (int)(rnd() % 2048) - 1024; \
+            else                                                \
+                ((int32_t *)buf)[i] = (int)(rnd() % 2048) - 1024; \
+        }                                                       \
+    } while (0)
+
+static void test_mct(Jpeg2000DSPContext *c, int type, const char *name)
+{
+    LOCAL_ALIGNED_32(int32_t, ref0, [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_32(int32_t, ref1, [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_32(int32_t, ref2, [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_32(int32_t, new0, [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_32(int32_t, new1, [BUF_SIZE + 8]);
+    LOCAL_ALIGNED_32(int32_t, new2, [BUF_SIZE + 8]);
+    int csize;
+
+    declare_func(void, void *src0, void *src1, void *src2, int csize);
+
+    if (check_func(c->mct_decode[type], "%s", name)) {
+        for (csize = BUF_SIZE - 7; csize <= BUF_SIZE; csize++) {
+            randomize_buffers(ref0, csize, type);
+            randomize_buffers(ref1, csize, type);
+            randomize_buffers(ref2, csize, type);
+            memcpy(new0, ref0, csize * sizeof(*ref0));
+            memcpy(new1, ref1, csize * sizeof(*ref1));
+            memcpy(new2, ref2, csize * sizeof(*ref2));
+
+            call_ref(ref0, ref1, ref2, csize);
+            call_new(new0, new1, new2, csize);
+            if (memcmp(ref0, new0, csize * sizeof(*ref0)) ||
+                memcmp(ref1, new1, csize * sizeof(*ref1)) ||
+                memcmp(ref2, new2, csize * sizeof(*ref2)))
+                fail();
+        }
+        bench_new(new0, new1, new2, BUF_SIZE);
+    }
+
+    report("%s", name);
+}
+
+static void test_lift97_float(DWTContext *s)
+{
+    LOCAL_ALIGNED_16(float, ref, [LIFT_SIZE]);
+    LOCAL_ALIGNED_16(float, new, [LIFT_SIZE]);
+    float c = (int)(rnd() % 2001 - 1000) / 1000.0f;
+
+    declare_func(void, float *p, int n, float c);
+
+    randomize_buffers(ref, LIFT_SIZE, FF_DWT97);
+    memcpy(new, ref, LIFT_SIZE * sizeof(*ref));
+
+    if (check_func(s->lift97_float, "dwt_lift97_float")) {
+        call_ref(ref + FF_DWT_COLS, NB_ROWS / 2, c);
+        call_new(new + FF_DWT_COLS, NB_ROWS / 2, c);
+        if (memcmp(ref, new, LIFT_SIZE * sizeof(*ref)))
+            fail();
+        bench_new(new + FF_DWT_COLS, NB_ROWS / 2, c);
+    }
+
+    report("dwt_lift97_float");
+}
+
+static void test_lift53(void (*func)(int32_t *p, int n), const char *name)
+{
+    LOCAL_ALIGNED_16(int32_t, ref, [LIFT_SIZE]);
+    LOCAL_ALIGNED_16(int32_t, new, [LIFT_SIZE]);
+
+    declare_func(void, int32_t *p, int n);
+
+    randomize_buffers(ref, LIFT_SIZE, FF_DWT53);
+    memcpy(new, ref, LIFT_SIZE * sizeof(*ref));
+
+    if (check_func(func, "%s", name)) {
+        call_ref(ref + FF_DWT_COLS, NB_ROWS / 2);
+        call_new(new + FF_DWT_COLS, NB_ROWS / 2);
+        if (memcmp(ref, new, LIFT_SIZE * sizeof(*ref)))
+            fail();
+        bench_new(new + FF_DWT_COLS, NB_ROWS / 2);
+    }
+
+    report("%s", name);
+}
+
+void checkasm_check_jpeg2000dsp(void)
+{
+    Jpeg2000DSPContext c;
+    DWTContext s97 = { { { 0 } } }, s53 = { { { 0 } } };
+    uint16_t border[2][2] = { { 0, NB_ROWS }, { 0, NB_ROWS } };
+
+    ff_jpeg2000dsp_init(&c);
+
+    test_mct(&c, FF_DWT97, "ict_float");
+    test_mct(&c, FF_DWT53, "rct_int");
+
+    if (ff_jpeg2000_dwt_init(&s97, border, 1, FF_DWT97) < 0 ||
+        ff_jpeg2000_dwt_init(&s53, border, 1, FF_DWT53) < 0) {
+        fail();
+        goto end;
+    }
+
+    test_lift97_float(&s97);
+    test_lift53(s53.lift53_low,  "dwt_lift53_low");
+    test_lift53(s53.lift53_high, "dwt_lift53_high");
+
+end:
+    ff_dwt_destroy(&s97);
+    ff_dwt_destroy(&s53);
+}
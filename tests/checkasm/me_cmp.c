@@ -0,0 +1,117 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdio.h>
+
+#include "libavcodec/avcodec.h"
+#include "libavcodec/me_cmp.h"
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+
+#include "checkasm.h"
+
+#define STRIDE 32
+/* one more row and column for the half-pel interpolation */
+#define BUF_SIZE (STRIDE * 17 + 1)
+
+/* The second block is the first one with small random changes, as the
+ * motion estimation compares similar blocks. */
+#define randomize_buffers()                                 \
+    do {                                                    \
+        int i;                                              \
+        for (i = 0; i < BUF_SIZE; i++) {                    \
+            blk1[i] = rnd();                                \
+            blk2[i] = av_clip_uint8(blk1[i] +               \
+                                    (int)(rnd() % 33) - 16);\
+        }                                                   \
+    } while (0)
+
+static void check_cmp(me_cmp_func func, const char *name, int size)
+{
+    LOCAL_ALIGNED_16(uint8_t, blk1, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, blk2, [BUF_SIZE]);
+    int h;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, int, struct MpegEncContext *c,
+                      uint8_t *blk1, uint8_t *blk2, ptrdiff_t stride, int h);
+
+    if (check_func(func, "%s", name)) {
+        /* 16 pixels wide blocks are compared with h 8 or 16,
+         * 8 pixels wide ones only with h 8 */
+        for (h = 8; h <= size; h += 8) {
+            int res0, res1;
+
+            randomize_buffers();
+            res0 = call_ref(NULL, blk1, blk2 + 1, STRIDE, h);
+            res1 = call_new(NULL, blk1, blk2 + 1, STRIDE, h);
+            if (res0 != res1)
+                fail();
+        }
+        bench_new(NULL, blk1, blk2 + 1, STRIDE, size);
+    }
+}
+
+static void check_sum_abs_dctelem(int (*func)(int16_t *block))
+{
+    LOCAL_ALIGNED_16(int16_t, block, [64]);
+    int i, res0, res1;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, int, int16_t *block);
+
+    if (check_func(func, "sum_abs_dctelem")) {
+        for (i = 0; i < 64; i++)
+            block[i] = (int16_t)(rnd() & 0x1ff) - 0x100;
+        res0 = call_ref(block);
+        res1 = call_new(block);
+        if (res0 != res1)
+            fail();
+        bench_new(block);
+    }
+}
+
+void checkasm_check_me_cmp(void)
+{
+    static const char *const dxy_names[4] = { "", "_x2", "_y2", "_xy2" };
+    AVCodecContext avctx = { 0 };
+    MECmpContext c;
+    char name[32];
+    int i, j;
+
+    avctx.flags = AV_CODEC_FLAG_BITEXACT;
+    ff_me_cmp_init_static();
+    ff_me_cmp_init(&c, &avctx);
+
+    for (i = 0; i < 2; i++) {
+        snprintf(name, sizeof(name), "sad%d", 16 >> i);
+        check_cmp(c.sad[i], name, 16 >> i);
+        snprintf(name, sizeof(name), "sse%d", 16 >> i);
+        check_cmp(c.sse[i], name, 16 >> i);
+    }
+    report("sad_sse");
+
+    for (i = 0; i < 2; i++)
+        for (j = 0; j < 4; j++) {
+            snprintf(name, sizeof(name), "pix_abs%d%s", 16 >> i, dxy_names[j]);
+            check_cmp(c.pix_abs[i][j], name, 16 >> i);
+        }
+    report("pix_abs");
+
+    check_sum_abs_dctelem(c.sum_abs_dctelem);
+    report("sum_abs_dctelem");
+}
@@ -0,0 +1,132 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavcodec/opusdsp.h"
+
+#include "checkasm.h"
+
+#define HISTORY   1024
+#define BUF_SIZE  960
+#define EPS       0.0001f
+
+#define randomize_float(buf, len, scale)                        \
+    do {                                                        \
+        int i;                                                  \
+        for (i = 0; i < len; i++) {                             \
+            float f = (float)rnd() / (UINT_MAX >> 1) - 1.0f;    \
+            buf[i] = f * scale;                                 \
+        }                                                       \
+    } while (0)
+
+static void test_postfilter(OpusDSPContext *s)
+{
+    LOCAL_ALIGNED_32(float, data0, [HISTORY + BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, data1, [HISTORY + BUF_SIZE]);
+    static const int lens[] = { 240, 720 };
+    float gains[3];
+    int i;
+
+    declare_func(void, float *data, int period, const float *gains, int len);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(lens); i++) {
+        int period = 15 + rnd() % (HISTORY - 17);
+
+        randomize_float(gains, 3, 0.3f);
+        randomize_float(data0, HISTORY + BUF_SIZE, 1.0f);
+        memcpy(data1, data0, (HISTORY + BUF_SIZE) * sizeof(*data0));
+
+        if (check_func(s->postfilter, "postfilter_%d", lens[i])) {
+            call_ref(data0 + HISTORY, period, gains, lens[i]);
+            call_new(data1 + HISTORY, period, gains, lens[i]);
+            if (!float_near_abs_eps_array(data0, data1, EPS, HISTORY + lens[i]))
+                fail();
+            bench_new(data1 + HISTORY, period, gains, lens[i]);
+        }
+    }
+
+    report("postfilter");
+}
+
+static void test_deemphasis(OpusDSPContext *s)
+{
+    LOCAL_ALIGNED_16(float, in,   [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, out0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, out1, [BUF_SIZE]);
+    float coeff0, coeff1;
+
+    declare_func_float(float, float *out, const float *in, int len, float coeff);
+
+    randomize_float(in, BUF_SIZE, 32768.0f);
+
+    if (check_func(s->deemphasis, "deemphasis")) {
+        float coeff = in[0];
+
+        coeff0 = call_ref(out0, in, BUF_SIZE, coeff);
+        coeff1 = call_new(out1, in, BUF_SIZE, coeff);
+        if (!float_near_abs_eps_array(out0, out1, EPS, BUF_SIZE) ||
+            !float_near_abs_eps(coeff0 / 32768, coeff1 / 32768, EPS))
+            fail();
+        bench_new(out1, in, BUF_SIZE, coeff);
+    }
+
+    report("deemphasis");
+}
+
+static void test_dequant_pvq(OpusDSPContext *s)
+{
+    LOCAL_ALIGNED_16(int,   iy,   [176]);
+    LOCAL_ALIGNED_16(float, out0, [176]);
+    LOCAL_ALIGNED_16(float, out1, [176]);
+    int i, N;
+
+    declare_func(void, float *X, const int *iy, int N, float gain);
+
+    for (N = 1; N <= 176; N += 1 + rnd() % 16) {
+        float gain = (float)rnd() / UINT_MAX;
+
+        for (i = 0; i < N; i++)
+            iy[i] = (int)(rnd() % 33) - 16;
+
+        if (check_func(s->dequant_pvq, "dequant_pvq")) {
+            memset(out0, 0, sizeof(*out0) * 176);
+            memset(out1, 0, sizeof(*out1) * 176);
+            call_ref(out0, iy, N, gain);
+            call_new(out1, iy, N, gain);
+            if (memcmp(out0, out1, sizeof(*out0) * 176))
+                fail();
+            bench_new(out1, iy, N, gain);
+        }
+    }
+
+    report("dequant_pvq");
+}
+
+void checkasm_check_opusdsp(void)
+{
+    OpusDSPContext s;
+
+    ff_opus_dsp_init(&s);
+
+    test_postfilter(&s);
+    test_deemphasis(&s);
+    test_dequant_pvq(&s);
+}
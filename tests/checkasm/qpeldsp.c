@@ -0,0 +1,86 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavcodec/qpeldsp.h"
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+#include "checkasm.h"
+
+/* the filters read one row and column past the block */
+#define BUF_SIZE (16 * (16 + 1 + 2))
+
+#define randomize_buffers()                 \
+    do {                                    \
+        int k;                              \
+        for (k = 0; k < BUF_SIZE; k += 4) { \
+            uint32_t r = rnd();             \
+            AV_WN32A(src0 + k, r);          \
+            AV_WN32A(src1 + k, r);          \
+            r = rnd();                      \
+            AV_WN32A(dst0 + k, r);          \
+            AV_WN32A(dst1 + k, r);          \
+        }                                   \
+    } while (0)
+
+static void check_qpel_tab(qpel_mc_func (*tab)[16], const char *op)
+{
+    LOCAL_ALIGNED_16(uint8_t, src0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, src1, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE]);
+    int i, j;
+
+    declare_func_emms(AV_CPU_FLAG_MMX | AV_CPU_FLAG_MMXEXT, void, uint8_t *dst,
+                      const uint8_t *src, ptrdiff_t stride);
+
+    for (i = 0; i < 2; i++) {
+        int size = 16 >> i;
+
+        for (j = 0; j < 16; j++) {
+            if (check_func(tab[i][j], "%s_qpel%d_mc%d%d", op, size, j & 3, j >> 2)) {
+                randomize_buffers();
+                call_ref(dst0, src0, size);
+                call_new(dst1, src1, size);
+                if (memcmp(src0, src1, BUF_SIZE) || memcmp(dst0, dst1, BUF_SIZE))
+                    fail();
+                bench_new(dst1, src1, size);
+            }
+        }
+    }
+}
+
+void checkasm_check_qpeldsp(void)
+{
+    QpelDSPContext q;
+
+    ff_qpeldsp_init(&q);
+
+    check_qpel_tab(q.put_qpel_pixels_tab, "put");
+    report("put");
+
+    check_qpel_tab(q.avg_qpel_pixels_tab, "avg");
+    report("avg");
+
+    check_qpel_tab(q.put_no_rnd_qpel_pixels_tab, "put_no_rnd");
+    report("put_no_rnd");
+}
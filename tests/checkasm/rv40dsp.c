@@ -0,0 +1,224 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavcodec/rv34dsp.h"
+
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+#include "checkasm.h"
+
+/* room for two 16x16 blocks, or one with the margins of the 6-tap filters */
+#define BUF_SIZE (2 * 16 * 16)
+
+#define randomize_buffers()                 \
+    do {                                    \
+        int k;                              \
+        for (k = 0; k < BUF_SIZE; k += 4) { \
+            uint32_t r = rnd();             \
+            AV_WN32A(buf0 + k, r);          \
+            AV_WN32A(buf1 + k, r);          \
+            r = rnd();                      \
+            AV_WN32A(dst0 + k, r);          \
+            AV_WN32A(dst1 + k, r);          \
+        }                                   \
+    } while (0)
+
+static void check_qpel(RV34DSPContext *c)
+{
+    LOCAL_ALIGNED_16(uint8_t, buf0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, buf1, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE]);
+    /* the 6-tap filters read from two rows and columns before the block */
+    uint8_t *src0 = buf0 + 3 * 16, *src1 = buf1 + 3 * 16;
+    int op, i, j;
+
+    declare_func_emms(AV_CPU_FLAG_MMX | AV_CPU_FLAG_MMXEXT, void, uint8_t *dst,
+                      const uint8_t *src, ptrdiff_t stride);
+
+    for (op = 0; op < 2; op++) {
+        qpel_mc_func (*tab)[16] = op ? c->avg_pixels_tab : c->put_pixels_tab;
+        const char *op_name = op ? "avg" : "put";
+
+        for (i = 0; i < 2; i++) {
+            int size = 16 >> i;
+
+            for (j = 0; j < 16; j++) {
+                if (check_func(tab[i][j], "%s_rv40_qpel%d_mc%d%d",
+                               op_name, size, j & 3, j >> 2)) {
+                    randomize_buffers();
+                    call_ref(dst0, src0, size);
+                    call_new(dst1, src1, size);
+                    if (memcmp(buf0, buf1, BUF_SIZE) || memcmp(dst0, dst1, BUF_SIZE))
+                        fail();
+                    bench_new(dst1, src1, size);
+                }
+            }
+        }
+        report("%s_qpel", op_name);
+    }
+}
+
+static void check_chroma(RV34DSPContext *c)
+{
+    LOCAL_ALIGNED_16(uint8_t, buf0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, buf1, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE]);
+    uint8_t *src0 = buf0 + 3 * 16, *src1 = buf1 + 3 * 16;
+    int op, i;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, uint8_t *dst, uint8_t *src,
+                      ptrdiff_t stride, int h, int x, int y);
+
+    for (op = 0; op < 2; op++) {
+        h264_chroma_mc_func *tab = op ? c->avg_chroma_pixels_tab : c->put_chroma_pixels_tab;
+        const char *op_name = op ? "avg" : "put";
+
+        for (i = 0; i < 2; i++) {
+            int size = 8 >> i;
+
+            if (check_func(tab[i], "%s_rv40_chroma_mc%d", op_name, size)) {
+                int x = rnd() & 7, y = rnd() & 7;
+
+                randomize_buffers();
+                call_ref(dst0, src0, 16, size, x, y);
+                call_new(dst1, src1, 16, size, x, y);
+                if (memcmp(buf0, buf1, BUF_SIZE) || memcmp(dst0, dst1, BUF_SIZE))
+                    fail();
+                bench_new(dst1, src1, 16, size, x, y);
+            }
+        }
+        report("%s_chroma", op_name);
+    }
+}
+
+static void check_weight(RV34DSPContext *c)
+{
+    LOCAL_ALIGNED_16(uint8_t, buf0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, buf1, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE]);
+    int i, j;
+
+    declare_func_emms(AV_CPU_FLAG_MMXEXT, void, uint8_t *dst, uint8_t *src1,
+                      uint8_t *src2, int w1, int w2, ptrdiff_t stride);
+
+    for (i = 0; i < 2; i++) {
+        for (j = 0; j < 2; j++) {
+            int size = 16 >> j;
+
+            if (check_func(c->rv40_weight_pixels_tab[i][j], "rv40_weight_%s_%d",
+                           i ? "nornd" : "rnd", size)) {
+                /* the weights add up to 1 << 14, the prescaled ones to 32 */
+                int w1 = i ? rnd() % 33 : rnd() % ((1 << 14) + 1);
+                int w2 = (i ? 32 : 1 << 14) - w1;
+
+                randomize_buffers();
+                call_ref(dst0, buf0, buf0 + 16 * 16, w1, w2, 16);
+                call_new(dst1, buf1, buf1 + 16 * 16, w1, w2, 16);
+                if (memcmp(dst0, dst1, BUF_SIZE))
+                    fail();
+                bench_new(dst1, buf1, buf1 + 16 * 16, w1, w2, 16);
+            }
+        }
+    }
+    report("weight");
+}
+
+static void check_idct(RV34DSPContext *c)
+{
+    LOCAL_ALIGNED_16(int16_t, block0, [16]);
+    LOCAL_ALIGNED_16(int16_t, block1, [16]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [4 * 16]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [4 * 16]);
+    int i;
+
+    {
+        declare_func_emms(AV_CPU_FLAG_MMX, void, int16_t *block);
+
+        if (check_func(c->rv34_inv_transform, "rv34_inv_transform")) {
+            for (i = 0; i < 16; i++)
+                block0[i] = block1[i] = (int)(rnd() % 512) - 256;
+            call_ref(block0);
+            call_new(block1);
+            if (memcmp(block0, block1, sizeof(*block0) * 16))
+                fail();
+            bench_new(block1);
+        }
+        if (check_func(c->rv34_inv_transform_dc, "rv34_inv_transform_dc")) {
+            block0[0] = block1[0] = rnd();
+            call_ref(block0);
+            call_new(block1);
+            if (memcmp(block0, block1, sizeof(*block0) * 16))
+                fail();
+            bench_new(block1);
+        }
+    }
+    {
+        declare_func_emms(AV_CPU_FLAG_MMX, void, uint8_t *dst, ptrdiff_t stride,
+                          int16_t *block);
+
+        if (check_func(c->rv34_idct_add, "rv34_idct_add")) {
+            /* the SIMD row transform is done with saturating 16-bit math */
+            for (i = 0; i < 16; i++)
+                block0[i] = block1[i] = (int)(rnd() % 512) - 256;
+            for (i = 0; i < 4 * 16; i++)
+                dst0[i] = dst1[i] = rnd();
+            call_ref(dst0, 16, block0);
+            call_new(dst1, 16, block1);
+            if (memcmp(block0, block1, sizeof(*block0) * 16) ||
+                memcmp(dst0, dst1, 4 * 16))
+                fail();
+            bench_new(dst1, 16, block1);
+        }
+    }
+    {
+        declare_func_emms(AV_CPU_FLAG_MMX, void, uint8_t *dst, ptrdiff_t stride,
+                          int dc);
+
+        if (check_func(c->rv34_idct_dc_add, "rv34_idct_dc_add")) {
+            int dc = (int)(rnd() % 2048) - 1024;
+
+            for (i = 0; i < 4 * 16; i++)
+                dst0[i] = dst1[i] = rnd();
+            call_ref(dst0, 16, dc);
+            call_new(dst1, 16, dc);
+            if (memcmp(dst0, dst1, 4 * 16))
+                fail();
+            bench_new(dst1, 16, dc);
+        }
+    }
+    report("idct");
+}
+
+void checkasm_check_rv40dsp(void)
+{
+    RV34DSPContext c;
+
+    ff_rv40dsp_init(&c);
+
+    check_qpel(&c);
+    check_chroma(&c);
+    check_weight(&c);
+    check_idct(&c);
+}
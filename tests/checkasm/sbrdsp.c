@@ -0,0 +1,298 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "libavutil/internal.h"
+#include "libavcodec/sbrdsp.h"
+
+#include "checkasm.h"
+
+#define randomize(buf, len) do {                                \
+    int i;                                                      \
+    for (i = 0; i < len; i++)                                   \
+        (buf)[i] = (float)(int32_t)rnd() / INT32_MAX;           \
+} while (0)
+
+#define EPS 0.0001
+
+static void test_sum64x5(void)
+{
+    LOCAL_ALIGNED_16(float, src, [320]);
+    LOCAL_ALIGNED_16(float, dst0, [320]);
+    LOCAL_ALIGNED_16(float, dst1, [320]);
+
+    declare_func(void, float *z);
+
+    randomize(src, 320);
+    memcpy(dst0, src, sizeof(dst0[0]) * 320);
+    memcpy(dst1, src, sizeof(dst1[0]) * 320);
+    call_ref(dst0);
+    call_new(dst1);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, 320))
+        fail();
+    bench_new(dst1);
+}
+
+static void test_sum_square(void)
+{
+    LOCAL_ALIGNED_16(float, src, [256], [2]);
+    float res0, res1;
+
+    declare_func_float(float, float (*x)[2], int n);
+
+    randomize((float *)src, 256 * 2);
+    res0 = call_ref(src, 256);
+    res1 = call_new(src, 256);
+    if (!float_near_abs_eps(res0, res1, 0.01))
+        fail();
+    bench_new(src, 256);
+}
+
+static void test_neg_odd_64(void)
+{
+    LOCAL_ALIGNED_16(float, src, [64]);
+    LOCAL_ALIGNED_16(float, dst0, [64]);
+    LOCAL_ALIGNED_16(float, dst1, [64]);
+
+    declare_func(void, float *x);
+
+    randomize(src, 64);
+    memcpy(dst0, src, sizeof(dst0[0]) * 64);
+    memcpy(dst1, src, sizeof(dst1[0]) * 64);
+    call_ref(dst0);
+    call_new(dst1);
+    if (memcmp(dst0, dst1, sizeof(dst0[0]) * 64))
+        fail();
+    bench_new(dst1);
+}
+
+static void test_qmf_pre_shuffle(void)
+{
+    LOCAL_ALIGNED_16(float, src, [128]);
+    LOCAL_ALIGNED_16(float, dst0, [128]);
+    LOCAL_ALIGNED_16(float, dst1, [128]);
+
+    declare_func(void, float *z);
+
+    randomize(src, 128);
+    memcpy(dst0, src, sizeof(dst0[0]) * 128);
+    memcpy(dst1, src, sizeof(dst1[0]) * 128);
+    call_ref(dst0);
+    call_new(dst1);
+    if (memcmp(dst0, dst1, sizeof(dst0[0]) * 128))
+        fail();
+    bench_new(dst1);
+}
+
+static void test_qmf_post_shuffle(void)
+{
+    LOCAL_ALIGNED_16(float, src, [64]);
+    LOCAL_ALIGNED_16(float, dst0, [32], [2]);
+    LOCAL_ALIGNED_16(float, dst1, [32], [2]);
+
+    declare_func(void, float W[32][2], const float *z);
+
+    randomize(src, 64);
+    call_ref(dst0, src);
+    call_new(dst1, src);
+    if (memcmp(dst0, dst1, sizeof(dst0[0]) * 32))
+        fail();
+    bench_new(dst1, src);
+}
+
+static void test_qmf_deint_neg(void)
+{
+    LOCAL_ALIGNED_16(float, src, [64]);
+    LOCAL_ALIGNED_16(float, dst0, [64]);
+    LOCAL_ALIGNED_16(float, dst1, [64]);
+
+    declare_func(void, float *v, const float *src);
+
+    randomize(src, 64);
+    call_ref(dst0, src);
+    call_new(dst1, src);
+    if (memcmp(dst0, dst1, sizeof(dst0[0]) * 64))
+        fail();
+    bench_new(dst1, src);
+}
+
+static void test_qmf_deint_bfly(void)
+{
+    LOCAL_ALIGNED_16(float, src0, [64]);
+    LOCAL_ALIGNED_16(float, src1, [64]);
+    LOCAL_ALIGNED_16(float, dst0, [128]);
+    LOCAL_ALIGNED_16(float, dst1, [128]);
+
+    declare_func(void, float *v, const float *src0, const float *src1);
+
+    randomize(src0, 64);
+    randomize(src1, 64);
+    call_ref(dst0, src0, src1);
+    call_new(dst1, src0, src1);
+    if (!float_near_abs_eps_array(dst0, dst1, EPS, 128))
+        fail();
+    bench_new(dst1, src0, src1);
+}
+
+static void test_autocorrelate(void)
+{
+    LOCAL_ALIGNED_16(float, src, [40], [2]);
+    LOCAL_ALIGNED_16(float, dst0, [3], [2][2]);
+    LOCAL_ALIGNED_16(float, dst1, [3], [2][2]);
+
+    declare_func(void, const float x[40][2], float phi[3][2][2]);
+
+    randomize((float *)src, 40 * 2);
+    memset(dst0, 0, sizeof(dst0[0]) * 3);
+    memset(dst1, 0, sizeof(dst1[0]) * 3);
+    call_ref(src, dst0);
+    call_new(src, dst1);
+    if (!float_near_abs_eps_array((float *)dst0, (float *)dst1, EPS, 3 * 2 * 2))
+        fail();
+    bench_new(src, dst1);
+}
+
+static void test_hf_gen(void)
+{
+    LOCAL_ALIGNED_16(float, low, [128], [2]);
+    LOCAL_ALIGNED_16(float, alpha, [2], [2]);
+    LOCAL_ALIGNED_16(float, dst0, [128], [2]);
+    LOCAL_ALIGNED_16(float, dst1, [128], [2]);
+    float bw = (float)rnd() / UINT_MAX;
+
+    declare_func(void, float (*X_high)[2], const float (*X_low)[2],
+                 const float alpha0[2], const float alpha1[2],
+                 float bw, int start, int end);
+
+    randomize((float *)low, 128 * 2);
+    randomize((float *)alpha, 2 * 2);
+    memset(dst0, 0, sizeof(dst0[0]) * 128);
+    memset(dst1, 0, sizeof(dst1[0]) * 128);
+    /* the start and end are even in the decoder */
+    call_ref(dst0, low, alpha[0], alpha[1], bw, 2, 126);
+    call_new(dst1, low, alpha[0], alpha[1], bw, 2, 126);
+    if (!float_near_abs_eps_array((float *)dst0, (float *)dst1, EPS, 128 * 2))
+        fail();
+    bench_new(dst1, low, alpha[0], alpha[1], bw, 2, 126);
+}
+
+static void test_hf_g_filt(void)
+{
+    LOCAL_ALIGNED_16(float, high, [128], [40][2]);
+    LOCAL_ALIGNED_16(float, g_filt, [128]);
+    LOCAL_ALIGNED_16(float, dst0, [128], [2]);
+    LOCAL_ALIGNED_16(float, dst1, [128], [2]);
+    int ixh = rnd() % 40;
+
+    declare_func(void, float (*Y)[2], const float (*X_high)[40][2],
+                 const float *g_filt, int m_max, intptr_t ixh);
+
+    randomize((float *)high, 128 * 40 * 2);
+    randomize(g_filt, 128);
+    call_ref(dst0, high, g_filt, 128, ixh);
+    call_new(dst1, high, g_filt, 128, ixh);
+    if (!float_near_abs_eps_array((float *)dst0, (float *)dst1, EPS, 128 * 2))
+        fail();
+    bench_new(dst1, high, g_filt, 128, ixh);
+}
+
+static void test_hf_apply_noise(const SBRDSPContext *sbrdsp)
+{
+    LOCAL_ALIGNED_16(float, s_m, [128]);
+    LOCAL_ALIGNED_16(float, q_filt, [128]);
+    LOCAL_ALIGNED_16(float, ref, [128], [2]);
+    LOCAL_ALIGNED_16(float, dst0, [128], [2]);
+    LOCAL_ALIGNED_16(float, dst1, [128], [2]);
+    int noise = rnd() % 512;
+    int kx = rnd() % 2;
+    int i;
+
+    declare_func(void, float (*Y)[2], const float *s_m,
+                 const float *q_filt, int noise, int kx, int m_max);
+
+    randomize((float *)ref, 128 * 2);
+    randomize(s_m, 128);
+    randomize(q_filt, 128);
+    /* both the sinusoid and the noise paths are taken */
+    for (i = 0; i < 128; i += 3)
+        s_m[i] = 0;
+
+    for (i = 0; i < 4; i++) {
+        if (check_func(sbrdsp->hf_apply_noise[i], "hf_apply_noise_%d", i)) {
+            memcpy(dst0, ref, sizeof(dst0[0]) * 128);
+            memcpy(dst1, ref, sizeof(dst1[0]) * 128);
+            call_ref(dst0, s_m, q_filt, noise, kx, 128);
+            call_new(dst1, s_m, q_filt, noise, kx, 128);
+            if (!float_near_abs_eps_array((float *)dst0, (float *)dst1, EPS, 128 * 2))
+                fail();
+            bench_new(dst1, s_m, q_filt, noise, kx, 128);
+        }
+    }
+}
+
+void checkasm_check_sbrdsp(void)
+{
+    SBRDSPContext sbrdsp;
+
+    ff_sbrdsp_init(&sbrdsp);
+
+    if (check_func(sbrdsp.sum64x5, "sum64x5"))
+        test_sum64x5();
+    report("sum64x5");
+
+    if (check_func(sbrdsp.sum_square, "sum_square"))
+        test_sum_square();
+    report("sum_square");
+
+    if (check_func(sbrdsp.neg_odd_64, "neg_odd_64"))
+        test_neg_odd_64();
+    report("neg_odd_64");
+
+    if (check_func(sbrdsp.qmf_pre_shuffle, "qmf_pre_shuffle"))
+        test_qmf_pre_shuffle();
+    report("qmf_pre_shuffle");
+
+    if (check_func(sbrdsp.qmf_post_shuffle, "qmf_post_shuffle"))
+        test_qmf_post_shuffle();
+    report("qmf_post_shuffle");
+
+    if (check_func(sbrdsp.qmf_deint_neg, "qmf_deint_neg"))
+        test_qmf_deint_neg();
+    report("qmf_deint_neg");
+
+    if (check_func(sbrdsp.qmf_deint_bfly, "qmf_deint_bfly"))
+        test_qmf_deint_bfly();
+    report("qmf_deint_bfly");
+
+    if (check_func(sbrdsp.autocorrelate, "autocorrelate"))
+        test_autocorrelate();
+    report("autocorrelate");
+
+    if (check_func(sbrdsp.hf_gen, "hf_gen"))
+        test_hf_gen();
+    report("hf_gen");
+
+    if (check_func(sbrdsp.hf_g_filt, "hf_g_filt"))
+        test_hf_g_filt();
+    report("hf_g_filt");
+
+    test_hf_apply_noise(&sbrdsp);
+    report("hf_apply_noise");
+}
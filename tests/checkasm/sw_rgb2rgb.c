@@ -0,0 +1,197 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/mem.h"
+
+#include "libswscale/rgb2rgb.h"
+
+#include "checkasm.h"
+
+/* not a multiple of the SIMD width, so that the C tail is run as well */
+#define WIDTH 131
+
+static void randomize_words(uint16_t *buf, int size, int bits)
+{
+    int i;
+
+    for (i = 0; i < size; i++)
+        buf[i] = rnd() & ((1 << bits) - 1);
+}
+
+static void check_interleave_words(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src1, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, src2, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst0, [WIDTH * 2]);
+    LOCAL_ALIGNED_32(uint16_t, dst1, [WIDTH * 2]);
+    int shift;
+
+    declare_func(void, const uint16_t *src1, const uint16_t *src2,
+                 uint16_t *dst, int width, int shift);
+
+    for (shift = 0; shift <= 6; shift += 6) {
+        if (check_func(interleaveWords, "interleave_words_%d", shift)) {
+            randomize_words(src1, WIDTH, 16 - shift);
+            randomize_words(src2, WIDTH, 16 - shift);
+            memset(dst0, 0, WIDTH * 2 * sizeof(*dst0));
+            memset(dst1, 0, WIDTH * 2 * sizeof(*dst1));
+
+            call_ref(src1, src2, dst0, WIDTH, shift);
+            call_new(src1, src2, dst1, WIDTH, shift);
+            if (memcmp(dst0, dst1, WIDTH * 2 * sizeof(*dst0)))
+                fail();
+            bench_new(src1, src2, dst1, WIDTH, shift);
+        }
+    }
+    report("interleave_words");
+}
+
+static void check_deinterleave_words(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src,   [WIDTH * 2]);
+    LOCAL_ALIGNED_32(uint16_t, dst10, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst11, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst20, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst21, [WIDTH]);
+    int shift;
+
+    declare_func(void, const uint16_t *src, uint16_t *dst1, uint16_t *dst2,
+                 int width, int shift);
+
+    for (shift = 0; shift <= 6; shift += 6) {
+        if (check_func(deinterleaveWords, "deinterleave_words_%d", shift)) {
+            randomize_words(src, WIDTH * 2, 16);
+            memset(dst10, 0, WIDTH * sizeof(*dst10));
+            memset(dst11, 0, WIDTH * sizeof(*dst11));
+            memset(dst20, 0, WIDTH * sizeof(*dst20));
+            memset(dst21, 0, WIDTH * sizeof(*dst21));
+
+            call_ref(src, dst10, dst20, WIDTH, shift);
+            call_new(src, dst11, dst21, WIDTH, shift);
+            if (memcmp(dst10, dst11, WIDTH * sizeof(*dst10)) ||
+                memcmp(dst20, dst21, WIDTH * sizeof(*dst20)))
+                fail();
+            bench_new(src, dst11, dst21, WIDTH, shift);
+        }
+    }
+    report("deinterleave_words");
+}
+
+static void check_shift_words(void)
+{
+    LOCAL_ALIGNED_32(uint16_t, src,  [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst0, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst1, [WIDTH]);
+    int shift, left;
+
+    declare_func(void, const uint16_t *src, uint16_t *dst,
+                 int width, int shift);
+
+    for (left = 0; left < 2; left++) {
+        for (shift = 2; shift <= 6; shift += 4) {
+            if (check_func(left ? shiftWordsLeft : shiftWordsRight,
+                           "shift_words_%s_%d", left ? "left" : "right",
+                           shift)) {
+                randomize_words(src, WIDTH, left ? 16 - shift : 16);
+                memset(dst0, 0, WIDTH * sizeof(*dst0));
+                memset(dst1, 0, WIDTH * sizeof(*dst1));
+
+                call_ref(src, dst0, WIDTH, shift);
+                call_new(src, dst1, WIDTH, shift);
+                if (memcmp(dst0, dst1, WIDTH * sizeof(*dst0)))
+                    fail();
+                bench_new(src, dst1, WIDTH, shift);
+            }
+        }
+    }
+    report("shift_words");
+}
+
+static void check_words_to_bytes_dither(void)
+{
+    /* 10 and 16 bits input */
+    static const int shifts[] = { 2, 8 };
+    LOCAL_ALIGNED_32(uint16_t, src,    [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t,  dst0,   [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t,  dst1,   [WIDTH]);
+    LOCAL_ALIGNED_8(uint8_t,   dither, [8]);
+    int i, j;
+
+    declare_func(void, const uint16_t *src, uint8_t *dst, int width,
+                 const uint8_t *dither, int shift);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(shifts); i++) {
+        if (check_func(wordsToBytesDither, "words_to_bytes_dither_%d",
+                       shifts[i])) {
+            /* full range words, to check the clipping */
+            randomize_words(src, WIDTH, 16);
+            for (j = 0; j < 8; j++)
+                dither[j] = rnd() & ((1 << shifts[i]) - 1);
+            memset(dst0, 0, WIDTH);
+            memset(dst1, 0, WIDTH);
+
+            call_ref(src, dst0, WIDTH, dither, shifts[i]);
+            call_new(src, dst1, WIDTH, dither, shifts[i]);
+            if (memcmp(dst0, dst1, WIDTH))
+                fail();
+            bench_new(src, dst1, WIDTH, dither, shifts[i]);
+        }
+    }
+    report("words_to_bytes_dither");
+}
+
+static void check_bytes_to_words(void)
+{
+    LOCAL_ALIGNED_32(uint8_t,  src,  [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst0, [WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, dst1, [WIDTH]);
+    int i, shift;
+
+    declare_func(void, const uint8_t *src, uint16_t *dst,
+                 int width, int shift);
+
+    for (shift = 2; shift <= 8; shift += 6) {
+        if (check_func(bytesToWords, "bytes_to_words_%d", shift)) {
+            for (i = 0; i < WIDTH; i++)
+                src[i] = rnd();
+            memset(dst0, 0, WIDTH * sizeof(*dst0));
+            memset(dst1, 0, WIDTH * sizeof(*dst1));
+
+            call_ref(src, dst0, WIDTH, shift);
+            call_new(src, dst1, WIDTH, shift);
+            if (memcmp(dst0, dst1, WIDTH * sizeof(*dst0)))
+                fail();
+            bench_new(src, dst1, WIDTH, shift);
+        }
+    }
+    report("bytes_to_words");
+}
+
+void checkasm_check_sw_rgb2rgb(void)
+{
+    ff_rgb2rgb_init();
+
+    check_interleave_words();
+    check_deinterleave_words();
+    check_shift_words();
+    check_words_to_bytes_dither();
+    check_bytes_to_words();
+}
@@ -0,0 +1,243 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+
+#include "libswscale/swscale.h"
+#include "libswscale/swscale_internal.h"
+
+#include "checkasm.h"
+
+/* a multiple of 32, so that all the SIMD versions are selected */
+#define DST_W        64
+#define SRC_W        (4 * DST_W)
+#define SRC_PAD      64
+#define MAX_FILTER   40
+#define MAX_LINES    16
+
+static const enum AVPixelFormat formats[] = {
+    AV_PIX_FMT_YUV420P,
+    AV_PIX_FMT_YUV420P9,
+    AV_PIX_FMT_YUV420P10,
+    AV_PIX_FMT_YUV420P12,
+    AV_PIX_FMT_YUV420P16,
+};
+
+static int format_depth(enum AVPixelFormat fmt)
+{
+    return av_pix_fmt_desc_get(fmt)->comp[0].depth;
+}
+
+static void setup_context(SwsContext *c, enum AVPixelFormat src_fmt,
+                          enum AVPixelFormat dst_fmt, int filter_size)
+{
+    c->srcFormat      = src_fmt;
+    c->dstFormat      = dst_fmt;
+    c->srcBpc         = format_depth(src_fmt);
+    c->dstBpc         = format_depth(dst_fmt);
+    c->srcW           = SRC_W;
+    c->dstW           = DST_W;
+    c->chrSrcW        = SRC_W;
+    c->chrDstW        = DST_W;
+    c->hLumFilterSize = filter_size;
+    c->hChrFilterSize = filter_size;
+    ff_getSwsFunc(c);
+}
+
+/* Random taps around a unit gain of 1 << log2_unit. */
+static void randomize_filter(int16_t *filter, int filter_size, int log2_unit)
+{
+    int sum = 0, i;
+
+    for (i = 0; i < filter_size; i++) {
+        filter[i] = (int)(rnd() & 127) - 64;
+        sum += filter[i];
+    }
+    i = rnd() % filter_size;
+    filter[i] += (1 << log2_unit) - sum;
+}
+
+static void check_hscale(SwsContext *c)
+{
+    static const int filter_sizes[] = { 4, 8, 12, 16, 20, 40 };
+    static const enum AVPixelFormat dst_formats[] = {
+        AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV420P16
+    };
+    LOCAL_ALIGNED_32(uint8_t, src,        [(SRC_W + SRC_PAD) * 2]);
+    LOCAL_ALIGNED_32(int16_t, filter,     [DST_W * MAX_FILTER]);
+    LOCAL_ALIGNED_32(int32_t, filter_pos, [DST_W]);
+    LOCAL_ALIGNED_32(int32_t, dst0,       [DST_W]);
+    LOCAL_ALIGNED_32(int32_t, dst1,       [DST_W]);
+    int i, j, k, f;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, SwsContext *c, int16_t *dst,
+                      int dst_w, const uint8_t *src, const int16_t *filter,
+                      const int32_t *filter_pos, int filter_size);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(formats); i++) {
+        int src_bits = format_depth(formats[i]);
+
+        for (j = 0; j < FF_ARRAY_ELEMS(dst_formats); j++) {
+            for (k = 0; k < FF_ARRAY_ELEMS(filter_sizes); k++) {
+                int fs = filter_sizes[k];
+
+                setup_context(c, formats[i], dst_formats[j], fs);
+
+                if (check_func(c->hyScale, "hscale_%d_to_%d_%d",
+                               src_bits, c->dstBpc > 15 ? 19 : 15, fs)) {
+                    for (f = 0; f < SRC_W + SRC_PAD; f++) {
+                        if (src_bits == 8)
+                            src[f] = rnd();
+                        else
+                            AV_WN16A(src + 2 * f,
+                                     rnd() & ((1 << src_bits) - 1));
+                    }
+                    for (f = 0; f < DST_W; f++) {
+                        filter_pos[f] = rnd() % (SRC_W - fs + 1);
+                        randomize_filter(filter + f * fs, fs, 14);
+                    }
+                    memset(dst0, 0, DST_W * sizeof(*dst0));
+                    memset(dst1, 0, DST_W * sizeof(*dst1));
+
+                    call_ref(c, (int16_t *)dst0, DST_W, src, filter,
+                             filter_pos, fs);
+                    call_new(c, (int16_t *)dst1, DST_W, src, filter,
+                             filter_pos, fs);
+                    if (memcmp(dst0, dst1, DST_W * sizeof(*dst0)))
+                        fail();
+                    bench_new(c, (int16_t *)dst1, DST_W, src, filter,
+                              filter_pos, fs);
+                }
+            }
+        }
+    }
+    report("hscale");
+}
+
+/* The 16 bit output takes 19 bit input in int32_t, the others 15 bit input
+ * in int16_t. Leave some headroom for the negative taps. */
+static void randomize_lines(int32_t *lines, int bits)
+{
+    int i;
+
+    for (i = 0; i < MAX_LINES * DST_W; i++) {
+        if (bits == 16)
+            lines[i] = rnd() & ((1 << 18) - 1);
+        else
+            ((int16_t *)lines)[i] = rnd() & ((1 << 15) - 1);
+    }
+}
+
+static void check_yuv2plane1(SwsContext *c)
+{
+    LOCAL_ALIGNED_32(int32_t, src,    [MAX_LINES * DST_W]);
+    LOCAL_ALIGNED_32(uint8_t, dst0,   [DST_W * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1,   [DST_W * 2]);
+    LOCAL_ALIGNED_8(uint8_t,  dither, [8]);
+    int i, j, offset;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, const int16_t *src, uint8_t *dst,
+                      int dst_w, const uint8_t *dither, int offset);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(formats); i++) {
+        int bits = format_depth(formats[i]);
+
+        setup_context(c, AV_PIX_FMT_YUV420P, formats[i], 4);
+
+        for (offset = 0; offset <= 3; offset += 3) {
+            if (!check_func(c->yuv2plane1, "yuv2plane1_%d_%d", bits, offset))
+                continue;
+            for (j = 0; j < 8; j++)
+                dither[j] = rnd();
+            randomize_lines(src, bits);
+            memset(dst0, 0, DST_W * 2);
+            memset(dst1, 0, DST_W * 2);
+
+            call_ref((const int16_t *)src, dst0, DST_W, dither, offset);
+            call_new((const int16_t *)src, dst1, DST_W, dither, offset);
+            if (memcmp(dst0, dst1, DST_W * (bits > 8 ? 2 : 1)))
+                fail();
+            bench_new((const int16_t *)src, dst1, DST_W, dither, offset);
+        }
+    }
+    report("yuv2plane1");
+}
+
+static void check_yuv2planeX(SwsContext *c)
+{
+    LOCAL_ALIGNED_32(int32_t, src_buf, [MAX_LINES * DST_W]);
+    LOCAL_ALIGNED_32(int16_t, filter,  [MAX_LINES]);
+    LOCAL_ALIGNED_32(uint8_t, dst0,    [DST_W * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1,    [DST_W * 2]);
+    LOCAL_ALIGNED_8(uint8_t,  dither,  [8]);
+    const int16_t *src[MAX_LINES];
+    int i, j, fs, offset;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, const int16_t *filter,
+                      int filter_size, const int16_t **src, uint8_t *dst,
+                      int dst_w, const uint8_t *dither, int offset);
+
+    for (i = 0; i < MAX_LINES; i++)
+        src[i] = (const int16_t *)(src_buf + i * DST_W);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(formats); i++) {
+        int bits = format_depth(formats[i]);
+
+        setup_context(c, AV_PIX_FMT_YUV420P, formats[i], 4);
+
+        for (offset = 0; offset <= 3; offset += 3) {
+            for (fs = 2; fs <= MAX_LINES; fs += 2) {
+                if (!check_func(c->yuv2planeX, "yuv2planeX_%d_%d_%d",
+                                bits, fs, offset))
+                    continue;
+                for (j = 0; j < 8; j++)
+                    dither[j] = rnd();
+                randomize_lines(src_buf, bits);
+                randomize_filter(filter, fs, 12);
+                memset(dst0, 0, DST_W * 2);
+                memset(dst1, 0, DST_W * 2);
+
+                call_ref(filter, fs, src, dst0, DST_W, dither, offset);
+                call_new(filter, fs, src, dst1, DST_W, dither, offset);
+                if (memcmp(dst0, dst1, DST_W * (bits > 8 ? 2 : 1)))
+                    fail();
+                bench_new(filter, fs, src, dst1, DST_W, dither, offset);
+            }
+        }
+    }
+    report("yuv2planeX");
+}
+
+void checkasm_check_sw_scale(void)
+{
+    SwsContext *c = sws_alloc_context();
+
+    if (!c)
+        return;
+
+    check_hscale(c);
+    check_yuv2plane1(c);
+    check_yuv2planeX(c);
+
+    sws_freeContext(c);
+}
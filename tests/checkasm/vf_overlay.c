@@ -0,0 +1,118 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with Libav; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
+
+#include "libavfilter/overlay.h"
+
+#include "checkasm.h"
+
+/* not a multiple of the vector sizes, so that the tails are tested too */
+#define WIDTH 123
+
+/* Mix fully transparent, fully opaque and translucent runs of pixels, so
+ * that the skipped blocks are exercised. */
+static uint8_t random_alpha(int i)
+{
+    switch ((i / 16) % 4) {
+    case 0:  return 0;
+    case 1:  return 255;
+    default: return rnd();
+    }
+}
+
+/* transparent is the value of the fully transparent premultiplied samples,
+ * -1 for straight alpha */
+static void check_blend_row(void (*func)(uint8_t *dst, const uint8_t *src,
+                                         const uint8_t *alpha, int w),
+                            const char *name, int transparent)
+{
+    LOCAL_ALIGNED_32(uint8_t, src,   [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t, alpha, [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t, dst0,  [WIDTH]);
+    LOCAL_ALIGNED_32(uint8_t, dst1,  [WIDTH]);
+    int i;
+
+    declare_func(void, uint8_t *dst, const uint8_t *src,
+                 const uint8_t *alpha, int w);
+
+    if (check_func(func, "%s", name)) {
+        for (i = 0; i < WIDTH; i++) {
+            src[i]   = rnd();
+            alpha[i] = random_alpha(i);
+            dst0[i]  = dst1[i] = rnd();
+            if (!alpha[i] && transparent >= 0)
+                src[i] = transparent;
+        }
+
+        call_ref(dst0, src, alpha, WIDTH);
+        call_new(dst1, src, alpha, WIDTH);
+        if (memcmp(dst0, dst1, WIDTH))
+            fail();
+        bench_new(dst1, src, alpha, WIDTH);
+    }
+}
+
+static void check_blend_rgba(void (*func)(uint8_t *dst, const uint8_t *src,
+                                          int w),
+                             const char *name, int premult)
+{
+    LOCAL_ALIGNED_32(uint8_t, src,  [WIDTH * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [WIDTH * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [WIDTH * 4]);
+    int i;
+
+    declare_func(void, uint8_t *dst, const uint8_t *src, int w);
+
+    if (check_func(func, "%s", name)) {
+        for (i = 0; i < WIDTH * 4; i++) {
+            src[i]  = (i & 3) == 3 ? random_alpha(i / 4) : rnd();
+            dst0[i] = dst1[i] = rnd();
+        }
+        if (premult)
+            for (i = 0; i < WIDTH; i++)
+                if (!src[4 * i + 3])
+                    AV_WN32A(src + 4 * i, 0);
+
+        call_ref(dst0, src, WIDTH);
+        call_new(dst1, src, WIDTH);
+        if (memcmp(dst0, dst1, WIDTH * 4))
+            fail();
+        bench_new(dst1, src, WIDTH);
+    }
+}
+
+void checkasm_check_vf_overlay(void)
+{
+    OverlayDSPContext dsp;
+
+    ff_overlay_init(&dsp);
+
+    check_blend_row(dsp.blend_row, "blend_row", -1);
+    check_blend_row(dsp.blend_row_premult, "blend_row_premult", 0);
+    check_blend_row(dsp.blend_row_premult_chroma, "blend_row_premult_chroma", 128);
+    report("blend_row");
+
+    check_blend_rgba(dsp.blend_rgba, "blend_rgba", 0);
+    check_blend_rgba(dsp.blend_rgba_premult, "blend_rgba_premult", 1);
+    report("blend_rgba");
+}
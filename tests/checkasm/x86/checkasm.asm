@@ -223,15 +223,17 @@ cglobal checked_call%1, 1,7
     jz .clobber_ok
     report_fail error_message
 .clobber_ok:
-%ifnid %1, _emms
+%ifidn %1, _emms
+    emms
+%elifnidn %1, _float
+    ; the x87 tag word must show all registers empty, the _float variant
+    ; skips this check since its return value is left on the x87 stack
     fstenv [esp]
     cmp  word [esp + 8], 0xffff
     je   .emms_ok
     report_fail error_message_emms
     emms
 .emms_ok:
-%else
-    emms
 %endif
     add  esp, max_args*4
     REP_RET
@@ -241,3 +243,6 @@ cglobal checked_call%1, 1,7
 
 CHECKED_CALL
 CHECKED_CALL _emms
+%if ARCH_X86_32
+CHECKED_CALL _float
+%endif
@@ -1,7 +1,12 @@
-FATE_CHECKASM = fate-checkasm-audiodsp                                  \
+FATE_CHECKASM = fate-checkasm-aacencdsp                                 \
+                fate-checkasm-aacpsdsp                                  \
+                fate-checkasm-ac3dsp                                    \
+                fate-checkasm-audiodsp                                  \
                 fate-checkasm-blockdsp                                  \
                 fate-checkasm-bswapdsp                                  \
                 fate-checkasm-dcadsp                                    \
+                fate-checkasm-ffv1dsp                                   \
+                fate-checkasm-float_dsp                                 \
                 fate-checkasm-fmtconvert                                \
                 fate-checkasm-h264dsp                                   \
                 fate-checkasm-h264pred                                  \
@@ -9,9 +14,20 @@ FATE_CHECKASM = fate-checkasm-audiodsp                                  \
                 fate-checkasm-hevc_add_res                              \
                 fate-checkasm-hevc_idct                                 \
                 fate-checkasm-hevc_mc                                   \
+                fate-checkasm-hpeldsp                                   \
                 fate-checkasm-huffyuvdsp                                \
+                fate-checkasm-idctdsp                                   \
+                fate-checkasm-jpeg2000dsp                               \
+                fate-checkasm-me_cmp                                    \
+                fate-checkasm-opusdsp                                   \
+                fate-checkasm-qpeldsp                                   \
+                fate-checkasm-rv40dsp                                   \
+                fate-checkasm-sbrdsp                                    \
+                fate-checkasm-sw_rgb2rgb                                \
+                fate-checkasm-sw_scale                                  \
                 fate-checkasm-synth_filter                              \
                 fate-checkasm-v210enc                                   \
+                fate-checkasm-vf_overlay                                \
                 fate-checkasm-vp8dsp                                    \
                 fate-checkasm-vp9dsp                                    \
 
@@ -106,6 +106,9 @@ fate-filter-scale200: CMD = video_filter "scale=w=200:h=200"
 FATE_FILTER_VSYNTH-$(CONFIG_SCALE_FILTER) += fate-filter-scale500
 fate-filter-scale500: CMD = video_filter "scale=w=500:h=500"
 
+FATE_FILTER_VSYNTH-$(call ALLYES, SPLIT_FILTER SCALE_FILTER OVERLAY_FILTER) += fate-filter-split_scale
+fate-filter-split_scale: CMD = video_filter "split[a][b];[a]scale=w=200:h=200[c];[b]scale=w=200:h=100[d];[c][d]overlay=0:50"
+
 FATE_FILTER_VSYNTH-$(CONFIG_VFLIP_FILTER) += fate-filter-vflip
 fate-filter-vflip: CMD = video_filter "vflip"
 
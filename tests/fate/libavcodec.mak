@@ -1,3 +1,8 @@
+FATE_LIBAVCODEC-yes += fate-decode-batch
+fate-decode-batch: libavcodec/tests/decode_batch$(EXESUF)
+fate-decode-batch: CMD = run libavcodec/tests/decode_batch
+fate-decode-batch: CMP = null
+
 FATE_LIBAVCODEC-$(CONFIG_GOLOMB) += fate-golomb
 fate-golomb: libavcodec/tests/golomb$(EXESUF)
 fate-golomb: CMD = run libavcodec/tests/golomb
@@ -17,6 +22,11 @@ fate-mpeg12framerate: libavcodec/tests/mpeg12framerate$(EXESUF)
 fate-mpeg12framerate: CMD = run libavcodec/tests/mpeg12framerate
 fate-mpeg12framerate: CMP = null
 
+FATE_LIBAVCODEC-$(call ALLYES, FFV1_ENCODER FFV1_DECODER) += fate-prof
+fate-prof: libavcodec/tests/prof$(EXESUF)
+fate-prof: CMD = run libavcodec/tests/prof
+fate-prof: CMP = null
+
 FATE_LIBAVCODEC-$(CONFIG_RANGECODER) += fate-rangecoder
 fate-rangecoder: libavcodec/tests/rangecoder$(EXESUF)
 fate-rangecoder: CMD = run libavcodec/tests/rangecoder
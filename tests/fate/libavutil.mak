@@ -52,6 +52,11 @@ fate-float-dsp: libavutil/tests/float_dsp$(EXESUF)
 fate-float-dsp: CMD = run libavutil/tests/float_dsp
 fate-float-dsp: CMP = null
 
+FATE_LIBAVUTIL += fate-frame
+fate-frame: libavutil/tests/frame$(EXESUF)
+fate-frame: CMD = run libavutil/tests/frame
+fate-frame: CMP = null
+
 FATE_LIBAVUTIL += fate-hmac
 fate-hmac: libavutil/tests/hmac$(EXESUF)
 fate-hmac: CMD = run libavutil/tests/hmac
@@ -0,0 +1,12 @@
+FATE_LIBSWSCALE += fate-sws-filter-cache
+fate-sws-filter-cache: libswscale/tests/filter_cache$(EXESUF)
+fate-sws-filter-cache: CMD = run libswscale/tests/filter_cache
+fate-sws-filter-cache: CMP = null
+
+FATE_LIBSWSCALE += fate-sws-scale-multi
+fate-sws-scale-multi: libswscale/tests/scale_multi$(EXESUF)
+fate-sws-scale-multi: CMD = run libswscale/tests/scale_multi
+fate-sws-scale-multi: CMP = null
+
+FATE-$(CONFIG_SWSCALE) += $(FATE_LIBSWSCALE)
+fate-libswscale: $(FATE_LIBSWSCALE)
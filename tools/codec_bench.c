@@ -0,0 +1,914 @@
+/*
+ * This file is part of Libav.
+ *
+ * Libav is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * Libav is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with Libav; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Measure the encoding or decoding throughput of a single codec.
+ *
+ * The raw input (e.g. the output of tests/videogen or tests/audiogen) is
+ * loaded into memory and split into frames before any timing starts. In
+ * decode mode it is also encoded once up front, so only the
+ * avcodec_send_*() and avcodec_receive_*() calls are timed. Every
+ * combination of the given thread counts and thread types is run and
+ * the results are printed as JSON.
+ *
+ * The latency of an input is the time from its avcodec_send_*() call to
+ * the return of the output with the same timestamp, inputs without a
+ * matching output are not counted. peak_rss_delta is how much the peak
+ * resident set size of the process grew above its resident set size at the
+ * start of a configuration. The peak is reset through /proc/self/clear_refs
+ * before each configuration, so it is only reported on Linux.
+ *
+ * Video encoders without yuv420p support get the input converted to their
+ * pixel format with libswscale, before any timing starts.
+ */
+
+#include "config.h"
+#if HAVE_UNISTD_H
+#include <unistd.h>             /* getopt */
+#endif
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/channel_layout.h"
+#include "libavutil/common.h"
+#include "libavutil/dict.h"
+#include "libavutil/error.h"
+#include "libavutil/frame.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/mem.h"
+#include "libavutil/parseutils.h"
+#include "libavutil/pixdesc.h"
+#include "libavutil/samplefmt.h"
+#include "libavutil/time.h"
+
+#include "libavcodec/avcodec.h"
+
+#if CONFIG_SWSCALE
+#include "libswscale/swscale.h"
+#endif
+
+#if !HAVE_GETOPT
+#include "compat/getopt.c"
+#endif
+
+#define MAX_RUNS 32
+
+typedef struct BenchContext {
+    const AVCodec *enc;
+    const AVCodec *dec;
+    AVDictionary *enc_opts;
+    int decode;
+
+    /* raw input */
+    uint8_t *raw;
+    size_t raw_size;
+    int width, height;
+    int sample_rate, channels;
+    int max_frames;
+
+    AVFrame **frames;
+    int nb_frames;
+    AVPacket **pkts;
+    int nb_pkts;
+    AVCodecParameters *par;
+
+    /* send time of each input of the current loop, -1 once matched */
+    int64_t *sent;
+    int nb_sent;
+    int first_pending;
+
+    int64_t *latency;
+    int nb_latency;
+} BenchContext;
+
+typedef struct BenchResult {
+    int threads;
+    int thread_type;
+    int active_thread_type;
+    int frames;
+    int latency_outputs;
+    int64_t total;
+    int64_t p50, p90, p99, max;
+    int64_t peak_rss_delta;
+} BenchResult;
+
+static void usage(void)
+{
+    printf("Measure the encoding or decoding throughput of a codec.\n");
+    printf("Usage: codec_bench [OPTIONS] encode|decode ENCODER INPUT\n");
+    printf("\n"
+           "INPUT is raw yuv420p video as written by tests/videogen, or raw\n"
+           "interleaved s16 audio as written by tests/audiogen with -a.\n"
+           "Video is converted to the encoder pixel format if needed.\n"
+           "In decode mode the packets are produced with ENCODER and decoded\n"
+           "with the default decoder for the same codec.\n"
+           "\n"
+           "Options:\n"
+           "-a               the input is audio\n"
+           "-s WxH           video size (default 352x288)\n"
+           "-r RATE          audio sample rate (default 44100)\n"
+           "-c CHANNELS      audio channels (default 2)\n"
+           "-n FRAMES        use at most FRAMES frames of the input\n"
+           "-t COUNTS        comma separated thread counts (default 1,2,4)\n"
+           "-m TYPES         comma separated thread types among frame and slice\n"
+           "                 (default frame,slice)\n"
+           "-l LOOPS         number of timed runs per configuration (default 3)\n"
+           "-o OPTIONS       encoder options, as key=value pairs separated by :\n"
+           "-h               print this help\n");
+}
+
+static void print_error(const char *msg, int err)
+{
+    char buf[128];
+
+    av_strerror(err, buf, sizeof(buf));
+    fprintf(stderr, "%s: %s\n", msg, buf);
+}
+
+/* Reset the peak resident set size of the process to the current one. */
+static int reset_peak_rss(void)
+{
+    FILE *f = fopen("/proc/self/clear_refs", "w");
+    int err;
+
+    if (!f)
+        return AVERROR(errno);
+    err = fputs("5", f) < 0;
+    /* kernels without support for 5 only fail when the write is flushed */
+    err |= fclose(f);
+    return err ? AVERROR(EIO) : 0;
+}
+
+/* Read a size field such as VmRSS from /proc/self/status, in bytes. */
+static int64_t read_status_size(const char *field)
+{
+    FILE *f = fopen("/proc/self/status", "r");
+    size_t len = strlen(field);
+    int64_t size = -1;
+    char line[256];
+
+    if (!f)
+        return -1;
+    while (fgets(line, sizeof(line), f)) {
+        if (!strncmp(line, field, len) && line[len] == ':') {
+            size = strtoll(line + len + 1, NULL, 10) * 1024;
+            break;
+        }
+    }
+    fclose(f);
+    return size;
+}
+
+static const char *thread_type_name(int type)
+{
+    switch (type) {
+    case FF_THREAD_FRAME: return "frame";
+    case FF_THREAD_SLICE: return "slice";
+    default:              return "none";
+    }
+}
+
+static int load_file(BenchContext *bc, const char *filename)
+{
+    FILE *f = fopen(filename, "rb");
+    long size;
+
+    if (!f) {
+        perror(filename);
+        return AVERROR(errno);
+    }
+    if (fseek(f, 0, SEEK_END) < 0 || (size = ftell(f)) <= 0 ||
+        fseek(f, 0, SEEK_SET) < 0) {
+        fprintf(stderr, "%s: cannot get the file size\n", filename);
+        fclose(f);
+        return AVERROR(EINVAL);
+    }
+
+    bc->raw = av_malloc(size);
+    if (!bc->raw) {
+        fclose(f);
+        return AVERROR(ENOMEM);
+    }
+    bc->raw_size = fread(bc->raw, 1, size, f);
+    fclose(f);
+
+    if (bc->raw_size != size) {
+        fprintf(stderr, "%s: short read\n", filename);
+        return AVERROR(EIO);
+    }
+    return 0;
+}
+
+static int add_frame(BenchContext *bc, AVFrame *frame)
+{
+    AVFrame **frames = av_realloc_array(bc->frames, bc->nb_frames + 1,
+                                        sizeof(*frames));
+    if (!frames)
+        return AVERROR(ENOMEM);
+    bc->frames = frames;
+    bc->frames[bc->nb_frames++] = frame;
+    return 0;
+}
+
+static int add_packet(BenchContext *bc, AVPacket *pkt)
+{
+    AVPacket **pkts = av_realloc_array(bc->pkts, bc->nb_pkts + 1,
+                                       sizeof(*pkts));
+    if (!pkts)
+        return AVERROR(ENOMEM);
+    bc->pkts = pkts;
+    bc->pkts[bc->nb_pkts++] = pkt;
+    return 0;
+}
+
+static int init_encoder(BenchContext *bc, AVCodecContext *ctx)
+{
+    const AVCodec *codec = bc->enc;
+    int i;
+
+    if (codec->type == AVMEDIA_TYPE_VIDEO) {
+        /* the yuvj formats have the same layout as the videogen output */
+        ctx->pix_fmt = AV_PIX_FMT_NONE;
+        for (i = 0; codec->pix_fmts && codec->pix_fmts[i] != AV_PIX_FMT_NONE; i++) {
+            if (codec->pix_fmts[i] == AV_PIX_FMT_YUV420P ||
+                codec->pix_fmts[i] == AV_PIX_FMT_YUVJ420P) {
+                ctx->pix_fmt = codec->pix_fmts[i];
+                break;
+            }
+        }
+        if (!codec->pix_fmts)
+            ctx->pix_fmt = AV_PIX_FMT_YUV420P;
+#if CONFIG_SWSCALE
+        if (ctx->pix_fmt == AV_PIX_FMT_NONE)
+            ctx->pix_fmt = avcodec_find_best_pix_fmt2((enum AVPixelFormat *)codec->pix_fmts,
+                                                      AV_PIX_FMT_YUV420P, 0, NULL);
+#endif
+        if (ctx->pix_fmt == AV_PIX_FMT_NONE) {
+            fprintf(stderr, "%s does not support yuv420p\n", codec->name);
+            return AVERROR(ENOSYS);
+        }
+        ctx->width     = bc->width;
+        ctx->height    = bc->height;
+        ctx->time_base = (AVRational){ 1, 25 };
+    } else if (codec->type == AVMEDIA_TYPE_AUDIO) {
+        ctx->sample_fmt = AV_SAMPLE_FMT_NONE;
+        for (i = 0; codec->sample_fmts && codec->sample_fmts[i] != AV_SAMPLE_FMT_NONE; i++) {
+            enum AVSampleFormat fmt = av_get_packed_sample_fmt(codec->sample_fmts[i]);
+            if (fmt == AV_SAMPLE_FMT_S16 || fmt == AV_SAMPLE_FMT_S32 ||
+                fmt == AV_SAMPLE_FMT_FLT || fmt == AV_SAMPLE_FMT_DBL) {
+                ctx->sample_fmt = codec->sample_fmts[i];
+                break;
+            }
+        }
+        if (!codec->sample_fmts)
+            ctx->sample_fmt = AV_SAMPLE_FMT_S16;
+        if (ctx->sample_fmt == AV_SAMPLE_FMT_NONE) {
+            fprintf(stderr, "%s has no usable sample format\n", codec->name);
+            return AVERROR(ENOSYS);
+        }
+        ctx->sample_rate    = bc->sample_rate;
+        ctx->channels       = bc->channels;
+        ctx->channel_layout = av_get_default_channel_layout(bc->channels);
+        ctx->time_base      = (AVRational){ 1, bc->sample_rate };
+    } else {
+        fprintf(stderr, "%s is not an audio or video encoder\n", codec->name);
+        return AVERROR(EINVAL);
+    }
+    return 0;
+}
+
+static int open_encoder(BenchContext *bc, AVCodecContext **pctx,
+                        int threads, int thread_type)
+{
+    AVDictionary *opts = NULL;
+    AVCodecContext *ctx;
+    int ret;
+
+    ctx = avcodec_alloc_context3(bc->enc);
+    if (!ctx)
+        return AVERROR(ENOMEM);
+    *pctx = ctx;
+
+    ret = init_encoder(bc, ctx);
+    if (ret < 0)
+        return ret;
+    ctx->thread_count = threads;
+    ctx->thread_type  = thread_type;
+
+    av_dict_copy(&opts, bc->enc_opts, 0);
+    ret = avcodec_open2(ctx, bc->enc, &opts);
+    av_dict_free(&opts);
+    if (ret < 0)
+        print_error("Cannot open the encoder", ret);
+    return ret;
+}
+
+static void convert_samples(AVFrame *frame, const int16_t *src)
+{
+    enum AVSampleFormat fmt = av_get_packed_sample_fmt(frame->format);
+    int planar = av_sample_fmt_is_planar(frame->format);
+    int channels = av_get_channel_layout_nb_channels(frame->channel_layout);
+    int i, ch;
+
+    for (i = 0; i < frame->nb_samples; i++) {
+        for (ch = 0; ch < channels; ch++) {
+            int v     = src[i * channels + ch];
+            int plane = planar ? ch : 0;
+            int idx   = planar ? i  : i * channels + ch;
+
+            switch (fmt) {
+            case AV_SAMPLE_FMT_S16:
+                ((int16_t *)frame->extended_data[plane])[idx] = v;
+                break;
+            case AV_SAMPLE_FMT_S32:
+                ((int32_t *)frame->extended_data[plane])[idx] = v * (1 << 16);
+                break;
+            case AV_SAMPLE_FMT_FLT:
+                ((float *)frame->extended_data[plane])[idx] = v / 32768.0f;
+                break;
+            case AV_SAMPLE_FMT_DBL:
+                ((double *)frame->extended_data[plane])[idx] = v / 32768.0;
+                break;
+            }
+        }
+    }
+}
+
+static int split_frames(BenchContext *bc, const AVCodecContext *ctx)
+{
+#if CONFIG_SWSCALE
+    struct SwsContext *sws = NULL;
+#endif
+    size_t frame_size, pos;
+    int convert = 0, ret = 0;
+
+    if (ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+        frame_size = av_image_get_buffer_size(AV_PIX_FMT_YUV420P,
+                                              bc->width, bc->height, 1);
+        convert = ctx->pix_fmt != AV_PIX_FMT_YUV420P &&
+                  ctx->pix_fmt != AV_PIX_FMT_YUVJ420P;
+#if CONFIG_SWSCALE
+        if (convert) {
+            sws = sws_getContext(bc->width, bc->height, AV_PIX_FMT_YUV420P,
+                                 ctx->width, ctx->height, ctx->pix_fmt,
+                                 SWS_BICUBIC, NULL, NULL, NULL);
+            if (!sws) {
+                fprintf(stderr, "Cannot convert yuv420p to %s\n",
+                        av_get_pix_fmt_name(ctx->pix_fmt));
+                return AVERROR(EINVAL);
+            }
+        }
+#endif
+    } else {
+        int nb_samples = ctx->frame_size;
+        if (!nb_samples)
+            nb_samples = 1024;
+        frame_size = (size_t)nb_samples * bc->channels * 2;
+    }
+
+    for (pos = 0; pos + frame_size <= bc->raw_size; pos += frame_size) {
+        AVFrame *frame;
+
+        if (bc->max_frames && bc->nb_frames >= bc->max_frames)
+            break;
+
+        frame = av_frame_alloc();
+        if (!frame) {
+            ret = AVERROR(ENOMEM);
+            goto end;
+        }
+        if (ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+            frame->format = ctx->pix_fmt;
+            frame->width  = ctx->width;
+            frame->height = ctx->height;
+        } else {
+            frame->format         = ctx->sample_fmt;
+            frame->nb_samples     = frame_size / (bc->channels * 2);
+            frame->channel_layout = ctx->channel_layout;
+            frame->sample_rate    = ctx->sample_rate;
+        }
+        ret = av_frame_get_buffer(frame, 32);
+        if (ret < 0) {
+            av_frame_free(&frame);
+            goto end;
+        }
+
+        if (ctx->codec_type == AVMEDIA_TYPE_VIDEO) {
+            uint8_t *src[4];
+            int src_linesize[4];
+
+            av_image_fill_arrays(src, src_linesize, bc->raw + pos,
+                                 AV_PIX_FMT_YUV420P, bc->width, bc->height, 1);
+#if CONFIG_SWSCALE
+            if (convert)
+                sws_scale(sws, (const uint8_t * const *)src, src_linesize,
+                          0, bc->height, frame->data, frame->linesize);
+            else
+#endif
+            av_image_copy(frame->data, frame->linesize,
+                          (const uint8_t **)src, src_linesize,
+                          AV_PIX_FMT_YUV420P, bc->width, bc->height);
+            frame->pts = bc->nb_frames;
+        } else {
+            convert_samples(frame, (const int16_t *)(bc->raw + pos));
+            frame->pts = (int64_t)bc->nb_frames * frame->nb_samples;
+        }
+
+        ret = add_frame(bc, frame);
+        if (ret < 0) {
+            av_frame_free(&frame);
+            goto end;
+        }
+    }
+
+    if (!bc->nb_frames) {
+        fprintf(stderr, "The input does not contain a full frame\n");
+        ret = AVERROR(EINVAL);
+    }
+end:
+#if CONFIG_SWSCALE
+    sws_freeContext(sws);
+#endif
+    return ret;
+}
+
+static int64_t input_pts(const BenchContext *bc, int idx)
+{
+    return bc->decode ? bc->pkts[idx]->pts : bc->frames[idx]->pts;
+}
+
+/* Match an output to the oldest pending input with the same timestamp. */
+static void record_output(BenchContext *bc, int64_t pts)
+{
+    int64_t now = av_gettime_relative();
+    int i;
+
+    if (pts == AV_NOPTS_VALUE)
+        return;
+
+    for (i = bc->first_pending; i < bc->nb_sent; i++) {
+        if (bc->sent[i] >= 0 && input_pts(bc, i) == pts) {
+            bc->latency[bc->nb_latency++] = now - bc->sent[i];
+            bc->sent[i] = -1;
+            break;
+        }
+    }
+    while (bc->first_pending < bc->nb_sent && bc->sent[bc->first_pending] < 0)
+        bc->first_pending++;
+}
+
+static int receive_packets(BenchContext *bc, AVCodecContext *ctx, AVPacket *pkt,
+                           int keep)
+{
+    int ret;
+
+    while ((ret = avcodec_receive_packet(ctx, pkt)) >= 0) {
+        /* the audio encoders shift the timestamps by their delay */
+        if (!keep && pkt->pts != AV_NOPTS_VALUE)
+            record_output(bc, pkt->pts + ctx->initial_padding);
+        if (keep) {
+            AVPacket *p = av_packet_alloc();
+            if (!p)
+                return AVERROR(ENOMEM);
+            av_packet_move_ref(p, pkt);
+            ret = add_packet(bc, p);
+            if (ret < 0) {
+                av_packet_free(&p);
+                return ret;
+            }
+        } else {
+            av_packet_unref(pkt);
+        }
+    }
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF ? 0 : ret;
+}
+
+/* Split the input into frames and, in decode mode, encode it once. */
+static int prepare_input(BenchContext *bc)
+{
+    AVCodecContext *ctx = NULL;
+    AVPacket *pkt = NULL;
+    int i, ret;
+
+    ret = open_encoder(bc, &ctx, 1, 0);
+    if (ret < 0)
+        goto end;
+    ret = split_frames(bc, ctx);
+    if (ret < 0 || !bc->decode)
+        goto end;
+
+    pkt = av_packet_alloc();
+    bc->par = avcodec_parameters_alloc();
+    if (!pkt || !bc->par) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    for (i = 0; i <= bc->nb_frames; i++) {
+        ret = avcodec_send_frame(ctx, i < bc->nb_frames ? bc->frames[i] : NULL);
+        if (ret < 0) {
+            print_error("Error encoding the input", ret);
+            goto end;
+        }
+        ret = receive_packets(bc, ctx, pkt, 1);
+        if (ret < 0)
+            goto end;
+    }
+
+    ret = avcodec_parameters_from_context(bc->par, ctx);
+end:
+    av_packet_free(&pkt);
+    avcodec_free_context(&ctx);
+    return ret;
+}
+
+static int open_decoder(BenchContext *bc, AVCodecContext **pctx,
+                        int threads, int thread_type)
+{
+    AVCodecContext *ctx;
+    int ret;
+
+    ctx = avcodec_alloc_context3(bc->dec);
+    if (!ctx)
+        return AVERROR(ENOMEM);
+    *pctx = ctx;
+
+    ret = avcodec_parameters_to_context(ctx, bc->par);
+    if (ret < 0)
+        return ret;
+    ctx->thread_count = threads;
+    ctx->thread_type  = thread_type;
+
+    ret = avcodec_open2(ctx, bc->dec, NULL);
+    if (ret < 0)
+        print_error("Cannot open the decoder", ret);
+    return ret;
+}
+
+static int run_encode(BenchContext *bc, AVCodecContext *ctx, int *nb_frames)
+{
+    AVPacket *pkt = av_packet_alloc();
+    int i, ret = 0;
+
+    if (!pkt)
+        return AVERROR(ENOMEM);
+
+    for (i = 0; i < bc->nb_frames; i++) {
+        bc->sent[bc->nb_sent++] = av_gettime_relative();
+        ret = avcodec_send_frame(ctx, bc->frames[i]);
+        if (ret >= 0)
+            ret = receive_packets(bc, ctx, pkt, 0);
+        if (ret < 0)
+            goto end;
+    }
+
+    ret = avcodec_send_frame(ctx, NULL);
+    if (ret >= 0)
+        ret = receive_packets(bc, ctx, pkt, 0);
+    *nb_frames += bc->nb_frames;
+end:
+    if (ret < 0)
+        print_error("Error encoding", ret);
+    av_packet_free(&pkt);
+    return ret;
+}
+
+static int receive_frames(BenchContext *bc, AVCodecContext *ctx, AVFrame *frame,
+                          int *nb_frames)
+{
+    int ret;
+
+    while ((ret = avcodec_receive_frame(ctx, frame)) >= 0) {
+        record_output(bc, frame->pts);
+        av_frame_unref(frame);
+        (*nb_frames)++;
+    }
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF ? 0 : ret;
+}
+
+static int run_decode(BenchContext *bc, AVCodecContext *ctx, int *nb_frames)
+{
+    AVFrame *frame = av_frame_alloc();
+    int i, ret = 0;
+
+    if (!frame)
+        return AVERROR(ENOMEM);
+
+    for (i = 0; i < bc->nb_pkts; i++) {
+        bc->sent[bc->nb_sent++] = av_gettime_relative();
+        ret = avcodec_send_packet(ctx, bc->pkts[i]);
+        if (ret >= 0)
+            ret = receive_frames(bc, ctx, frame, nb_frames);
+        if (ret < 0)
+            goto end;
+    }
+
+    ret = avcodec_send_packet(ctx, NULL);
+    if (ret >= 0)
+        ret = receive_frames(bc, ctx, frame, nb_frames);
+end:
+    if (ret < 0)
+        print_error("Error decoding", ret);
+    av_frame_free(&frame);
+    return ret;
+}
+
+static int cmp_int64(const void *a, const void *b)
+{
+    int64_t va = *(const int64_t *)a, vb = *(const int64_t *)b;
+    return (va > vb) - (va < vb);
+}
+
+static int64_t percentile(const int64_t *sorted, int nb, int p)
+{
+    return sorted[(int64_t)(nb - 1) * p / 100];
+}
+
+/* Each loop uses a new codec context, only the send/receive calls and the
+ * final flush are timed. */
+static int run_config(BenchContext *bc, BenchResult *res, int loops)
+{
+    int per_loop = bc->decode ? bc->nb_pkts : bc->nb_frames;
+    int64_t rss_start = -1, rss_peak;
+    int i, ret = 0;
+
+    if (!per_loop) {
+        fprintf(stderr, "Nothing to %s\n", bc->decode ? "decode" : "encode");
+        return AVERROR(EINVAL);
+    }
+
+    bc->nb_latency = 0;
+    av_freep(&bc->latency);
+    bc->latency = av_malloc_array(per_loop * loops, sizeof(*bc->latency));
+    if (!bc->latency)
+        return AVERROR(ENOMEM);
+    av_freep(&bc->sent);
+    bc->sent = av_malloc_array(per_loop, sizeof(*bc->sent));
+    if (!bc->sent)
+        return AVERROR(ENOMEM);
+
+    if (reset_peak_rss() >= 0)
+        rss_start = read_status_size("VmRSS");
+
+    for (i = 0; i < loops; i++) {
+        AVCodecContext *ctx = NULL;
+        int64_t start;
+
+        bc->nb_sent       = 0;
+        bc->first_pending = 0;
+
+        ret = bc->decode ? open_decoder(bc, &ctx, res->threads, res->thread_type) :
+                           open_encoder(bc, &ctx, res->threads, res->thread_type);
+        if (ret < 0) {
+            avcodec_free_context(&ctx);
+            return ret;
+        }
+        res->active_thread_type = ctx->active_thread_type;
+
+        start = av_gettime_relative();
+        ret = bc->decode ? run_decode(bc, ctx, &res->frames) :
+                           run_encode(bc, ctx, &res->frames);
+        res->total += av_gettime_relative() - start;
+
+        avcodec_free_context(&ctx);
+        if (ret < 0)
+            return ret;
+    }
+
+    res->latency_outputs = bc->nb_latency;
+    if (bc->nb_latency) {
+        qsort(bc->latency, bc->nb_latency, sizeof(*bc->latency), cmp_int64);
+        res->p50 = percentile(bc->latency, bc->nb_latency, 50);
+        res->p90 = percentile(bc->latency, bc->nb_latency, 90);
+        res->p99 = percentile(bc->latency, bc->nb_latency, 99);
+        res->max = bc->latency[bc->nb_latency - 1];
+    }
+    rss_peak = read_status_size("VmHWM");
+    res->peak_rss_delta = rss_start >= 0 && rss_peak >= 0 ? rss_peak - rss_start : -1;
+    return 0;
+}
+
+static void print_results(const BenchContext *bc, const BenchResult *res,
+                          int nb_res, int loops)
+{
+    int i;
+
+    printf("{\n");
+    printf("    \"codec\": \"%s\",\n", bc->decode ? bc->dec->name : bc->enc->name);
+    printf("    \"mode\": \"%s\",\n", bc->decode ? "decode" : "encode");
+    printf("    \"media_type\": \"%s\",\n",
+           bc->enc->type == AVMEDIA_TYPE_VIDEO ? "video" : "audio");
+    printf("    \"input_frames\": %d,\n", bc->nb_frames);
+    if (bc->decode)
+        printf("    \"input_packets\": %d,\n", bc->nb_pkts);
+    printf("    \"loops\": %d,\n", loops);
+    printf("    \"runs\": [\n");
+    for (i = 0; i < nb_res; i++) {
+        const BenchResult *r = &res[i];
+        double seconds = r->total / 1000000.0;
+
+        printf("        {\n");
+        printf("            \"threads\": %d,\n", r->threads);
+        printf("            \"thread_type\": \"%s\",\n", thread_type_name(r->thread_type));
+        printf("            \"active_thread_type\": \"%s\",\n",
+               thread_type_name(r->active_thread_type));
+        printf("            \"frames\": %d,\n", r->frames);
+        printf("            \"time_us\": %"PRId64",\n", r->total);
+        printf("            \"fps\": %.2f,\n", seconds > 0 ? r->frames / seconds : 0.0);
+        printf("            \"latency_outputs\": %d,\n", r->latency_outputs);
+        printf("            \"latency_us\": { \"p50\": %"PRId64", \"p90\": %"PRId64
+               ", \"p99\": %"PRId64", \"max\": %"PRId64" },\n",
+               r->p50, r->p90, r->p99, r->max);
+        if (r->peak_rss_delta >= 0)
+            printf("            \"peak_rss_delta\": %"PRId64"\n", r->peak_rss_delta);
+        else
+            printf("            \"peak_rss_delta\": null\n");
+        printf("        }%s\n", i < nb_res - 1 ? "," : "");
+    }
+    printf("    ]\n");
+    printf("}\n");
+}
+
+static int parse_list(const char *str, int *list, int max, int types)
+{
+    const char *p = str;
+    int nb = 0;
+
+    while (*p && nb < max) {
+        const char *end = strchr(p, ',');
+        int len = end ? end - p : strlen(p);
+        char *tail;
+        int v = -1;
+
+        if (types) {
+            if (len == 5 && !strncmp(p, "frame", 5))
+                v = FF_THREAD_FRAME;
+            else if (len == 5 && !strncmp(p, "slice", 5))
+                v = FF_THREAD_SLICE;
+        } else {
+            v = strtol(p, &tail, 10);
+            if (tail != p + len || v < 1)
+                v = -1;
+        }
+        if (v < 0) {
+            fprintf(stderr, "Invalid list entry '%.*s'\n", len, p);
+            return AVERROR(EINVAL);
+        }
+        list[nb++] = v;
+        p += len + !!end;
+    }
+    return nb;
+}
+
+int main(int argc, char **argv)
+{
+    BenchContext bc = { 0 };
+    BenchResult res[MAX_RUNS] = { { 0 } };
+    int threads[MAX_RUNS], types[MAX_RUNS];
+    int nb_threads, nb_types, nb_res = 0;
+    const char *thread_list = "1,2,4", *type_list = "frame,slice";
+    int audio = 0, loops = 3;
+    int c, i, j, ret;
+
+    bc.width       = 352;
+    bc.height      = 288;
+    bc.sample_rate = 44100;
+    bc.channels    = 2;
+
+    while ((c = getopt(argc, argv, "as:r:c:n:t:m:l:o:h")) != -1) {
+        switch (c) {
+        case 'a':
+            audio = 1;
+            break;
+        case 's':
+            if (av_parse_video_size(&bc.width, &bc.height, optarg) < 0) {
+                fprintf(stderr, "Invalid video size '%s'\n", optarg);
+                return 1;
+            }
+            break;
+        case 'r':
+            bc.sample_rate = atoi(optarg);
+            break;
+        case 'c':
+            bc.channels = atoi(optarg);
+            break;
+        case 'n':
+            bc.max_frames = atoi(optarg);
+            break;
+        case 't':
+            thread_list = optarg;
+            break;
+        case 'm':
+            type_list = optarg;
+            break;
+        case 'l':
+            loops = atoi(optarg);
+            break;
+        case 'o':
+            if (av_dict_parse_string(&bc.enc_opts, optarg, "=", ":", 0) < 0) {
+                fprintf(stderr, "Invalid encoder options '%s'\n", optarg);
+                return 1;
+            }
+            break;
+        case 'h':
+            usage();
+            return 0;
+        case '?':
+            return 1;
+        }
+    }
+
+    if (argc - optind != 3) {
+        usage();
+        return 1;
+    }
+    if (bc.sample_rate <= 0 || bc.channels <= 0 || loops <= 0) {
+        fprintf(stderr, "Invalid sample rate, channel count or loop count\n");
+        return 1;
+    }
+
+    if (!strcmp(argv[optind], "decode"))
+        bc.decode = 1;
+    else if (strcmp(argv[optind], "encode")) {
+        fprintf(stderr, "Unknown mode '%s'\n", argv[optind]);
+        return 1;
+    }
+
+    nb_threads = parse_list(thread_list, threads, MAX_RUNS, 0);
+    nb_types   = parse_list(type_list, types, MAX_RUNS, 1);
+    if (nb_threads <= 0 || nb_types <= 0)
+        return 1;
+
+    avcodec_register_all();
+
+    bc.enc = avcodec_find_encoder_by_name(argv[optind + 1]);
+    if (!bc.enc) {
+        fprintf(stderr, "Unknown encoder '%s'\n", argv[optind + 1]);
+        return 1;
+    }
+    if (bc.enc->type != (audio ? AVMEDIA_TYPE_AUDIO : AVMEDIA_TYPE_VIDEO)) {
+        fprintf(stderr, "%s is not %s encoder\n", bc.enc->name,
+                audio ? "an audio" : "a video");
+        return 1;
+    }
+    if (bc.decode) {
+        bc.dec = avcodec_find_decoder(bc.enc->id);
+        if (!bc.dec) {
+            fprintf(stderr, "No decoder for %s\n", bc.enc->name);
+            return 1;
+        }
+    }
+
+    ret = load_file(&bc, argv[optind + 2]);
+    if (ret < 0)
+        goto end;
+    ret = prepare_input(&bc);
+    if (ret < 0)
+        goto end;
+
+    for (i = 0; i < nb_threads; i++) {
+        for (j = 0; j < nb_types && nb_res < MAX_RUNS; j++) {
+            res[nb_res].threads     = threads[i];
+            res[nb_res].thread_type = types[j];
+            ret = run_config(&bc, &res[nb_res], loops);
+            if (ret < 0)
+                goto end;
+            nb_res++;
+        }
+    }
+
+    print_results(&bc, res, nb_res, loops);
+
+end:
+    for (i = 0; i < bc.nb_frames; i++)
+        av_frame_free(&bc.frames[i]);
+    av_freep(&bc.frames);
+    for (i = 0; i < bc.nb_pkts; i++)
+        av_packet_free(&bc.pkts[i]);
+    av_freep(&bc.pkts);
+    avcodec_parameters_free(&bc.par);
+    av_dict_free(&bc.enc_opts);
+    av_freep(&bc.sent);
+    av_freep(&bc.latency);
+    av_freep(&bc.raw);
+    return ret < 0;
+}